@@ -48,6 +48,10 @@ static void init(grib_action_class* c)
     if (!c)
         return;
 
+    /* Once the class is initialised, the lock is not needed */
+    if (GRIB_ATOMIC_LOAD(c->inited))
+        return;
+
     GRIB_MUTEX_INIT_ONCE(&once, &init_mutex);
     GRIB_MUTEX_LOCK(&mutex1);
     if (!c->inited) {
@@ -55,7 +59,7 @@ static void init(grib_action_class* c)
             init(*(c->super));
         }
         c->init_class(c);
-        c->inited = 1;
+        GRIB_ATOMIC_STORE(c->inited, 1);
     }
     GRIB_MUTEX_UNLOCK(&mutex1);
 }
@@ -214,57 +214,15 @@ static void destroy(grib_context* context, grib_action* act)
     grib_context_free_persistent(context, self->basename);
 }
 
-static grib_hash_array_value* get_hash_array_impl(grib_handle* h, grib_action* a)
+/* Load the hash array of the files master, local and ecmf into the context. Called with the lock held */
+static grib_hash_array_value* load_hash_array(grib_handle* h, grib_action_hash_array* self, int id,
+                                              const char* master, const char* local, const char* ecmf)
 {
-    char buf[4096] = {0,};
-    char master[1024] = {0,};
-    char local[1024] = {0,};
-    char ecmf[1024] = {0,};
-    char masterDir[1024] = {0,};
-    size_t lenMasterDir = 1024;
-    char localDir[1024] = {0,};
-    size_t lenLocalDir = 1024;
-    char ecmfDir[1024] = {0,};
-    size_t lenEcmfDir = 1024;
-    char key[4096]    = {0,};
-    char* full = 0;
-    int id;
-    int err;
-    grib_action_hash_array* self = (grib_action_hash_array*)a;
-
     grib_context* context    = ((grib_action*)self)->context;
     grib_hash_array_value* c = NULL;
+    char* full               = 0;
 
-    if (self->hash_array != NULL)
-        return self->hash_array;
-
-    Assert(self->masterDir);
-    grib_get_string(h, self->masterDir, masterDir, &lenMasterDir);
-
-    snprintf(buf, 4096, "%s/%s", masterDir, self->basename);
-
-    err = grib_recompose_name(h, NULL, buf, master, 1);
-    if (err) {
-        grib_context_log(context, GRIB_LOG_ERROR,
-                         "unable to build name of directory %s", self->masterDir);
-        return NULL;
-    }
-
-    if (self->localDir) {
-        grib_get_string(h, self->localDir, localDir, &lenLocalDir);
-        snprintf(buf, 4096, "%s/%s", localDir, self->basename);
-        grib_recompose_name(h, NULL, buf, local, 1);
-    }
-
-    if (self->ecmfDir) {
-        grib_get_string(h, self->ecmfDir, ecmfDir, &lenEcmfDir);
-        snprintf(buf, 4096, "%s/%s", ecmfDir, self->basename);
-        grib_recompose_name(h, NULL, buf, ecmf, 1);
-    }
-
-    snprintf(key, 4096, "%s%s%s", master, local, ecmf);
-
-    id = grib_itrie_get_id(h->context->hash_array_index, key);
+    /* Loaded by another thread meanwhile */
     if ((c = h->context->hash_array[id]) != NULL)
         return c;
 
@@ -300,27 +258,80 @@ static grib_hash_array_value* get_hash_array_impl(grib_handle* h, grib_action* a
     grib_context_log(h->context, GRIB_LOG_DEBUG,
                      "Loading hash_array %s from %s", ((grib_action*)self)->name, full);
 
-    h->context->hash_array[id] = c;
     if (c) {
-        grib_trie* index = grib_trie_new(context);
+        grib_hash_array_value* first = c;
+        grib_trie* index             = grib_trie_new(context);
         while (c) {
             c->index = index;
             grib_trie_insert_no_replace(index, c->name, c);
             c = c->next;
         }
+        c = first;
     }
+    /* Published complete, with its index */
+    GRIB_ATOMIC_STORE(h->context->hash_array[id], c);
 
-    return h->context->hash_array[id];
+    return c;
 }
 
+
 grib_hash_array_value* get_hash_array(grib_handle* h, grib_action* a)
 {
-    grib_hash_array_value* result = NULL;
-    GRIB_MUTEX_INIT_ONCE(&once, &init);
-    GRIB_MUTEX_LOCK(&mutex);
+    char buf[4096] = {0,};
+    char master[1024] = {0,};
+    char local[1024] = {0,};
+    char ecmf[1024] = {0,};
+    char masterDir[1024] = {0,};
+    size_t lenMasterDir = 1024;
+    char localDir[1024] = {0,};
+    size_t lenLocalDir = 1024;
+    char ecmfDir[1024] = {0,};
+    size_t lenEcmfDir = 1024;
+    char key[4096]    = {0,};
+    int id;
+    int err;
+    grib_action_hash_array* self = (grib_action_hash_array*)a;
 
-    result = get_hash_array_impl(h, a);
+    grib_context* context    = ((grib_action*)self)->context;
+    grib_hash_array_value* c = NULL;
+
+    if (self->hash_array != NULL)
+        return self->hash_array;
+
+    Assert(self->masterDir);
+    grib_get_string(h, self->masterDir, masterDir, &lenMasterDir);
+
+    snprintf(buf, 4096, "%s/%s", masterDir, self->basename);
 
+    err = grib_recompose_name(h, NULL, buf, master, 1);
+    if (err) {
+        grib_context_log(context, GRIB_LOG_ERROR,
+                         "unable to build name of directory %s", self->masterDir);
+        return NULL;
+    }
+
+    if (self->localDir) {
+        grib_get_string(h, self->localDir, localDir, &lenLocalDir);
+        snprintf(buf, 4096, "%s/%s", localDir, self->basename);
+        grib_recompose_name(h, NULL, buf, local, 1);
+    }
+
+    if (self->ecmfDir) {
+        grib_get_string(h, self->ecmfDir, ecmfDir, &lenEcmfDir);
+        snprintf(buf, 4096, "%s/%s", ecmfDir, self->basename);
+        grib_recompose_name(h, NULL, buf, ecmf, 1);
+    }
+
+    snprintf(key, 4096, "%s%s%s", master, local, ecmf);
+
+    id = grib_itrie_get_id(h->context->hash_array_index, key);
+    /* Once loaded, the hash arrays are read without the lock */
+    if ((c = GRIB_ATOMIC_LOAD(h->context->hash_array[id])) != NULL)
+        return c;
+
+    GRIB_MUTEX_INIT_ONCE(&once, &init);
+    GRIB_MUTEX_LOCK(&mutex);
+    c = load_hash_array(h, self, id, master, local, ecmf);
     GRIB_MUTEX_UNLOCK(&mutex);
-    return result;
+    return c;
 }
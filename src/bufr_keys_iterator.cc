@@ -114,6 +114,7 @@ static int next_attribute(bufr_keys_iterator* kiter)
     if (!kiter->current)
         return 0;
     if (!kiter->attributes) {
+        /* The attributes an element creates on first use are read-only, never iterated */
         kiter->attributes       = kiter->current->attributes;
         kiter->prefix           = 0;
         kiter->i_curr_attribute = 0;
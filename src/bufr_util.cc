@@ -682,6 +682,45 @@ int codes_bufr_extract_headers_malloc(grib_context* c, const char* filename, cod
     return GRIB_SUCCESS;
 }
 
+int codes_bufr_extract_columns_malloc(grib_handle* h, const char** keys, size_t num_keys, double** columns, size_t* sizes)
+{
+    grib_accessor* data = NULL;
+    size_t k = 0;
+    int err  = 0;
+
+    if (!h || h->product_kind != PRODUCT_BUFR)
+        return GRIB_INVALID_ARGUMENT;
+    data = grib_find_accessor(h, "dataAccessors");
+    if (!data)
+        return GRIB_NOT_FOUND;
+
+    err = accessor_bufr_data_array_extract_columns(data, keys, num_keys, columns, sizes);
+    if (err != GRIB_NOT_IMPLEMENTED)
+        return err;
+
+    // The values of the quality information are named after the elements of its bitmap: they are read from the keys
+    err = grib_set_long(h, "unpack", 1);
+    for (k = 0; k < num_keys && !err; k++) {
+        err = grib_get_size(h, keys[k], &sizes[k]);
+        if (err)
+            break;
+        columns[k] = (double*)malloc((sizes[k] ? sizes[k] : 1) * sizeof(double));
+        if (!columns[k]) {
+            err = GRIB_OUT_OF_MEMORY;
+            break;
+        }
+        err = grib_get_double_array(h, keys[k], columns[k], &sizes[k]);
+    }
+    if (err) {
+        for (k = 0; k < num_keys; k++) {
+            free(columns[k]);
+            columns[k] = NULL;
+            sizes[k]   = 0;
+        }
+    }
+    return err;
+}
+
 static const char* codes_bufr_header_get_centre_name(long edition, long centre_code)
 {
     (void)edition;
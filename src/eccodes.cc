@@ -301,6 +301,33 @@ int codes_grib_nearest_find_multiple(const grib_handle* h, int is_lsm,
 {
     return grib_nearest_find_multiple(h, is_lsm, inlats, inlons, npoints, outlats, outlons, values, distances, indexes);
 }
+int codes_grib_nearest_find_batch(const grib_handle* h,
+                                  const double* inlats, const double* inlons, size_t npoints,
+                                  double* outlats, double* outlons,
+                                  double* values, double* distances, int* indexes)
+{
+    return grib_nearest_find_batch(h, inlats, inlons, npoints, outlats, outlons, values, distances, indexes);
+}
+grib_grid_geometry* codes_grid_geometry_new_from_handle(const grib_handle* h, int* error)
+{
+    return grib_grid_geometry_new_from_handle(h, error);
+}
+int codes_grid_geometry_get_size(const grib_grid_geometry* g, size_t* size)
+{
+    return grib_grid_geometry_get_size(g, size);
+}
+int codes_grid_geometry_get_latlons(const grib_grid_geometry* g, double* lats, double* lons, size_t* size)
+{
+    return grib_grid_geometry_get_latlons(g, lats, lons, size);
+}
+int codes_grid_geometry_equal(const grib_grid_geometry* g1, const grib_grid_geometry* g2)
+{
+    return grib_grid_geometry_equal(g1, g2);
+}
+int codes_grid_geometry_delete(grib_grid_geometry* g)
+{
+    return grib_grid_geometry_delete(g);
+}
 int codes_grib_nearest_delete(grib_nearest* nearest)
 {
     return grib_nearest_delete(nearest);
@@ -157,6 +157,13 @@ typedef struct grib_iterator codes_iterator;
 */
 typedef struct grib_nearest codes_nearest;
 
+/*! Codes grid geometry, the coordinates of the points of the grid of a GRIB message,
+    shared by the messages on the same grid.
+    \ingroup iterators
+    \struct codes_grid_geometry
+*/
+typedef struct grib_grid_geometry codes_grid_geometry;
+
 /*! Codes keys iterator. Iterator over keys.
     \ingroup keys_iterator
     \struct codes_keys_iterator
@@ -404,6 +411,45 @@ codes_handle* codes_grib_handle_new_from_file(codes_context* c, FILE* f, int* er
  */
 codes_handle* codes_bufr_handle_new_from_file(codes_context* c, FILE* f, int* error);
 
+/*! Memory-mapped file of messages, see codes_handle_new_from_mmap.
+    \ingroup codes_handle
+    \struct codes_mmap_file
+*/
+typedef struct grib_mmap_file codes_mmap_file;
+
+/**
+ *  Map a whole file in memory so that handles can be created from it without reading or copying messages.
+ *  Remember always to close it when it is not needed anymore.
+ *
+ * @param c           : the context (NULL for default context)
+ * @param filename    : the path to the file
+ * @param error       : error code set if the returned file is NULL
+ * @return            the mapped file, NULL if a problem is encountered
+ */
+codes_mmap_file* codes_mmap_file_open(codes_context* c, const char* filename, int* error);
+
+/**
+ *  Create a handle from the next message of a mapped file.
+ *  The message is not copied: the handle points straight into the mapping, which stays
+ *  valid until the handle is deleted, even if the file is closed first.
+ *  Keys set on the handle never modify the file on disk.
+ *
+ * @param c           : the context from which the handle will be created (NULL for default context)
+ * @param mf          : the mapped file
+ * @param product     : the kind of product, one of PRODUCT_GRIB, PRODUCT_BUFR or PRODUCT_ANY
+ * @param error       : error code set if the returned handle is NULL and the end of file is not reached
+ * @return            the new handle, NULL at the end of the file or if a problem is encountered
+ */
+codes_handle* codes_handle_new_from_mmap(codes_context* c, codes_mmap_file* mf, ProductKind product, int* error);
+
+/**
+ *  Close a mapped file. The memory is released once the last handle created from it is deleted.
+ *
+ * @param mf          : the mapped file
+ * @return            0 if OK, integer value on error
+ */
+int codes_mmap_file_close(codes_mmap_file* mf);
+
 
 /**
  *  Write a coded message to a file.
@@ -719,6 +765,81 @@ int codes_grib_nearest_find_multiple(const codes_handle* h, int is_lsm,
                                      double* outlats, double* outlons,
                                      double* values, double* distances, int* indexes);
 
+/**
+ * Find the nearest point of each of a batch of points whose latitudes and longitudes
+ * are given in the inlats, inlons arrays respectively, on any grid with a geoiterator.
+ * The nearest point is searched in a spatial index of the points of the grid, built
+ * the first time the grid is searched and shared by the messages on the same grid
+ * (same edition and md5GridSection), so searching many points on many fields costs
+ * little more than reading the values.
+ * values, distances, indexes (in the "values" array) for the nearest points are returned.
+ * The distances are given in kilometres.
+ *
+ * @param h           : handle from which geography and data values are taken
+ * @param inlats      : latitudes of the points to search for
+ * @param inlons      : longitudes of the points to search for
+ * @param npoints     : number of points (size of the inlats,inlons,outlats,outlons,values,distances,indexes arrays)
+ * @param outlats     : returned array of latitudes of the nearest points
+ * @param outlons     : returned array of longitudes of the nearest points
+ * @param values      : returned array of data values of the nearest points, can be NULL to skip decoding the data
+ * @param distances   : returned array of distances from the nearest points
+ * @param indexes     : returned array of indexes of the nearest points
+ * @return            0 if OK, integer value on error
+ */
+int codes_grib_nearest_find_batch(const codes_handle* h,
+                                  const double* inlats, const double* inlons, size_t npoints,
+                                  double* outlats, double* outlons,
+                                  double* values, double* distances, int* indexes);
+
+/**
+ * Get the geometry of the grid of a message: the latitudes and longitudes of its points,
+ * in the order of the geoiterator. They are computed once per grid and shared by the
+ * messages on the same grid (same edition and md5GridSection), in the context of the handle.
+ * The geometry must be deleted with codes_grid_geometry_delete.
+ *
+ * @param h           : the handle whose grid is taken
+ * @param error       : error code
+ * @return            the geometry, NULL on error
+ */
+codes_grid_geometry* codes_grid_geometry_new_from_handle(const codes_handle* h, int* error);
+
+/**
+ * Get the number of points of a grid geometry
+ *
+ * @param g           : the geometry
+ * @param size        : the address of a size_t where the number of points will be set
+ * @return            0 if OK, integer value on error
+ */
+int codes_grid_geometry_get_size(const codes_grid_geometry* g, size_t* size);
+
+/**
+ * Get the latitudes and longitudes of the points of a grid geometry
+ *
+ * @param g           : the geometry
+ * @param lats        : returned array of latitudes, can be NULL
+ * @param lons        : returned array of longitudes, can be NULL
+ * @param size        : the size of the arrays, set to the number of points
+ * @return            0 if OK, integer value on error
+ */
+int codes_grid_geometry_get_latlons(const codes_grid_geometry* g, double* lats, double* lons, size_t* size);
+
+/**
+ * Tell whether two grid geometries are the same grid
+ *
+ * @param g1          : a geometry
+ * @param g2          : another geometry
+ * @return            1 if the grids are the same, 0 if not
+ */
+int codes_grid_geometry_equal(const codes_grid_geometry* g1, const codes_grid_geometry* g2);
+
+/**
+ * Delete a grid geometry. The coordinates stay in the context for the next messages on the grid.
+ *
+ * @param g           : the geometry to be deleted
+ * @return            0 if OK, integer value on error
+ */
+int codes_grid_geometry_delete(codes_grid_geometry* g);
+
 /* @} */
 
 /*! \defgroup get_set Accessing header and data values   */
@@ -1440,6 +1561,20 @@ codes_handle* codes_grib_util_set_spec(codes_handle* h,
  * returns 0 if OK, integer value on error.
  */
 int codes_bufr_extract_headers_malloc(codes_context* c, const char* filename, codes_bufr_header** result, int* num_messages, int strict_mode);
+
+/* EXPERIMENTAL FEATURE
+ * Extract the values of data elements of a BUFR message as whole columns, without creating the keys of its elements.
+ * keys    = array of 'num_keys' element names, each one possibly with a rank (e.g. "#2#airTemperature")
+ *           or a condition (e.g. "/pressure=85000/airTemperature") as for codes_get_double_array.
+ * columns = array of 'num_keys' pointers, each set to the values of its key over all subsets.
+ *           Each of these arrays should be freed by the caller.
+ * sizes   = array of 'num_keys' sizes, each set to the number of values of its key.
+ * returns 0 if OK, integer value on error (e.g. CODES_NOT_FOUND if no data element has the key,
+ *         CODES_INVALID_TYPE if the elements are strings).
+ * The keys of the elements are created, as with unpack=1, when the message has quality information and
+ * its elements are named after those of the bitmap.
+ */
+int codes_bufr_extract_columns_malloc(codes_handle* h, const char** keys, size_t num_keys, double** columns, size_t* sizes);
 int codes_bufr_header_get_string(codes_bufr_header* bh, const char* key, char* val, size_t* len);
 
 /* EXPERIMENTAL FEATURE
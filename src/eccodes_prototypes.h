@@ -144,6 +144,7 @@ int grib_accessors_list_value_count(grib_accessors_list* al, size_t* count);
 int grib_accessor_notify_change(grib_accessor* a, grib_accessor* changed);
 void grib_init_accessor(grib_accessor* a, const long len, grib_arguments* args);
 void grib_accessor_delete(grib_context* ct, grib_accessor* a);
+void grib_accessor_reset(grib_accessor* a);
 grib_accessor* grib_accessor_clone(grib_accessor* a, grib_section* s, int* err);
 void grib_update_size(grib_accessor* a, size_t len);
 int grib_nearest_smaller_value(grib_accessor* a, double val, double* nearest);
@@ -171,6 +172,18 @@ void grib_concept_value_delete(grib_context* c, grib_concept_value* v);
 grib_concept_condition* grib_concept_condition_new(grib_context* c, const char* name, grib_expression* expression, grib_iarray* iarray);
 void grib_concept_condition_delete(grib_context* c, grib_concept_condition* v);
 
+/* grib_definitions_cache.cc*/
+char* grib_definitions_cache_default_path(grib_context* c);
+int grib_definitions_cache_write(grib_context* c, const char* filename, char* const* files, size_t num_files, size_t* num_compiled);
+grib_concept_value* grib_definitions_cache_get_concept(grib_context* c, const char* filename);
+grib_hash_array_value* grib_definitions_cache_get_hash_array(grib_context* c, const char* filename);
+void grib_definitions_cache_delete(grib_context* c);
+
+/* grib_concept_index.cc*/
+void grib_concept_index_delete(grib_context* c, grib_concept_index* index);
+grib_concept_index* grib_concept_index_new(grib_context* c, grib_concept_value* concept);
+int grib_concept_index_get_candidates(const grib_concept_index* index, grib_handle* h, size_t* entries, size_t max, size_t* count);
+
 /* grib_hash_array.cc*/
 grib_hash_array_value* grib_integer_hash_array_value_new(grib_context* c, const char* name, grib_iarray* array);
 void grib_hash_array_value_delete(grib_context* c, grib_hash_array_value* v);
@@ -265,6 +278,7 @@ grib_vsarray* accessor_bufr_data_array_get_stringValues(grib_accessor* a);
 grib_accessors_list* accessor_bufr_data_array_get_dataAccessors(grib_accessor* a);
 grib_trie_with_rank* accessor_bufr_data_array_get_dataAccessorsTrie(grib_accessor* a);
 void accessor_bufr_data_array_set_unpackMode(grib_accessor* a, int unpackMode);
+int accessor_bufr_data_array_extract_columns(grib_accessor* a, const char** keys, size_t num_keys, double** columns, size_t* sizes);
 
 /* grib_accessor_class_bufr_data_element.cc*/
 void accessor_bufr_data_element_set_index(grib_accessor* a, long index);
@@ -276,6 +290,10 @@ void accessor_bufr_data_element_set_descriptors(grib_accessor* a, bufr_descripto
 void accessor_bufr_data_element_set_numericValues(grib_accessor* a, grib_vdarray* numericValues);
 void accessor_bufr_data_element_set_stringValues(grib_accessor* a, grib_vsarray* stringValues);
 void accessor_bufr_data_element_set_elementsDescriptorsIndex(grib_accessor* a, grib_viarray* elementsDescriptorsIndex);
+grib_accessor* accessor_bufr_data_element_new_attribute(const char* name, grib_section* section, int type, char* sval, double dval, long lval, unsigned long flags);
+void accessor_bufr_data_element_set_lazy_attributes(grib_accessor* a, long count, int extraAttributes, grib_section* section);
+int accessor_bufr_data_element_get_code(grib_accessor* a, long* code);
+int accessor_bufr_data_element_add_attributes(grib_accessor* a);
 
 /* grib_accessor_class_bufr_elements_table.cc*/
 int bufr_descriptor_is_marker(bufr_descriptor* d);
@@ -671,6 +689,7 @@ grib_handle* codes_new_from_index(grib_index* index, int message_type, int* err)
 void grib_index_rewind(grib_index* index);
 int codes_index_set_product_kind(grib_index* index, ProductKind product_kind);
 int codes_index_set_unpack_bufr(grib_index* index, int unpack);
+int codes_index_set_num_threads(grib_index* index, int num_threads);
 int is_index_file(const char* filename);
 
 /* grib_accessor_class_number_of_points_gaussian.cc*/
@@ -790,6 +809,12 @@ void grib_permanent_free(const grib_context* c, void* p);
 void* grib_buffer_malloc(const grib_context* c, size_t s);
 void grib_buffer_free(const grib_context* c, void* p);
 void* grib_buffer_realloc(const grib_context* c, void* p, size_t s);
+grib_arena* grib_arena_new(grib_context* c);
+void* grib_arena_malloc_clear(grib_arena* a, size_t size);
+void grib_arena_free(grib_arena* a, void* p, size_t size);
+size_t grib_arena_size(const grib_arena* a);
+void grib_arena_delete(grib_arena* a);
+void grib_arena_chunks_delete(grib_context* c);
 
 /* grib_buffer.cc*/
 void grib_get_buffer_ownership(const grib_context* c, grib_buffer* b);
@@ -872,6 +897,7 @@ void grib_print_api_version(FILE* out);
 const char* grib_get_package_name(void);
 grib_context* grib_context_get_default(void);
 char* codes_resolve_path(grib_context* c, const char* path);
+const grib_string_list* grib_context_get_definition_files_dirs(grib_context* c);
 char* grib_context_full_defs_path(grib_context* c, const char* basename);
 char* grib_samples_path(const grib_context* c);
 char* grib_definition_path(const grib_context* c);
@@ -949,11 +975,34 @@ grib_file* grib_get_file(const char* filename, int* err);
 void grib_file_delete(grib_file* file);
 
 /* grib_geography.cc*/
+void grib_gaussian_latitudes_cache_delete(grib_context* c);
+int grib_context_get_gaussian_latitudes(grib_context* c, long trunc, double* lats);
 int grib_get_gaussian_latitudes(long trunc, double* lats);
 int is_gaussian_global(double lat1, double lat2, double lon1, double lon2, long num_points_equator, const double* latitudes, double angular_precision);
 void rotate(const double inlat, const double inlon, const double angleOfRot, const double southPoleLat, const double southPoleLon, double* outlat, double* outlon);
 void unrotate(const double inlat, const double inlon, const double angleOfRot, const double southPoleLat, const double southPoleLon, double* outlat, double* outlon);
 double geographic_distance_spherical(double radius, double lon1, double lat1, double lon2, double lat2);
+int grib_latitudes_from_conformal_t(double e, const double* ts, double* phi, size_t n);
+
+/* grib_handle_layout.cc*/
+void grib_handle_layout_start(grib_handle* h);
+void grib_handle_layout_end(grib_handle* h);
+void grib_handle_layout_delete(grib_context* c, grib_handle_layout* l);
+grib_handle_layout* grib_handle_layout_reading(const grib_accessor* a);
+int grib_handle_layout_unpack_long(grib_handle_layout* l, grib_accessor_class* c, grib_accessor* a, long* v, size_t* len);
+int grib_handle_layout_unpack_double(grib_handle_layout* l, grib_accessor_class* c, grib_accessor* a, double* v, size_t* len);
+int grib_handle_layout_unpack_float(grib_handle_layout* l, grib_accessor_class* c, grib_accessor* a, float* v, size_t* len);
+int grib_handle_layout_unpack_string(grib_handle_layout* l, grib_accessor_class* c, grib_accessor* a, char* v, size_t* len);
+int grib_handle_layout_unpack_bytes(grib_handle_layout* l, grib_accessor_class* c, grib_accessor* a, unsigned char* v, size_t* len);
+int grib_handle_layout_is_missing(grib_handle_layout* l, grib_accessor_class* c, grib_accessor* a);
+void grib_handle_layout_unsupported(const grib_accessor* a);
+void grib_handle_layout_packed(grib_accessor* a);
+void grib_handle_layout_packed_double(grib_accessor* a, const double* v, size_t len);
+void grib_handle_layout_packed_long(grib_accessor* a, const long* v, size_t len);
+void grib_handle_layout_changed(grib_handle* h);
+int grib_handle_skeleton_keep(grib_handle* h);
+grib_handle* grib_handle_skeleton_take(grib_context* c, const void* data, size_t buflen);
+void grib_handle_skeletons_delete(grib_context* c);
 
 /* grib_handle.cc*/
 grib_section* grib_section_create(grib_handle* h, grib_accessor* owner);
@@ -962,6 +1011,7 @@ void grib_empty_section(grib_context* c, grib_section* b);
 void grib_section_delete(grib_context* c, grib_section* b);
 int grib_handle_delete(grib_handle* h);
 grib_handle* grib_new_handle(grib_context* c);
+grib_arena* grib_handle_arena(grib_handle* h);
 grib_handle* codes_handle_new_from_samples(grib_context* c, const char* name);
 grib_handle* grib_handle_new_from_samples(grib_context* c, const char* name);
 grib_handle* codes_bufr_handle_new_from_samples(grib_context* c, const char* name);
@@ -1040,6 +1090,11 @@ int grib_read_any_from_memory(grib_context* ctx, unsigned char** data, size_t* d
 int grib_count_in_file(grib_context* c, FILE* f, int* n);
 int grib_count_in_filename(grib_context* c, const char* filename, int* n);
 int codes_extract_offsets_malloc(grib_context* c, const char* filename, ProductKind product, off_t** offsets, int* length, int strict_mode);
+grib_mmap_file* codes_mmap_file_open(grib_context* c, const char* filename, int* err);
+void grib_mmap_file_release(grib_mmap_file* mf);
+const unsigned char* grib_mmap_file_data(const grib_mmap_file* mf, size_t* length);
+int codes_mmap_file_close(grib_mmap_file* mf);
+grib_handle* codes_handle_new_from_mmap(grib_context* c, grib_mmap_file* mf, ProductKind product, int* err);
 
 
 /* grib_trie.cc*/
@@ -1103,12 +1158,15 @@ int grib_yyerror(const char* msg);
 void grib_parser_include(const char* included_fname);
 grib_concept_value* grib_parse_concept_file(grib_context* gc, const char* filename);
 grib_hash_array_value* grib_parse_hash_array_file(grib_context* gc, const char* filename);
+int grib_parse_values_file(grib_context* gc, const char* filename, grib_concept_value** concept, grib_hash_array_value** hash_array);
 grib_action* grib_parse_file(grib_context* gc, const char* filename);
 int grib_type_to_int(char id);
 
 /* grib_query.cc*/
 grib_accessors_list* grib_find_accessors_list(const grib_handle* h, const char* name);
 char* grib_split_name_attribute(grib_context* c, const char* name, char* attribute_name);
+char* grib_split_name_rank(grib_context* c, const char* name, int* rank);
+char* grib_split_name_condition(const char* name, codes_condition* condition);
 grib_accessor* grib_find_accessor(const grib_handle* h, const char* name);
 grib_accessor* grib_find_attribute(grib_handle* h, const char* name, const char* attr_name, int* err);
 grib_accessor* grib_find_accessor_fast(grib_handle* h, const char* name);
@@ -1238,6 +1296,7 @@ grib_expression* new_unop_expression(grib_context* c, grib_unop_long_proc long_f
 
 /* grib_expression_class_functor.cc*/
 grib_expression* new_func_expression(grib_context* c, const char* name, grib_arguments* args);
+const char* grib_expression_functor_name(grib_expression* g);
 
 /* grib_expression_class_accessor.cc*/
 grib_expression* new_accessor_expression(grib_context* c, const char* name, long start, size_t length);
@@ -1263,6 +1322,17 @@ grib_expression* new_string_expression(grib_context* c, const char* value);
 /* grib_expression_class_sub_string.cc*/
 grib_expression* new_sub_string_expression(grib_context* c, const char* value, size_t start, size_t length);
 
+/* grib_expression_class_column.cc*/
+grib_expression* new_column_expression(grib_context* c, const char* name, grib_column* column, const long* row);
+
+/* grib_grid_geometry.cc*/
+grib_grid_geometry* grib_grid_geometry_new_from_handle(const grib_handle* h, int* error);
+int grib_grid_geometry_get_size(const grib_grid_geometry* g, size_t* size);
+int grib_grid_geometry_get_latlons(const grib_grid_geometry* g, double* lats, double* lons, size_t* size);
+int grib_grid_geometry_equal(const grib_grid_geometry* g1, const grib_grid_geometry* g2);
+int grib_grid_geometry_delete(grib_grid_geometry* g);
+void grib_grid_geometry_cache_delete(grib_context* c);
+
 /* grib_nearest.cc*/
 int grib_nearest_find(grib_nearest* nearest, const grib_handle* h, double inlat, double inlon, unsigned long flags, double* outlats, double* outlons, double* values, double* distances, int* indexes, size_t* len);
 int grib_nearest_init(grib_nearest* i, grib_handle* h, grib_arguments* args);
@@ -1270,6 +1340,8 @@ int grib_nearest_delete(grib_nearest* i);
 int grib_nearest_get_radius(grib_handle* h, double* radiusInKm);
 void grib_binary_search(const double xx[], const size_t n, double x, size_t* ju, size_t* jl);
 int grib_nearest_find_multiple(const grib_handle* h, int is_lsm, const double* inlats, const double* inlons, long npoints, double* outlats, double* outlons, double* values, double* distances, int* indexes);
+void grib_nearest_index_delete(grib_context* c, grib_nearest_index* index);
+int grib_nearest_find_batch(const grib_handle* h, const double* inlats, const double* inlons, size_t npoints, double* outlats, double* outlons, double* values, double* distances, int* indexes);
 int grib_nearest_find_generic(grib_nearest* nearest, grib_handle* h, double inlat, double inlon, unsigned long flags,
                               const char* values_keyname,
                               double** out_lats,
@@ -1382,6 +1454,7 @@ int compute_bufr_key_rank(grib_handle* h, grib_string_list* keys, const char* ke
 char** codes_bufr_copy_data_return_copied_keys(grib_handle* hin, grib_handle* hout, size_t* nkeys, int* err);
 int codes_bufr_copy_data(grib_handle* hin, grib_handle* hout);
 int codes_bufr_extract_headers_malloc(grib_context* c, const char* filename, codes_bufr_header** result, int* num_messages, int strict_mode);
+int codes_bufr_extract_columns_malloc(grib_handle* h, const char** keys, size_t num_keys, double** columns, size_t* sizes);
 int codes_bufr_header_get_string(codes_bufr_header* bh, const char* key, char* val, size_t* len);
 int codes_bufr_key_is_header(const grib_handle* h, const char* key, int* err);
 int codes_bufr_key_is_coordinate(const grib_handle* h, const char* key, int* err);
@@ -28,9 +28,17 @@ GRIB_INLINE static int grib_inline_strcmp(const char* a, const char* b)
     return (*a == 0 && *b == 0) ? 0 : 1;
 }
 
+/* The attributes of a BUFR data element are created on first use */
+GRIB_INLINE static void create_lazy_attributes(grib_accessor* a)
+{
+    if (a->flags & GRIB_ACCESSOR_FLAG_LAZY_ATTRIBUTES)
+        accessor_bufr_data_element_add_attributes(a);
+}
+
 void grib_accessor_dump(grib_accessor* a, grib_dumper* f)
 {
     grib_accessor_class* c = a->cclass;
+    create_lazy_attributes(a);
     while (c) {
         if (c->dump) {
             c->dump(a, f);
@@ -44,6 +52,7 @@ void grib_accessor_dump(grib_accessor* a, grib_dumper* f)
 int grib_pack_missing(grib_accessor* a)
 {
     grib_accessor_class* c = a->cclass;
+    grib_handle_layout_packed(a);
     /*grib_context_log(a->context, GRIB_LOG_DEBUG, "(%s)%s is packing (double) %g",(a->parent->owner)?(a->parent->owner->name):"root", a->name ,v?(*v):0); */
     while (c) {
         if (c->pack_missing) {
@@ -58,6 +67,7 @@ int grib_pack_missing(grib_accessor* a)
 int grib_pack_zero(grib_accessor* a)
 {
     grib_accessor_class* c = a->cclass;
+    grib_handle_layout_packed(a);
     /*grib_context_log(a->context, GRIB_LOG_DEBUG, "(%s)%s is packing (double) %g",(a->parent->owner)?(a->parent->owner->name):"root", a->name ,v?(*v):0); */
     while (c) {
         if (c->clear) {
@@ -75,7 +85,8 @@ int grib_is_missing_internal(grib_accessor* a)
     /*grib_context_log(a->context, GRIB_LOG_DEBUG, "(%s)%s is packing (double) %g",(a->parent->owner)?(a->parent->owner->name):"root", a->name ,v?(*v):0); */
     while (c) {
         if (c->is_missing) {
-            return c->is_missing(a);
+            grib_handle_layout* l = grib_handle_layout_reading(a);
+            return l ? grib_handle_layout_is_missing(l, c, a) : c->is_missing(a);
         }
         c = c->super ? *(c->super) : NULL;
     }
@@ -86,6 +97,7 @@ int grib_is_missing_internal(grib_accessor* a)
 int grib_pack_double(grib_accessor* a, const double* v, size_t* len)
 {
     grib_accessor_class* c = a->cclass;
+    grib_handle_layout_packed_double(a, v, len ? *len : 0);
     /*grib_context_log(a->context, GRIB_LOG_DEBUG, "(%s)%s is packing (double) %g",(a->parent->owner)?(a->parent->owner->name):"root", a->name ,v?(*v):0); */
     while (c) {
         if (c->pack_double) {
@@ -100,6 +112,7 @@ int grib_pack_double(grib_accessor* a, const double* v, size_t* len)
 int grib_pack_float(grib_accessor* a, const float* v, size_t* len)
 {
     grib_accessor_class* c = a->cclass;
+    grib_handle_layout_packed(a);
     while (c) {
         if (c->pack_float) {
             return c->pack_float(a, v, len);
@@ -113,6 +126,7 @@ int grib_pack_float(grib_accessor* a, const float* v, size_t* len)
 int grib_pack_expression(grib_accessor* a, grib_expression* e)
 {
     grib_accessor_class* c = a->cclass;
+    grib_handle_layout_packed(a);
     /*grib_context_log(a->context, GRIB_LOG_DEBUG, "(%s)%s is packing (double) %g",(a->parent->owner)?(a->parent->owner->name):"root", a->name ,v?(*v):0); */
     while (c) {
         if (c->pack_expression) {
@@ -127,6 +141,7 @@ int grib_pack_expression(grib_accessor* a, grib_expression* e)
 int grib_pack_string(grib_accessor* a, const char* v, size_t* len)
 {
     grib_accessor_class* c = a->cclass;
+    grib_handle_layout_packed(a);
     /*grib_context_log(a->context, GRIB_LOG_DEBUG, "(%s)%s is packing (string) %s",(a->parent->owner)?(a->parent->owner->name):"root", a->name ,v?v:"(null)");*/
     while (c) {
         if (c->pack_string) {
@@ -141,6 +156,7 @@ int grib_pack_string(grib_accessor* a, const char* v, size_t* len)
 int grib_pack_string_array(grib_accessor* a, const char** v, size_t* len)
 {
     grib_accessor_class* c = a->cclass;
+    grib_handle_layout_packed(a);
     /*grib_context_log(a->context, GRIB_LOG_DEBUG, "(%s)%s is packing (string) %s",(a->parent->owner)?(a->parent->owner->name):"root", a->name ,v?v:"(null)");*/
     while (c) {
         if (c->pack_string_array) {
@@ -155,6 +171,7 @@ int grib_pack_string_array(grib_accessor* a, const char** v, size_t* len)
 int grib_pack_long(grib_accessor* a, const long* v, size_t* len)
 {
     grib_accessor_class* c = a->cclass;
+    grib_handle_layout_packed_long(a, v, len ? *len : 0);
     /*grib_context_log(a->context, GRIB_LOG_DEBUG, "(%s)%s is packing (long) %d",(a->parent->owner)?(a->parent->owner->name):"root", a->name ,v?(*v):0); */
     while (c) {
         if (c->pack_long) {
@@ -169,6 +186,7 @@ int grib_pack_long(grib_accessor* a, const long* v, size_t* len)
 int grib_pack_bytes(grib_accessor* a, const unsigned char* v, size_t* len)
 {
     grib_accessor_class* c = a->cclass;
+    grib_handle_layout_packed(a);
     /*grib_context_log(a->context, GRIB_LOG_DEBUG, "(%s)%s is packing (bytes) %d",(a->parent->owner)?(a->parent->owner->name):"root", a->name ,v?(*v):0); */
     while (c) {
         if (c->pack_bytes) {
@@ -186,7 +204,8 @@ int grib_unpack_bytes(grib_accessor* a, unsigned char* v, size_t* len)
     /*grib_context_log(a->context, GRIB_LOG_DEBUG, "(%s)%s is unpacking (bytes)",(a->parent->owner)?(a->parent->owner->name):"root", a->name ); */
     while (c) {
         if (c->unpack_bytes) {
-            return c->unpack_bytes(a, v, len);
+            grib_handle_layout* l = grib_handle_layout_reading(a);
+            return l ? grib_handle_layout_unpack_bytes(l, c, a, v, len) : c->unpack_bytes(a, v, len);
         }
         c = c->super ? *(c->super) : NULL;
     }
@@ -197,6 +216,7 @@ int grib_unpack_bytes(grib_accessor* a, unsigned char* v, size_t* len)
 int grib_unpack_double_subarray(grib_accessor* a, double* v, size_t start, size_t len)
 {
     grib_accessor_class* c = a->cclass;
+    grib_handle_layout_unsupported(a);
     while (c) {
         if (c->unpack_double_subarray) {
             return c->unpack_double_subarray(a, v, start, len);
@@ -213,7 +233,8 @@ int grib_unpack_double(grib_accessor* a, double* v, size_t* len)
     /*grib_context_log(a->context, GRIB_LOG_DEBUG, "(%s)%s is unpacking (double)",(a->parent->owner)?(a->parent->owner->name):"root", a->name ); */
     while (c) {
         if (c->unpack_double) {
-            return c->unpack_double(a, v, len);
+            grib_handle_layout* l = grib_handle_layout_reading(a);
+            return l ? grib_handle_layout_unpack_double(l, c, a, v, len) : c->unpack_double(a, v, len);
         }
         c = c->super ? *(c->super) : NULL;
     }
@@ -227,7 +248,8 @@ int grib_unpack_float(grib_accessor* a, float* v, size_t* len)
     while (c) {
         /* printf("grib_accessor.c grib_unpack_float:: c->name=%s\n",c->name); */
         if (c->unpack_float) {
-            return c->unpack_float(a, v, len);
+            grib_handle_layout* l = grib_handle_layout_reading(a);
+            return l ? grib_handle_layout_unpack_float(l, c, a, v, len) : c->unpack_float(a, v, len);
         }
         c = c->super ? *(c->super) : NULL;
     }
@@ -250,6 +272,7 @@ int grib_unpack<float>(grib_accessor* a, float* v, size_t* len)
 int grib_unpack_double_element(grib_accessor* a, size_t i, double* v)
 {
     grib_accessor_class* c = a->cclass;
+    grib_handle_layout_unsupported(a);
     while (c) {
         if (c->unpack_double_element) {
             return c->unpack_double_element(a, i, v);
@@ -277,6 +300,7 @@ int grib_unpack_float_element(grib_accessor* a, size_t i, float* v)
 int grib_unpack_double_element_set(grib_accessor* a, const size_t* index_array, size_t len, double* val_array)
 {
     grib_accessor_class* c = a->cclass;
+    grib_handle_layout_unsupported(a);
     DEBUG_ASSERT(len > 0);
     while (c) {
         if (c->unpack_double_element_set) {
@@ -307,7 +331,8 @@ int grib_unpack_string(grib_accessor* a, char* v, size_t* len)
     /* grib_context_log(a->context, GRIB_LOG_DEBUG, "(%s)%s is unpacking (string)",(a->parent->owner)?(a->parent->owner->name):"root", a->name ); */
     while (c) {
         if (c->unpack_string) {
-            return c->unpack_string(a, v, len);
+            grib_handle_layout* l = grib_handle_layout_reading(a);
+            return l ? grib_handle_layout_unpack_string(l, c, a, v, len) : c->unpack_string(a, v, len);
         }
         c = c->super ? *(c->super) : NULL;
     }
@@ -318,6 +343,7 @@ int grib_unpack_string(grib_accessor* a, char* v, size_t* len)
 int grib_unpack_string_array(grib_accessor* a, char** v, size_t* len)
 {
     grib_accessor_class* c = a->cclass;
+    grib_handle_layout_unsupported(a);
     while (c) {
         if (c->unpack_string_array) {
             return c->unpack_string_array(a, v, len);
@@ -402,7 +428,8 @@ int grib_unpack_long(grib_accessor* a, long* v, size_t* len)
     /*grib_context_log(a->context, GRIB_LOG_DEBUG, "(%s)%s is unpacking (long)",(a->parent->owner)?(a->parent->owner->name):"root", a->name ); */
     while (c) {
         if (c->unpack_long) {
-            return c->unpack_long(a, v, len);
+            grib_handle_layout* l = grib_handle_layout_reading(a);
+            return l ? grib_handle_layout_unpack_long(l, c, a, v, len) : c->unpack_long(a, v, len);
         }
         c = c->super ? *(c->super) : NULL;
     }
@@ -555,6 +582,7 @@ void grib_init_accessor(grib_accessor* a, const long len, grib_arguments* args)
 void grib_accessor_delete(grib_context* ct, grib_accessor* a)
 {
     grib_accessor_class* c = a->cclass;
+    grib_arena* arena      = grib_handle_arena(grib_handle_of_accessor(a));
     while (c) {
         grib_accessor_class* s = c->super ? *(c->super) : NULL;
         /*printf("grib_accessor_delete: before destroy a=%p c->name=%s ==> a->name=%s\n", (void*)a, c->name, a->name);*/
@@ -564,7 +592,19 @@ void grib_accessor_delete(grib_context* ct, grib_accessor* a)
         c = s;
     }
     /*printf("grib_accessor_delete before free a=%p\n", (void*)a);*/
-    grib_context_free(ct, a);
+    grib_arena_free(arena, a, a->cclass->size);
+}
+
+/* Forgets the values cached from the message. For this one too, ALL reset are called */
+
+void grib_accessor_reset(grib_accessor* a)
+{
+    grib_accessor_class* c = a->cclass;
+    while (c) {
+        if (c->reset)
+            c->reset(a);
+        c = c->super ? *(c->super) : NULL;
+    }
 }
 
 grib_accessor* grib_accessor_clone(grib_accessor* a, grib_section* s, int* err)
@@ -702,6 +742,7 @@ int grib_accessor_add_attribute(grib_accessor* a, grib_accessor* attr, int nest_
     grib_accessor* same = NULL;
     grib_accessor* aloc = a;
 
+    create_lazy_attributes(a);
     if (grib_accessor_has_attributes(a)) {
         same = ecc__grib_accessor_get_attribute(a, attr->name, &id);
     }
@@ -719,6 +760,8 @@ int grib_accessor_add_attribute(grib_accessor* a, grib_accessor* attr, int nest_
             attr->parent_as_attribute = aloc;
             if (aloc->same)
                 attr->same = ecc__grib_accessor_get_attribute(aloc->same, attr->name, &idx);
+            /* The dumpers walk the attributes of attributes */
+            create_lazy_attributes(attr);
 
             grib_context_log(a->context, GRIB_LOG_DEBUG, "added attribute %s->%s", a->name, attr->name);
             return GRIB_SUCCESS;
@@ -759,6 +802,7 @@ int grib_accessor_delete_attribute(grib_accessor* a, const char* name)
 
 grib_accessor* grib_accessor_get_attribute_by_index(grib_accessor* a, int index)
 {
+    create_lazy_attributes(a);
     if (index < MAX_ACCESSOR_ATTRIBUTES)
         return a->attributes[index];
 
@@ -773,6 +817,7 @@ const char* grib_accessor_get_name(grib_accessor* a)
 grib_accessor* ecc__grib_accessor_get_attribute(grib_accessor* a, const char* name, int* index)
 {
     int i = 0;
+    create_lazy_attributes(a);
     while (i < MAX_ACCESSOR_ATTRIBUTES && a->attributes[i]) {
         if (!grib_inline_strcmp(a->attributes[i]->name, name)) {
             *index = i;
@@ -785,6 +830,7 @@ grib_accessor* ecc__grib_accessor_get_attribute(grib_accessor* a, const char* na
 
 int grib_accessor_has_attributes(grib_accessor* a)
 {
+    create_lazy_attributes(a);
     return a->attributes[0] ? 1 : 0;
 }
 
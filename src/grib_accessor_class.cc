@@ -75,29 +75,33 @@ static struct table_entry table[] = {
 
 grib_section* grib_create_root_section(const grib_context* context, grib_handle* h)
 {
-    char* fpath     = 0;
-    grib_section* s = (grib_section*)grib_context_malloc_clear(context, sizeof(grib_section));
-
-    GRIB_MUTEX_INIT_ONCE(&once, &init);
-    GRIB_MUTEX_LOCK(&mutex1);
-    if (h->context->grib_reader == NULL) {
-        if ((fpath = grib_context_full_defs_path(h->context, "boot.def")) == NULL) {
-            grib_context_log(h->context, GRIB_LOG_FATAL,
-                             "Unable to find boot.def. Context path=%s\n"
-                             "\nPossible causes:\n"
-                             "- The software is not correctly installed\n"
-                             "- The environment variable ECCODES_DEFINITION_PATH is defined but incorrect\n",
-                             context->grib_definition_files_path);
+    char* fpath                = 0;
+    grib_section* s            = (grib_section*)grib_arena_malloc_clear(grib_handle_arena(h), sizeof(grib_section));
+    grib_action_file_list* afl = GRIB_ATOMIC_LOAD(h->context->grib_reader);
+
+    /* The lock is only needed until boot.def, the first file, is parsed */
+    if (afl == NULL || GRIB_ATOMIC_LOAD(afl->first) == NULL) {
+        GRIB_MUTEX_INIT_ONCE(&once, &init);
+        GRIB_MUTEX_LOCK(&mutex1);
+        if (h->context->grib_reader == NULL) {
+            if ((fpath = grib_context_full_defs_path(h->context, "boot.def")) == NULL) {
+                grib_context_log(h->context, GRIB_LOG_FATAL,
+                                 "Unable to find boot.def. Context path=%s\n"
+                                 "\nPossible causes:\n"
+                                 "- The software is not correctly installed\n"
+                                 "- The environment variable ECCODES_DEFINITION_PATH is defined but incorrect\n",
+                                 context->grib_definition_files_path);
+            }
+            grib_parse_file(h->context, fpath);
         }
-        grib_parse_file(h->context, fpath);
+        GRIB_MUTEX_UNLOCK(&mutex1);
     }
-    GRIB_MUTEX_UNLOCK(&mutex1);
 
     s->h        = h;
     s->aclength = NULL;
     s->owner    = NULL;
     s->block    = (grib_block_of_accessors*)
-        grib_context_malloc_clear(context, sizeof(grib_block_of_accessors));
+        grib_arena_malloc_clear(grib_handle_arena(h), sizeof(grib_block_of_accessors));
     grib_context_log(context, GRIB_LOG_DEBUG, "Creating root section");
     return s;
 }
@@ -141,7 +145,7 @@ grib_accessor* grib_accessor_factory(grib_section* p, grib_action* creator,
     c = *((grib_accessor_classes_hash(creator->op, strlen(creator->op)))->cclass);
 #endif
 
-    a = (grib_accessor*)grib_context_malloc_clear(p->h->context, c->size);
+    a = (grib_accessor*)grib_arena_malloc_clear(grib_handle_arena(p->h), c->size);
 
     a->name       = creator->name;
     a->name_space = creator->name_space;
@@ -225,6 +229,9 @@ static void link_same_attributes(grib_accessor* a, grib_accessor* b)
     grib_accessor* bAttribute = NULL;
     if (a == NULL || b == NULL)
         return;
+    /* Linked when they are created */
+    if (a->flags & GRIB_ACCESSOR_FLAG_LAZY_ATTRIBUTES)
+        return;
     if (!grib_accessor_has_attributes(b))
         return;
     while (i < MAX_ACCESSOR_ATTRIBUTES && a->attributes[i]) {
@@ -41,6 +41,7 @@
    MEMBERS    = grib_vsarray* stringValues
    MEMBERS    = grib_viarray* elementsDescriptorsIndex
    MEMBERS    = int do_decode
+   MEMBERS    = int keys_pending
    MEMBERS    = int bitmapStartElementsDescriptorsIndex
    MEMBERS    = int bitmapCurrentElementsDescriptorsIndex
    MEMBERS    = int bitmapSize
@@ -121,6 +122,7 @@ typedef struct grib_accessor_bufr_data_array
     grib_vsarray* stringValues;
     grib_viarray* elementsDescriptorsIndex;
     int do_decode;
+    int keys_pending;
     int bitmapStartElementsDescriptorsIndex;
     int bitmapCurrentElementsDescriptorsIndex;
     int bitmapSize;
@@ -202,6 +204,7 @@ static grib_accessor_class _grib_accessor_class_bufr_data_array = {
     0,     /* unpack a subarray */
     0,                      /* clear */
     0,                 /* clone accessor */
+    0,                 /* reset */
 };
 
 
@@ -214,6 +217,7 @@ grib_accessor_class* grib_accessor_class_bufr_data_array = &_grib_accessor_class
 #define PROCESS_DECODE 0
 #define PROCESS_NEW_DATA 1
 #define PROCESS_ENCODE 2
+#define PROCESS_DECODE_VALUES 3 /* Decode without creating the keys */
 
 #define OVERRIDDEN_REFERENCE_VALUES_KEY "inputOverriddenReferenceValues"
 
@@ -234,6 +238,16 @@ typedef int (*codec_replication_proc)(grib_context* c, grib_accessor_bufr_data_a
 
 static int create_keys(const grib_accessor* a, long onlySubset, long startSubset, long endSubset);
 
+/* The keys of values decoded for their columns only are created when first needed */
+static int create_pending_keys(grib_accessor* a)
+{
+    grib_accessor_bufr_data_array* self = (grib_accessor_bufr_data_array*)a;
+    if (!self->keys_pending)
+        return GRIB_SUCCESS;
+    self->keys_pending = 0;
+    return create_keys(a, 0, 0, 0);
+}
+
 static void restart_bitmap(grib_accessor_bufr_data_array* self)
 {
     self->bitmapCurrent                         = -1;
@@ -377,6 +391,7 @@ static void init(grib_accessor* a, const long v, grib_arguments* params)
     dataKeysAcc                    = grib_find_accessor(grib_handle_of_accessor(a), dataKeysName);
     self->dataKeys                 = dataKeysAcc->parent;
     self->do_decode                = 1;
+    self->keys_pending             = 0;
     self->elementsDescriptorsIndex = 0;
     self->numericValues            = 0;
     self->tempDoubleValues         = 0;
@@ -504,12 +519,14 @@ grib_vsarray* accessor_bufr_data_array_get_stringValues(grib_accessor* a)
 grib_accessors_list* accessor_bufr_data_array_get_dataAccessors(grib_accessor* a)
 {
     grib_accessor_bufr_data_array* self = (grib_accessor_bufr_data_array*)a;
+    create_pending_keys(a);
     return self->dataAccessors;
 }
 
 grib_trie_with_rank* accessor_bufr_data_array_get_dataAccessorsTrie(grib_accessor* a)
 {
     grib_accessor_bufr_data_array* self = (grib_accessor_bufr_data_array*)a;
+    create_pending_keys(a);
     return self->dataAccessorsTrie;
 }
 
@@ -1835,42 +1852,6 @@ static void push_zero_element(grib_accessor_bufr_data_array* self, grib_darray*
     }
 }
 
-static grib_accessor* create_attribute_variable(const char* name, grib_section* section, int type, char* sval, double dval, long lval, unsigned long flags)
-{
-    grib_accessor* a    = NULL;
-    grib_action creator = {0,};
-    size_t len;
-    creator.op         = (char*)"variable";
-    creator.name_space = (char*)"";
-    creator.flags      = GRIB_ACCESSOR_FLAG_READ_ONLY | flags;
-    creator.set        = 0;
-
-    creator.name = (char*)name;
-    a            = grib_accessor_factory(section, &creator, 0, NULL);
-    a->parent    = NULL;
-    a->h         = section->h;
-    accessor_variable_set_type(a, type);
-    len = 1;
-    switch (type) {
-        case GRIB_TYPE_LONG:
-            grib_pack_long(a, &lval, &len);
-            break;
-        case GRIB_TYPE_DOUBLE:
-            grib_pack_double(a, &dval, &len);
-            break;
-        case GRIB_TYPE_STRING:
-            if (!sval)
-                return NULL;
-            /* Performance: No need for len=strlen(sval). It's not used. */
-            /* See grib_accessor_class_variable.c, pack_string() */
-            len = 0;
-            grib_pack_string(a, sval, &len);
-            break;
-    }
-
-    return a;
-}
-
 static void set_creator_name(grib_action* creator, int code)
 {
     switch (code) {
@@ -1960,7 +1941,6 @@ static grib_accessor* create_accessor_from_descriptor(const grib_accessor* a, gr
 {
     grib_accessor_bufr_data_array* self = (grib_accessor_bufr_data_array*)a;
     char code[10]               = {0,};
-    char* temp_str              = NULL;
     int idx                     = 0;
     unsigned long flags         = GRIB_ACCESSOR_FLAG_READ_ONLY;
     grib_action operatorCreator = {0,};
@@ -2024,40 +2004,7 @@ static grib_accessor* create_accessor_from_descriptor(const grib_accessor* a, gr
                 grib_accessor_add_attribute(elementAccessor, attribute, 0);
             }
 
-            attribute = create_attribute_variable("index", section, GRIB_TYPE_LONG, 0, 0, count, flags);
-            if (!attribute)
-                return NULL;
-            grib_accessor_add_attribute(elementAccessor, attribute, 0);
-
-            snprintf(code, sizeof(code), "%06ld", self->expanded->v[idx]->code);
-            temp_str  = grib_context_strdup(a->context, code);
-            attribute = create_attribute_variable("code", section, GRIB_TYPE_STRING, temp_str, 0, 0, flags);
-            if (!attribute)
-                return NULL;
-            grib_sarray_push(a->context, self->tempStrings, temp_str); /* ECC-325: store alloc'd string (due to strdup) for clean up later */
-            grib_accessor_add_attribute(elementAccessor, attribute, 0);
-
-            if (add_extra_attributes) {
-                attribute = create_attribute_variable("units", section, GRIB_TYPE_STRING, self->expanded->v[idx]->units, 0, 0, GRIB_ACCESSOR_FLAG_DUMP | flags);
-                if (!attribute)
-                    return NULL;
-                grib_accessor_add_attribute(elementAccessor, attribute, 0);
-
-                attribute = create_attribute_variable("scale", section, GRIB_TYPE_LONG, 0, 0, self->expanded->v[idx]->scale, flags);
-                if (!attribute)
-                    return NULL;
-                grib_accessor_add_attribute(elementAccessor, attribute, 0);
-
-                attribute = create_attribute_variable("reference", section, GRIB_TYPE_DOUBLE, 0, self->expanded->v[idx]->reference, 0, flags);
-                if (!attribute)
-                    return NULL;
-                grib_accessor_add_attribute(elementAccessor, attribute, 0);
-
-                attribute = create_attribute_variable("width", section, GRIB_TYPE_LONG, 0, 0, self->expanded->v[idx]->width, flags);
-                if (!attribute)
-                    return NULL;
-                grib_accessor_add_attribute(elementAccessor, attribute, 0);
-            }
+            accessor_bufr_data_element_set_lazy_attributes(elementAccessor, count, add_extra_attributes, section);
             break;
         case 2:
             set_creator_name(&creator, self->expanded->v[idx]->code);
@@ -2074,23 +2021,19 @@ static grib_accessor* create_accessor_from_descriptor(const grib_accessor* a, gr
                 accessor_bufr_data_element_set_type(elementAccessor, self->expanded->v[idx]->type);
                 accessor_bufr_data_element_set_numberOfSubsets(elementAccessor, self->numberOfSubsets);
                 accessor_bufr_data_element_set_subsetNumber(elementAccessor, subset);
-
-                attribute = create_attribute_variable("index", section, GRIB_TYPE_LONG, 0, 0, count, flags);
-                if (!attribute)
-                    return NULL;
-                grib_accessor_add_attribute(elementAccessor, attribute, 0);
+                accessor_bufr_data_element_set_lazy_attributes(elementAccessor, count, 0, section);
             }
             else {
                 elementAccessor = grib_accessor_factory(section, &operatorCreator, 0, NULL);
                 accessor_variable_set_type(elementAccessor, GRIB_TYPE_LONG);
 
-                attribute = create_attribute_variable("index", section, GRIB_TYPE_LONG, 0, 0, count, flags);
+                attribute = accessor_bufr_data_element_new_attribute("index", section, GRIB_TYPE_LONG, 0, 0, count, flags);
                 if (!attribute)
                     return NULL;
                 grib_accessor_add_attribute(elementAccessor, attribute, 0);
 
                 snprintf(code, sizeof(code), "%06ld", self->expanded->v[idx]->code);
-                attribute = create_attribute_variable("code", section, GRIB_TYPE_STRING, code, 0, 0, flags);
+                attribute = accessor_bufr_data_element_new_attribute("code", section, GRIB_TYPE_STRING, code, 0, 0, flags);
                 if (!attribute)
                     return NULL;
                 grib_accessor_add_attribute(elementAccessor, attribute, 0);
@@ -2110,34 +2053,34 @@ static grib_accessor* create_accessor_from_descriptor(const grib_accessor* a, gr
             accessor_bufr_data_element_set_numberOfSubsets(elementAccessor, self->numberOfSubsets);
             accessor_bufr_data_element_set_subsetNumber(elementAccessor, subset);
 
-            attribute = create_attribute_variable("index", section, GRIB_TYPE_LONG, 0, 0, count, flags);
+            attribute = accessor_bufr_data_element_new_attribute("index", section, GRIB_TYPE_LONG, 0, 0, count, flags);
             if (!attribute)
                 return NULL;
             grib_accessor_add_attribute(elementAccessor, attribute, 0);
 
             snprintf(code, sizeof(code), "%06ld", self->expanded->v[idx]->code);
-            attribute = create_attribute_variable("code", section, GRIB_TYPE_STRING, code, 0, 0, flags);
+            attribute = accessor_bufr_data_element_new_attribute("code", section, GRIB_TYPE_STRING, code, 0, 0, flags);
             if (!attribute)
                 return NULL;
             grib_accessor_add_attribute(elementAccessor, attribute, 0);
 
             if (add_extra_attributes) {
-                attribute = create_attribute_variable("units", section, GRIB_TYPE_STRING, self->expanded->v[idx]->units, 0, 0, GRIB_ACCESSOR_FLAG_DUMP);
+                attribute = accessor_bufr_data_element_new_attribute("units", section, GRIB_TYPE_STRING, self->expanded->v[idx]->units, 0, 0, GRIB_ACCESSOR_FLAG_DUMP);
                 if (!attribute)
                     return NULL;
                 grib_accessor_add_attribute(elementAccessor, attribute, 0);
 
-                attribute = create_attribute_variable("scale", section, GRIB_TYPE_LONG, 0, 0, self->expanded->v[idx]->scale, flags);
+                attribute = accessor_bufr_data_element_new_attribute("scale", section, GRIB_TYPE_LONG, 0, 0, self->expanded->v[idx]->scale, flags);
                 if (!attribute)
                     return NULL;
                 grib_accessor_add_attribute(elementAccessor, attribute, 0);
 
-                attribute = create_attribute_variable("reference", section, GRIB_TYPE_DOUBLE, 0, self->expanded->v[idx]->reference, 0, flags);
+                attribute = accessor_bufr_data_element_new_attribute("reference", section, GRIB_TYPE_DOUBLE, 0, self->expanded->v[idx]->reference, 0, flags);
                 if (!attribute)
                     return NULL;
                 grib_accessor_add_attribute(elementAccessor, attribute, 0);
 
-                attribute = create_attribute_variable("width", section, GRIB_TYPE_LONG, 0, 0, self->expanded->v[idx]->width, flags);
+                attribute = accessor_bufr_data_element_new_attribute("width", section, GRIB_TYPE_LONG, 0, 0, self->expanded->v[idx]->width, flags);
                 if (!attribute)
                     return NULL;
                 grib_accessor_add_attribute(elementAccessor, attribute, 0);
@@ -2256,20 +2199,30 @@ static grib_iarray* set_subset_list(
     return list;
 }
 
-static int bitmap_ref_skip(grib_accessors_list* al, int* err)
+/* The code attribute of an accessor: that of an element whose attributes are not created yet is read from its descriptor */
+static int get_code_attribute(grib_accessor* a, long* code, int* err)
 {
     grib_accessor* acode = NULL;
+    size_t l             = 1;
+
+    if (a->flags & GRIB_ACCESSOR_FLAG_LAZY_ATTRIBUTES)
+        return accessor_bufr_data_element_get_code(a, code) == GRIB_SUCCESS;
+
+    acode = grib_accessor_get_attribute(a, "code");
+    if (!acode)
+        return 0;
+    *err = grib_unpack_long(acode, code, &l);
+    return 1;
+}
+
+static int bitmap_ref_skip(grib_accessors_list* al, int* err)
+{
     long code[1];
-    size_t l = 1;
 
     if (!al || !al->accessor)
         return 0;
 
-    acode = grib_accessor_get_attribute(al->accessor, "code");
-
-    if (acode)
-        *err = grib_unpack_long(acode, code, &l);
-    else
+    if (!get_code_attribute(al->accessor, code, err))
         return 1;
 
     switch (code[0]) {
@@ -2292,16 +2245,11 @@ static int bitmap_ref_skip(grib_accessors_list* al, int* err)
 /* Return 1 if the descriptor is an operator marking the start of a bitmap */
 static int is_bitmap_start_descriptor(grib_accessors_list* al, int* err)
 {
-    grib_accessor* acode = NULL;
     long code[1];
-    size_t l = 1;
     if (!al || !al->accessor)
         return 0;
 
-    acode = grib_accessor_get_attribute(al->accessor, "code");
-    if (acode)
-        *err = grib_unpack_long(acode, code, &l);
-    else
+    if (!get_code_attribute(al->accessor, code, err))
         return 1;
 
     switch (code[0]) {
@@ -2843,7 +2791,7 @@ static int process_elements(grib_accessor* a, int flag, long onlySubset, long st
     long totalSize;
     bufr_descriptor** descriptors = 0;
     long icount;
-    int decoding = 0, do_clean = 1;
+    int decoding = 0, do_clean = 1, create_data_keys = 1;
     grib_buffer* buffer = NULL;
     codec_element_proc codec_element;
     codec_replication_proc codec_replication;
@@ -2859,11 +2807,17 @@ static int process_elements(grib_accessor* a, int flag, long onlySubset, long st
 
     totalSize = self->bitsToEndData;
 
+    if (flag == PROCESS_DECODE_VALUES) {
+        flag             = PROCESS_DECODE;
+        create_data_keys = 0;
+    }
+
     switch (flag) {
         case PROCESS_DECODE:
             if (!self->do_decode)
-                return 0;
-            self->do_decode = 0;
+                return create_data_keys ? create_pending_keys(a) : GRIB_SUCCESS;
+            self->do_decode    = 0;
+            self->keys_pending = 0;
             buffer          = h->buffer;
             decoding        = 1;
             do_clean        = 1;
@@ -3361,7 +3315,10 @@ static int process_elements(grib_accessor* a, int flag, long onlySubset, long st
     /*grib_viarray_print("DBG process_elements: self->elementsDescriptorsIndex", self->elementsDescriptorsIndex);*/
 
     if (decoding) {
-        err                 = create_keys(a, 0, 0, 0);
+        if (create_data_keys)
+            err = create_keys(a, 0, 0, 0);
+        else
+            self->keys_pending = 1;
         self->bitsToEndData = totalSize;
     }
     else {
@@ -3465,6 +3422,264 @@ static int unpack_double(grib_accessor* a, double* val, size_t* len)
     return GRIB_SUCCESS;
 }
 
+/* A data element that is a key, named as create_keys names it */
+typedef struct bufr_column_element
+{
+    const char* name;
+    long subset;
+    long index;                  /* -1 for the subsetNumber of an uncompressed subset */
+    bufr_descriptor* descriptor; /* NULL for the subsetNumber */
+} bufr_column_element;
+
+/* The elements that are keys, in the order of the list of data accessors. The operators are not, they have no value.
+ * Returns GRIB_NOT_IMPLEMENTED when the quality information is in the structure: its elements are named after the
+ * elements of its bitmap */
+static int get_column_elements(grib_accessor_bufr_data_array* self, bufr_column_element** result, size_t* count)
+{
+    grib_context* c = ((grib_accessor*)self)->context;
+    long iss, ide, end, elementsInSubset;
+    size_t n = 0, size = 0;
+    bufr_column_element* elements = NULL;
+    grib_action creator           = {0,};
+
+    end = self->compressedData ? 1 : self->numberOfSubsets;
+    for (iss = 0; iss < end; iss++)
+        size += grib_iarray_used_size(self->elementsDescriptorsIndex->v[iss]) + 1;
+    elements = (bufr_column_element*)grib_context_malloc(c, (size ? size : 1) * sizeof(bufr_column_element));
+    if (!elements)
+        return GRIB_OUT_OF_MEMORY;
+
+    for (iss = 0; iss < end; iss++) {
+        const grib_iarray* edi = self->elementsDescriptorsIndex->v[iss];
+        int qualityPresent     = 0;
+        elementsInSubset       = grib_iarray_used_size(self->elementsDescriptorsIndex->v[iss]);
+        for (ide = 0; ide < elementsInSubset; ide++) {
+            bufr_descriptor* descriptor = self->expanded->v[edi->v[ide]];
+            const char* name            = NULL;
+            if (descriptor->nokey == 1)
+                continue;
+            if (descriptor->code == 222000 || descriptor->code == 223000 || descriptor->code == 224000 || descriptor->code == 225000) {
+                qualityPresent = 1;
+            }
+            else if ((descriptor->X == 33 || bufr_descriptor_is_marker(descriptor)) && qualityPresent &&
+                     self->unpackMode == CODES_BUFR_UNPACK_STRUCTURE) {
+                grib_context_free(c, elements);
+                return GRIB_NOT_IMPLEMENTED;
+            }
+            if (ide == 0 && !self->compressedData) {
+                elements[n].name       = "subsetNumber";
+                elements[n].subset     = iss;
+                elements[n].index      = -1;
+                elements[n].descriptor = NULL;
+                n++;
+            }
+            switch (descriptor->F) {
+                case 0:
+                case 1:
+                    if (descriptor->code != 31021 && (descriptor->code != 33007 || !qualityPresent))
+                        name = descriptor->shortName;
+                    break;
+                case 2:
+                    if (bufr_descriptor_is_marker(descriptor)) {
+                        set_creator_name(&creator, descriptor->code);
+                        name = creator.name;
+                    }
+                    break;
+            }
+            if (name) {
+                elements[n].name       = name;
+                elements[n].subset     = iss;
+                elements[n].index      = ide;
+                elements[n].descriptor = descriptor;
+                n++;
+            }
+        }
+    }
+    *result = elements;
+    *count  = n;
+    return GRIB_SUCCESS;
+}
+
+/* The values of the element, as its accessor unpacks them */
+static size_t get_column_values(const grib_accessor_bufr_data_array* self, const bufr_column_element* e,
+                                const double** values, double* subsetNumber)
+{
+    const grib_darray* dval = NULL;
+    if (e->index < 0) {
+        *subsetNumber = e->subset + 1;
+        *values       = subsetNumber;
+        return 1;
+    }
+    if (!self->compressedData) {
+        *values = &self->numericValues->v[e->subset]->v[e->index];
+        return 1;
+    }
+    dval    = self->numericValues->v[e->index];
+    *values = dval->v;
+    return grib_darray_used_size((grib_darray*)dval) == 1 ? 1 : self->numberOfSubsets;
+}
+
+/* As for the accessors in grib_query.cc: an array is equal to the value only if it is constant and the
+ * multi-element constant arrays are on */
+static int column_condition_true(const grib_accessor_bufr_data_array* self, const bufr_column_element* e,
+                                 const codes_condition* condition)
+{
+    const double* values = NULL;
+    double subsetNumber  = 0;
+    size_t i = 0, n = get_column_values(self, e, &values, &subsetNumber);
+
+    if (n > 1 && !((grib_accessor*)self)->context->bufr_multi_element_constant_arrays)
+        return 0;
+    switch (condition->rightType) {
+        case GRIB_TYPE_LONG:
+            for (i = 0; i < n; i++) {
+                const long lval = values[i] == GRIB_MISSING_DOUBLE ? GRIB_MISSING_LONG : (long)values[i];
+                if (lval != condition->rightLong)
+                    return 0;
+            }
+            return 1;
+        case GRIB_TYPE_DOUBLE:
+            for (i = 0; i < n; i++) {
+                if (values[i] != condition->rightDouble)
+                    return 0;
+            }
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+/* Append the values of the elements [first,last] named 'name' to the column, if not NULL. Returns their number */
+static size_t select_column_values(const grib_accessor_bufr_data_array* self, const bufr_column_element* elements,
+                                   size_t first, size_t last, const char* name, int rank, double* column, int* err)
+{
+    size_t i = 0, size = 0;
+    int r = 0;
+
+    for (i = first; i <= last; i++) {
+        const bufr_column_element* e = &elements[i];
+        const double* values = NULL;
+        double subsetNumber  = 0;
+        size_t n             = 0;
+
+        if (strcmp(e->name, name) != 0)
+            continue;
+        r++;
+        if (rank >= 0 && r != rank)
+            continue;
+        if (e->descriptor && e->descriptor->type == BUFR_DESCRIPTOR_TYPE_STRING) {
+            *err = GRIB_INVALID_TYPE;
+            return 0;
+        }
+        n = get_column_values(self, e, &values, &subsetNumber);
+        if (column)
+            memcpy(column + size, values, n * sizeof(double));
+        size += n;
+        if (r == rank)
+            break;
+    }
+    return size;
+}
+
+/* The values of the elements named 'name' in the regions of the list where the condition is true, as
+ * search_accessors_list_by_condition finds them */
+static size_t select_column_values_by_condition(const grib_accessor_bufr_data_array* self, const bufr_column_element* elements,
+                                                size_t count, const char* name, const codes_condition* condition,
+                                                double* column, int* err)
+{
+    size_t i = 0, start = 0, size = 0;
+    int in_region = 0, end = 0;
+
+    for (i = 0; i < count && !*err; i++) {
+        end = 0;
+        if (!strcmp(elements[i].name, condition->left)) {
+            const int is_true = column_condition_true(self, &elements[i], condition);
+            if (!in_region && is_true) {
+                in_region = 1;
+                start     = i;
+            }
+            else if (in_region && !is_true) {
+                end = 1;
+            }
+        }
+        if (in_region && (end || i == count - 1)) {
+            size += select_column_values(self, elements, start, i, name, -1, column ? column + size : NULL, err);
+            in_region = 0;
+        }
+    }
+    return size;
+}
+
+static size_t select_column(const grib_accessor_bufr_data_array* self, const bufr_column_element* elements, size_t count,
+                            const char* name, int rank, const codes_condition* condition, double* column, int* err)
+{
+    if (count == 0)
+        return 0;
+    if (condition->left)
+        return select_column_values_by_condition(self, elements, count, name, condition, column, err);
+    return select_column_values(self, elements, 0, count - 1, name, rank, column, err);
+}
+
+/* The values of the keys, one array per key, read from the decoded data without creating the accessors of its
+ * elements. A key is a name of element, with a rank or a condition as for grib_find_accessors_list.
+ * The arrays are allocated here, to be freed by the caller. */
+int accessor_bufr_data_array_extract_columns(grib_accessor* a, const char** keys, size_t num_keys, double** columns, size_t* sizes)
+{
+    grib_accessor_bufr_data_array* self = (grib_accessor_bufr_data_array*)a;
+    grib_context* c                     = a->context;
+    bufr_column_element* elements       = NULL;
+    size_t count = 0, k = 0;
+    int err = 0;
+
+    for (k = 0; k < num_keys; k++) {
+        columns[k] = NULL;
+        sizes[k]   = 0;
+    }
+    err = process_elements(a, PROCESS_DECODE_VALUES, 0, 0, 0);
+    if (err)
+        return err;
+    err = get_column_elements(self, &elements, &count);
+    if (err)
+        return err;
+
+    for (k = 0; k < num_keys && !err; k++) {
+        codes_condition condition = {0,};
+        const char* name          = keys[k];
+        char* str                 = NULL;
+        int rank                  = -1;
+        size_t size               = 0;
+
+        if (name[0] == '/')
+            name = str = grib_split_name_condition(keys[k], &condition);
+        else if (name[0] == '#')
+            name = str = grib_split_name_rank(c, keys[k], &rank);
+
+        if (name)
+            size = select_column(self, elements, count, name, rank, &condition, NULL, &err);
+        if (!err && size == 0)
+            err = GRIB_NOT_FOUND;
+        if (!err) {
+            columns[k] = (double*)malloc(size * sizeof(double));
+            if (!columns[k])
+                err = GRIB_OUT_OF_MEMORY;
+            else
+                sizes[k] = select_column(self, elements, count, name, rank, &condition, columns[k], &err);
+        }
+        grib_context_free(c, str);
+        grib_context_free(c, condition.left);
+    }
+    grib_context_free(c, elements);
+
+    if (err) {
+        for (k = 0; k < num_keys; k++) {
+            free(columns[k]);
+            columns[k] = NULL;
+            sizes[k]   = 0;
+        }
+    }
+    return err;
+}
+
 static void destroy(grib_context* c, grib_accessor* a)
 {
     grib_accessor_bufr_data_array* self = (grib_accessor_bufr_data_array*)a;
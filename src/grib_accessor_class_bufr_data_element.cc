@@ -35,6 +35,9 @@
    MEMBERS    = grib_vsarray* stringValues
    MEMBERS    = grib_viarray* elementsDescriptorsIndex
    MEMBERS    = char* cname
+   MEMBERS    = long count
+   MEMBERS    = int extraAttributes
+   MEMBERS    = grib_section* attributesSection
 
    END_CLASS_DEF
 
@@ -83,6 +86,9 @@ typedef struct grib_accessor_bufr_data_element
     grib_vsarray* stringValues;
     grib_viarray* elementsDescriptorsIndex;
     char* cname;
+    long count;
+    int extraAttributes;
+    grib_section* attributesSection;
 } grib_accessor_bufr_data_element;
 
 extern grib_accessor_class* grib_accessor_class_gen;
@@ -133,6 +139,7 @@ static grib_accessor_class _grib_accessor_class_bufr_data_element = {
     0,     /* unpack a subarray */
     0,                      /* clear */
     &make_clone,                 /* clone accessor */
+    0,                           /* reset */
 };
 
 
@@ -163,7 +170,7 @@ static grib_accessor* make_clone(grib_accessor* a, grib_section* s, int* err)
     the_clone->name                           = copied_name;
     elementAccessor                           = (grib_accessor_bufr_data_element*)the_clone;
     self                                      = (grib_accessor_bufr_data_element*)a;
-    the_clone->flags                          = a->flags;
+    the_clone->flags                          = a->flags & ~GRIB_ACCESSOR_FLAG_LAZY_ATTRIBUTES;
     the_clone->parent                         = NULL;
     the_clone->h                              = s->h;
     elementAccessor->index                    = self->index;
@@ -176,6 +183,9 @@ static grib_accessor* make_clone(grib_accessor* a, grib_section* s, int* err)
     elementAccessor->stringValues             = self->stringValues;
     elementAccessor->elementsDescriptorsIndex = self->elementsDescriptorsIndex;
     elementAccessor->cname                    = copied_name; /* ECC-765 */
+    elementAccessor->count                    = self->count;
+    elementAccessor->extraAttributes          = self->extraAttributes;
+    elementAccessor->attributesSection        = s;
 
     i = 0;
     while (a->attributes[i]) {
@@ -184,10 +194,155 @@ static grib_accessor* make_clone(grib_accessor* a, grib_section* s, int* err)
         grib_accessor_add_attribute(the_clone, attribute, 0);
         i++;
     }
+    /* The clone creates the attributes not yet created by the original after those it copied */
+    the_clone->flags |= a->flags & GRIB_ACCESSOR_FLAG_LAZY_ATTRIBUTES;
 
     return the_clone;
 }
 
+grib_accessor* accessor_bufr_data_element_new_attribute(const char* name, grib_section* section, int type,
+                                                        char* sval, double dval, long lval, unsigned long flags)
+{
+    grib_accessor* a    = NULL;
+    grib_action creator = {0,};
+    size_t len;
+    creator.op         = (char*)"variable";
+    creator.name_space = (char*)"";
+    creator.flags      = GRIB_ACCESSOR_FLAG_READ_ONLY | flags;
+    creator.set        = 0;
+
+    creator.name = (char*)name;
+    a            = grib_accessor_factory(section, &creator, 0, NULL);
+    a->parent    = NULL;
+    a->h         = section->h;
+    accessor_variable_set_type(a, type);
+    len = 1;
+    switch (type) {
+        case GRIB_TYPE_LONG:
+            grib_pack_long(a, &lval, &len);
+            break;
+        case GRIB_TYPE_DOUBLE:
+            grib_pack_double(a, &dval, &len);
+            break;
+        case GRIB_TYPE_STRING:
+            if (!sval)
+                return NULL;
+            /* Performance: No need for len=strlen(sval). It's not used. */
+            /* See grib_accessor_class_variable.c, pack_string() */
+            len = 0;
+            grib_pack_string(a, sval, &len);
+            break;
+    }
+
+    return a;
+}
+
+/* Defer the creation of the index, code, units, scale, reference and width attributes of an
+ * element until one of its attributes is looked for: most are never queried */
+void accessor_bufr_data_element_set_lazy_attributes(grib_accessor* a, long count, int extraAttributes, grib_section* section)
+{
+    grib_accessor_bufr_data_element* self = (grib_accessor_bufr_data_element*)a;
+    self->count                           = count;
+    self->extraAttributes                 = extraAttributes;
+    self->attributesSection               = section;
+    a->flags |= GRIB_ACCESSOR_FLAG_LAZY_ATTRIBUTES;
+}
+
+static bufr_descriptor* element_descriptor(grib_accessor_bufr_data_element* self)
+{
+    const int idx = self->compressedData ? self->elementsDescriptorsIndex->v[0]->v[self->index]
+                                         : self->elementsDescriptorsIndex->v[self->subsetNumber]->v[self->index];
+    return self->descriptors->v[idx];
+}
+
+/* The value of the code attribute, which markers do not have */
+int accessor_bufr_data_element_get_code(grib_accessor* a, long* code)
+{
+    const bufr_descriptor* descriptor = element_descriptor((grib_accessor_bufr_data_element*)a);
+    if (descriptor->F == 2)
+        return GRIB_NOT_FOUND;
+    *code = descriptor->code;
+    return GRIB_SUCCESS;
+}
+
+static int create_attributes(grib_accessor* a)
+{
+    grib_accessor_bufr_data_element* self = (grib_accessor_bufr_data_element*)a;
+    bufr_descriptor* descriptor           = element_descriptor(self);
+    const unsigned long flags             = GRIB_ACCESSOR_FLAG_READ_ONLY;
+    grib_section* section                 = self->attributesSection;
+    grib_accessor* attribute              = NULL;
+    char code[10]                         = {0,};
+    int i = 0, idx = 0, err = 0;
+
+    a->flags &= ~GRIB_ACCESSOR_FLAG_LAZY_ATTRIBUTES;
+
+    attribute = accessor_bufr_data_element_new_attribute("index", section, GRIB_TYPE_LONG, 0, 0, self->count, flags);
+    if (!attribute)
+        return GRIB_INTERNAL_ERROR;
+    if ((err = grib_accessor_add_attribute(a, attribute, 0)) != GRIB_SUCCESS)
+        return err;
+
+    if (descriptor->F != 2) {
+        snprintf(code, sizeof(code), "%06ld", descriptor->code);
+        attribute = accessor_bufr_data_element_new_attribute("code", section, GRIB_TYPE_STRING, code, 0, 0, flags);
+        if (!attribute)
+            return GRIB_INTERNAL_ERROR;
+        if ((err = grib_accessor_add_attribute(a, attribute, 0)) != GRIB_SUCCESS)
+            return err;
+
+        if (self->extraAttributes) {
+            grib_accessor* extra[4];
+            extra[0] = accessor_bufr_data_element_new_attribute("units", section, GRIB_TYPE_STRING, descriptor->units, 0, 0, GRIB_ACCESSOR_FLAG_DUMP | flags);
+            extra[1] = accessor_bufr_data_element_new_attribute("scale", section, GRIB_TYPE_LONG, 0, 0, descriptor->scale, flags);
+            extra[2] = accessor_bufr_data_element_new_attribute("reference", section, GRIB_TYPE_DOUBLE, 0, descriptor->reference, 0, flags);
+            extra[3] = accessor_bufr_data_element_new_attribute("width", section, GRIB_TYPE_LONG, 0, 0, descriptor->width, flags);
+            for (i = 0; i < 4; i++) {
+                if (!extra[i])
+                    return GRIB_INTERNAL_ERROR;
+                if ((err = grib_accessor_add_attribute(a, extra[i], 0)) != GRIB_SUCCESS)
+                    return err;
+            }
+        }
+    }
+
+    /* The attributes added before, like those of an associated field, are linked as when the element was pushed */
+    if (a->same) {
+        for (i = 0; i < MAX_ACCESSOR_ATTRIBUTES && a->attributes[i]; i++) {
+            attribute = ecc__grib_accessor_get_attribute(a->same, a->attributes[i]->name, &idx);
+            if (attribute)
+                a->attributes[i]->same = attribute;
+        }
+    }
+    return GRIB_SUCCESS;
+}
+
+int accessor_bufr_data_element_add_attributes(grib_accessor* a)
+{
+    grib_accessor** older = NULL;
+    grib_accessor* p      = NULL;
+    size_t n = 0, i = 0;
+    int err = 0;
+
+    /* The attributes of the element are linked to those of the previous ones of the same name,
+     * which are created first, the oldest first */
+    for (p = a->same; p && (p->flags & GRIB_ACCESSOR_FLAG_LAZY_ATTRIBUTES); p = p->same)
+        n++;
+    if (n > 0) {
+        older = (grib_accessor**)grib_context_malloc(a->context, n * sizeof(grib_accessor*));
+        if (!older)
+            return GRIB_OUT_OF_MEMORY;
+        for (p = a->same, i = 0; i < n; p = p->same, i++)
+            older[i] = p;
+        for (i = n; i > 0 && !err; i--)
+            err = create_attributes(older[i - 1]);
+        grib_context_free(a->context, older);
+        if (err)
+            return err;
+    }
+    return create_attributes(a);
+}
+
 void accessor_bufr_data_element_set_index(grib_accessor* a, long index)
 {
     grib_accessor_bufr_data_element* self = (grib_accessor_bufr_data_element*)a;
@@ -110,6 +110,7 @@ static grib_accessor_class _grib_accessor_class_bufr_extract_area_subsets = {
     0,     /* unpack a subarray */
     0,                      /* clear */
     0,                 /* clone accessor */
+    0,                 /* reset */
 };
 
 
@@ -51,6 +51,7 @@ static void thread_init()
    SUPER      = grib_accessor_class_unsigned
    IMPLEMENTS = init;dump;unpack_string;pack_expression;unpack_long
    IMPLEMENTS = value_count;pack_string; destroy; get_native_type;
+   IMPLEMENTS = reset
    MEMBERS    =  const char* tablename
    MEMBERS    =  const char* masterDir
    MEMBERS    =  const char* localDir
@@ -79,6 +80,7 @@ static int value_count(grib_accessor*, long*);
 static void destroy(grib_context*, grib_accessor*);
 static void dump(grib_accessor*, grib_dumper*);
 static void init(grib_accessor*, const long, grib_arguments*);
+static void reset(grib_accessor*);
 
 typedef struct grib_accessor_codetable
 {
@@ -144,6 +146,7 @@ static grib_accessor_class _grib_accessor_class_codetable = {
     0,     /* unpack a subarray */
     0,                      /* clear */
     0,                 /* clone accessor */
+    &reset,            /* reset */
 };
 
 
@@ -234,6 +237,14 @@ static void init(grib_accessor* a, const long len, grib_arguments* params)
     }
 }
 
+/* The table depends on the values of the message */
+static void reset(grib_accessor* a)
+{
+    grib_accessor_codetable* self = (grib_accessor_codetable*)a;
+    self->table                   = NULL;
+    self->table_loaded            = 0;
+}
+
 /* Note: A fast cut-down version of strcmp which does NOT return -1 */
 /* 0 means input strings are equal and 1 means not equal */
 GRIB_INLINE static int grib_inline_strcmp(const char* a, const char* b)
@@ -268,6 +279,28 @@ static void dump_codetable(grib_codetable* atable)
     }
 }
 #endif
+
+/* The table of the cache for filename and localFilename */
+static grib_codetable* find_table(grib_codetable* next, const char* filename, const char* localFilename)
+{
+    while (next) {
+        if ((filename && next->filename[0] && grib_inline_strcmp(filename, next->filename[0]) == 0) &&
+            ((localFilename == 0 && next->filename[1] == NULL) ||
+             ((localFilename != 0 && next->filename[1] != NULL) && grib_inline_strcmp(localFilename, next->filename[1]) == 0))) {
+            return next;
+        }
+        /* Special case: see GRIB-735 */
+        if (filename == NULL && localFilename != NULL) {
+            if (str_eq(localFilename, next->filename[0]) ||
+                str_eq(localFilename, next->filename[1])) {
+                return next;
+            }
+        }
+        next = next->next;
+    }
+    return NULL;
+}
+
 static grib_codetable* load_table(grib_accessor* a)
 {
     grib_accessor_codetable* self = (grib_accessor_codetable*)a;
@@ -275,7 +308,6 @@ static grib_codetable* load_table(grib_accessor* a)
     grib_handle* h        = ((grib_accessor*)self)->parent->h;
     grib_context* c       = h->context;
     grib_codetable* t     = NULL;
-    grib_codetable* next  = NULL;
     char* filename        = 0;
     char recomposed[1024] = {0,};
     char localRecomposed[1024] = {0,};
@@ -309,32 +341,22 @@ static grib_codetable* load_table(grib_accessor* a)
         localFilename = grib_context_full_defs_path(c, localRecomposed);
     }
 
+    /*printf("DBG %s: Look in cache: f=%s lf=%s (recomposed=%s)\n", self->att.name, filename, localFilename,recomposed);*/
+    if (filename == NULL && localFilename == NULL)
+        return NULL;
+
+    /* The tables are added to the cache once loaded and never changed, so it is searched
+     * without the lock. Only loading a table takes it
+     */
+    if ((t = find_table(GRIB_ATOMIC_LOAD(c->codetable), filename, localFilename)) != NULL)
+        return t;
+
     GRIB_MUTEX_INIT_ONCE(&once, &thread_init);
     GRIB_MUTEX_LOCK(&mutex1); /* GRIB-930 */
 
-    /*printf("DBG %s: Look in cache: f=%s lf=%s (recomposed=%s)\n", self->att.name, filename, localFilename,recomposed);*/
-    if (filename == NULL && localFilename == NULL) {
-        t = NULL;
+    /* Loaded by another thread meanwhile */
+    if ((t = find_table(c->codetable, filename, localFilename)) != NULL)
         goto the_end;
-    }
-    next = c->codetable;
-    while (next) {
-        if ((filename && next->filename[0] && grib_inline_strcmp(filename, next->filename[0]) == 0) &&
-            ((localFilename == 0 && next->filename[1] == NULL) ||
-             ((localFilename != 0 && next->filename[1] != NULL) && grib_inline_strcmp(localFilename, next->filename[1]) == 0))) {
-            t = next;
-            goto the_end;
-        }
-        /* Special case: see GRIB-735 */
-        if (filename == NULL && localFilename != NULL) {
-            if (str_eq(localFilename, next->filename[0]) ||
-                str_eq(localFilename, next->filename[1])) {
-                t = next;
-                goto the_end;
-            }
-        }
-        next = next->next;
-    }
 
     if (a->flags & GRIB_ACCESSOR_FLAG_TRANSIENT) {
         Assert(a->vvalue != NULL);
@@ -362,6 +384,8 @@ static grib_codetable* load_table(grib_accessor* a)
         t = NULL;
         goto the_end;
     }
+    t->next = c->codetable;
+    GRIB_ATOMIC_STORE(c->codetable, t);
 
 the_end:
     GRIB_MUTEX_UNLOCK(&mutex1);
@@ -386,9 +410,7 @@ static int grib_load_codetable(grib_context* c, const char* filename,
     if (t->filename[0] == NULL) {
         t->filename[0]        = grib_context_strdup_persistent(c, filename);
         t->recomposed_name[0] = grib_context_strdup_persistent(c, recomposed_name);
-        t->next               = c->codetable;
         t->size               = size;
-        c->codetable          = t;
     }
     else {
         t->filename[1]        = grib_context_strdup_persistent(c, filename);
@@ -92,6 +92,7 @@ static grib_accessor_class _grib_accessor_class_codetable_units = {
     0,     /* unpack a subarray */
     0,                      /* clear */
     0,                 /* clone accessor */
+    0,                 /* reset */
 };
 
 
@@ -109,6 +109,7 @@ static grib_accessor_class _grib_accessor_class_concept = {
     0,     /* unpack a subarray */
     0,                      /* clear */
     0,                 /* clone accessor */
+    0,                 /* reset */
 };
 
 
@@ -229,30 +230,55 @@ static int concept_condition_true(grib_handle* h, grib_concept_condition* c)
         return concept_condition_expression_true(h, c);
 }
 
+/* Number of conditions of the entry when they are all true, -1 otherwise */
+static int concept_value_conditions_true(grib_handle* h, grib_concept_value* c)
+{
+    grib_concept_condition* e = c->conditions;
+    int cnt                   = 0;
+    while (e) {
+        if (!concept_condition_true(h, e))
+            return -1;
+        e = e->next;
+        cnt++;
+    }
+    return cnt;
+}
+
+/* Entries of a concept worth evaluating when it is indexed. More are all evaluated */
+#define MAX_CONCEPT_CANDIDATES 256
+
 static const char* concept_evaluate(grib_accessor* a)
 {
     int match        = 0;
+    int cnt          = 0;
     const char* best = 0;
     /* const char* prev = 0; */
     grib_concept_value* c = action_concept_get_concept(a);
     grib_handle* h        = grib_handle_of_accessor(a);
 
-    while (c) {
-        grib_concept_condition* e = c->conditions;
-        int cnt                   = 0;
-        while (e) {
-            if (!concept_condition_true(h, e))
-                break;
-            e = e->next;
-            cnt++;
+    /* Only the entries which can match, in the same order */
+    if (c && c->conditions_index) {
+        const grib_concept_index* index = c->conditions_index;
+        size_t candidates[MAX_CONCEPT_CANDIDATES];
+        size_t count = 0, i = 0;
+        if (grib_concept_index_get_candidates(index, h, candidates, MAX_CONCEPT_CANDIDATES, &count) == GRIB_SUCCESS) {
+            for (i = 0; i < count; i++) {
+                cnt = concept_value_conditions_true(h, index->values[candidates[i]]);
+                if (cnt >= 0 && cnt >= match) {
+                    match = cnt;
+                    best  = index->values[candidates[i]]->name;
+                }
+            }
+            return best;
         }
+    }
 
-        if (e == NULL) {
-            if (cnt >= match) {
-                /* prev  = (cnt > match) ? NULL : best; */
-                match = cnt;
-                best  = c->name;
-            }
+    while (c) {
+        cnt = concept_value_conditions_true(h, c);
+        if (cnt >= 0 && cnt >= match) {
+            /* prev  = (cnt > match) ? NULL : best; */
+            match = cnt;
+            best  = c->name;
         }
 
         c = c->next;
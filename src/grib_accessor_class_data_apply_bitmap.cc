@@ -9,6 +9,7 @@
  */
 
 #include "grib_value.h"
+#include <cstdint>
 
 /*
    This is used by make_class.pl
@@ -23,12 +24,18 @@
    IMPLEMENTS = value_count
    IMPLEMENTS = dump;get_native_type
    IMPLEMENTS = compare
+   IMPLEMENTS = destroy;reset;notify_change
    MEMBERS=const char*  coded_values
    MEMBERS=const char*  bitmap
    MEMBERS=const char*  missing_value
    MEMBERS=const char*  number_of_data_points
    MEMBERS=const char*  number_of_values
    MEMBERS=const char*  binary_scale_factor
+   MEMBERS=grib_accessor* bitmap_accessor
+   MEMBERS=uint64_t* bitmap_words
+   MEMBERS=size_t* bitmap_ranks
+   MEMBERS=size_t bitmap_size
+   MEMBERS=size_t bitmap_count
    END_CLASS_DEF
  */
 
@@ -47,9 +54,12 @@ static int pack_double(grib_accessor*, const double* val, size_t* len);
 static int unpack_double(grib_accessor*, double* val, size_t* len);
 static int unpack_float(grib_accessor*, float* val, size_t* len);
 static int value_count(grib_accessor*, long*);
+static void destroy(grib_context*, grib_accessor*);
 static void dump(grib_accessor*, grib_dumper*);
 static void init(grib_accessor*, const long, grib_arguments*);
+static int notify_change(grib_accessor*, grib_accessor*);
 static int compare(grib_accessor*, grib_accessor*);
+static void reset(grib_accessor*);
 static int unpack_double_element(grib_accessor*, size_t i, double* val);
 static int unpack_double_element_set(grib_accessor*, const size_t* index_array, size_t len, double* val_array);
 
@@ -64,6 +74,11 @@ typedef struct grib_accessor_data_apply_bitmap
     const char*  number_of_data_points;
     const char*  number_of_values;
     const char*  binary_scale_factor;
+    grib_accessor* bitmap_accessor;
+    uint64_t* bitmap_words;
+    size_t* bitmap_ranks;
+    size_t bitmap_size;
+    size_t bitmap_count;
 } grib_accessor_data_apply_bitmap;
 
 extern grib_accessor_class* grib_accessor_class_gen;
@@ -76,7 +91,7 @@ static grib_accessor_class _grib_accessor_class_data_apply_bitmap = {
     0,                           /* init_class */
     &init,                       /* init */
     0,                  /* post_init */
-    0,                    /* destroy */
+    &destroy,                    /* destroy */
     &dump,                       /* dump */
     0,                /* next_offset */
     0,              /* get length of string */
@@ -100,7 +115,7 @@ static grib_accessor_class _grib_accessor_class_data_apply_bitmap = {
     0,                 /* pack_bytes */
     0,               /* unpack_bytes */
     0,            /* pack_expression */
-    0,              /* notify_change */
+    &notify_change,              /* notify_change */
     0,                /* update_size */
     0,             /* preferred_size */
     0,                     /* resize */
@@ -114,6 +129,7 @@ static grib_accessor_class _grib_accessor_class_data_apply_bitmap = {
     0,     /* unpack a subarray */
     0,                      /* clear */
     0,                 /* clone accessor */
+    &reset,                      /* reset */
 };
 
 
@@ -132,9 +148,147 @@ static void init(grib_accessor* a, const long v, grib_arguments* args)
     self->binary_scale_factor   = grib_arguments_get_name(grib_handle_of_accessor(a), args, n++);
     self->number_of_data_points = grib_arguments_get_name(grib_handle_of_accessor(a), args, n++);
     self->number_of_values      = grib_arguments_get_name(grib_handle_of_accessor(a), args, n++);
+    self->bitmap_accessor       = NULL;
+    self->bitmap_words          = NULL;
+    self->bitmap_ranks          = NULL;
+    self->bitmap_size           = 0;
+    self->bitmap_count          = 0;
 
     a->length = 0;
 }
+
+/* The number of values present is kept for each block of 8 words, i.e. 512 values, of the bitmap */
+#define BITMAP_RANK_BLOCK_WORDS 8
+
+static int popcount64(uint64_t x)
+{
+#if defined(__GNUC__)
+    return __builtin_popcountll(x);
+#else
+    x = x - ((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+    return (int)((x * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+static void clear_bitmap_ranks(grib_accessor* a)
+{
+    grib_accessor_data_apply_bitmap* self = (grib_accessor_data_apply_bitmap*)a;
+    grib_context_free(a->context, self->bitmap_words);
+    grib_context_free(a->context, self->bitmap_ranks);
+    self->bitmap_accessor = NULL;
+    self->bitmap_words    = NULL;
+    self->bitmap_ranks    = NULL;
+    self->bitmap_size     = 0;
+    self->bitmap_count    = 0;
+}
+
+/* The bitmap as words of 64 values, the first one in the most significant bit, and the number of values
+ * present before each block of words. Kept until the bitmap changes */
+static int get_bitmap_ranks(grib_accessor* a, grib_accessor* bitmap, size_t n_vals)
+{
+    grib_accessor_data_apply_bitmap* self = (grib_accessor_data_apply_bitmap*)a;
+    grib_handle* h  = grib_handle_of_accessor(a);
+    size_t nwords   = (n_vals + 63) / 64;
+    size_t i = 0, count = 0;
+    uint64_t* words = NULL;
+    size_t* ranks   = NULL;
+    int err         = 0;
+
+    if (self->bitmap_words && self->bitmap_accessor == bitmap && self->bitmap_size == n_vals)
+        return GRIB_SUCCESS;
+    clear_bitmap_ranks(a);
+
+    words = (uint64_t*)grib_context_malloc_clear(a->context, (nwords + 1) * sizeof(uint64_t));
+    ranks = (size_t*)grib_context_malloc(a->context, (nwords / BITMAP_RANK_BLOCK_WORDS + 1) * sizeof(size_t));
+    if (!words || !ranks) {
+        grib_context_free(a->context, words);
+        grib_context_free(a->context, ranks);
+        return GRIB_OUT_OF_MEMORY;
+    }
+
+    if ((size_t)bitmap->length * 8 >= n_vals) {
+        /* The bits of the message, as the bitmap accessor decodes them */
+        const unsigned char* p = h->buffer->data + bitmap->offset;
+        const size_t nbytes    = (n_vals + 7) / 8;
+        for (i = 0; i < nbytes; i++)
+            words[i / 8] |= (uint64_t)p[i] << (56 - 8 * (i % 8));
+        if (n_vals % 64)
+            words[nwords - 1] &= ~(uint64_t)0 << (64 - n_vals % 64);
+    }
+    else {
+        size_t len    = n_vals;
+        double* bvals = (double*)grib_context_malloc(a->context, (n_vals ? n_vals : 1) * sizeof(double));
+        if (!bvals)
+            err = GRIB_OUT_OF_MEMORY;
+        else
+            err = grib_get_double_array_internal(h, self->bitmap, bvals, &len);
+        for (i = 0; !err && i < len && i < n_vals; i++) {
+            if (bvals[i] != 0)
+                words[i / 64] |= (uint64_t)1 << (63 - i % 64);
+        }
+        grib_context_free(a->context, bvals);
+        if (err) {
+            grib_context_free(a->context, words);
+            grib_context_free(a->context, ranks);
+            return err;
+        }
+    }
+
+    for (i = 0; i < nwords; i++) {
+        if (i % BITMAP_RANK_BLOCK_WORDS == 0)
+            ranks[i / BITMAP_RANK_BLOCK_WORDS] = count;
+        count += popcount64(words[i]);
+    }
+    if (nwords % BITMAP_RANK_BLOCK_WORDS == 0)
+        ranks[nwords / BITMAP_RANK_BLOCK_WORDS] = count;
+
+    self->bitmap_accessor = bitmap;
+    self->bitmap_words    = words;
+    self->bitmap_ranks    = ranks;
+    self->bitmap_size     = n_vals;
+    self->bitmap_count    = count;
+
+    /* Told when the bitmap is set */
+    grib_dependency_add(a, bitmap);
+    return GRIB_SUCCESS;
+}
+
+static int bitmap_is_present(const grib_accessor_data_apply_bitmap* self, size_t i)
+{
+    return (self->bitmap_words[i / 64] >> (63 - i % 64)) & 1;
+}
+
+/* The number of values present before the i-th one, i.e. its index in the coded values */
+static size_t bitmap_rank(const grib_accessor_data_apply_bitmap* self, size_t i)
+{
+    const size_t w = i / 64;
+    size_t j = 0, rank = self->bitmap_ranks[w / BITMAP_RANK_BLOCK_WORDS];
+
+    for (j = w - w % BITMAP_RANK_BLOCK_WORDS; j < w; j++)
+        rank += popcount64(self->bitmap_words[j]);
+    if (i % 64)
+        rank += popcount64(self->bitmap_words[w] >> (64 - i % 64));
+    return rank;
+}
+
+static void destroy(grib_context* c, grib_accessor* a)
+{
+    clear_bitmap_ranks(a);
+}
+
+static void reset(grib_accessor* a)
+{
+    clear_bitmap_ranks(a);
+}
+
+static int notify_change(grib_accessor* a, grib_accessor* changed)
+{
+    clear_bitmap_ranks(a);
+    return GRIB_SUCCESS;
+}
+
 static void dump(grib_accessor* a, grib_dumper* dumper)
 {
     grib_dump_values(dumper, a);
@@ -159,11 +313,10 @@ static int value_count(grib_accessor* a, long* count)
 static int unpack_double_element(grib_accessor* a, size_t idx, double* val)
 {
     grib_accessor_data_apply_bitmap* self = (grib_accessor_data_apply_bitmap*)a;
-    grib_handle* gh      = grib_handle_of_accessor(a);
-    int err = 0, i = 0;
-    size_t cidx          = 0;
+    grib_handle* gh       = grib_handle_of_accessor(a);
+    grib_accessor* bitmap = NULL;
+    int err = 0;
     double missing_value = 0;
-    double* bvals        = NULL;
     size_t n_vals        = 0;
     long nn              = 0;
 
@@ -172,115 +325,91 @@ static int unpack_double_element(grib_accessor* a, size_t idx, double* val)
     if (err)
         return err;
 
-    if (!grib_find_accessor(gh, self->bitmap))
+    bitmap = grib_find_accessor(gh, self->bitmap);
+    if (!bitmap)
         return grib_get_double_element_internal(gh, self->coded_values, idx, val);
 
+    if (idx >= n_vals)
+        return GRIB_INVALID_ARGUMENT;
+
     if ((err = grib_get_double_internal(gh, self->missing_value, &missing_value)) != GRIB_SUCCESS)
         return err;
 
-    if ((err = grib_get_double_element_internal(gh, self->bitmap, idx, val)) != GRIB_SUCCESS)
+    if ((err = get_bitmap_ranks(a, bitmap, n_vals)) != GRIB_SUCCESS)
         return err;
 
-    if (*val == 0) {
+    if (!bitmap_is_present(self, idx)) {
         *val = missing_value;
         return GRIB_SUCCESS;
     }
 
-    bvals = (double*)grib_context_malloc(a->context, n_vals * sizeof(double));
-    if (bvals == NULL)
-        return GRIB_OUT_OF_MEMORY;
-
-    if ((err = grib_get_double_array_internal(gh, self->bitmap, bvals, &n_vals)) != GRIB_SUCCESS)
-        return err;
-
-    cidx = 0;
-    for (i = 0; i < idx; i++) {
-        cidx += bvals[i];
-    }
-
-    grib_context_free(a->context, bvals);
-
-    return grib_get_double_element_internal(gh, self->coded_values, cidx, val);
+    return grib_get_double_element_internal(gh, self->coded_values, bitmap_rank(self, idx), val);
 }
 
 static int unpack_double_element_set(grib_accessor* a, const size_t* index_array, size_t len, double* val_array)
 {
     grib_accessor_data_apply_bitmap* self = (grib_accessor_data_apply_bitmap*)a;
-    grib_handle* gh = grib_handle_of_accessor(a);
-    int err = 0, all_missing = 1;
-    size_t cidx        = 0; /* index into the coded_values array */
+    grib_handle* gh       = grib_handle_of_accessor(a);
+    grib_accessor* bitmap = NULL;
+    int err = 0;
     size_t* cidx_array = NULL; /* array of indexes into the coded_values */
     double* cval_array = NULL; /* array of values of the coded_values */
     double missing_value = 0;
-    double* bvals        = NULL;
-    size_t n_vals = 0, i = 0, j = 0, idx = 0, count_1s = 0, ci = 0;
+    size_t n_vals = 0, i = 0, count_1s = 0, ci = 0;
     long nn = 0;
 
     err    = grib_value_count(a, &nn);
     n_vals = nn;
     if (err) return err;
 
-    if (!grib_find_accessor(gh, self->bitmap))
+    bitmap = grib_find_accessor(gh, self->bitmap);
+    if (!bitmap)
         return grib_get_double_element_set_internal(gh, self->coded_values, index_array, len, val_array);
 
     if ((err = grib_get_double_internal(gh, self->missing_value, &missing_value)) != GRIB_SUCCESS)
         return err;
 
-    err = grib_get_double_element_set_internal(gh, self->bitmap, index_array, len, val_array);
-    if (err) return err;
+    if ((err = get_bitmap_ranks(a, bitmap, n_vals)) != GRIB_SUCCESS)
+        return err;
+
     for (i = 0; i < len; i++) {
-        if (val_array[i] == 0) {
-            val_array[i] = missing_value;
-        } else {
-            all_missing = 0;
+        if (index_array[i] >= n_vals)
+            return GRIB_INVALID_ARGUMENT;
+        if (bitmap_is_present(self, index_array[i]))
             count_1s++;
-        }
     }
 
-    if (all_missing) {
+    if (count_1s == 0) {
+        for (i = 0; i < len; i++)
+            val_array[i] = missing_value;
         return GRIB_SUCCESS;
     }
 
-    /* At this point val_array contains entries which are either missing_value or 1 */
-    /* Now we need to dig into the codes values with index array of count_1s */
-
-    bvals = (double*)grib_context_malloc(a->context, n_vals * sizeof(double));
-    if (!bvals) return GRIB_OUT_OF_MEMORY;
-
-    if ((err = grib_get_double_array_internal(gh, self->bitmap, bvals, &n_vals)) != GRIB_SUCCESS)
-        return err;
-
+    /* The values present are in the coded values, at the rank of their index in the bitmap */
     cidx_array = (size_t*)grib_context_malloc(a->context, count_1s * sizeof(size_t));
     cval_array = (double*)grib_context_malloc(a->context, count_1s * sizeof(double));
+    if (!cidx_array || !cval_array) {
+        grib_context_free(a->context, cidx_array);
+        grib_context_free(a->context, cval_array);
+        return GRIB_OUT_OF_MEMORY;
+    }
 
     ci = 0;
     for (i = 0; i < len; i++) {
-        if (val_array[i] == 1) {
-            idx = index_array[i];
-            cidx = 0;
-            for (j = 0; j < idx; j++) {
-                cidx += bvals[j];
-            }
-            Assert(ci < count_1s);
-            cidx_array[ci++] = cidx;
-        }
+        if (bitmap_is_present(self, index_array[i]))
+            cidx_array[ci++] = bitmap_rank(self, index_array[i]);
     }
     err = grib_get_double_element_set_internal(gh, self->coded_values, cidx_array, count_1s, cval_array);
-    if (err) return err;
-
-    /* Transfer from cval_array to our result val_array */
-    ci = 0;
-    for (i = 0; i < len; i++) {
-        if (val_array[i] == 1) {
-            val_array[i] = cval_array[ci++];
-        }
+    if (!err) {
+        ci = 0;
+        for (i = 0; i < len; i++)
+            val_array[i] = bitmap_is_present(self, index_array[i]) ? cval_array[ci++] : missing_value;
     }
 
-    grib_context_free(a->context, bvals);
     grib_context_free(a->context, cidx_array);
     grib_context_free(a->context, cval_array);
 
-    return GRIB_SUCCESS;
+    return err;
 }
 
 static int pack_double(grib_accessor* a, const double* val, size_t* len)
@@ -299,6 +428,7 @@ static int pack_double(grib_accessor* a, const double* val, size_t* len)
     if (*len == 0)
         return GRIB_NO_VALUES;
 
+    clear_bitmap_ranks(a);
     if (!grib_find_accessor(hand, self->bitmap)) {
         /*printf("SETTING TOTAL number_of_data_points %s %ld\n",self->number_of_data_points,*len);*/
         if (self->number_of_data_points)
@@ -357,13 +487,15 @@ static int unpack(grib_accessor* a, T* val, size_t* len)
     size_t coded_n_vals  = 0;
     T* coded_vals   = NULL;
     double missing_value = 0;
+    grib_accessor* bitmap = NULL;
 
     err    = grib_value_count(a, &nn);
     n_vals = nn;
     if (err)
         return err;
 
-    if (!grib_find_accessor(grib_handle_of_accessor(a), self->bitmap))
+    bitmap = grib_find_accessor(grib_handle_of_accessor(a), self->bitmap);
+    if (!bitmap)
         return grib_get_array<T>(grib_handle_of_accessor(a), self->coded_values, val, len);
 
     if ((err = grib_get_size(grib_handle_of_accessor(a), self->coded_values, &coded_n_vals)) != GRIB_SUCCESS)
@@ -385,9 +517,17 @@ static int unpack(grib_accessor* a, T* val, size_t* len)
         return GRIB_SUCCESS;
     }
 
-    if ((err = grib_get_array_internal<T>(grib_handle_of_accessor(a), self->bitmap, val, &n_vals)) != GRIB_SUCCESS)
+    if ((err = get_bitmap_ranks(a, bitmap, n_vals)) != GRIB_SUCCESS)
         return err;
 
+    if (self->bitmap_count > coded_n_vals) {
+        grib_context_log(a->context, GRIB_LOG_ERROR,
+                         "grib_accessor_class_data_apply_bitmap [%s]:"
+                         " %s :  number of coded values does not match bitmap %ld %ld",
+                         a->name, __func__, coded_n_vals, n_vals);
+        return GRIB_ARRAY_TOO_SMALL;
+    }
+
     coded_vals = (T*)grib_context_malloc(a->context, coded_n_vals * sizeof(T));
     if (coded_vals == NULL)
         return GRIB_OUT_OF_MEMORY;
@@ -402,21 +542,22 @@ static int unpack(grib_accessor* a, T* val, size_t* len)
                      __func__,
                      a->name, n_vals);
 
-    for (i = 0; i < n_vals; i++) {
-        if (val[i] == 0) {
-            val[i] = missing_value;
+    /* A word at a time: all missing, all present or bit by bit */
+    for (i = 0; i < n_vals; i += 64) {
+        const uint64_t word = self->bitmap_words[i / 64];
+        const size_t n      = n_vals - i < 64 ? n_vals - i : 64;
+        size_t k            = 0;
+        if (word == 0) {
+            for (k = 0; k < n; k++)
+                val[i + k] = missing_value;
+        }
+        else if (n == 64 && word == ~(uint64_t)0) {
+            memcpy(val + i, coded_vals + j, 64 * sizeof(T));
+            j += 64;
         }
         else {
-            val[i] = coded_vals[j++];
-            if (j > coded_n_vals) {
-                grib_context_free(a->context, coded_vals);
-                grib_context_log(a->context, GRIB_LOG_ERROR,
-                                 "grib_accessor_class_data_apply_bitmap [%s]:"
-                                 " %s :  number of coded values does not match bitmap %ld %ld",
-                                 a->name, __func__, coded_n_vals, n_vals);
-
-                return GRIB_ARRAY_TOO_SMALL;
-            }
+            for (k = 0; k < n; k++)
+                val[i + k] = ((word >> (63 - k)) & 1) ? coded_vals[j++] : (T)missing_value;
         }
     }
 
@@ -9,6 +9,7 @@
  */
 
 #include "grib_api_internal.h"
+#include "grib_value.h"
 
 /*
    This is used by make_class.pl
@@ -17,7 +18,7 @@
    CLASS      = accessor
    SUPER      = grib_accessor_class_gen
    IMPLEMENTS = init
-   IMPLEMENTS = unpack_double;unpack_double_element;unpack_double_element_set
+   IMPLEMENTS = unpack_double;unpack_float;unpack_double_element;unpack_double_element_set
    IMPLEMENTS = pack_double
    IMPLEMENTS = value_count
    IMPLEMENTS = dump;get_native_type
@@ -45,6 +46,7 @@ or edit "accessor.class" and rerun ./make_class.pl
 static int get_native_type(grib_accessor*);
 static int pack_double(grib_accessor*, const double* val, size_t* len);
 static int unpack_double(grib_accessor*, double* val, size_t* len);
+static int unpack_float(grib_accessor*, float* val, size_t* len);
 static int value_count(grib_accessor*, long*);
 static void dump(grib_accessor*, grib_dumper*);
 static void init(grib_accessor*, const long, grib_arguments*);
@@ -91,7 +93,7 @@ static grib_accessor_class _grib_accessor_class_data_apply_boustrophedonic_bitma
     &pack_double,                /* pack_double */
     0,                 /* pack_float */
     &unpack_double,              /* unpack_double */
-    0,               /* unpack_float */
+    &unpack_float,               /* unpack_float */
     0,                /* pack_string */
     0,              /* unpack_string */
     0,          /* pack_string_array */
@@ -113,6 +115,7 @@ static grib_accessor_class _grib_accessor_class_data_apply_boustrophedonic_bitma
     0,     /* unpack a subarray */
     0,                      /* clear */
     0,                 /* clone accessor */
+    0,                 /* reset */
 };
 
 
@@ -158,8 +161,11 @@ static int value_count(grib_accessor* a, long* count)
     return ret;
 }
 
-static int unpack_double(grib_accessor* a, double* val, size_t* len)
+template <typename T>
+static int unpack(grib_accessor* a, T* val, size_t* len)
 {
+    static_assert(std::is_floating_point<T>::value, "Requires floating point numbers");
+
     grib_accessor_data_apply_boustrophedonic_bitmap* self = (grib_accessor_data_apply_boustrophedonic_bitmap*)a;
     grib_handle* gh                                       = grib_handle_of_accessor(a);
 
@@ -167,7 +173,7 @@ static int unpack_double(grib_accessor* a, double* val, size_t* len)
     long nn              = 0;
     int err              = 0;
     size_t coded_n_vals  = 0;
-    double* coded_vals   = NULL;
+    T* coded_vals        = NULL;
     double missing_value = 0;
     long numberOfPoints, numberOfRows, numberOfColumns;
 
@@ -188,7 +194,7 @@ static int unpack_double(grib_accessor* a, double* val, size_t* len)
     Assert(nn == numberOfPoints);
 
     if (!grib_find_accessor(gh, self->bitmap))
-        return grib_get_double_array_internal(gh, self->coded_values, val, len);
+        return grib_get_array_internal<T>(gh, self->coded_values, val, len);
 
     if ((err = grib_get_size(gh, self->coded_values, &coded_n_vals)) != GRIB_SUCCESS)
         return err;
@@ -209,14 +215,14 @@ static int unpack_double(grib_accessor* a, double* val, size_t* len)
         return GRIB_SUCCESS;
     }
 
-    if ((err = grib_get_double_array_internal(gh, self->bitmap, val, &n_vals)) != GRIB_SUCCESS)
+    if ((err = grib_get_array_internal<T>(gh, self->bitmap, val, &n_vals)) != GRIB_SUCCESS)
         return err;
 
-    coded_vals = (double*)grib_context_malloc(a->context, coded_n_vals * sizeof(double));
+    coded_vals = (T*)grib_context_malloc(a->context, coded_n_vals * sizeof(T));
     if (coded_vals == NULL)
         return GRIB_OUT_OF_MEMORY;
 
-    if ((err = grib_get_double_array_internal(gh, self->coded_values, coded_vals, &coded_n_vals)) != GRIB_SUCCESS) {
+    if ((err = grib_get_array_internal<T>(gh, self->coded_values, coded_vals, &coded_n_vals)) != GRIB_SUCCESS) {
         grib_context_free(a->context, coded_vals);
         return err;
     }
@@ -237,7 +243,7 @@ static int unpack_double(grib_accessor* a, double* val, size_t* len)
             size_t mid   = (numberOfColumns - 1) / 2;
             for (k = 0; k < mid; ++k) {
                 /* Swap value at either end */
-                double temp    = val[start + k];
+                T temp         = val[start + k];
                 val[start + k] = val[end - k];
                 val[end - k]   = temp;
             }
@@ -268,6 +274,16 @@ static int unpack_double(grib_accessor* a, double* val, size_t* len)
     return err;
 }
 
+static int unpack_double(grib_accessor* a, double* val, size_t* len)
+{
+    return unpack<double>(a, val, len);
+}
+
+static int unpack_float(grib_accessor* a, float* val, size_t* len)
+{
+    return unpack<float>(a, val, len);
+}
+
 static int unpack_double_element(grib_accessor* a, size_t idx, double* val)
 {
     grib_accessor_data_apply_boustrophedonic_bitmap* self = (grib_accessor_data_apply_boustrophedonic_bitmap*)a;
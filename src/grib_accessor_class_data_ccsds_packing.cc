@@ -25,6 +25,7 @@
    IMPLEMENTS = pack_double
    IMPLEMENTS = unpack_double_element;unpack_double_element_set
    IMPLEMENTS = value_count
+   IMPLEMENTS = destroy;reset
    MEMBERS=const char*   number_of_values
    MEMBERS=const char*   reference_value
    MEMBERS=const char*   binary_scale_factor
@@ -35,6 +36,9 @@
    MEMBERS=const char*   ccsds_flags
    MEMBERS=const char*   ccsds_block_size
    MEMBERS=const char*   ccsds_rsi
+   MEMBERS=size_t*       rsi_offsets
+   MEMBERS=size_t        rsi_count
+   MEMBERS=size_t        rsi_length
 
    END_CLASS_DEF
 
@@ -54,7 +58,9 @@ static int pack_double(grib_accessor*, const double* val, size_t* len);
 static int unpack_double(grib_accessor*, double* val, size_t* len);
 static int unpack_float(grib_accessor*, float* val, size_t* len);
 static int value_count(grib_accessor*, long*);
+static void destroy(grib_context*, grib_accessor*);
 static void init(grib_accessor*, const long, grib_arguments*);
+static void reset(grib_accessor*);
 static int unpack_double_element(grib_accessor*, size_t i, double* val);
 static int unpack_double_element_set(grib_accessor*, const size_t* index_array, size_t len, double* val_array);
 
@@ -79,6 +85,9 @@ typedef struct grib_accessor_data_ccsds_packing
     const char*   ccsds_flags;
     const char*   ccsds_block_size;
     const char*   ccsds_rsi;
+    size_t*       rsi_offsets;
+    size_t        rsi_count;
+    size_t        rsi_length;
 } grib_accessor_data_ccsds_packing;
 
 extern grib_accessor_class* grib_accessor_class_values;
@@ -91,7 +100,7 @@ static grib_accessor_class _grib_accessor_class_data_ccsds_packing = {
     0,                           /* init_class */
     &init,                       /* init */
     0,                  /* post_init */
-    0,                    /* destroy */
+    &destroy,                    /* destroy */
     0,                       /* dump */
     0,                /* next_offset */
     0,              /* get length of string */
@@ -129,6 +138,7 @@ static grib_accessor_class _grib_accessor_class_data_ccsds_packing = {
     0,     /* unpack a subarray */
     0,                      /* clear */
     0,                 /* clone accessor */
+    &reset,                      /* reset */
 };
 
 
@@ -151,6 +161,9 @@ static void init(grib_accessor* a, const long v, grib_arguments* args)
     self->ccsds_flags             = grib_arguments_get_name(h, args, self->carg++);
     self->ccsds_block_size        = grib_arguments_get_name(h, args, self->carg++);
     self->ccsds_rsi               = grib_arguments_get_name(h, args, self->carg++);
+    self->rsi_offsets             = NULL;
+    self->rsi_count               = 0;
+    self->rsi_length              = 0;
 
     a->flags |= GRIB_ACCESSOR_FLAG_DATA;
 }
@@ -162,6 +175,25 @@ static int value_count(grib_accessor* a, long* count)
     return grib_get_long_internal(grib_handle_of_accessor(a), self->number_of_values, count);
 }
 
+static void clear_rsi_offsets(grib_accessor* a)
+{
+    grib_accessor_data_ccsds_packing* self = (grib_accessor_data_ccsds_packing*)a;
+    grib_context_free(a->context, self->rsi_offsets);
+    self->rsi_offsets = NULL;
+    self->rsi_count   = 0;
+    self->rsi_length  = 0;
+}
+
+static void destroy(grib_context* c, grib_accessor* a)
+{
+    clear_rsi_offsets(a);
+}
+
+static void reset(grib_accessor* a)
+{
+    clear_rsi_offsets(a);
+}
+
 #if defined(HAVE_LIBAEC) || defined(HAVE_AEC)
 
 #include <libaec.h>
@@ -207,6 +239,293 @@ static void print_aec_stream_info(struct aec_stream* strm, const char* func)
     fprintf(stderr, "ECCODES DEBUG CCSDS %s aec_stream.avail_in=%lu\n",       func, strm->avail_in);
 }
 
+/*
+ * The reference sample intervals (RSI) of the coded data can be decoded on their own: the offset of
+ * each one is found by reading the identifiers and lengths of the blocks, as described in CCSDS 121.0-B,
+ * without decoding their samples. That of a block whose identifier is 0 is the low entropy option,
+ * followed by one bit telling a second extension (1) from zero blocks (0); the last identifier is that of
+ * an uncompressed block, the others of a split of k=id-1 bits
+ */
+
+/* A run of zero blocks to the end of the segment of 64 blocks, or to the end of the RSI */
+#define CCSDS_ROS 5
+
+typedef struct ccsds_bit_reader
+{
+    const unsigned char* data;
+    size_t nbytes;
+    size_t pos; /* In bits */
+} ccsds_bit_reader;
+
+static int clz64(uint64_t x)
+{
+#if defined(__GNUC__)
+    return __builtin_clzll(x);
+#else
+    int n = 0;
+    while (!(x & ((uint64_t)1 << 63))) {
+        x <<= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+/* The bits from the current position on, at least 57 of them, the first one in the most significant bit */
+static uint64_t ccsds_peek(const ccsds_bit_reader* r)
+{
+    const size_t byte = r->pos / 8;
+    const unsigned char* p = r->data + byte;
+    uint64_t w        = 0;
+    size_t i          = 0;
+    if (byte + 8 <= r->nbytes) {
+        w = ((uint64_t)p[0] << 56) | ((uint64_t)p[1] << 48) | ((uint64_t)p[2] << 40) | ((uint64_t)p[3] << 32) |
+            ((uint64_t)p[4] << 24) | ((uint64_t)p[5] << 16) | ((uint64_t)p[6] << 8) | (uint64_t)p[7];
+    }
+    else {
+        for (i = 0; i < 8; i++)
+            w = (w << 8) | (byte + i < r->nbytes ? p[i] : 0);
+    }
+    return w << (r->pos % 8);
+}
+
+static uint32_t ccsds_get(ccsds_bit_reader* r, int nbits)
+{
+    const uint32_t v = (uint32_t)(ccsds_peek(r) >> (64 - nbits));
+    r->pos += nbits;
+    return v;
+}
+
+/* A fundamental sequence codeword: its value is the number of zeros before the one */
+static int ccsds_get_fs(ccsds_bit_reader* r, uint32_t* fs)
+{
+    uint64_t w = 0;
+    *fs        = 0;
+    while ((w = ccsds_peek(r)) == 0) {
+        *fs += 64 - r->pos % 8;
+        r->pos += 64 - r->pos % 8;
+        if (r->pos > r->nbytes * 8)
+            return GRIB_DECODING_ERROR;
+    }
+    *fs += clz64(w);
+    r->pos += clz64(w) + 1;
+    return GRIB_SUCCESS;
+}
+
+static int popcount64(uint64_t x)
+{
+#if defined(__GNUC__)
+    return __builtin_popcountll(x);
+#else
+    x = x - ((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+    return (int)((x * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+/* The position, from the most significant bit, of the n-th bit set of w, counting from 1 */
+static int select64(uint64_t w, int n)
+{
+    int pos = 0, width = 0;
+    for (width = 32; width > 0; width /= 2) {
+        const int ones = popcount64(w >> (64 - width));
+        if (ones < n) {
+            n -= ones;
+            w <<= width;
+            pos += width;
+        }
+    }
+    return pos;
+}
+
+/* Each codeword ends with the only one of its bits set: they are skipped 56 bits at a time */
+static int ccsds_skip_fs(ccsds_bit_reader* r, size_t count)
+{
+    while (count > 0) {
+        const uint64_t w = ccsds_peek(r) & ~(uint64_t)0xff;
+        const size_t ones = popcount64(w);
+        if (ones < count) {
+            r->pos += 56;
+            count -= ones;
+        }
+        else {
+            r->pos += select64(w, (int)count) + 1;
+            count = 0;
+        }
+        if (r->pos > r->nbytes * 8)
+            return GRIB_DECODING_ERROR;
+    }
+    return GRIB_SUCCESS;
+}
+
+/* The offset in bits of each RSI in the coded data, or an error if the data are not as expected */
+static int ccsds_find_rsi_offsets(const unsigned char* data, size_t nbytes, long flags, long bits_per_sample,
+                                  long block_size, long rsi, size_t n_vals, size_t* offsets, size_t count)
+{
+    ccsds_bit_reader r = { data, nbytes, 0 };
+    const size_t blocks = (n_vals + block_size - 1) / block_size;
+    const int pp        = (flags & AEC_DATA_PREPROCESS) ? 1 : 0;
+    uint32_t id_max     = 0;
+    int id_len          = 0;
+    size_t i            = 0;
+    int err             = 0;
+
+    if (bits_per_sample > 16)
+        id_len = 5;
+    else if (bits_per_sample > 8)
+        id_len = 4;
+    else if ((flags & AEC_RESTRICTED) && bits_per_sample <= 4)
+        id_len = bits_per_sample <= 2 ? 1 : 2;
+    else
+        id_len = 3;
+    id_max = (1U << id_len) - 1;
+
+    for (i = 0; i < count; i++) {
+        const size_t rsi_blocks = (blocks - i * rsi < (size_t)rsi) ? blocks - i * rsi : rsi;
+        size_t b = 0;
+        int ref  = pp;
+
+        offsets[i] = r.pos;
+        while (b < rsi_blocks) {
+            const uint32_t id = ccsds_get(&r, id_len);
+            if (id == 0) {
+                const uint32_t second_extension = ccsds_get(&r, 1);
+                r.pos += ref * bits_per_sample;
+                if (second_extension) {
+                    err = ccsds_skip_fs(&r, block_size / 2);
+                    b++;
+                }
+                else {
+                    uint32_t fs = 0;
+                    size_t zero_blocks = 0;
+                    err = ccsds_get_fs(&r, &fs);
+                    zero_blocks = fs + 1;
+                    if (zero_blocks == CCSDS_ROS) {
+                        zero_blocks = rsi - b;
+                        if (64 - b % 64 < zero_blocks)
+                            zero_blocks = 64 - b % 64;
+                    }
+                    else if (zero_blocks > CCSDS_ROS) {
+                        zero_blocks--;
+                    }
+                    b += zero_blocks;
+                }
+            }
+            else if (id == id_max) {
+                r.pos += block_size * bits_per_sample;
+                b++;
+            }
+            else {
+                r.pos += ref * bits_per_sample;
+                err = ccsds_skip_fs(&r, block_size - ref);
+                r.pos += (id - 1) * (block_size - ref);
+                b++;
+            }
+            if (err || r.pos > nbytes * 8)
+                return GRIB_DECODING_ERROR;
+            ref = 0;
+        }
+        if (flags & AEC_PAD_RSI)
+            r.pos = (r.pos + 7) / 8 * 8;
+    }
+    /* All the data read, up to the padding of the last byte */
+    if (r.pos > nbytes * 8 || nbytes * 8 - r.pos >= 8)
+        return GRIB_DECODING_ERROR;
+    return GRIB_SUCCESS;
+}
+
+/* The offsets of the RSIs of the data, found when first needed. None if they could not be found */
+static int get_rsi_offsets(grib_accessor* a, long flags, long bits_per_value, long block_size, long rsi, size_t n_vals)
+{
+    grib_accessor_data_ccsds_packing* self = (grib_accessor_data_ccsds_packing*)a;
+    grib_handle* hand   = grib_handle_of_accessor(a);
+    const size_t length = grib_byte_count(a);
+    const size_t count  = (n_vals + block_size * rsi - 1) / (block_size * rsi);
+    size_t* offsets     = NULL;
+
+    if (self->rsi_length == length && self->rsi_count == count)
+        return GRIB_SUCCESS;
+    clear_rsi_offsets(a);
+
+    offsets = (size_t*)grib_context_malloc(a->context, count * sizeof(size_t));
+    if (!offsets)
+        return GRIB_OUT_OF_MEMORY;
+    if (ccsds_find_rsi_offsets(hand->buffer->data + grib_byte_offset(a), length, flags, bits_per_value,
+                               block_size, rsi, n_vals, offsets, count) != GRIB_SUCCESS) {
+        grib_context_log(a->context, GRIB_LOG_DEBUG, "%s: offsets of the RSIs of %s not found, decoding all of them",
+                         a->cclass->name, a->name);
+        grib_context_free(a->context, offsets);
+        offsets = NULL;
+    }
+    self->rsi_offsets = offsets;
+    self->rsi_count   = count;
+    self->rsi_length  = length;
+    return GRIB_SUCCESS;
+}
+
+/* The first n_samples samples of the RSIs from the first to the last one, decoded at once from the offset
+ * of the first. That of the first RSI is 0 and needs no offsets */
+static int decode_rsis(grib_accessor* a, size_t first, size_t last, long flags, long bits_per_value, long block_size, long rsi,
+                       unsigned char* decoded, size_t n_samples, size_t nbytes)
+{
+    grib_accessor_data_ccsds_packing* self = (grib_accessor_data_ccsds_packing*)a;
+    grib_handle* hand         = grib_handle_of_accessor(a);
+    const unsigned char* data = hand->buffer->data + grib_byte_offset(a);
+    const size_t length       = grib_byte_count(a);
+    const size_t start        = first ? self->rsi_offsets[first] : 0;
+    const size_t end          = (self->rsi_offsets && last + 1 < self->rsi_count) ? self->rsi_offsets[last + 1] : length * 8;
+    const size_t shift        = start % 8;
+    size_t buflen             = (end + 7) / 8 - start / 8;
+    unsigned char* buf        = NULL;
+    struct aec_stream strm;
+    size_t j = 0;
+    int err  = 0;
+
+    if (shift) {
+        /* The first RSI from the first bit of the buffer */
+        buf = (unsigned char*)grib_context_buffer_malloc(a->context, buflen);
+        if (!buf)
+            return GRIB_OUT_OF_MEMORY;
+        data += start / 8;
+        for (j = 0; j < buflen; j++) {
+            unsigned int byte = (unsigned int)data[j] << shift;
+            if (start / 8 + j + 1 < length)
+                byte |= data[j + 1] >> (8 - shift);
+            buf[j] = (unsigned char)byte;
+        }
+    }
+
+    strm.flags           = flags;
+    strm.bits_per_sample = bits_per_value;
+    strm.block_size      = block_size;
+    strm.rsi             = rsi;
+    strm.next_in         = shift ? buf : data + start / 8;
+    strm.avail_in        = buflen;
+    strm.next_out        = decoded;
+    strm.avail_out       = n_samples * nbytes;
+
+    if ((err = aec_buffer_decode(&strm)) != AEC_OK) {
+        grib_context_log(a->context, GRIB_LOG_ERROR, "%s %s: aec_buffer_decode error %d (%s)",
+                         a->cclass->name, __func__, err, aec_get_error_message(err));
+        err = GRIB_DECODING_ERROR;
+    }
+    grib_context_buffer_free(a->context, buf);
+    return err;
+}
+
+static double decoded_sample(const unsigned char* decoded, size_t nbytes, size_t i)
+{
+    switch (nbytes) {
+        case 1:
+            return reinterpret_cast<const uint8_t*>(decoded)[i];
+        case 2:
+            return reinterpret_cast<const uint16_t*>(decoded)[i];
+        default:
+            return reinterpret_cast<const uint32_t*>(decoded)[i];
+    }
+}
+
 static int pack_double(grib_accessor* a, const double* val, size_t* len)
 {
     grib_accessor_data_ccsds_packing* self = (grib_accessor_data_ccsds_packing*)a;
@@ -237,6 +556,7 @@ static int pack_double(grib_accessor* a, const double* val, size_t* len)
     struct aec_stream strm;
 
     self->dirty = 1;
+    clear_rsi_offsets(a);
 
     n_vals = *len;
 
@@ -647,52 +967,45 @@ static int unpack_float(grib_accessor* a, float* val, size_t* len)
     return unpack<float>(a, val, len);
 }
 
-static int unpack_double_element(grib_accessor* a, size_t idx, double* val)
+// The elements picked from all the values decoded
+static int unpack_elements_of_all_values(grib_accessor* a, const size_t* index_array, size_t len, double* val_array, size_t n_vals)
 {
-    // The index idx relates to codedValues NOT values!
-    grib_accessor_data_ccsds_packing* self = (grib_accessor_data_ccsds_packing*)a;
-    grib_handle* hand = grib_handle_of_accessor(a);
-    int err = 0;
-    size_t size    = 0;
-    long bits_per_value = 0;
-    double reference_value = 0;
-    double* values = NULL;
+    size_t size    = n_vals, i = 0;
+    double* values = (double*)grib_context_malloc_clear(a->context, size * sizeof(double));
+    int err        = 0;
 
-    if ((err = grib_get_long_internal(hand, self->bits_per_value, &bits_per_value)) != GRIB_SUCCESS)
-        return err;
-    if ((err = grib_get_double_internal(hand, self->reference_value, &reference_value)) != GRIB_SUCCESS)
-        return err;
-
-    // Special case of constant field
-    if (bits_per_value == 0) {
-        *val = reference_value;
-        return GRIB_SUCCESS;
-    }
-
-    err = grib_get_size(hand, "codedValues", &size);
-    if (err) return err;
-    if (idx > size) return GRIB_INVALID_ARGUMENT;
-
-    values = (double*)grib_context_malloc_clear(a->context, size * sizeof(double));
-    err    = grib_get_double_array(hand, "codedValues", values, &size);
+    if (!values)
+        return GRIB_OUT_OF_MEMORY;
+    err = grib_get_double_array(grib_handle_of_accessor(a), "codedValues", values, &size);
     if (err) {
         grib_context_free(a->context, values);
         return err;
     }
-    *val = values[idx];
+    for (i = 0; i < len; i++) {
+        val_array[i] = values[index_array[i]];
+    }
     grib_context_free(a->context, values);
     return GRIB_SUCCESS;
 }
 
+static int unpack_double_element(grib_accessor* a, size_t idx, double* val)
+{
+    // The index idx relates to codedValues NOT values!
+    return unpack_double_element_set(a, &idx, 1, val);
+}
+
 static int unpack_double_element_set(grib_accessor* a, const size_t* index_array, size_t len, double* val_array)
 {
     grib_accessor_data_ccsds_packing* self = (grib_accessor_data_ccsds_packing*)a;
     grib_handle* hand = grib_handle_of_accessor(a);
-    size_t size = 0, i = 0;
-    double* values = NULL;
-    int err = 0;
-    long bits_per_value = 0;
-    double reference_value = 0;
+    size_t i = 0, n_vals = 0, samples = 0, count = 0, nbytes = 0, empty = 0, gaps = 0;
+    int err = 0, through_gaps = 0;
+    long bits_per_value = 0, binary_scale_factor = 0, decimal_scale_factor = 0, nn = 0;
+    long ccsds_flags = 0, ccsds_block_size = 0, ccsds_rsi = 0;
+    double reference_value = 0, bscale = 0, dscale = 0;
+    size_t* counts = NULL;
+    size_t* order  = NULL;
+    unsigned char* decoded = NULL;
 
     if ((err = grib_get_long_internal(hand, self->bits_per_value, &bits_per_value)) != GRIB_SUCCESS)
         return err;
@@ -708,26 +1021,106 @@ static int unpack_double_element_set(grib_accessor* a, const size_t* index_array
     }
 
     // GRIB-564: The indexes in index_array relate to codedValues NOT values!
-    err = grib_get_size(grib_handle_of_accessor(a), "codedValues", &size);
-    if (err)
+    if ((err = grib_value_count(a, &nn)) != GRIB_SUCCESS)
         return err;
+    n_vals = nn;
 
     for (i = 0; i < len; i++) {
-        if (index_array[i] > size) return GRIB_INVALID_ARGUMENT;
+        if (index_array[i] >= n_vals) return GRIB_INVALID_ARGUMENT;
     }
+    if (len == 0)
+        return GRIB_SUCCESS;
 
-    values = (double*)grib_context_malloc_clear(a->context, size * sizeof(double));
-    err    = grib_get_double_array(grib_handle_of_accessor(a), "codedValues", values, &size);
-    if (err) {
-        grib_context_free(a->context, values);
+    if ((err = grib_get_long_internal(hand, self->binary_scale_factor, &binary_scale_factor)) != GRIB_SUCCESS)
+        return err;
+    if ((err = grib_get_long_internal(hand, self->decimal_scale_factor, &decimal_scale_factor)) != GRIB_SUCCESS)
+        return err;
+    if ((err = grib_get_long(hand, self->ccsds_flags, &ccsds_flags)) != GRIB_SUCCESS)
         return err;
+    if ((err = grib_get_long_internal(hand, self->ccsds_block_size, &ccsds_block_size)) != GRIB_SUCCESS)
+        return err;
+    if ((err = grib_get_long_internal(hand, self->ccsds_rsi, &ccsds_rsi)) != GRIB_SUCCESS)
+        return err;
+    modify_aec_flags(&ccsds_flags);
+
+    nbytes = (bits_per_value + 7) / 8;
+    if (nbytes == 3)
+        nbytes = 4;
+    if (nbytes > 4 || ccsds_block_size <= 0 || ccsds_rsi <= 0)
+        return unpack_elements_of_all_values(a, index_array, len, val_array, n_vals);
+
+    // Only the RSIs of the elements are decoded, up to their last element, those following one another
+    // at once: the elements are ordered by their RSI
+    samples = ccsds_block_size * ccsds_rsi;
+    count   = (n_vals + samples - 1) / samples;
+    counts  = (size_t*)grib_context_malloc_clear(a->context, (count + 1) * sizeof(size_t));
+    order   = (size_t*)grib_context_malloc(a->context, len * sizeof(size_t));
+    if (!counts || !order) {
+        err = GRIB_OUT_OF_MEMORY;
+        goto cleanup;
     }
-    for (i = 0; i < len; i++) {
-        val_array[i] = values[index_array[i]];
+    for (i = 0; i < len; i++)
+        counts[index_array[i] / samples + 1]++;
+    for (i = 0; i < count; i++) {
+        if (counts[i + 1] == 0)
+            empty++;
+        else
+            gaps = empty;
+        counts[i + 1] += counts[i];
+    }
+    // The RSIs after those of no element are decoded from their offset. Finding the offsets takes about
+    // a fifth of the time of decoding all the RSIs: for many elements, the few RSIs between them are decoded
+    if (gaps > 0 && !self->rsi_offsets && len >= count && gaps * 5 < count)
+        through_gaps = 1;
+    if (gaps > 0 && !through_gaps) {
+        if ((err = get_rsi_offsets(a, ccsds_flags, bits_per_value, ccsds_block_size, ccsds_rsi, n_vals)) != GRIB_SUCCESS)
+            goto cleanup;
+        if (!self->rsi_offsets) {
+            err = unpack_elements_of_all_values(a, index_array, len, val_array, n_vals);
+            goto cleanup;
+        }
+    }
+    for (i = 0; i < len; i++)
+        order[counts[index_array[i] / samples]++] = i;
+    // counts[i] is now the end of the elements of the i-th RSI in order
+
+    bscale = codes_power<double>(binary_scale_factor, 2);
+    dscale = codes_power<double>(-decimal_scale_factor, 10);
+    for (i = 0; i < count;) {
+        size_t last = i, end = 0, j = 0;
+        const size_t begin = i ? counts[i - 1] : 0;
+        if (counts[i] == begin && !through_gaps) {
+            i++;
+            continue;
+        }
+        while (last + 1 < count && (through_gaps || counts[last + 1] > counts[last]))
+            last++;
+        for (j = begin; j < counts[last]; j++) {
+            if (index_array[order[j]] + 1 > end)
+                end = index_array[order[j]] + 1;
+        }
+        decoded = (unsigned char*)grib_context_buffer_malloc(a->context, (end - i * samples) * nbytes);
+        if (!decoded) {
+            err = GRIB_OUT_OF_MEMORY;
+            goto cleanup;
+        }
+        err = decode_rsis(a, i, last, ccsds_flags, bits_per_value, ccsds_block_size, ccsds_rsi, decoded, end - i * samples, nbytes);
+        if (err)
+            goto cleanup;
+        for (j = begin; j < counts[last]; j++) {
+            const size_t k = order[j];
+            val_array[k]   = (decoded_sample(decoded, nbytes, index_array[k] - i * samples) * bscale + reference_value) * dscale;
+        }
+        grib_context_buffer_free(a->context, decoded);
+        decoded = NULL;
+        i = last + 1;
     }
 
-    grib_context_free(a->context, values);
-    return GRIB_SUCCESS;
+cleanup:
+    grib_context_free(a->context, counts);
+    grib_context_free(a->context, order);
+    grib_context_buffer_free(a->context, decoded);
+    return err;
 }
 
 #else
@@ -9,6 +9,7 @@
  */
 
 #include "grib_api_internal.h"
+#include <type_traits>
 
 /*
    This is used by make_class.pl
@@ -17,7 +18,7 @@
    CLASS      = accessor
    SUPER      = grib_accessor_class_data_g1simple_packing
    IMPLEMENTS = init
-   IMPLEMENTS = unpack_double
+   IMPLEMENTS = unpack_double;unpack_float
    IMPLEMENTS = value_count
    IMPLEMENTS = pack_double
    MEMBERS=const char*  missing_value
@@ -39,6 +40,7 @@ or edit "accessor.class" and rerun ./make_class.pl
 
 static int pack_double(grib_accessor*, const double* val, size_t* len);
 static int unpack_double(grib_accessor*, double* val, size_t* len);
+static int unpack_float(grib_accessor*, float* val, size_t* len);
 static int value_count(grib_accessor*, long*);
 static void init(grib_accessor*, const long, grib_arguments*);
 
@@ -100,7 +102,7 @@ static grib_accessor_class _grib_accessor_class_data_dummy_field = {
     &pack_double,                /* pack_double */
     0,                 /* pack_float */
     &unpack_double,              /* unpack_double */
-    0,               /* unpack_float */
+    &unpack_float,               /* unpack_float */
     0,                /* pack_string */
     0,              /* unpack_string */
     0,          /* pack_string_array */
@@ -122,6 +124,7 @@ static grib_accessor_class _grib_accessor_class_data_dummy_field = {
     0,     /* unpack a subarray */
     0,                      /* clear */
     0,                 /* clone accessor */
+    0,                 /* reset */
 };
 
 
@@ -137,8 +140,11 @@ static void init(grib_accessor* a, const long v, grib_arguments* args)
     self->bitmap                         = grib_arguments_get_name(grib_handle_of_accessor(a), args, self->carg++);
 }
 
-static int unpack_double(grib_accessor* a, double* val, size_t* len)
+template <typename T>
+static int unpack(grib_accessor* a, T* val, size_t* len)
 {
+    static_assert(std::is_floating_point<T>::value, "Requires floating point numbers");
+
     grib_accessor_data_dummy_field* self = (grib_accessor_data_dummy_field*)a;
     size_t i                             = 0;
     size_t n_vals                        = 0;
@@ -162,7 +168,20 @@ static int unpack_double(grib_accessor* a, double* val, size_t* len)
         val[i] = missing_value;
 
     if (grib_find_accessor(grib_handle_of_accessor(a), self->bitmap)) {
-        if ((err = grib_set_double_array_internal(grib_handle_of_accessor(a), self->bitmap, val, n_vals)) != GRIB_SUCCESS)
+        if (std::is_same<T, double>::value) {
+            err = grib_set_double_array_internal(grib_handle_of_accessor(a), self->bitmap, (double*)val, n_vals);
+        }
+        else {
+            /* The bitmap can only be set from doubles */
+            double* dval = (double*)grib_context_malloc(a->context, n_vals * sizeof(double));
+            if (!dval)
+                return GRIB_OUT_OF_MEMORY;
+            for (i = 0; i < n_vals; i++)
+                dval[i] = missing_value;
+            err = grib_set_double_array_internal(grib_handle_of_accessor(a), self->bitmap, dval, n_vals);
+            grib_context_free(a->context, dval);
+        }
+        if (err != GRIB_SUCCESS)
             return err;
     }
 
@@ -170,6 +189,16 @@ static int unpack_double(grib_accessor* a, double* val, size_t* len)
     return err;
 }
 
+static int unpack_double(grib_accessor* a, double* val, size_t* len)
+{
+    return unpack<double>(a, val, len);
+}
+
+static int unpack_float(grib_accessor* a, float* val, size_t* len)
+{
+    return unpack<float>(a, val, len);
+}
+
 static int pack_double(grib_accessor* a, const double* val, size_t* len)
 {
     grib_accessor_data_dummy_field* self = (grib_accessor_data_dummy_field*)a;
@@ -129,6 +129,7 @@ static grib_accessor_class _grib_accessor_class_data_g1complex_packing = {
     0,     /* unpack a subarray */
     0,                      /* clear */
     0,                 /* clone accessor */
+    0,                 /* reset */
 };
 
 
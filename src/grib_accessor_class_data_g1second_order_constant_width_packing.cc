@@ -10,6 +10,7 @@
 
 #include "grib_scaling.h"
 #include "grib_api_internal.h"
+#include <type_traits>
 
 /*
    This is used by make_class.pl
@@ -149,6 +150,7 @@ static grib_accessor_class _grib_accessor_class_data_g1second_order_constant_wid
     0,     /* unpack a subarray */
     0,                      /* clear */
     0,                 /* clone accessor */
+    0,                 /* reset */
 };
 
 
@@ -192,13 +194,11 @@ static int value_count(grib_accessor* a, long* numberOfSecondOrderPackedValues)
     return err;
 }
 
-static int unpack_float(grib_accessor*, float* val, size_t* len)
+template <typename T>
+static int unpack(grib_accessor* a, T* values, size_t* len)
 {
-    return GRIB_NOT_IMPLEMENTED;
-}
+    static_assert(std::is_floating_point<T>::value, "Requires floating point numbers");
 
-static int unpack_double(grib_accessor* a, double* values, size_t* len)
-{
     grib_accessor_data_g1second_order_constant_width_packing* self = (grib_accessor_data_g1second_order_constant_width_packing*)a;
     int ret                                                        = 0;
     long numberOfGroups, numberOfSecondOrderPackedValues;
@@ -310,7 +310,7 @@ static int unpack_double(grib_accessor* a, double* values, size_t* len)
     s = codes_power<double>(binary_scale_factor, 2);
     d = codes_power<double>(-decimal_scale_factor, 10);
     for (i = 0; i < numberOfSecondOrderPackedValues; i++) {
-        values[i] = (double)(((X[i] * s) + reference_value) * d);
+        values[i] = (T)(((X[i] * s) + reference_value) * d);
     }
 
     *len = numberOfSecondOrderPackedValues;
@@ -321,6 +321,16 @@ static int unpack_double(grib_accessor* a, double* values, size_t* len)
     return ret;
 }
 
+static int unpack_double(grib_accessor* a, double* values, size_t* len)
+{
+    return unpack<double>(a, values, len);
+}
+
+static int unpack_float(grib_accessor* a, float* values, size_t* len)
+{
+    return unpack<float>(a, values, len);
+}
+
 static int pack_double(grib_accessor* a, const double* cval, size_t* len)
 {
     const char* cclass_name = a->cclass->name;
@@ -24,6 +24,7 @@
    IMPLEMENTS = unpack_double_element;unpack_double_element_set
    IMPLEMENTS = value_count
    IMPLEMENTS = destroy
+   IMPLEMENTS = reset
    MEMBERS=const char* half_byte
    MEMBERS=const char* packingType
    MEMBERS=const char* ieee_packing
@@ -74,6 +75,7 @@ static void destroy(grib_context*, grib_accessor*);
 static void init(grib_accessor*, const long, grib_arguments*);
 static int unpack_double_element(grib_accessor*, size_t i, double* val);
 static int unpack_double_element_set(grib_accessor*, const size_t* index_array, size_t len, double* val_array);
+static void reset(grib_accessor*);
 
 typedef struct grib_accessor_data_g1second_order_general_extended_packing
 {
@@ -174,6 +176,7 @@ static grib_accessor_class _grib_accessor_class_data_g1second_order_general_exte
     0,     /* unpack a subarray */
     0,                      /* clear */
     0,                 /* clone accessor */
+    &reset,            /* reset */
 };
 
 
@@ -256,6 +259,14 @@ static void init(grib_accessor* a, const long v, grib_arguments* args)
     a->flags |= GRIB_ACCESSOR_FLAG_DATA;
 }
 
+static void reset(grib_accessor* a)
+{
+    grib_accessor_data_g1second_order_general_extended_packing* self = (grib_accessor_data_g1second_order_general_extended_packing*)a;
+    destroy(a->context, a);
+    self->double_dirty = self->float_dirty = 1;
+    self->size                            = 0;
+}
+
 static int value_count(grib_accessor* a, long* count)
 {
     grib_accessor_data_g1second_order_general_extended_packing* self = (grib_accessor_data_g1second_order_general_extended_packing*)a;
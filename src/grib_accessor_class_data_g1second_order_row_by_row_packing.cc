@@ -146,6 +146,7 @@ static grib_accessor_class _grib_accessor_class_data_g1second_order_row_by_row_p
     0,     /* unpack a subarray */
     0,                      /* clear */
     0,                 /* clone accessor */
+    0,                 /* reset */
 };
 
 
@@ -9,6 +9,7 @@
  */
 
 #include "grib_api_internal.h"
+#include "grib_value.h"
 
 /*
    This is used by make_class.pl
@@ -16,7 +17,7 @@
    START_CLASS_DEF
    CLASS      = accessor
    SUPER      = grib_accessor_class_data_shsimple_packing
-   IMPLEMENTS = unpack_double
+   IMPLEMENTS = unpack_double;unpack_float
    IMPLEMENTS = value_count
    END_CLASS_DEF
  */
@@ -32,6 +33,7 @@ or edit "accessor.class" and rerun ./make_class.pl
 */
 
 static int unpack_double(grib_accessor*, double* val, size_t* len);
+static int unpack_float(grib_accessor*, float* val, size_t* len);
 static int value_count(grib_accessor*, long*);
 
 typedef struct grib_accessor_data_g1shsimple_packing
@@ -71,7 +73,7 @@ static grib_accessor_class _grib_accessor_class_data_g1shsimple_packing = {
     0,                /* pack_double */
     0,                 /* pack_float */
     &unpack_double,              /* unpack_double */
-    0,               /* unpack_float */
+    &unpack_float,               /* unpack_float */
     0,                /* pack_string */
     0,              /* unpack_string */
     0,          /* pack_string_array */
@@ -93,6 +95,7 @@ static grib_accessor_class _grib_accessor_class_data_g1shsimple_packing = {
     0,     /* unpack a subarray */
     0,                      /* clear */
     0,                 /* clone accessor */
+    0,                 /* reset */
 };
 
 
@@ -114,10 +117,14 @@ static int value_count(grib_accessor* a, long* count)
     return err;
 }
 
-static int unpack_double(grib_accessor* a, double* val, size_t* len)
+template <typename T>
+static int unpack(grib_accessor* a, T* val, size_t* len)
 {
+    static_assert(std::is_floating_point<T>::value, "Requires floating point numbers");
+
     grib_accessor_data_g1shsimple_packing* self = (grib_accessor_data_g1shsimple_packing*)a;
     int err                                     = GRIB_SUCCESS;
+    double real_part                            = 0;
 
     size_t coded_n_vals = 0;
     size_t n_vals       = 0;
@@ -132,12 +139,12 @@ static int unpack_double(grib_accessor* a, double* val, size_t* len)
         return GRIB_ARRAY_TOO_SMALL;
     }
 
-    if ((err = grib_get_double_internal(grib_handle_of_accessor(a), self->real_part, val)) != GRIB_SUCCESS)
+    if ((err = grib_get_double_internal(grib_handle_of_accessor(a), self->real_part, &real_part)) != GRIB_SUCCESS)
         return err;
 
-    val++;
+    *val++ = real_part;
 
-    if ((err = grib_get_double_array_internal(grib_handle_of_accessor(a), self->coded_values, val, &coded_n_vals)) != GRIB_SUCCESS)
+    if ((err = grib_get_array_internal<T>(grib_handle_of_accessor(a), self->coded_values, val, &coded_n_vals)) != GRIB_SUCCESS)
         return err;
 
     grib_context_log(a->context, GRIB_LOG_DEBUG,
@@ -148,3 +155,13 @@ static int unpack_double(grib_accessor* a, double* val, size_t* len)
 
     return err;
 }
+
+static int unpack_double(grib_accessor* a, double* val, size_t* len)
+{
+    return unpack<double>(a, val, len);
+}
+
+static int unpack_float(grib_accessor* a, float* val, size_t* len)
+{
+    return unpack<float>(a, val, len);
+}
@@ -149,6 +149,7 @@ static grib_accessor_class _grib_accessor_class_data_g22order_packing = {
     0,     /* unpack a subarray */
     0,                      /* clear */
     0,                 /* clone accessor */
+    0,                 /* reset */
 };
 
 
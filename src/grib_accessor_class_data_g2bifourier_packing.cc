@@ -17,6 +17,7 @@
 #include "grib_optimize_decimal_factor.h"
 #include <cmath>
 #include <algorithm>
+#include <type_traits>
 
 /*
    This is used by make_class.pl
@@ -25,7 +26,7 @@
    CLASS      = accessor
    SUPER      = grib_accessor_class_data_simple_packing
    IMPLEMENTS = init
-   IMPLEMENTS = unpack_double
+   IMPLEMENTS = unpack_double;unpack_float
    IMPLEMENTS = pack_double
    IMPLEMENTS = value_count
    MEMBERS= const char*  ieee_floats
@@ -57,6 +58,7 @@ or edit "accessor.class" and rerun ./make_class.pl
 
 static int pack_double(grib_accessor*, const double* val, size_t* len);
 static int unpack_double(grib_accessor*, double* val, size_t* len);
+static int unpack_float(grib_accessor*, float* val, size_t* len);
 static int value_count(grib_accessor*, long*);
 static void init(grib_accessor*, const long, grib_arguments*);
 
@@ -123,7 +125,7 @@ static grib_accessor_class _grib_accessor_class_data_g2bifourier_packing = {
     &pack_double,                /* pack_double */
     0,                 /* pack_float */
     &unpack_double,              /* unpack_double */
-    0,               /* unpack_float */
+    &unpack_float,               /* unpack_float */
     0,                /* pack_string */
     0,              /* unpack_string */
     0,          /* pack_string_array */
@@ -145,6 +147,7 @@ static grib_accessor_class _grib_accessor_class_data_g2bifourier_packing = {
     0,     /* unpack a subarray */
     0,                      /* clear */
     0,                 /* clone accessor */
+    0,                 /* reset */
 };
 
 
@@ -607,8 +610,11 @@ cleanup:
     return NULL;
 }
 
-static int unpack_double(grib_accessor* a, double* val, size_t* len)
+template <typename T>
+static int unpack(grib_accessor* a, T* val, size_t* len)
 {
+    static_assert(std::is_floating_point<T>::value, "Requires floating point numbers");
+
     grib_accessor_data_g2bifourier_packing* self = (grib_accessor_data_g2bifourier_packing*)a;
     grib_handle* gh                              = grib_handle_of_accessor(a);
 
@@ -690,7 +696,7 @@ static int unpack_double(grib_accessor* a, double* val, size_t* len)
             for (k = 0; k < 4; k++) {
                 double S     = scals(i, j);
                 long dec_val = grib_decode_unsigned_long(lres, &lpos, bt->bits_per_value);
-                val[isp + k] = (double)(((dec_val * s) + bt->reference_value) * d) / S;
+                val[isp + k] = (T)((((dec_val * s) + bt->reference_value) * d) / S);
             }
 
         isp += 4;
@@ -706,6 +712,16 @@ cleanup:
     return ret;
 }
 
+static int unpack_double(grib_accessor* a, double* val, size_t* len)
+{
+    return unpack<double>(a, val, len);
+}
+
+static int unpack_float(grib_accessor* a, float* val, size_t* len)
+{
+    return unpack<float>(a, val, len);
+}
+
 static int pack_double(grib_accessor* a, const double* val, size_t* len)
 {
     grib_accessor_data_g2bifourier_packing* self = (grib_accessor_data_g2bifourier_packing*)a;
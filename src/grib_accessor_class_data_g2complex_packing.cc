@@ -122,6 +122,7 @@ static grib_accessor_class _grib_accessor_class_data_g2complex_packing = {
     0,     /* unpack a subarray */
     0,                      /* clear */
     0,                 /* clone accessor */
+    0,                 /* reset */
 };
 
 
@@ -9,6 +9,7 @@
  */
 
 #include "grib_api_internal.h"
+#include "grib_value.h"
 
 /*
    This is used by make_class.pl
@@ -17,7 +18,7 @@
    CLASS      = accessor
    SUPER      = grib_accessor_class_data_shsimple_packing
    IMPLEMENTS = init
-   IMPLEMENTS = unpack_double
+   IMPLEMENTS = unpack_double;unpack_float
    IMPLEMENTS = pack_double
    IMPLEMENTS = value_count
    MEMBERS=const char*  numberOfValues
@@ -37,6 +38,7 @@ or edit "accessor.class" and rerun ./make_class.pl
 
 static int pack_double(grib_accessor*, const double* val, size_t* len);
 static int unpack_double(grib_accessor*, double* val, size_t* len);
+static int unpack_float(grib_accessor*, float* val, size_t* len);
 static int value_count(grib_accessor*, long*);
 static void init(grib_accessor*, const long, grib_arguments*);
 
@@ -79,7 +81,7 @@ static grib_accessor_class _grib_accessor_class_data_g2shsimple_packing = {
     &pack_double,                /* pack_double */
     0,                 /* pack_float */
     &unpack_double,              /* unpack_double */
-    0,               /* unpack_float */
+    &unpack_float,               /* unpack_float */
     0,                /* pack_string */
     0,              /* unpack_string */
     0,          /* pack_string_array */
@@ -101,6 +103,7 @@ static grib_accessor_class _grib_accessor_class_data_g2shsimple_packing = {
     0,     /* unpack a subarray */
     0,                      /* clear */
     0,                 /* clone accessor */
+    0,                 /* reset */
 };
 
 
@@ -124,38 +127,54 @@ static int value_count(grib_accessor* a, long* len)
     return grib_get_long(grib_handle_of_accessor(a), self->numberOfValues, len);
 }
 
-static int unpack_double(grib_accessor* a, double* val, size_t* len)
+template <typename T>
+static int unpack(grib_accessor* a, T* val, size_t* len)
 {
+    static_assert(std::is_floating_point<T>::value, "Requires floating point numbers");
+
     grib_accessor_data_g2shsimple_packing* self = (grib_accessor_data_g2shsimple_packing*)a;
     int err                                     = GRIB_SUCCESS;
+    double real_part                            = 0;
 
-    size_t n_vals = 0;
+    size_t coded_n_vals = 0;
+    size_t n_vals       = 0;
 
-    if ((err = grib_get_size(grib_handle_of_accessor(a), self->coded_values, &n_vals)) != GRIB_SUCCESS)
+    if ((err = grib_get_size(grib_handle_of_accessor(a), self->coded_values, &coded_n_vals)) != GRIB_SUCCESS)
         return err;
 
     self->dirty = 0;
 
-    /* n_vals = coded_n_vals+1; */
+    /* The real part comes first */
+    n_vals = coded_n_vals + 1;
 
     if (*len < n_vals) {
         *len = n_vals;
         return GRIB_ARRAY_TOO_SMALL;
     }
 
-    if ((err = grib_get_double_internal(grib_handle_of_accessor(a), self->real_part, val)) != GRIB_SUCCESS)
+    if ((err = grib_get_double_internal(grib_handle_of_accessor(a), self->real_part, &real_part)) != GRIB_SUCCESS)
         return err;
 
-    val++;
+    *val++ = real_part;
 
-    if ((err = grib_get_double_array_internal(grib_handle_of_accessor(a), self->coded_values, val, &n_vals)) != GRIB_SUCCESS)
+    if ((err = grib_get_array_internal<T>(grib_handle_of_accessor(a), self->coded_values, val, &coded_n_vals)) != GRIB_SUCCESS)
         return err;
 
-    *len = n_vals;
+    *len = coded_n_vals + 1;
 
     return err;
 }
 
+static int unpack_double(grib_accessor* a, double* val, size_t* len)
+{
+    return unpack<double>(a, val, len);
+}
+
+static int unpack_float(grib_accessor* a, float* val, size_t* len)
+{
+    return unpack<float>(a, val, len);
+}
+
 static int pack_double(grib_accessor* a, const double* val, size_t* len)
 {
     grib_accessor_data_g2shsimple_packing* self = (grib_accessor_data_g2shsimple_packing*)a;
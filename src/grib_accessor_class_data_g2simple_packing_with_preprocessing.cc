@@ -20,7 +20,7 @@
    SUPER      = grib_accessor_class_data_g2simple_packing
    IMPLEMENTS = init
    IMPLEMENTS = pack_double
-   IMPLEMENTS = unpack_double
+   IMPLEMENTS = unpack_double;unpack_float
    IMPLEMENTS = value_count
    MEMBERS=const char*  pre_processing
    MEMBERS=const char*  pre_processing_parameter
@@ -40,6 +40,7 @@ or edit "accessor.class" and rerun ./make_class.pl
 
 static int pack_double(grib_accessor*, const double* val, size_t* len);
 static int unpack_double(grib_accessor*, double* val, size_t* len);
+static int unpack_float(grib_accessor*, float* val, size_t* len);
 static int value_count(grib_accessor*, long*);
 static void init(grib_accessor*, const long, grib_arguments*);
 
@@ -96,7 +97,7 @@ static grib_accessor_class _grib_accessor_class_data_g2simple_packing_with_prepr
     &pack_double,                /* pack_double */
     0,                 /* pack_float */
     &unpack_double,              /* unpack_double */
-    0,               /* unpack_float */
+    &unpack_float,               /* unpack_float */
     0,                /* pack_string */
     0,              /* unpack_string */
     0,          /* pack_string_array */
@@ -118,6 +119,7 @@ static grib_accessor_class _grib_accessor_class_data_g2simple_packing_with_prepr
     0,     /* unpack a subarray */
     0,                      /* clear */
     0,                 /* clone accessor */
+    0,                 /* reset */
 };
 
 
@@ -253,6 +255,62 @@ static int unpack_double(grib_accessor* a, double* val, size_t* len)
     return err;
 }
 
+static int unpack_float(grib_accessor* a, float* val, size_t* len)
+{
+    grib_accessor_data_g2simple_packing_with_preprocessing* self = (grib_accessor_data_g2simple_packing_with_preprocessing*)a;
+    grib_accessor_class* super  = *(a->cclass->super);
+    grib_accessor_class* super2 = NULL;
+
+    size_t n_vals = 0, i = 0;
+    long nn       = 0;
+    int err       = 0;
+    double* dval  = NULL;
+
+    long pre_processing;
+
+    err    = grib_value_count(a, &nn);
+    n_vals = nn;
+    if (err)
+        return err;
+
+    if (n_vals == 0) {
+        *len = 0;
+        return GRIB_SUCCESS;
+    }
+
+    if ((err = grib_get_long_internal(grib_handle_of_accessor(a), self->pre_processing, &pre_processing)) != GRIB_SUCCESS) {
+        return err;
+    }
+
+    if (pre_processing == 0) {
+        /* Nothing to invert: decode straight to float */
+        self->dirty = 0;
+        Assert(super->super);
+        super2 = *(super->super);
+        err    = super2->unpack_float(a, val, &n_vals); /* GRIB-364 */
+        if (err != GRIB_SUCCESS)
+            return err;
+        *len = (long)n_vals;
+        return err;
+    }
+
+    /* The inverse transform must be applied at full precision before narrowing */
+    if (*len < n_vals)
+        return GRIB_ARRAY_TOO_SMALL;
+    dval = (double*)grib_context_malloc(a->context, n_vals * sizeof(double));
+    if (!dval)
+        return GRIB_OUT_OF_MEMORY;
+    err = unpack_double(a, dval, &n_vals);
+    if (err == GRIB_SUCCESS) {
+        for (i = 0; i < n_vals; i++)
+            val[i] = (float)dval[i];
+        *len = n_vals;
+    }
+    grib_context_free(a->context, dval);
+
+    return err;
+}
+
 static int pack_double(grib_accessor* a, const double* val, size_t* len)
 {
     grib_accessor_data_g2simple_packing_with_preprocessing* self = (grib_accessor_data_g2simple_packing_with_preprocessing*)a;
@@ -10,6 +10,7 @@
 
 #include "grib_scaling.h"
 #include "grib_api_internal.h"
+#include <type_traits>
 
 /*
    This is used by make_class.pl
@@ -134,6 +135,7 @@ static grib_accessor_class _grib_accessor_class_data_jpeg2000_packing = {
     0,     /* unpack a subarray */
     0,                      /* clear */
     0,                 /* clone accessor */
+    0,                 /* reset */
 };
 
 
@@ -215,13 +217,11 @@ static int value_count(grib_accessor* a, long* n_vals)
 #define EXTRA_BUFFER_SIZE 10240
 
 #if HAVE_JPEG
-static int unpack_float(grib_accessor*, float* val, size_t* len)
+template <typename T>
+static int unpack(grib_accessor* a, T* val, size_t* len)
 {
-    return GRIB_NOT_IMPLEMENTED;
-}
+    static_assert(std::is_floating_point<T>::value, "Requires floating point numbers");
 
-static int unpack_double(grib_accessor* a, double* val, size_t* len)
-{
     grib_accessor_data_jpeg2000_packing* self = (grib_accessor_data_jpeg2000_packing*)a;
 
     int err = GRIB_SUCCESS;
@@ -240,6 +240,7 @@ static int unpack_double(grib_accessor* a, double* val, size_t* len)
     long bits_per_value       = 0;
     double units_factor       = 1.0;
     double units_bias         = 0.0;
+    double* coded             = NULL;
 
     n_vals = 0;
     err    = grib_value_count(a, &nn);
@@ -284,40 +285,62 @@ static int unpack_double(grib_accessor* a, double* val, size_t* len)
     buf = (unsigned char*)grib_handle_of_accessor(a)->buffer->data;
     buf += grib_byte_offset(a);
 
+    /* The JPEG decoders hand back the coded integers as doubles. When unpacking
+     * to float they go to a scratch buffer and are scaled straight into val */
+    if (std::is_same<T, double>::value) {
+        coded = (double*)val;
+    }
+    else {
+        coded = (double*)grib_context_malloc(a->context, n_vals * sizeof(double));
+        if (!coded)
+            return GRIB_OUT_OF_MEMORY;
+    }
+
     switch (self->jpeg_lib) {
         case OPENJPEG_LIB:
-            if ((err = grib_openjpeg_decode(a->context, buf, &buflen, val, &n_vals)) != GRIB_SUCCESS)
-                return err;
+            err = grib_openjpeg_decode(a->context, buf, &buflen, coded, &n_vals);
             break;
         case JASPER_LIB:
-            if ((err = grib_jasper_decode(a->context, buf, &buflen, val, &n_vals)) != GRIB_SUCCESS)
-                return err;
+            err = grib_jasper_decode(a->context, buf, &buflen, coded, &n_vals);
             break;
         default:
             grib_context_log(a->context, GRIB_LOG_ERROR, "Unable to unpack. Invalid JPEG library.\n");
-            return GRIB_DECODING_ERROR;
+            err = GRIB_DECODING_ERROR;
     }
 
-    *len = n_vals;
+    if (err == GRIB_SUCCESS) {
+        *len = n_vals;
 
-    for (i = 0; i < n_vals; i++) {
-        val[i] = (val[i] * bscale + reference_value) * dscale;
-    }
-    if (units_factor != 1.0) {
-        if (units_bias != 0.0)
-            for (i = 0; i < n_vals; i++)
-                val[i] = val[i] * units_factor + units_bias;
-        else
-            for (i = 0; i < n_vals; i++)
-                val[i] *= units_factor;
+        for (i = 0; i < n_vals; i++) {
+            double v = (coded[i] * bscale + reference_value) * dscale;
+            if (units_factor != 1.0) {
+                if (units_bias != 0.0)
+                    v = v * units_factor + units_bias;
+                else
+                    v *= units_factor;
+            }
+            else if (units_bias != 0.0)
+                v += units_bias;
+            val[i] = (T)v;
+        }
     }
-    else if (units_bias != 0.0)
-        for (i = 0; i < n_vals; i++)
-            val[i] += units_bias;
+
+    if ((void*)coded != (void*)val)
+        grib_context_free(a->context, coded);
 
     return err;
 }
 
+static int unpack_double(grib_accessor* a, double* val, size_t* len)
+{
+    return unpack<double>(a, val, len);
+}
+
+static int unpack_float(grib_accessor* a, float* val, size_t* len)
+{
+    return unpack<float>(a, val, len);
+}
+
 static int pack_double(grib_accessor* a, const double* cval, size_t* len)
 {
     grib_accessor_data_jpeg2000_packing* self = (grib_accessor_data_jpeg2000_packing*)a;
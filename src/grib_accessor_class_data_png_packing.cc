@@ -10,6 +10,7 @@
 
 #include "grib_scaling.h"
 #include "grib_api_internal.h"
+#include <type_traits>
 #define PNG_ANYBITS
 
 /*
@@ -19,7 +20,7 @@
    CLASS      = accessor
    SUPER      = grib_accessor_class_values
    IMPLEMENTS = init
-   IMPLEMENTS = unpack_double
+   IMPLEMENTS = unpack_double;unpack_float
    IMPLEMENTS = pack_double
    IMPLEMENTS = value_count
    IMPLEMENTS = unpack_double_element;unpack_double_element_set
@@ -50,6 +51,7 @@ or edit "accessor.class" and rerun ./make_class.pl
 
 static int pack_double(grib_accessor*, const double* val, size_t* len);
 static int unpack_double(grib_accessor*, double* val, size_t* len);
+static int unpack_float(grib_accessor*, float* val, size_t* len);
 static int value_count(grib_accessor*, long*);
 static void init(grib_accessor*, const long, grib_arguments*);
 static int unpack_double_element(grib_accessor*, size_t i, double* val);
@@ -104,7 +106,7 @@ static grib_accessor_class _grib_accessor_class_data_png_packing = {
     &pack_double,                /* pack_double */
     0,                 /* pack_float */
     &unpack_double,              /* unpack_double */
-    0,               /* unpack_float */
+    &unpack_float,               /* unpack_float */
     0,                /* pack_string */
     0,              /* unpack_string */
     0,          /* pack_string_array */
@@ -126,6 +128,7 @@ static grib_accessor_class _grib_accessor_class_data_png_packing = {
     0,     /* unpack a subarray */
     0,                      /* clear */
     0,                 /* clone accessor */
+    0,                 /* reset */
 };
 
 
@@ -197,8 +200,11 @@ static void png_flush_callback(png_structp png)
     /* Empty */
 }
 
-static int unpack_double(grib_accessor* a, double* val, size_t* len)
+template <typename T>
+static int unpack(grib_accessor* a, T* val, size_t* len)
 {
+    static_assert(std::is_floating_point<T>::value, "Requires floating point numbers");
+
     grib_accessor_data_png_packing* self = (grib_accessor_data_png_packing*)a;
 
     int err = GRIB_SUCCESS;
@@ -332,7 +338,7 @@ static int unpack_double(grib_accessor* a, double* val, size_t* len)
         long pos      = 0;
         int k;
         for (k = 0; k < width; k++)
-            val[i++] = (double)(((grib_decode_unsigned_long(row, &pos, bits8) * bscale) + reference_value) * dscale);
+            val[i++] = (T)(((grib_decode_unsigned_long(row, &pos, bits8) * bscale) + reference_value) * dscale);
     }
     /*-------------------------------------------*/
     *len = n_vals;
@@ -343,6 +349,16 @@ cleanup:
     return err;
 }
 
+static int unpack_double(grib_accessor* a, double* val, size_t* len)
+{
+    return unpack<double>(a, val, len);
+}
+
+static int unpack_float(grib_accessor* a, float* val, size_t* len)
+{
+    return unpack<float>(a, val, len);
+}
+
 static bool is_constant(const double* values, size_t n_vals)
 {
     bool isConstant = true;
@@ -747,6 +763,11 @@ static int unpack_double(grib_accessor* a, double* val, size_t* len)
     print_error_feature_not_enabled(a->context);
     return GRIB_FUNCTIONALITY_NOT_ENABLED;
 }
+static int unpack_float(grib_accessor* a, float* val, size_t* len)
+{
+    print_error_feature_not_enabled(a->context);
+    return GRIB_FUNCTIONALITY_NOT_ENABLED;
+}
 static int pack_double(grib_accessor* a, const double* val, size_t* len)
 {
     print_error_feature_not_enabled(a->context);
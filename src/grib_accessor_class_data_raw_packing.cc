@@ -12,6 +12,7 @@
  ****************************/
 
 #include "grib_ieeefloat.h"
+#include <type_traits>
 
 #define PRE_PROCESSING_NONE 0
 #define PRE_PROCESSING_DIFFERENCE 1
@@ -22,7 +23,7 @@
    CLASS      = accessor
    SUPER      = grib_accessor_class_values
    IMPLEMENTS = init
-   IMPLEMENTS = unpack_double
+   IMPLEMENTS = unpack_double;unpack_float
    IMPLEMENTS = unpack_double_element;unpack_double_element_set
    IMPLEMENTS = pack_double
    IMPLEMENTS = value_count
@@ -44,6 +45,7 @@ or edit "accessor.class" and rerun ./make_class.pl
 
 static int pack_double(grib_accessor*, const double* val, size_t* len);
 static int unpack_double(grib_accessor*, double* val, size_t* len);
+static int unpack_float(grib_accessor*, float* val, size_t* len);
 static int value_count(grib_accessor*, long*);
 static void init(grib_accessor*, const long, grib_arguments*);
 static int unpack_double_element(grib_accessor*, size_t i, double* val);
@@ -90,7 +92,7 @@ static grib_accessor_class _grib_accessor_class_data_raw_packing = {
     &pack_double,                /* pack_double */
     0,                 /* pack_float */
     &unpack_double,              /* unpack_double */
-    0,               /* unpack_float */
+    &unpack_float,               /* unpack_float */
     0,                /* pack_string */
     0,              /* unpack_string */
     0,          /* pack_string_array */
@@ -112,6 +114,7 @@ static grib_accessor_class _grib_accessor_class_data_raw_packing = {
     0,     /* unpack a subarray */
     0,                      /* clear */
     0,                 /* clone accessor */
+    0,                 /* reset */
 };
 
 
@@ -135,8 +138,11 @@ static int value_count(grib_accessor* a, long* n_vals)
     return grib_get_long_internal(grib_handle_of_accessor(a), self->number_of_values, n_vals);
 }
 
-static int unpack_double(grib_accessor* a, double* val, size_t* len)
+template <typename T>
+static int unpack(grib_accessor* a, T* val, size_t* len)
 {
+    static_assert(std::is_floating_point<T>::value, "Requires floating point numbers");
+
     grib_accessor_data_raw_packing* self = (grib_accessor_data_raw_packing*)a;
     unsigned char* buf                   = NULL;
     int bytes                            = 0;
@@ -172,13 +178,23 @@ static int unpack_double(grib_accessor* a, double* val, size_t* len)
     if (*len < nvals)
         return GRIB_ARRAY_TOO_SMALL;
 
-    code = grib_ieee_decode_array<double>(a->context, buf, nvals, bytes, val);
+    code = grib_ieee_decode_array<T>(a->context, buf, nvals, bytes, val);
 
     *len = nvals;
 
     return code;
 }
 
+static int unpack_double(grib_accessor* a, double* val, size_t* len)
+{
+    return unpack<double>(a, val, len);
+}
+
+static int unpack_float(grib_accessor* a, float* val, size_t* len)
+{
+    return unpack<float>(a, val, len);
+}
+
 static int pack_double(grib_accessor* a, const double* val, size_t* len)
 {
     grib_accessor_data_raw_packing* self = (grib_accessor_data_raw_packing*)a;
@@ -10,6 +10,7 @@
 
 #include "grib_scaling.h"
 #include "grib_api_internal.h"
+#include <type_traits>
 
 /*
    This is used by make_class.pl
@@ -18,7 +19,7 @@
    CLASS      = accessor
    SUPER      = grib_accessor_class_values
    IMPLEMENTS = init
-   IMPLEMENTS = unpack_double
+   IMPLEMENTS = unpack_double;unpack_float
    IMPLEMENTS = pack_double
    IMPLEMENTS = value_count
    MEMBERS=const char*  number_of_values
@@ -43,6 +44,7 @@ or edit "accessor.class" and rerun ./make_class.pl
 
 static int pack_double(grib_accessor*, const double* val, size_t* len);
 static int unpack_double(grib_accessor*, double* val, size_t* len);
+static int unpack_float(grib_accessor*, float* val, size_t* len);
 static int value_count(grib_accessor*, long*);
 static void init(grib_accessor*, const long, grib_arguments*);
 
@@ -91,7 +93,7 @@ static grib_accessor_class _grib_accessor_class_data_run_length_packing = {
     &pack_double,                /* pack_double */
     0,                 /* pack_float */
     &unpack_double,              /* unpack_double */
-    0,               /* unpack_float */
+    &unpack_float,               /* unpack_float */
     0,                /* pack_string */
     0,              /* unpack_string */
     0,          /* pack_string_array */
@@ -113,6 +115,7 @@ static grib_accessor_class _grib_accessor_class_data_run_length_packing = {
     0,     /* unpack a subarray */
     0,                      /* clear */
     0,                 /* clone accessor */
+    0,                 /* reset */
 };
 
 
@@ -140,8 +143,11 @@ static int value_count(grib_accessor* a, long* number_of_values)
     return grib_get_long_internal(grib_handle_of_accessor(a), self->number_of_values, number_of_values);
 }
 
-static int unpack_double(grib_accessor* a, double* val, size_t* len)
+template <typename T>
+static int unpack(grib_accessor* a, T* val, size_t* len)
 {
+    static_assert(std::is_floating_point<T>::value, "Requires floating point numbers");
+
     grib_accessor_data_run_length_packing* self = (grib_accessor_data_run_length_packing*)a;
     grib_handle* gh                             = grib_handle_of_accessor(a);
     const char* cclass_name                     = a->cclass->name;
@@ -153,7 +159,7 @@ static int unpack_double(grib_accessor* a, double* val, size_t* len)
     long v, n, factor, k, j;
     long* compressed_values = NULL;
     double level_scale_factor = 0;
-    double* levels = NULL;
+    T* levels = NULL;
     unsigned char* buf = NULL;
     double missingValue = 9999.0;
 
@@ -197,7 +203,7 @@ static int unpack_double(grib_accessor* a, double* val, size_t* len)
         decimal_scale_factor = -(decimal_scale_factor - 128);
     }
     level_scale_factor = codes_power<double>(-decimal_scale_factor, 10.0);
-    levels = (double*)grib_context_malloc_clear(a->context, sizeof(double) * (number_of_level_values + 1));
+    levels = (T*)grib_context_malloc_clear(a->context, sizeof(T) * (number_of_level_values + 1));
     levels[0] = missingValue;
     for (i = 0; i < number_of_level_values; i++) {
         levels[i + 1] = level_values[i] * level_scale_factor;
@@ -246,6 +252,16 @@ static int unpack_double(grib_accessor* a, double* val, size_t* len)
     return err;
 }
 
+static int unpack_double(grib_accessor* a, double* val, size_t* len)
+{
+    return unpack<double>(a, val, len);
+}
+
+static int unpack_float(grib_accessor* a, float* val, size_t* len)
+{
+    return unpack<float>(a, val, len);
+}
+
 static int pack_double(grib_accessor* a, const double* val, size_t* len)
 {
     grib_accessor_data_run_length_packing* self = (grib_accessor_data_run_length_packing*)a;
@@ -9,6 +9,7 @@
  */
 
 #include "grib_api_internal.h"
+#include "grib_value.h"
 
 /*
    This is used by make_class.pl
@@ -17,7 +18,7 @@
    CLASS      = accessor
    SUPER      = grib_accessor_class_gen
    IMPLEMENTS = init
-   IMPLEMENTS = unpack_double
+   IMPLEMENTS = unpack_double;unpack_float
    IMPLEMENTS = dump;get_native_type
    MEMBERS=const char*  primary_bitmap
    MEMBERS=const char*  secondary_bitmap
@@ -38,6 +39,7 @@ or edit "accessor.class" and rerun ./make_class.pl
 
 static int get_native_type(grib_accessor*);
 static int unpack_double(grib_accessor*, double* val, size_t* len);
+static int unpack_float(grib_accessor*, float* val, size_t* len);
 static void dump(grib_accessor*, grib_dumper*);
 static void init(grib_accessor*, const long, grib_arguments*);
 
@@ -78,7 +80,7 @@ static grib_accessor_class _grib_accessor_class_data_secondary_bitmap = {
     0,                /* pack_double */
     0,                 /* pack_float */
     &unpack_double,              /* unpack_double */
-    0,               /* unpack_float */
+    &unpack_float,               /* unpack_float */
     0,                /* pack_string */
     0,              /* unpack_string */
     0,          /* pack_string_array */
@@ -100,6 +102,7 @@ static grib_accessor_class _grib_accessor_class_data_secondary_bitmap = {
     0,     /* unpack a subarray */
     0,                      /* clear */
     0,                 /* clone accessor */
+    0,                 /* reset */
 };
 
 
@@ -123,8 +126,11 @@ static void dump(grib_accessor* a, grib_dumper* dumper)
     grib_dump_values(dumper, a);
 }
 
-static int unpack_double(grib_accessor* a, double* val, size_t* len)
+template <typename T>
+static int unpack(grib_accessor* a, T* val, size_t* len)
 {
+    static_assert(std::is_floating_point<T>::value, "Requires floating point numbers");
+
     grib_accessor_data_secondary_bitmap* self = (grib_accessor_data_secondary_bitmap*)a;
 
     size_t i       = 0;
@@ -137,8 +143,8 @@ static int unpack_double(grib_accessor* a, double* val, size_t* len)
     int err        = 0;
     size_t primary_len;
     size_t secondary_len;
-    double* primary_vals;
-    double* secondary_vals;
+    T* primary_vals;
+    T* secondary_vals;
     err    = grib_value_count(a, &nn);
     n_vals = nn;
     if (err)
@@ -158,23 +164,23 @@ static int unpack_double(grib_accessor* a, double* val, size_t* len)
     if ((err = grib_get_size(grib_handle_of_accessor(a), self->secondary_bitmap, &secondary_len)) != GRIB_SUCCESS)
         return err;
 
-    primary_vals = (double*)grib_context_malloc(a->context, primary_len * sizeof(double));
+    primary_vals = (T*)grib_context_malloc(a->context, primary_len * sizeof(T));
     if (!primary_vals)
         return GRIB_OUT_OF_MEMORY;
 
-    secondary_vals = (double*)grib_context_malloc(a->context, secondary_len * sizeof(double));
+    secondary_vals = (T*)grib_context_malloc(a->context, secondary_len * sizeof(T));
     if (!secondary_vals) {
         grib_context_free(a->context, primary_vals);
         return GRIB_OUT_OF_MEMORY;
     }
 
-    if ((err = grib_get_double_array_internal(grib_handle_of_accessor(a), self->primary_bitmap, primary_vals, &primary_len)) != GRIB_SUCCESS) {
+    if ((err = grib_get_array_internal<T>(grib_handle_of_accessor(a), self->primary_bitmap, primary_vals, &primary_len)) != GRIB_SUCCESS) {
         grib_context_free(a->context, secondary_vals);
         grib_context_free(a->context, primary_vals);
         return err;
     }
 
-    if ((err = grib_get_double_array_internal(grib_handle_of_accessor(a), self->secondary_bitmap, secondary_vals, &secondary_len)) != GRIB_SUCCESS) {
+    if ((err = grib_get_array_internal<T>(grib_handle_of_accessor(a), self->secondary_bitmap, secondary_vals, &secondary_len)) != GRIB_SUCCESS) {
         grib_context_free(a->context, secondary_vals);
         grib_context_free(a->context, primary_vals);
         return err;
@@ -206,6 +212,16 @@ static int unpack_double(grib_accessor* a, double* val, size_t* len)
     return err;
 }
 
+static int unpack_double(grib_accessor* a, double* val, size_t* len)
+{
+    return unpack<double>(a, val, len);
+}
+
+static int unpack_float(grib_accessor* a, float* val, size_t* len)
+{
+    return unpack<float>(a, val, len);
+}
+
 static int get_native_type(grib_accessor* a)
 {
     // grib_accessor_data_secondary_bitmap* self =  (grib_accessor_data_secondary_bitmap*)a;
@@ -11,13 +11,14 @@
 #include "grib_scaling.h"
 #include "grib_api_internal.h"
 #include <cmath>
+#include <type_traits>
 /*
    This is used by make_class.pl
 
    START_CLASS_DEF
    CLASS      = accessor
    SUPER      = grib_accessor_class_data_simple_packing
-   IMPLEMENTS = unpack_double
+   IMPLEMENTS = unpack_double;unpack_float
    IMPLEMENTS = value_count
    IMPLEMENTS = init
    MEMBERS= const char*  GRIBEX_sh_bug_present
@@ -46,6 +47,7 @@ or edit "accessor.class" and rerun ./make_class.pl
 */
 
 static int unpack_double(grib_accessor*, double* val, size_t* len);
+static int unpack_float(grib_accessor*, float* val, size_t* len);
 static int value_count(grib_accessor*, long*);
 static void init(grib_accessor*, const long, grib_arguments*);
 
@@ -109,7 +111,7 @@ static grib_accessor_class _grib_accessor_class_data_sh_unpacked = {
     0,                /* pack_double */
     0,                 /* pack_float */
     &unpack_double,              /* unpack_double */
-    0,               /* unpack_float */
+    &unpack_float,               /* unpack_float */
     0,                /* pack_string */
     0,              /* unpack_string */
     0,          /* pack_string_array */
@@ -131,6 +133,7 @@ static grib_accessor_class _grib_accessor_class_data_sh_unpacked = {
     0,     /* unpack a subarray */
     0,                      /* clear */
     0,                 /* clone accessor */
+    0,                 /* reset */
 };
 
 
@@ -185,8 +188,11 @@ static int value_count(grib_accessor* a, long* count)
     return ret;
 }
 
-static int unpack_double(grib_accessor* a, double* val, size_t* len)
+template <typename T>
+static int unpack(grib_accessor* a, T* val, size_t* len)
 {
+    static_assert(std::is_floating_point<T>::value, "Requires floating point numbers");
+
     grib_accessor_data_sh_unpacked* self = (grib_accessor_data_sh_unpacked*)a;
 
     size_t i      = 0;
@@ -325,14 +331,16 @@ static int unpack_double(grib_accessor* a, double* val, size_t* len)
         lup = mmax;
         if (sub_k >= 0) {
             for (hcount = 0; hcount < sub_k + 1; hcount++) {
-                val[i++] = decode_float(grib_decode_unsigned_long(hres, &hpos, 8 * bytes));
-                val[i++] = decode_float(grib_decode_unsigned_long(hres, &hpos, 8 * bytes));
+                double re = decode_float(grib_decode_unsigned_long(hres, &hpos, 8 * bytes));
+                double im = decode_float(grib_decode_unsigned_long(hres, &hpos, 8 * bytes));
 
                 if (GRIBEX_sh_bug_present && hcount == sub_k) {
                     /*  bug in ecmwf data, last row (K+1)is scaled but should not */
-                    val[i - 2] *= scals[lup];
-                    val[i - 1] *= scals[lup];
+                    re *= scals[lup];
+                    im *= scals[lup];
                 }
+                val[i++] = re;
+                val[i++] = im;
                 lup++;
             }
             sub_k--;
@@ -359,3 +367,13 @@ static int unpack_double(grib_accessor* a, double* val, size_t* len)
 
     return ret;
 }
+
+static int unpack_double(grib_accessor* a, double* val, size_t* len)
+{
+    return unpack<double>(a, val, len);
+}
+
+static int unpack_float(grib_accessor* a, float* val, size_t* len)
+{
+    return unpack<float>(a, val, len);
+}
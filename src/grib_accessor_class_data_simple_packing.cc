@@ -130,6 +130,7 @@ static grib_accessor_class _grib_accessor_class_data_simple_packing = {
     &unpack_double_subarray,     /* unpack a subarray */
     0,                      /* clear */
     0,                 /* clone accessor */
+    0,                 /* reset */
 };
 
 
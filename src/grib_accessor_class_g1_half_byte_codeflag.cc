@@ -96,6 +96,7 @@ static grib_accessor_class _grib_accessor_class_g1_half_byte_codeflag = {
     0,     /* unpack a subarray */
     0,                      /* clear */
     0,                 /* clone accessor */
+    0,                 /* reset */
 };
 
 
@@ -96,6 +96,7 @@ static grib_accessor_class _grib_accessor_class_g1_message_length = {
     0,     /* unpack a subarray */
     0,                      /* clear */
     0,                 /* clone accessor */
+    0,                 /* reset */
 };
 
 
@@ -121,6 +122,27 @@ int grib_get_g1_message_size(grib_handle* h, grib_accessor* tl, grib_accessor* s
         *sec4_len     = 0;
         off           = tl->offset * 8;
         *total_length = grib_decode_unsigned_long(h->buffer->data, &off, tl->length * 8);
+        if (h->partial && (*total_length & 0x800000)) {
+            /* Headers only: section 4 is not decoded but its length is needed for large GRIBs.
+             * It follows the headers and the bitmap section if any */
+            size_t s4_offset = 0;
+            long flags       = 0;
+            if (grib_get_offset(h, "endOfHeadersMarker", &s4_offset) != GRIB_SUCCESS ||
+                grib_get_long(h, "section1Flags", &flags) != GRIB_SUCCESS)
+                return GRIB_SUCCESS;
+            if ((flags & (1 << 6)) && s4_offset + 3 <= h->buffer->ulength) {
+                off = s4_offset * 8;
+                s4_offset += grib_decode_unsigned_long(h->buffer->data, &off, 24);
+            }
+            if (s4_offset + 3 <= h->buffer->ulength) {
+                off  = s4_offset * 8;
+                slen = grib_decode_unsigned_long(h->buffer->data, &off, 24);
+                if (slen < 120) {
+                    tlen = *total_length & 0x7fffff;
+                    *total_length = tlen * 120 - slen + 4;
+                }
+            }
+        }
         return GRIB_SUCCESS;
     }
 
@@ -18,6 +18,7 @@
    IMPLEMENTS = unpack_double; destroy
    IMPLEMENTS = value_count;compare
    IMPLEMENTS = init
+   IMPLEMENTS = reset
    MEMBERS = const char* verifyingMonth
    END_CLASS_DEF
 
@@ -38,6 +39,7 @@ static int value_count(grib_accessor*, long*);
 static void destroy(grib_context*, grib_accessor*);
 static void init(grib_accessor*, const long, grib_arguments*);
 static int compare(grib_accessor*, grib_accessor*);
+static void reset(grib_accessor*);
 
 typedef struct grib_accessor_g1end_of_interval_monthly
 {
@@ -99,6 +101,7 @@ static grib_accessor_class _grib_accessor_class_g1end_of_interval_monthly = {
     0,     /* unpack a subarray */
     0,                      /* clear */
     0,                 /* clone accessor */
+    &reset,            /* reset */
 };
 
 
@@ -124,6 +127,11 @@ static void init(grib_accessor* a, const long l, grib_arguments* c)
     a->dirty  = 1;
 }
 
+static void reset(grib_accessor* a)
+{
+    a->dirty = 1;
+}
+
 static int unpack_double(grib_accessor* a, double* val, size_t* len)
 {
     grib_accessor_g1end_of_interval_monthly* self = (grib_accessor_g1end_of_interval_monthly*)a;
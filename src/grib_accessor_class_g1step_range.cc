@@ -23,6 +23,7 @@
    IMPLEMENTS = pack_long;unpack_long;dump
    IMPLEMENTS = get_native_type;string_length
    IMPLEMENTS = init; destroy
+   IMPLEMENTS = reset
    MEMBERS    = const char* p1
    MEMBERS    = const char* p2
    MEMBERS    = const char* timeRangeIndicator
@@ -55,6 +56,7 @@ static int value_count(grib_accessor*, long*);
 static void destroy(grib_context*, grib_accessor*);
 static void dump(grib_accessor*, grib_dumper*);
 static void init(grib_accessor*, const long, grib_arguments*);
+static void reset(grib_accessor*);
 
 typedef struct grib_accessor_g1step_range
 {
@@ -123,6 +125,7 @@ static grib_accessor_class _grib_accessor_class_g1step_range = {
     0,     /* unpack a subarray */
     0,                      /* clear */
     0,                 /* clone accessor */
+    &reset,            /* reset */
 };
 
 
@@ -153,6 +156,11 @@ static void init(grib_accessor* a, const long l, grib_arguments* c)
     a->length = 0;
 }
 
+static void reset(grib_accessor* a)
+{
+    a->dirty = 1;
+}
+
 static void dump(grib_accessor* a, grib_dumper* dumper)
 {
     grib_dump_string(dumper, a, NULL);
@@ -121,6 +121,7 @@ static grib_accessor_class _grib_accessor_class_g2_mars_labeling = {
     0,     /* unpack a subarray */
     0,                      /* clear */
     0,                 /* clone accessor */
+    0,                 /* reset */
 };
 
 
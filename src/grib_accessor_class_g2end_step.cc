@@ -132,6 +132,7 @@ static grib_accessor_class _grib_accessor_class_g2end_step = {
     0,     /* unpack a subarray */
     0,                      /* clear */
     0,                 /* clone accessor */
+    0,                 /* reset */
 };
 
 
@@ -137,6 +137,7 @@ static grib_accessor_class _grib_accessor_class_gen = {
     &unpack_double_subarray,     /* unpack a subarray */
     &clear,                      /* clear */
     &make_clone,                 /* clone accessor */
+    0,                           /* reset */
 };
 
 
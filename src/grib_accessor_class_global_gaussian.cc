@@ -114,6 +114,7 @@ static grib_accessor_class _grib_accessor_class_global_gaussian = {
     0,     /* unpack a subarray */
     0,                      /* clear */
     0,                 /* clone accessor */
+    0,                 /* reset */
 };
 
 
@@ -209,7 +210,7 @@ static int unpack_long(grib_accessor* a, long* val, size_t* len)
                          "Key %s (unpack_long): Memory allocation error: %zu bytes", a->name, sizeof(double) * N * 2);
         return GRIB_OUT_OF_MEMORY;
     }
-    if ((ret = grib_get_gaussian_latitudes(N, lats)) != GRIB_SUCCESS)
+    if ((ret = grib_context_get_gaussian_latitudes(c, N, lats)) != GRIB_SUCCESS)
         return ret;
 
     /* GRIB-704: Work out the maximum element in pl array, if present */
@@ -295,7 +296,7 @@ static int pack_long(grib_accessor* a, const long* val, size_t* len)
                          "Key %s (pack_long): Memory allocation error: %zu bytes", a->name, sizeof(double) * N * 2);
         return GRIB_OUT_OF_MEMORY;
     }
-    if ((ret = grib_get_gaussian_latitudes(N, lats)) != GRIB_SUCCESS)
+    if ((ret = grib_context_get_gaussian_latitudes(c, N, lats)) != GRIB_SUCCESS)
         return ret;
 
     if ((ret = grib_get_long_internal(h, self->plpresent, &plpresent)) != GRIB_SUCCESS)
@@ -26,6 +26,7 @@
    IMPLEMENTS = unpack_long;pack_long;destroy
    IMPLEMENTS = init;dump;value_count;get_native_type
    IMPLEMENTS = compare
+   IMPLEMENTS = reset
    MEMBERS = char* key
    MEMBERS = grib_hash_array_value* ha
     END_CLASS_DEF
@@ -55,6 +56,7 @@ static void destroy(grib_context*, grib_accessor*);
 static void dump(grib_accessor*, grib_dumper*);
 static void init(grib_accessor*, const long, grib_arguments*);
 static int compare(grib_accessor*, grib_accessor*);
+static void reset(grib_accessor*);
 
 typedef struct grib_accessor_hash_array
 {
@@ -113,6 +115,7 @@ static grib_accessor_class _grib_accessor_class_hash_array = {
     0,     /* unpack a subarray */
     0,                      /* clear */
     0,                 /* clone accessor */
+    &reset,            /* reset */
 };
 
 
@@ -130,6 +133,12 @@ static void init(grib_accessor* a, const long len, grib_arguments* args)
     self->ha                       = NULL;
 }
 
+static void reset(grib_accessor* a)
+{
+    grib_accessor_hash_array* self = (grib_accessor_hash_array*)a;
+    self->ha                       = NULL;
+}
+
 static void dump(grib_accessor* a, grib_dumper* dumper)
 {
     grib_dump_string(dumper, a, NULL);
@@ -18,6 +18,7 @@
    IMPLEMENTS = unpack_double;
    IMPLEMENTS = value_count
    IMPLEMENTS = init
+   IMPLEMENTS = reset
    MEMBERS =const char* values
    MEMBERS =long distinct
    MEMBERS =double* lats
@@ -40,6 +41,7 @@ or edit "accessor.class" and rerun ./make_class.pl
 static int unpack_double(grib_accessor*, double* val, size_t* len);
 static int value_count(grib_accessor*, long*);
 static void init(grib_accessor*, const long, grib_arguments*);
+static void reset(grib_accessor*);
 
 typedef struct grib_accessor_latitudes
 {
@@ -102,6 +104,7 @@ static grib_accessor_class _grib_accessor_class_latitudes = {
     0,     /* unpack a subarray */
     0,                      /* clear */
     0,                 /* clone accessor */
+    &reset,            /* reset */
 };
 
 
@@ -151,16 +154,24 @@ static void init(grib_accessor* a, const long l, grib_arguments* c)
     a->flags |= GRIB_ACCESSOR_FLAG_READ_ONLY;
 }
 
+static void reset(grib_accessor* a)
+{
+    grib_accessor_latitudes* self = (grib_accessor_latitudes*)a;
+    if (self->lats)
+        grib_context_free(a->context, self->lats);
+    self->lats = NULL;
+    self->size = 0;
+    self->save = 0;
+}
+
 static int unpack_double(grib_accessor* a, double* val, size_t* len)
 {
     grib_context* c               = a->context;
     grib_accessor_latitudes* self = (grib_accessor_latitudes*)a;
     int ret = 0;
-    double* v = val;
-    double dummyLon = 0;
     size_t size = 0;
     long count = 0;
-    grib_iterator* iter = NULL;
+    grib_grid_geometry* g = NULL;
 
     self->save = 1;
     ret = value_count(a, &count);
@@ -188,19 +199,14 @@ static int unpack_double(grib_accessor* a, double* val, size_t* len)
         return GRIB_SUCCESS;
     }
 
-    // ECC-1525 Performance: We do not need the values to be decoded
-    iter = grib_iterator_new(grib_handle_of_accessor(a), GRIB_GEOITERATOR_NO_VALUES, &ret);
-    if (ret != GRIB_SUCCESS) {
-        if (iter)
-            grib_iterator_delete(iter);
+    /* The coordinates are shared by the fields on the same grid */
+    g = grib_grid_geometry_new_from_handle(grib_handle_of_accessor(a), &ret);
+    if (!g) {
         grib_context_log(c, GRIB_LOG_ERROR, "latitudes: Unable to create iterator");
         return ret;
     }
-
-    while (grib_iterator_next(iter, v++, &dummyLon, NULL)) {}
-    grib_iterator_delete(iter);
-
-    *len = size;
+    ret = grib_grid_geometry_get_latlons(g, val, NULL, len);
+    grib_grid_geometry_delete(g);
 
     return ret;
 }
@@ -243,30 +249,32 @@ static int get_distinct(grib_accessor* a, double** val, long* len)
     double prev;
     double* v       = NULL;
     double* v1      = NULL;
-    double dummyLon = 0;
     int ret = 0;
     int i;
     long jScansPositively = 0; /* default: north to south */
     size_t size           = *len;
     grib_context* c       = a->context;
 
-    // Performance: We do not need the values to be decoded
-    grib_iterator* iter   = grib_iterator_new(grib_handle_of_accessor(a), GRIB_GEOITERATOR_NO_VALUES, &ret);
-    if (ret != GRIB_SUCCESS) {
-        if (iter)
-            grib_iterator_delete(iter);
+    /* The coordinates are shared by the fields on the same grid */
+    grib_grid_geometry* g = grib_grid_geometry_new_from_handle(grib_handle_of_accessor(a), &ret);
+    if (!g) {
         grib_context_log(c, GRIB_LOG_ERROR, "latitudes: Unable to create iterator");
         return ret;
     }
     v = (double*)grib_context_malloc_clear(c, size * sizeof(double));
     if (!v) {
         grib_context_log(c, GRIB_LOG_ERROR, "latitudes: Error allocating %zu bytes", size * sizeof(double));
+        grib_grid_geometry_delete(g);
         return GRIB_OUT_OF_MEMORY;
     }
     *val = v;
 
-    while (grib_iterator_next(iter, v++, &dummyLon, NULL)) {}
-    grib_iterator_delete(iter);
+    ret = grib_grid_geometry_get_latlons(g, v, NULL, &size);
+    grib_grid_geometry_delete(g);
+    if (ret != GRIB_SUCCESS) {
+        grib_context_free(c, v);
+        return ret;
+    }
     v = *val;
 
     /* See which direction the latitudes are to be scanned */
@@ -102,6 +102,7 @@ static grib_accessor_class _grib_accessor_class_mars_step = {
     0,     /* unpack a subarray */
     0,                      /* clear */
     0,                 /* clone accessor */
+    0,                 /* reset */
 };
 
 
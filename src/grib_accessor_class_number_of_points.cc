@@ -101,6 +101,7 @@ static grib_accessor_class _grib_accessor_class_number_of_points = {
     0,     /* unpack a subarray */
     0,                      /* clear */
     0,                 /* clone accessor */
+    0,                 /* reset */
 };
 
 
@@ -98,6 +98,7 @@ static grib_accessor_class _grib_accessor_class_offset_values = {
     0,     /* unpack a subarray */
     0,                      /* clear */
     0,                 /* clone accessor */
+    0,                 /* reset */
 };
 
 
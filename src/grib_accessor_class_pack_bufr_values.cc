@@ -104,6 +104,7 @@ static grib_accessor_class _grib_accessor_class_pack_bufr_values = {
     0,     /* unpack a subarray */
     0,                      /* clear */
     0,                 /* clone accessor */
+    0,                 /* reset */
 };
 
 
@@ -23,6 +23,7 @@
    IMPLEMENTS = unpack_long
    IMPLEMENTS = pack_long
    IMPLEMENTS = init
+   IMPLEMENTS = reset
    MEMBERS = const char* values
    MEMBERS = const char* binaryScaleFactor
    MEMBERS = const char* decimalScaleFactor
@@ -43,6 +44,7 @@ or edit "accessor.class" and rerun ./make_class.pl
 static int pack_long(grib_accessor*, const long* val, size_t* len);
 static int unpack_long(grib_accessor*, long* val, size_t* len);
 static void init(grib_accessor*, const long, grib_arguments*);
+static void reset(grib_accessor*);
 
 typedef struct grib_accessor_second_order_bits_per_value
 {
@@ -104,6 +106,7 @@ static grib_accessor_class _grib_accessor_class_second_order_bits_per_value = {
     0,     /* unpack a subarray */
     0,                      /* clear */
     0,                 /* clone accessor */
+    &reset,            /* reset */
 };
 
 
@@ -157,6 +160,13 @@ static void init(grib_accessor* a, const long l, grib_arguments* c)
     a->length = 0;
 }
 
+/* Computed from the values when not packed */
+static void reset(grib_accessor* a)
+{
+    grib_accessor_second_order_bits_per_value* self = (grib_accessor_second_order_bits_per_value*)a;
+    self->bitsPerValue                              = 0;
+}
+
 static int pack_long(grib_accessor* a, const long* val, size_t* len)
 {
     grib_accessor_second_order_bits_per_value* self = (grib_accessor_second_order_bits_per_value*)a;
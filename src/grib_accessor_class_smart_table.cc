@@ -23,6 +23,7 @@
    SUPER      = grib_accessor_class_unsigned
    IMPLEMENTS = init;dump;unpack_string;unpack_long
    IMPLEMENTS = value_count; destroy; get_native_type;
+   IMPLEMENTS = reset
    MEMBERS    =  const char* values
    MEMBERS    =  const char* tablename
    MEMBERS    =  const char* masterDir
@@ -55,6 +56,7 @@ static int value_count(grib_accessor*, long*);
 static void destroy(grib_context*, grib_accessor*);
 static void dump(grib_accessor*, grib_dumper*);
 static void init(grib_accessor*, const long, grib_arguments*);
+static void reset(grib_accessor*);
 
 typedef struct grib_accessor_smart_table
 {
@@ -126,6 +128,7 @@ static grib_accessor_class _grib_accessor_class_smart_table = {
     0,     /* unpack a subarray */
     0,                      /* clear */
     0,                 /* clone accessor */
+    &reset,            /* reset */
 };
 
 
@@ -184,6 +187,17 @@ static void init(grib_accessor* a, const long len, grib_arguments* params)
     self->tableCodes     = 0;
 }
 
+static void reset(grib_accessor* a)
+{
+    grib_accessor_smart_table* self = (grib_accessor_smart_table*)a;
+    if (self->tableCodes)
+        grib_context_free(a->context, self->tableCodes);
+    self->tableCodes     = NULL;
+    self->tableCodesSize = 0;
+    self->table          = NULL;
+    self->dirty          = 1;
+}
+
 static grib_smart_table* load_table(grib_accessor* a)
 {
     grib_accessor_smart_table* self = (grib_accessor_smart_table*)a;
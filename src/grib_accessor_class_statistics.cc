@@ -24,6 +24,7 @@
    IMPLEMENTS = unpack_string
    IMPLEMENTS = value_count;compare
    IMPLEMENTS = init
+   IMPLEMENTS = reset
    MEMBERS = const char* values
    MEMBERS = const char* missing_value
    END_CLASS_DEF
@@ -46,6 +47,7 @@ static int value_count(grib_accessor*, long*);
 static void destroy(grib_context*, grib_accessor*);
 static void init(grib_accessor*, const long, grib_arguments*);
 static int compare(grib_accessor*, grib_accessor*);
+static void reset(grib_accessor*);
 
 typedef struct grib_accessor_statistics
 {
@@ -108,6 +110,7 @@ static grib_accessor_class _grib_accessor_class_statistics = {
     0,     /* unpack a subarray */
     0,                      /* clear */
     0,                 /* clone accessor */
+    &reset,            /* reset */
 };
 
 
@@ -134,6 +137,11 @@ static void init(grib_accessor* a, const long l, grib_arguments* c)
     a->dirty  = 1;
 }
 
+static void reset(grib_accessor* a)
+{
+    a->dirty = 1;
+}
+
 static int unpack_double(grib_accessor* a, double* val, size_t* len)
 {
     grib_accessor_statistics* self = (grib_accessor_statistics*)a;
@@ -23,6 +23,7 @@
    IMPLEMENTS = unpack_double; destroy
    IMPLEMENTS = value_count;compare
    IMPLEMENTS = init
+   IMPLEMENTS = reset
    MEMBERS = const char* values
    MEMBERS = const char* J
    MEMBERS = const char* K
@@ -47,6 +48,7 @@ static int value_count(grib_accessor*, long*);
 static void destroy(grib_context*, grib_accessor*);
 static void init(grib_accessor*, const long, grib_arguments*);
 static int compare(grib_accessor*, grib_accessor*);
+static void reset(grib_accessor*);
 
 typedef struct grib_accessor_statistics_spectral
 {
@@ -112,6 +114,7 @@ static grib_accessor_class _grib_accessor_class_statistics_spectral = {
     0,     /* unpack a subarray */
     0,                      /* clear */
     0,                 /* clone accessor */
+    &reset,            /* reset */
 };
 
 
@@ -141,6 +144,11 @@ static void init(grib_accessor* a, const long l, grib_arguments* c)
     a->dirty  = 1;
 }
 
+static void reset(grib_accessor* a)
+{
+    a->dirty = 1;
+}
+
 static int unpack_double(grib_accessor* a, double* val, size_t* len)
 {
     grib_accessor_statistics_spectral* self = (grib_accessor_statistics_spectral*)a;
@@ -111,6 +111,7 @@ static grib_accessor_class _grib_accessor_class_to_double = {
     0,     /* unpack a subarray */
     0,                      /* clear */
     0,                 /* clone accessor */
+    0,                 /* reset */
 };
 
 
@@ -92,6 +92,7 @@ static grib_accessor_class _grib_accessor_class_uint16 = {
     0,     /* unpack a subarray */
     0,                      /* clear */
     0,                 /* clone accessor */
+    0,                 /* reset */
 };
 
 
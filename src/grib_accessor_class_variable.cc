@@ -119,6 +119,7 @@ static grib_accessor_class _grib_accessor_class_variable = {
     0,     /* unpack a subarray */
     0,                      /* clear */
     &make_clone,                 /* clone accessor */
+    0,                           /* reset */
 };
 
 
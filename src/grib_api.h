@@ -204,6 +204,11 @@ typedef struct grib_iterator grib_iterator;
 */
 typedef struct grib_nearest grib_nearest;
 
+/*! Grib grid geometry, the coordinates of the points of a grid, shared by the messages on the same grid.
+    \ingroup grib_iterator
+*/
+typedef struct grib_grid_geometry grib_grid_geometry;
+
 /*! Grib keys iterator. Iterator over keys.
     \ingroup keys_iterator
 */
@@ -274,6 +279,7 @@ grib_index* grib_index_new(grib_context* c, const char* keys, int* err);
 /* EXPERIMENTAL */
 int codes_index_set_product_kind(grib_index* index, ProductKind product_kind);
 int codes_index_set_unpack_bufr(grib_index* index, int unpack);
+int codes_index_set_num_threads(grib_index* index, int num_threads);
 
 
 /**
@@ -727,6 +733,81 @@ int grib_nearest_find_multiple(const grib_handle* h, int is_lsm,
                                double* outlats, double* outlons,
                                double* values, double* distances, int* indexes);
 
+/**
+ * Find the nearest point of each of a batch of points whose latitudes and longitudes
+ * are given in the inlats, inlons arrays respectively, on any grid with a geoiterator.
+ * The nearest point is searched in a spatial index of the points of the grid, built
+ * the first time the grid is searched and shared by the messages on the same grid
+ * (same edition and md5GridSection), so searching many points on many fields costs
+ * little more than reading the values.
+ * values, distances, indexes (in the "values" array) for the nearest points are returned.
+ * The distances are given in kilometres.
+ *
+ * @param h           : handle from which geography and data values are taken
+ * @param inlats      : latitudes of the points to search for
+ * @param inlons      : longitudes of the points to search for
+ * @param npoints     : number of points (size of the inlats,inlons,outlats,outlons,values,distances,indexes arrays)
+ * @param outlats     : returned array of latitudes of the nearest points
+ * @param outlons     : returned array of longitudes of the nearest points
+ * @param values      : returned array of data values of the nearest points, can be NULL to skip decoding the data
+ * @param distances   : returned array of distances from the nearest points
+ * @param indexes     : returned array of indexes of the nearest points
+ * @return            0 if OK, integer value on error
+ */
+int grib_nearest_find_batch(const grib_handle* h,
+                            const double* inlats, const double* inlons, size_t npoints,
+                            double* outlats, double* outlons,
+                            double* values, double* distances, int* indexes);
+
+/**
+ * Get the geometry of the grid of a message: the latitudes and longitudes of its points,
+ * in the order of the geoiterator. They are computed once per grid and shared by the
+ * messages on the same grid (same edition and md5GridSection), in the context of the handle.
+ * The geometry must be deleted with grib_grid_geometry_delete.
+ *
+ * @param h           : the handle whose grid is taken
+ * @param error       : error code
+ * @return            the geometry, NULL on error
+ */
+grib_grid_geometry* grib_grid_geometry_new_from_handle(const grib_handle* h, int* error);
+
+/**
+ * Get the number of points of a grid geometry
+ *
+ * @param g           : the geometry
+ * @param size        : the address of a size_t where the number of points will be set
+ * @return            0 if OK, integer value on error
+ */
+int grib_grid_geometry_get_size(const grib_grid_geometry* g, size_t* size);
+
+/**
+ * Get the latitudes and longitudes of the points of a grid geometry
+ *
+ * @param g           : the geometry
+ * @param lats        : returned array of latitudes, can be NULL
+ * @param lons        : returned array of longitudes, can be NULL
+ * @param size        : the size of the arrays, set to the number of points
+ * @return            0 if OK, integer value on error
+ */
+int grib_grid_geometry_get_latlons(const grib_grid_geometry* g, double* lats, double* lons, size_t* size);
+
+/**
+ * Tell whether two grid geometries are the same grid
+ *
+ * @param g1          : a geometry
+ * @param g2          : another geometry
+ * @return            1 if the grids are the same, 0 if not
+ */
+int grib_grid_geometry_equal(const grib_grid_geometry* g1, const grib_grid_geometry* g2);
+
+/**
+ * Delete a grid geometry. The coordinates stay in the context for the next messages on the grid.
+ *
+ * @param g           : the geometry to be deleted
+ * @return            0 if OK, integer value on error
+ */
+int grib_grid_geometry_delete(grib_grid_geometry* g);
+
 /* @} */
 
 /*! \defgroup get_set Accessing header and data values   */
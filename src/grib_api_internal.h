@@ -160,6 +160,23 @@ extern int pthread_mutexattr_settype(pthread_mutexattr_t* attr, int type);
 #endif
 #endif
 
+/* Publication of the read-mostly structures of the context (tries, caches of tables, concepts
+ * and definition files), which are searched without taking their lock: a writer holds the lock,
+ * completes a new object then makes it reachable with GRIB_ATOMIC_STORE. Readers follow the
+ * links with GRIB_ATOMIC_LOAD, so they see either nothing or the complete object.
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#define GRIB_ATOMIC_LOAD(a) __atomic_load_n(&(a), __ATOMIC_ACQUIRE)
+#define GRIB_ATOMIC_STORE(a, v) __atomic_store_n(&(a), (v), __ATOMIC_RELEASE)
+#elif defined(_MSC_VER)
+/* With /volatile:ms, the default on x86 and x64, volatile loads acquire and stores release */
+#define GRIB_ATOMIC_LOAD(a) (*(const volatile decltype(a)*)&(a))
+#define GRIB_ATOMIC_STORE(a, v) (*(volatile decltype(a)*)&(a) = (v))
+#else
+#define GRIB_ATOMIC_LOAD(a) (a)
+#define GRIB_ATOMIC_STORE(a, v) ((a) = (v))
+#endif
+
 
 #ifndef HAVE_FSEEKO
 #define fseeko fseek
@@ -252,6 +269,7 @@ typedef struct grib_action_file grib_action_file;
 typedef struct grib_action_file_list grib_action_file_list;
 typedef struct grib_block_of_accessors grib_block_of_accessors;
 typedef struct grib_buffer grib_buffer;
+typedef struct grib_mmap_file grib_mmap_file;
 typedef struct grib_accessor_class grib_accessor_class;
 typedef struct grib_action grib_action;
 typedef struct grib_action_class grib_action_class;
@@ -263,6 +281,12 @@ typedef struct grib_smart_table grib_smart_table;
 typedef struct grib_accessor grib_accessor;
 typedef struct grib_iterator_class grib_iterator_class;
 typedef struct grib_nearest_class grib_nearest_class;
+typedef struct grib_nearest_index grib_nearest_index;
+typedef struct grib_gaussian_latitudes grib_gaussian_latitudes;
+typedef struct grib_definitions_cache grib_definitions_cache;
+typedef struct grib_arena grib_arena;
+typedef struct grib_arena_chunk grib_arena_chunk;
+typedef struct grib_handle_layout grib_handle_layout;
 typedef struct grib_dumper grib_dumper;
 typedef struct grib_dumper_class grib_dumper_class;
 typedef struct grib_dependency grib_dependency;
@@ -329,6 +353,7 @@ typedef int (*accessor_pack_bytes_proc)(grib_accessor*, const unsigned char*, si
 typedef int (*accessor_pack_expression_proc)(grib_accessor*, grib_expression*);
 typedef int (*accessor_clear_proc)(grib_accessor*);
 typedef grib_accessor* (*accessor_clone_proc)(grib_accessor*, grib_section*, int*);
+typedef void (*accessor_reset_proc)(grib_accessor*);
 
 typedef void (*accessor_init_class_proc)(grib_accessor_class*);
 
@@ -557,6 +582,8 @@ struct grib_accessor
 #define GRIB_ACCESSOR_FLAG_LOWERCASE        (1 << 17)
 #define GRIB_ACCESSOR_FLAG_BUFR_COORD       (1 << 18)
 #define GRIB_ACCESSOR_FLAG_COPY_IF_CHANGING_EDITION (1 << 19)
+/* BUFR data element whose standard attributes are created when first needed */
+#define GRIB_ACCESSOR_FLAG_LAZY_ATTRIBUTES  (1 << 20)
 
 /**
 *  a section accessor
@@ -661,6 +688,19 @@ struct grib_iterator
     unsigned long flags;
 };
 
+/* The coordinates of the points of a grid, in the order of the geoiterator */
+struct grib_grid_geometry
+{
+    grib_context* context;
+    char* fingerprint;   /* edition:md5GridSection, NULL when not cached */
+    size_t count;        /* Number of points */
+    double* lats;
+    double* lons;
+    grib_nearest_index* nearest_index; /* Built by the first batched nearest search */
+    int refcount;        /* Users, plus one while in the cache */
+    grib_grid_geometry* next;
+};
+
 struct grib_nearest
 {
     grib_arguments* args; /**  args of iterator   */
@@ -857,6 +897,9 @@ struct grib_handle
     char* section_length[MAX_NUM_SECTIONS];
     int sections_count;
     off_t offset;
+    grib_mmap_file* mmap_file; /** Mapped file holding the message, if any */
+    grib_arena* arena;         /** Accessors, sections and dependencies of the handle */
+    grib_handle_layout* layout; /** Values read to build the accessors, to reuse them */
     /* grib_accessor* groups[MAX_NUM_GROUPS]; */
     ProductKind product_kind;
     /* grib_trie* bufr_elements_table; */
@@ -935,6 +978,7 @@ struct grib_accessor_class
     accessor_unpack_double_subarray_proc unpack_double_subarray;
     accessor_clear_proc clear;
     accessor_clone_proc make_clone;
+    accessor_reset_proc reset;
 };
 
 typedef struct grib_multi_support grib_multi_support;
@@ -985,6 +1029,7 @@ struct grib_concept_value_name
 };
 
 typedef struct grib_concept_value grib_concept_value;
+typedef struct grib_concept_index grib_concept_index;
 
 struct grib_concept_value
 {
@@ -992,6 +1037,7 @@ struct grib_concept_value
     char* name;
     grib_concept_condition* conditions;
     grib_trie* index;
+    grib_concept_index* conditions_index; /* On the first entry, to find the entries matching a handle */
 };
 
 /* ----------*/
@@ -1067,6 +1113,14 @@ struct grib_context
     grib_trie* lists;
     grib_trie* expanded_descriptors;
     int file_pool_max_opened_files;
+    grib_grid_geometry* grid_geometries; /* Coordinates of the last grids, shared by the fields on them */
+    grib_gaussian_latitudes* gaussian_latitudes; /* Latitudes of the last Gaussian grids, by N */
+    grib_definitions_cache* definitions_cache;   /* Compiled concept and hash array files */
+    grib_arena_chunk* arena_chunks;              /* Chunks of the deleted handles, for the next ones */
+    size_t arena_chunks_count;
+    int handle_skeletons_max;                    /* Deleted GRIB handles kept to build the next ones */
+    grib_handle* handle_skeletons;
+    size_t handle_skeletons_count;
 #if GRIB_PTHREADS
     pthread_mutex_t mutex;
 #elif GRIB_OMP_THREADS
@@ -1174,6 +1228,8 @@ struct grib_where
 {
     grib_context* context;
     char* string;
+    grib_expression* expression; /* Compiled from 'string' and evaluated on the columns */
+    long row;                    /* Row of the columns the expression is evaluated on */
 };
 
 struct grib_column
@@ -1239,40 +1295,36 @@ struct grib_fieldset
 
 /* concept index structures */
 
-typedef struct grib_concept_index_key grib_concept_index_key;
-typedef struct grib_concept_index grib_concept_index;
-typedef struct grib_conditions_tree grib_conditions_tree;
-typedef struct grib_concept_entry grib_concept_entry;
-typedef struct grib_concept_key grib_concept_key;
+typedef struct grib_concept_index_node grib_concept_index_node;
+typedef struct grib_concept_index_bucket grib_concept_index_bucket;
 
-struct grib_concept_index_entry
+/* Entries of a concept with the same constant value for the key of a node */
+struct grib_concept_index_bucket
 {
-    char* name;
-    char* value;
-    int type;
-    grib_concept_entry* next;
+    long lval;
+    char* sval;
+    grib_concept_index_node* node;
 };
 
-struct grib_concept_index_key
+/* A leaf lists entries, by their position in the concept. Other nodes split the
+ * entries on the value of a key: the entries with no constant condition on the
+ * key are in others */
+struct grib_concept_index_node
 {
-    char* name;
+    char* key;
     int type;
-    grib_concept_key* next;
+    grib_concept_index_bucket* buckets; /* Hash table of size mask+1 */
+    size_t mask;
+    grib_concept_index_node* others;
+    size_t* entries;
+    size_t count;
 };
 
 struct grib_concept_index
 {
-    grib_context* context;
-    grib_concept_key* keys;
-    grib_conditions_tree* conditions;
-};
-
-struct grib_conditions_tree
-{
-    char* value;
-    void* object;
-    grib_conditions_tree* next;
-    grib_conditions_tree* next_key;
+    grib_concept_value** values; /* The entries of the concept in order */
+    size_t count;
+    grib_concept_index_node* root;
 };
 
 /* support for in-memory definition and tables */
@@ -1315,6 +1367,8 @@ struct grib_field_list
     grib_field_list* next;
 };
 
+typedef struct grib_index_flat grib_index_flat;
+typedef struct grib_index_hash grib_index_hash;
 
 struct grib_index
 {
@@ -1330,6 +1384,9 @@ struct grib_index
     int count;
     ProductKind product_kind;
     int unpack_bufr; /* Only meaningful for product_kind of BUFR */
+    int num_threads; /* Worker threads used to extract the keys when adding files */
+    grib_index_flat* flat; /* Index file in the flat format (v2) queried in place, instead of 'fields' */
+    grib_index_hash* hash; /* Lookup of the key values and field tree nodes, built when first needed */
 };
 
 /* header compute */
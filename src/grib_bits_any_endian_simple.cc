@@ -199,14 +199,21 @@ int grib_encode_double_array(size_t n_vals, const double* val, long bits_per_val
     unsigned char* encoded     = p;
     double x;
     if (bits_per_value % 8) {
-        for (i = 0; i < n_vals; i++) {
+        if ((*off & 7) == 0) {
+            i = grib_encode_double_array_simd(grib_bits_simd_level(), n_vals, val, bits_per_value, reference_value, d, divisor, encoded + *off / 8);
+            *off += i * bits_per_value;
+        }
+        for (; i < n_vals; i++) {
             x            = (((val[i] * d) - reference_value) * divisor) + 0.5;
             unsigned_val = (unsigned long)x;
             grib_encode_unsigned_longb(encoded, unsigned_val, off, bits_per_value);
         }
     }
     else {
-        for (i = 0; i < n_vals; i++) {
+        i = grib_encode_double_array_simd(grib_bits_simd_level(), n_vals, val, bits_per_value, reference_value, d, divisor, encoded);
+        encoded += i * (bits_per_value / 8);
+        *off += i * bits_per_value;
+        for (; i < n_vals; i++) {
             int blen     = 0;
             blen         = bits_per_value;
             x            = ((((val[i] * d) - reference_value) * divisor) + 0.5);
@@ -11,6 +11,7 @@
 #pragma once
 
 #include "grib_api_internal.h"
+#include "grib_bits_simd.h"
 
 /* A mask with x least-significant bits set, possibly 0 or >=32 */
 /* -1UL is 1111111... in every bit in binary representation */
@@ -47,7 +48,9 @@ int grib_decode_array(const unsigned char* p, long* bitp, long bitsPerValue,
         int l    = bitsPerValue / 8;
         size_t o = 0;
 
-        for (i = 0; i < n_vals; i++) {
+        i = grib_decode_array_simd(grib_bits_simd_level(), p, bitsPerValue, reference_value, s, d, n_vals, val);
+        o = i * l;
+        for (; i < n_vals; i++) {
             lvalue = 0;
             lvalue <<= 8;
             lvalue |= p[o++];
@@ -64,13 +67,19 @@ int grib_decode_array(const unsigned char* p, long* bitp, long bitsPerValue,
     else {
         unsigned long mask = BIT_MASK1(bitsPerValue);
 
+        if ((*bitp & 7) == 0) {
+            /* Byte-aligned start: the SIMD kernels (if any) take the bulk of the values */
+            i = grib_decode_array_simd(grib_bits_simd_level(), p + *bitp / 8, bitsPerValue, reference_value, s, d, n_vals, val);
+            *bitp += i * bitsPerValue;
+        }
+
         /* pi: position of bitp in p[]. >>3 == /8 */
         long pi = *bitp / 8;
         /* some bits might of the current byte at pi might be used */
         /* by the previous number usefulBitsInByte gives remaining unused bits */
         /* number of useful bits in current byte */
         int usefulBitsInByte = 8 - (*bitp & 7);
-        for (i = 0; i < n_vals; i++) {
+        for (; i < n_vals; i++) {
             /* value read as long */
             long bitsToRead = 0;
             lvalue          = 0;
@@ -0,0 +1,321 @@
+/*
+ * (C) Copyright 2005- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities granted to it by
+ * virtue of its status as an intergovernmental organisation nor does it submit to any jurisdiction.
+ */
+
+/*
+ * AVX2 and AVX-512 kernels for simple packing. The kernels are compiled with function
+ * target attributes so no special compiler flags are needed, and the instruction set is
+ * chosen at runtime from the CPU features. Results are bit-identical to the scalar code in
+ * grib_bits_any_endian_simple: the same sequence of double operations is used (no FMA) and
+ * conversions round/truncate the same way.
+ */
+
+#include "grib_bits_simd.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__)) && !defined(ECCODES_ON_WINDOWS)
+#define GRIB_SIMD_X86 1
+#include <immintrin.h>
+#else
+#define GRIB_SIMD_X86 0
+#endif
+
+static int simd_level_detect()
+{
+    const char* no_simd = codes_getenv("ECCODES_GRIB_NO_SIMD");
+    if (no_simd && atoi(no_simd) != 0)
+        return GRIB_SIMD_NONE;
+#if GRIB_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+        return GRIB_SIMD_AVX512;
+    if (__builtin_cpu_supports("avx2"))
+        return GRIB_SIMD_AVX2;
+#endif
+    return GRIB_SIMD_NONE;
+}
+
+int grib_bits_simd_level(void)
+{
+    static const int level = simd_level_detect();
+    return level;
+}
+
+#if GRIB_SIMD_X86
+
+#define SIMD_AVX2   __attribute__((target("avx2")))
+#define SIMD_AVX512 __attribute__((target("avx2,avx512f")))
+
+/* Embedded rounding stops the compiler from contracting mul/add pairs into FMAs */
+#define ROUND_NEAREST (_MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)
+
+/* Number of bytes read from the stream to unpack four values */
+static constexpr size_t unpack4_width(int bpv)
+{
+    return bpv == 8 ? 4 : (bpv <= 16 ? 8 : 16);
+}
+
+/* Unpack four big-endian values of BPV bits into four 32-bit lanes */
+template <int BPV>
+SIMD_AVX2 static inline __m128i unpack4(const unsigned char* q)
+{
+    if constexpr (BPV == 8) {
+        int32_t w;
+        memcpy(&w, q, sizeof(w));
+        return _mm_cvtepu8_epi32(_mm_cvtsi32_si128(w));
+    }
+    else if constexpr (BPV == 12) {
+        /* Three bytes hold two values: gather the two bytes spanning each value, then shift */
+        __m128i b = _mm_loadl_epi64((const __m128i*)q);
+        b         = _mm_shuffle_epi8(b, _mm_setr_epi8(1, 0, -1, -1, 2, 1, -1, -1, 4, 3, -1, -1, 5, 4, -1, -1));
+        b         = _mm_srlv_epi32(b, _mm_setr_epi32(4, 0, 4, 0));
+        return _mm_and_si128(b, _mm_set1_epi32(0xFFF));
+    }
+    else if constexpr (BPV == 16) {
+        const __m128i b = _mm_loadl_epi64((const __m128i*)q);
+        return _mm_shuffle_epi8(b, _mm_setr_epi8(1, 0, -1, -1, 3, 2, -1, -1, 5, 4, -1, -1, 7, 6, -1, -1));
+    }
+    else if constexpr (BPV == 24) {
+        const __m128i b = _mm_loadu_si128((const __m128i*)q);
+        return _mm_shuffle_epi8(b, _mm_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1));
+    }
+    else {
+        static_assert(BPV == 32, "unsupported bitsPerValue");
+        const __m128i b = _mm_loadu_si128((const __m128i*)q);
+        return _mm_shuffle_epi8(b, _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12));
+    }
+}
+
+/* Pack four 32-bit lanes (already reduced to BPV bits) as big-endian values, writing exactly BPV/2 bytes */
+template <int BPV>
+SIMD_AVX2 static inline void pack4(__m128i u, unsigned char* out)
+{
+    unsigned char tmp[16];
+    if constexpr (BPV == 8) {
+        const int32_t w = _mm_cvtsi128_si32(_mm_shuffle_epi8(u, _mm_setr_epi8(0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1)));
+        memcpy(out, &w, sizeof(w));
+    }
+    else if constexpr (BPV == 12) {
+        /* Join each pair of values into a 24-bit word, then write its three bytes */
+        const __m128i even = _mm_and_si128(u, _mm_setr_epi32(-1, 0, -1, 0));
+        const __m128i pair = _mm_or_si128(_mm_slli_epi64(even, 12), _mm_srli_epi64(u, 32));
+        _mm_storeu_si128((__m128i*)tmp, _mm_shuffle_epi8(pair, _mm_setr_epi8(2, 1, 0, 10, 9, 8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1)));
+        memcpy(out, tmp, 6);
+    }
+    else if constexpr (BPV == 16) {
+        _mm_storel_epi64((__m128i*)out, _mm_shuffle_epi8(u, _mm_setr_epi8(1, 0, 5, 4, 9, 8, 13, 12, -1, -1, -1, -1, -1, -1, -1, -1)));
+    }
+    else if constexpr (BPV == 24) {
+        _mm_storeu_si128((__m128i*)tmp, _mm_shuffle_epi8(u, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1)));
+        memcpy(out, tmp, 12);
+    }
+    else {
+        static_assert(BPV == 32, "unsupported bitsPerValue");
+        _mm_storeu_si128((__m128i*)out, _mm_shuffle_epi8(u, _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12)));
+    }
+}
+
+SIMD_AVX2 static inline void store4(double* out, __m256d x)
+{
+    _mm256_storeu_pd(out, x);
+}
+
+SIMD_AVX2 static inline void store4(float* out, __m256d x)
+{
+    _mm_storeu_ps(out, _mm256_cvtpd_ps(x));
+}
+
+SIMD_AVX512 static inline void store8(double* out, __m512d x)
+{
+    _mm512_storeu_pd(out, x);
+}
+
+SIMD_AVX512 static inline void store8(float* out, __m512d x)
+{
+    _mm256_storeu_ps(out, _mm512_cvtpd_ps(x));
+}
+
+template <int BPV, typename T>
+SIMD_AVX2 static size_t decode_avx2(const unsigned char* p, size_t nbytes,
+                                    double reference_value, double s, double d,
+                                    size_t n_vals, T* val)
+{
+    const __m256d vs = _mm256_set1_pd(s);
+    const __m256d vr = _mm256_set1_pd(reference_value);
+    const __m256d vd = _mm256_set1_pd(d);
+    size_t i = 0, o = 0;
+
+    for (; i + 4 <= n_vals && o + unpack4_width(BPV) <= nbytes; i += 4, o += BPV / 2) {
+        const __m128i u = unpack4<BPV>(p + o);
+        __m256d x;
+        if constexpr (BPV == 32) {
+            /* No unsigned 32-bit conversion before AVX-512: bias into the signed range and back */
+            x = _mm256_cvtepi32_pd(_mm_xor_si128(u, _mm_set1_epi32(INT32_MIN)));
+            x = _mm256_add_pd(x, _mm256_set1_pd(2147483648.0));
+        }
+        else {
+            x = _mm256_cvtepi32_pd(u);
+        }
+        x = _mm256_mul_pd(_mm256_add_pd(_mm256_mul_pd(x, vs), vr), vd);
+        store4(val + i, x);
+    }
+    return i;
+}
+
+template <int BPV, typename T>
+SIMD_AVX512 static size_t decode_avx512(const unsigned char* p, size_t nbytes,
+                                        double reference_value, double s, double d,
+                                        size_t n_vals, T* val)
+{
+    const __m512d vs = _mm512_set1_pd(s);
+    const __m512d vr = _mm512_set1_pd(reference_value);
+    const __m512d vd = _mm512_set1_pd(d);
+    size_t i = 0, o = 0;
+
+    for (; i + 8 <= n_vals && o + BPV / 2 + unpack4_width(BPV) <= nbytes; i += 8, o += BPV) {
+        const __m256i u = _mm256_inserti128_si256(_mm256_castsi128_si256(unpack4<BPV>(p + o)),
+                                                  unpack4<BPV>(p + o + BPV / 2), 1);
+        __m512d x = _mm512_cvtepu32_pd(u);
+        x = _mm512_mul_round_pd(_mm512_add_round_pd(_mm512_mul_round_pd(x, vs, ROUND_NEAREST), vr, ROUND_NEAREST), vd, ROUND_NEAREST);
+        store8(val + i, x);
+    }
+    /* Finish with the narrower kernel, which may get closer to the end of the stream */
+    return i + decode_avx2<BPV>(p + o, nbytes - o, reference_value, s, d, n_vals - i, val + i);
+}
+
+template <int BPV>
+SIMD_AVX2 static size_t encode_avx2(size_t n_vals, const double* val,
+                                    double reference_value, double d, double divisor,
+                                    unsigned char* p)
+{
+    const __m256d vd    = _mm256_set1_pd(d);
+    const __m256d vr    = _mm256_set1_pd(reference_value);
+    const __m256d vdiv  = _mm256_set1_pd(divisor);
+    const __m256d half  = _mm256_set1_pd(0.5);
+    const __m256d zero  = _mm256_setzero_pd();
+    const __m256d two31 = _mm256_set1_pd(2147483648.0);
+    const __m256d vmax  = _mm256_set1_pd(BPV == 32 ? 4294967296.0 : 2147483648.0);
+    size_t i = 0;
+
+    for (; i + 4 <= n_vals; i += 4, p += BPV / 2) {
+        __m256d x = _mm256_loadu_pd(val + i);
+        x         = _mm256_add_pd(_mm256_mul_pd(_mm256_sub_pd(_mm256_mul_pd(x, vd), vr), vdiv), half);
+
+        /* Anything out of range (or NaN) is left to the scalar code */
+        const __m256d ok = _mm256_and_pd(_mm256_cmp_pd(x, zero, _CMP_GE_OQ), _mm256_cmp_pd(x, vmax, _CMP_LT_OQ));
+        if (_mm256_movemask_pd(ok) != 0xF)
+            break;
+
+        __m128i u;
+        if constexpr (BPV == 32) {
+            /* Truncate values >= 2^31 as x - 2^31 (exact) and put the top bit back */
+            const __m256d adj = _mm256_and_pd(_mm256_cmp_pd(x, two31, _CMP_GE_OQ), two31);
+            const __m128i top = _mm_slli_epi32(_mm256_cvttpd_epi32(_mm256_mul_pd(adj, half)), 1);
+            u = _mm_or_si128(_mm256_cvttpd_epi32(_mm256_sub_pd(x, adj)), top);
+        }
+        else {
+            u = _mm_and_si128(_mm256_cvttpd_epi32(x), _mm_set1_epi32((1 << BPV) - 1));
+        }
+        pack4<BPV>(u, p);
+    }
+    return i;
+}
+
+template <int BPV>
+SIMD_AVX512 static size_t encode_avx512(size_t n_vals, const double* val,
+                                        double reference_value, double d, double divisor,
+                                        unsigned char* p)
+{
+    const __m512d vd   = _mm512_set1_pd(d);
+    const __m512d vr   = _mm512_set1_pd(reference_value);
+    const __m512d vdiv = _mm512_set1_pd(divisor);
+    const __m512d half = _mm512_set1_pd(0.5);
+    const __m512d zero = _mm512_setzero_pd();
+    const __m512d vmax = _mm512_set1_pd(4294967296.0);
+    size_t i = 0;
+
+    for (; i + 8 <= n_vals; i += 8, p += BPV) {
+        __m512d x = _mm512_loadu_pd(val + i);
+        x = _mm512_mul_round_pd(x, vd, ROUND_NEAREST);
+        x = _mm512_sub_round_pd(x, vr, ROUND_NEAREST);
+        x = _mm512_mul_round_pd(x, vdiv, ROUND_NEAREST);
+        x = _mm512_add_round_pd(x, half, ROUND_NEAREST);
+
+        const __mmask8 ok = _mm512_cmp_pd_mask(x, zero, _CMP_GE_OQ) & _mm512_cmp_pd_mask(x, vmax, _CMP_LT_OQ);
+        if (ok != 0xFF)
+            break;
+
+        __m256i u = _mm512_cvttpd_epu32(x);
+        if constexpr (BPV < 32)
+            u = _mm256_and_si256(u, _mm256_set1_epi32((1 << BPV) - 1));
+        pack4<BPV>(_mm256_castsi256_si128(u), p);
+        pack4<BPV>(_mm256_extracti128_si256(u, 1), p + BPV / 2);
+    }
+    return i + encode_avx2<BPV>(n_vals - i, val + i, reference_value, d, divisor, p);
+}
+
+#endif /* GRIB_SIMD_X86 */
+
+template <typename T>
+size_t grib_decode_array_simd(int level, const unsigned char* p, long bitsPerValue,
+                              double reference_value, double s, double d,
+                              size_t n_vals, T* val)
+{
+#if GRIB_SIMD_X86
+    const size_t nbytes = (n_vals * bitsPerValue + 7) / 8;
+    if (level >= GRIB_SIMD_AVX512) {
+        switch (bitsPerValue) {
+            case 8:  return decode_avx512<8>(p, nbytes, reference_value, s, d, n_vals, val);
+            case 12: return decode_avx512<12>(p, nbytes, reference_value, s, d, n_vals, val);
+            case 16: return decode_avx512<16>(p, nbytes, reference_value, s, d, n_vals, val);
+            case 24: return decode_avx512<24>(p, nbytes, reference_value, s, d, n_vals, val);
+            case 32: return decode_avx512<32>(p, nbytes, reference_value, s, d, n_vals, val);
+        }
+    }
+    else if (level == GRIB_SIMD_AVX2) {
+        switch (bitsPerValue) {
+            case 8:  return decode_avx2<8>(p, nbytes, reference_value, s, d, n_vals, val);
+            case 12: return decode_avx2<12>(p, nbytes, reference_value, s, d, n_vals, val);
+            case 16: return decode_avx2<16>(p, nbytes, reference_value, s, d, n_vals, val);
+            case 24: return decode_avx2<24>(p, nbytes, reference_value, s, d, n_vals, val);
+            case 32: return decode_avx2<32>(p, nbytes, reference_value, s, d, n_vals, val);
+        }
+    }
+#endif
+    return 0;
+}
+
+template size_t grib_decode_array_simd<double>(int, const unsigned char*, long, double, double, double, size_t, double*);
+template size_t grib_decode_array_simd<float>(int, const unsigned char*, long, double, double, double, size_t, float*);
+
+size_t grib_encode_double_array_simd(int level, size_t n_vals, const double* val, long bitsPerValue,
+                                     double reference_value, double d, double divisor,
+                                     unsigned char* p)
+{
+#if GRIB_SIMD_X86
+    if (level >= GRIB_SIMD_AVX512) {
+        switch (bitsPerValue) {
+            case 8:  return encode_avx512<8>(n_vals, val, reference_value, d, divisor, p);
+            case 12: return encode_avx512<12>(n_vals, val, reference_value, d, divisor, p);
+            case 16: return encode_avx512<16>(n_vals, val, reference_value, d, divisor, p);
+            case 24: return encode_avx512<24>(n_vals, val, reference_value, d, divisor, p);
+            case 32: return encode_avx512<32>(n_vals, val, reference_value, d, divisor, p);
+        }
+    }
+    else if (level == GRIB_SIMD_AVX2) {
+        switch (bitsPerValue) {
+            case 8:  return encode_avx2<8>(n_vals, val, reference_value, d, divisor, p);
+            case 12: return encode_avx2<12>(n_vals, val, reference_value, d, divisor, p);
+            case 16: return encode_avx2<16>(n_vals, val, reference_value, d, divisor, p);
+            case 24: return encode_avx2<24>(n_vals, val, reference_value, d, divisor, p);
+            case 32: return encode_avx2<32>(n_vals, val, reference_value, d, divisor, p);
+        }
+    }
+#endif
+    return 0;
+}
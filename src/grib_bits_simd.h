@@ -0,0 +1,41 @@
+/*
+ * (C) Copyright 2005- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities granted to it by
+ * virtue of its status as an intergovernmental organisation nor does it submit to any jurisdiction.
+ */
+
+#pragma once
+
+#include "grib_api_internal.h"
+
+/* Instruction set levels of the runtime-dispatched bit packing kernels */
+#define GRIB_SIMD_NONE   0
+#define GRIB_SIMD_AVX2   1
+#define GRIB_SIMD_AVX512 2
+
+/* Highest kernel level supported by the CPU (GRIB_SIMD_NONE if ECCODES_GRIB_NO_SIMD is set) */
+int grib_bits_simd_level(void);
+
+/*
+ * Decode up to n_vals values of bitsPerValue bits starting at the byte-aligned stream p,
+ * as ((lvalue * s) + reference_value) * d. Only a few widths have kernels (8, 12, 16, 24 and 32).
+ * Returns the number of values decoded, which is always a multiple of 8 bits in the stream;
+ * the caller handles the remainder with the scalar code.
+ */
+template <typename T>
+size_t grib_decode_array_simd(int level, const unsigned char* p, long bitsPerValue,
+                              double reference_value, double s, double d,
+                              size_t n_vals, T* val);
+
+/*
+ * Encode up to n_vals values as (((val * d) - reference_value) * divisor) + 0.5 into the
+ * byte-aligned stream p. Returns the number of values encoded, again a multiple of 8 bits.
+ * Stops early on values which do not fit so that the scalar code can deal with them.
+ */
+size_t grib_encode_double_array_simd(int level, size_t n_vals, const double* val, long bitsPerValue,
+                                     double reference_value, double d, double divisor,
+                                     unsigned char* p);
@@ -11,161 +11,392 @@
 /*
  * Description: concept index
  *
+ * A decision tree on the constant conditions of the entries of a concept (paramId, shortName...).
+ * Each node splits the entries on the value of the key which discriminates them best
+ * (discipline, parameterNumber, indicatorOfParameter...), in a hash table. The entries with
+ * no constant condition on the key go to the others branch.
+ * Looking up a handle gives, in the order of the concept, the only entries which can have
+ * all their conditions true: evaluating them gives the same match as evaluating them all.
  */
 
 #include "grib_api_internal.h"
 
-static grib_concept_index_entry* index_entry_new(grib_context* c, grib_concept_index_keys* keys)
+#define CONCEPT_INDEX_LEAF_SIZE 8
+#define CONCEPT_INDEX_MAX_DEPTH 8
+/* Length of the strings got from the handle, as when evaluating the conditions */
+#define CONCEPT_INDEX_STRING_LENGTH 80
+
+/* A constant condition of an entry */
+typedef struct concept_index_term
+{
+    const char* name;
+    int type;
+    long lval;
+    const char* sval;
+    size_t entry;
+} concept_index_term;
+
+static int compare_terms(const void* a, const void* b)
 {
-    grib_concept_index_entry* entry = NULL;
+    const concept_index_term* ta = (const concept_index_term*)a;
+    const concept_index_term* tb = (const concept_index_term*)b;
+    int cmp                      = strcmp(ta->name, tb->name);
+    if (cmp)
+        return cmp;
+    if (ta->type != tb->type)
+        return ta->type < tb->type ? -1 : 1;
+    if (ta->type == GRIB_TYPE_LONG) {
+        if (ta->lval != tb->lval)
+            return ta->lval < tb->lval ? -1 : 1;
+    }
+    else if ((cmp = strcmp(ta->sval, tb->sval)) != 0) {
+        return cmp;
+    }
+    return ta->entry < tb->entry ? -1 : ta->entry > tb->entry ? 1 : 0;
+}
 
-    Assert(keys);
+static int same_key(const concept_index_term* a, const concept_index_term* b)
+{
+    return a->type == b->type && strcmp(a->name, b->name) == 0;
+}
 
-    if (!c)
-        c = grib_context_get_default();
+static int same_value(const concept_index_term* a, const concept_index_term* b)
+{
+    return a->type == GRIB_TYPE_LONG ? a->lval == b->lval : strcmp(a->sval, b->sval) == 0;
+}
 
-    entry = grib_context_malloc_clear(c, sizeof(grib_concept_index_entry));
-    if (!entry)
-        grib_context_log(c, GRIB_LOG_FATAL, "grib_concept_index_entry unable to allocate");
-    e = entry;
+static size_t hash_long(long value)
+{
+    unsigned long long x = (unsigned long long)value;
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    return (size_t)x;
+}
 
-    while (keys && keys->name) {
-        e->name = grib_context_strdup(c, keys->name);
-        e->type = keys->type;
-        e->next = grib_context_malloc_clear(c, sizeof(grib_concept_index_entry));
-        if (!e->next)
-            grib_context_log(c, GRIB_LOG_FATAL, "grib_concept_index_entry unable to allocate");
+static size_t hash_string(const char* s)
+{
+    size_t h = 2166136261u;
+    while (*s)
+        h = (h ^ (unsigned char)*s++) * 16777619u;
+    return h;
+}
 
-        e    = e->next;
-        keys = keys->next;
+/* The value of the condition when it is a constant the index can split on */
+static int term_from_condition(grib_concept_condition* cond, size_t entry, concept_index_term* t)
+{
+    grib_expression* e = cond->expression;
+    size_t size        = 0;
+    int err            = 0;
+
+    if (!e)
+        return 0;
+    t->name  = cond->name;
+    t->entry = entry;
+    t->lval  = 0;
+    t->sval  = NULL;
+    if (strcmp(e->cclass->name, "long") == 0) {
+        t->type = GRIB_TYPE_LONG;
+        grib_expression_evaluate_long(NULL, e, &t->lval);
+        return 1;
     }
-
-    return entry;
+    if (strcmp(e->cclass->name, "string") == 0) {
+        t->type = GRIB_TYPE_STRING;
+        t->sval = grib_expression_evaluate_string(NULL, e, NULL, &size, &err);
+        return t->sval != NULL && err == 0 && strlen(t->sval) < CONCEPT_INDEX_STRING_LENGTH;
+    }
+    return 0;
 }
 
-static void index_entry_delete(grib_context* c, grib_concept_index_entry* entry)
+static void node_delete(grib_context* c, grib_concept_index_node* node)
 {
-    grib_concept_index_entry* e;
-    while (entry) {
-        e     = entry;
-        entry = entry->next;
-        grib_context_free(c, e->name);
-        grib_context_free(c, e->value);
-        grib_context_free(c, e);
+    size_t i = 0;
+    if (!node)
+        return;
+    if (node->buckets) {
+        for (i = 0; i <= node->mask; i++) {
+            grib_context_free_persistent(c, node->buckets[i].sval);
+            node_delete(c, node->buckets[i].node);
+        }
+        grib_context_free_persistent(c, node->buckets);
     }
+    node_delete(c, node->others);
+    grib_context_free_persistent(c, node->key);
+    grib_context_free_persistent(c, node->entries);
+    grib_context_free_persistent(c, node);
 }
 
-static int index_insert_entry(grib_concept_index* index, grib_concept_index_entry* entry, void* object)
+static grib_concept_index_node* node_new(grib_context* c, const grib_concept_index* index,
+                                         const size_t* entries, size_t count, int depth, unsigned char* in_bucket);
+
+static grib_concept_index_node* leaf_new(grib_context* c, const size_t* entries, size_t count)
 {
-    int err = 0;
-    int found;
-    grib_conditions_tree* cur     = index->conditions;
-    grib_conditions_tree* prev    = index->conditions;
-    grib_concept_index_keys* keys = index->keys;
+    grib_concept_index_node* node = (grib_concept_index_node*)grib_context_malloc_clear_persistent(c, sizeof(grib_concept_index_node));
+    if (!node)
+        return NULL;
+    node->count   = count;
+    node->entries = (size_t*)grib_context_malloc_persistent(c, count * sizeof(size_t));
+    if (!node->entries) {
+        grib_context_free_persistent(c, node);
+        return NULL;
+    }
+    memcpy(node->entries, entries, count * sizeof(size_t));
+    return node;
+}
 
-    while (keys->name) {
-        if (!cur) {
-            cur = grib_context_malloc_clear_persistent(index->context, sizeof(grib_conditions_tree));
-            if (!cur)
-                grib_context_log(index->context, GRIB_LOG_FATAL, "index_insert_entry unable to allocate");
-            prev->next = cur;
-        }
-        value = entry->value ? entry->value : "*";
-        while (cur && (!cur->value || (found = !strcmp(cur->value, value)) == 0))
-            cur = cur->next;
-
-        if (!found) {
-            cur->next = grib_context_malloc_clear_persistent(index->context, sizeof(grib_conditions_tree));
-            Assert(cur->next);
-            cur = cur->next;
+/* Split the entries on the terms of the key in [first,last) */
+static grib_concept_index_node* split_new(grib_context* c, const grib_concept_index* index,
+                                          const size_t* entries, size_t count, int depth, unsigned char* in_bucket,
+                                          const concept_index_term* first, const concept_index_term* last)
+{
+    grib_concept_index_node* node = NULL;
+    const concept_index_term* t   = NULL;
+    size_t* sub                   = NULL;
+    size_t distinct = 0, size = 1, n = 0, i = 0;
+
+    for (t = first; t < last; t++) {
+        if (t == first || !same_value(t, t - 1))
+            distinct++;
+    }
+    while (size < 2 * distinct)
+        size <<= 1;
+
+    node = (grib_concept_index_node*)grib_context_malloc_clear_persistent(c, sizeof(grib_concept_index_node));
+    sub  = (size_t*)grib_context_malloc(c, count * sizeof(size_t));
+    if (!node || !sub)
+        goto fail;
+    node->key     = grib_context_strdup_persistent(c, first->name);
+    node->type    = first->type;
+    node->mask    = size - 1;
+    node->buckets = (grib_concept_index_bucket*)grib_context_malloc_clear_persistent(c, size * sizeof(grib_concept_index_bucket));
+    if (!node->key || !node->buckets)
+        goto fail;
+
+    for (t = first; t < last;) {
+        const concept_index_term* end = t;
+        grib_concept_index_bucket* b  = NULL;
+        n                             = 0;
+        while (end < last && same_value(end, t)) {
+            sub[n++] = end->entry;
+            end++;
         }
-
-        cur->value = grib_context_strdup(index->context, value);
-        entry      = entry->next;
-        keys       = keys->next;
-        prev       = cur;
-        cur        = cur->next_key;
+        i = (t->type == GRIB_TYPE_LONG ? hash_long(t->lval) : hash_string(t->sval)) & node->mask;
+        while (node->buckets[i].node)
+            i = (i + 1) & node->mask;
+        b       = &node->buckets[i];
+        b->lval = t->lval;
+        if (t->type == GRIB_TYPE_STRING && (b->sval = grib_context_strdup_persistent(c, t->sval)) == NULL)
+            goto fail;
+        if ((b->node = node_new(c, index, sub, n, depth + 1, in_bucket)) == NULL)
+            goto fail;
+        t = end;
     }
 
-    while (cur) {
-        prev = cur;
-        cur  = cur->next_key;
+    /* Entries are in the bucket of at most one value of the key */
+    n = 0;
+    for (t = first; t < last; t++)
+        in_bucket[t->entry] = 1;
+    for (i = 0; i < count; i++) {
+        if (!in_bucket[entries[i]])
+            sub[n++] = entries[i];
     }
-
-    prev->object = object;
-
-    return err;
+    for (t = first; t < last; t++)
+        in_bucket[t->entry] = 0;
+    if (n > 0 && (node->others = node_new(c, index, sub, n, depth + 1, in_bucket)) == NULL)
+        goto fail;
+
+    grib_context_free(c, sub);
+    return node;
+
+fail:
+    grib_context_free(c, sub);
+    node_delete(c, node);
+    return NULL;
 }
 
-static void index_add_conditions(grib_concept_index* index, grib_concept_condition* condition)
-{
-    grib_concept_condition* c = condition;
-    char s[512]               = {0,};
-    grib_concept_index_entry* e;
-    grib_concept_index_entry* entry = index_entry_new(index->context, index->keys);
-
-    while (c) {
-        size_t size = 512;
-        int type;
-        e    = entry;
-        type = grib_expression_native_type(0, c->expression);
-        switch (type) {
-            case GRIB_TYPE_LONG:
-                grib_expression_evaluate_long(0, c->expression, &lres);
-                snprintf(s, sizeof(s), "%ld", lres);
-                break;
-
-            case GRIB_TYPE_DOUBLE:
-                grib_expression_evaluate_double(0, c->expression, &dres);
-                snprintf(s, sizeof(s), "%g", dres);
-                break;
-
-            case GRIB_TYPE_STRING:
-                grib_expression_evaluate_string(0, c->expression, s, &size, &err);
-                break;
-
-            default:
-                Assert(0);
-                break;
+static grib_concept_index_node* node_new(grib_context* c, const grib_concept_index* index,
+                                         const size_t* entries, size_t count, int depth, unsigned char* in_bucket)
+{
+    grib_concept_index_node* node = NULL;
+    concept_index_term* terms     = NULL;
+    size_t nterms = 0, i = 0, best_first = 0, best_last = 0;
+    double best_score = 0;
+
+    if (count <= CONCEPT_INDEX_LEAF_SIZE || depth >= CONCEPT_INDEX_MAX_DEPTH)
+        return leaf_new(c, entries, count);
+
+    for (i = 0; i < count; i++) {
+        grib_concept_condition* cond = NULL;
+        for (cond = index->values[entries[i]]->conditions; cond; cond = cond->next)
+            nterms++;
+    }
+    terms = (concept_index_term*)grib_context_malloc(c, (nterms + 1) * sizeof(concept_index_term));
+    if (!terms)
+        return NULL;
+
+    /* The first constant condition of each entry on each key */
+    nterms = 0;
+    for (i = 0; i < count; i++) {
+        grib_concept_condition* cond = NULL;
+        for (cond = index->values[entries[i]]->conditions; cond; cond = cond->next) {
+            concept_index_term* t = &terms[nterms];
+            size_t j              = 0;
+            if (!term_from_condition(cond, entries[i], t))
+                continue;
+            for (j = nterms; j > 0 && terms[j - 1].entry == entries[i]; j--) {
+                if (strcmp(terms[j - 1].name, t->name) == 0)
+                    break;
+            }
+            if (j == 0 || terms[j - 1].entry != entries[i])
+                nterms++;
         }
-
-        while (e->name && strcmp(e->name, c->name))
-            e = e->next;
-
-        e->type  = type;
-        e->value = grib_context_strdup(index->context, s);
-        if (!e->name) {
-            e->name = grib_context_strdup(index->context, c->name);
-            e->next = grib_context_malloc_clear_persistent(index->context, sizeof(grib_concept_index_entry));
-            if (!e->next)
-                grib_context_log(index->context, GRIB_LOG_FATAL, "index_add_conditions unable to allocate");
+    }
+    qsort(terms, nterms, sizeof(concept_index_term), &compare_terms);
+
+    /* The key leaving the fewest entries to evaluate, on average over its values */
+    best_score = 0.75 * count;
+    for (i = 0; i < nterms;) {
+        size_t j = i, distinct = 0;
+        double score = 0;
+        for (; j < nterms && same_key(&terms[j], &terms[i]); j++) {
+            if (j == i || !same_value(&terms[j], &terms[j - 1]))
+                distinct++;
         }
-
-        c = c->next;
+        score = (double)(count - (j - i)) + (double)(j - i) / distinct;
+        if (score < best_score) {
+            best_score = score;
+            best_first = i;
+            best_last  = j;
+        }
+        i = j;
     }
 
-    index_insert_entry(index, entry, condition->name);
+    if (best_last > best_first)
+        node = split_new(c, index, entries, count, depth, in_bucket, terms + best_first, terms + best_last);
+    else
+        node = leaf_new(c, entries, count);
+    grib_context_free(c, terms);
+    return node;
+}
 
-    index_entry_delete(index->context, entry);
+void grib_concept_index_delete(grib_context* c, grib_concept_index* index)
+{
+    if (!index)
+        return;
+    node_delete(c, index->root);
+    grib_context_free_persistent(c, index->values);
+    grib_context_free_persistent(c, index);
 }
 
-grib_concept_index* grib_concept_index_new_from_concept(grib_context* c, grib_concept_value* concept, int* err)
+/* NULL when the concept is too small to need an index, or on error: the entries are then all evaluated */
+grib_concept_index* grib_concept_index_new(grib_context* c, grib_concept_value* concept)
 {
-    grib_concept_index* index;
+    grib_concept_index* index = NULL;
+    grib_concept_value* v     = NULL;
+    size_t* entries           = NULL;
+    unsigned char* in_bucket  = NULL;
+    size_t count = 0, i = 0;
+
+    for (v = concept; v; v = v->next)
+        count++;
+    if (count <= CONCEPT_INDEX_LEAF_SIZE)
+        return NULL;
+
+    index     = (grib_concept_index*)grib_context_malloc_clear_persistent(c, sizeof(grib_concept_index));
+    entries   = (size_t*)grib_context_malloc(c, count * sizeof(size_t));
+    in_bucket = (unsigned char*)grib_context_malloc_clear(c, count);
+    if (!index || !entries || !in_bucket)
+        goto fail;
+    index->count  = count;
+    index->values = (grib_concept_value**)grib_context_malloc_persistent(c, count * sizeof(grib_concept_value*));
+    if (!index->values)
+        goto fail;
+    for (v = concept, i = 0; v; v = v->next, i++) {
+        index->values[i] = v;
+        entries[i]       = i;
+    }
+    if ((index->root = node_new(c, index, entries, count, 0, in_bucket)) == NULL)
+        goto fail;
 
-    if (!c)
-        c = grib_context_get_default();
+    grib_context_free(c, entries);
+    grib_context_free(c, in_bucket);
+    return index;
 
-    index             = grib_context_malloc_clear_persistent(c, sizeof(grib_concept_index));
-    index->keys       = grib_context_malloc_clear_persistent(c, sizeof(grib_concept_index_key));
-    index->conditions = grib_context_malloc_clear_persistent(c, sizeof(grib_conditions_tree));
-    index->conditions = grib_context_malloc_clear_persistent(c, sizeof(grib_conditions_tree));
-    index->context    = c;
+fail:
+    grib_context_log(c, GRIB_LOG_DEBUG, "grib_concept_index_new: unable to index concept %s", concept->name);
+    grib_context_free(c, entries);
+    grib_context_free(c, in_bucket);
+    grib_concept_index_delete(c, index);
+    return NULL;
+}
 
-    while (concept) {
-        index_add_conditions(index, concept->conditions, err);
-        concept = concept->next;
+static const grib_concept_index_bucket* node_find(const grib_concept_index_node* node, grib_handle* h)
+{
+    const grib_concept_index_bucket* b = NULL;
+    size_t i                           = 0;
+
+    if (node->type == GRIB_TYPE_LONG) {
+        long lval = 0;
+        if (grib_get_long(h, node->key, &lval) != GRIB_SUCCESS)
+            return NULL;
+        for (i = hash_long(lval) & node->mask; (b = &node->buckets[i])->node; i = (i + 1) & node->mask) {
+            if (b->lval == lval)
+                return b;
+        }
     }
+    else {
+        char sval[CONCEPT_INDEX_STRING_LENGTH];
+        size_t len = sizeof(sval);
+        if (grib_get_string(h, node->key, sval, &len) != GRIB_SUCCESS)
+            return NULL;
+        for (i = hash_string(sval) & node->mask; (b = &node->buckets[i])->node; i = (i + 1) & node->mask) {
+            if (strcmp(b->sval, sval) == 0)
+                return b;
+        }
+    }
+    return NULL;
+}
 
-    return index;
+static int node_candidates(const grib_concept_index_node* node, grib_handle* h, size_t* entries, size_t max, size_t* count)
+{
+    const grib_concept_index_bucket* b = NULL;
+    int err                            = 0;
+
+    while (node) {
+        if (!node->key) {
+            if (*count + node->count > max)
+                return GRIB_ARRAY_TOO_SMALL;
+            memcpy(entries + *count, node->entries, node->count * sizeof(size_t));
+            *count += node->count;
+            return GRIB_SUCCESS;
+        }
+        if ((b = node_find(node, h)) != NULL) {
+            if ((err = node_candidates(b->node, h, entries, max, count)) != GRIB_SUCCESS)
+                return err;
+        }
+        node = node->others;
+    }
+    return GRIB_SUCCESS;
+}
+
+/*
+ * The positions in the concept of the entries which can match the handle, in increasing order.
+ * GRIB_ARRAY_TOO_SMALL if there are more than max
+ */
+int grib_concept_index_get_candidates(const grib_concept_index* index, grib_handle* h, size_t* entries, size_t max, size_t* count)
+{
+    size_t i = 0, j = 0;
+    int err  = 0;
+
+    *count = 0;
+    if ((err = node_candidates(index->root, h, entries, max, count)) != GRIB_SUCCESS)
+        return err;
+    /* The branches give increasing runs: few, so sort by insertion */
+    for (i = 1; i < *count; i++) {
+        const size_t e = entries[i];
+        for (j = i; j > 0 && entries[j - 1] > e; j--)
+            entries[j] = entries[j - 1];
+        entries[j] = e;
+    }
+    return GRIB_SUCCESS;
 }
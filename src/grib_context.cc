@@ -277,6 +277,7 @@ const char* grib_get_package_name()
 }
 
 #define DEFAULT_FILE_POOL_MAX_OPENED_FILES 0
+#define DEFAULT_HANDLE_SKELETONS 4
 
 static grib_context default_grib_context = {
     0,               /* inited                     */
@@ -361,7 +362,15 @@ static grib_context default_grib_context = {
     0,              /* classes                    */
     0,              /* lists                      */
     0,              /* expanded_descriptors       */
-    DEFAULT_FILE_POOL_MAX_OPENED_FILES /* file_pool_max_opened_files */
+    DEFAULT_FILE_POOL_MAX_OPENED_FILES, /* file_pool_max_opened_files */
+    0,                                  /* grid_geometries            */
+    0,                                  /* gaussian_latitudes         */
+    0,                                  /* definitions_cache          */
+    0,                                  /* arena_chunks               */
+    0,                                  /* arena_chunks_count         */
+    DEFAULT_HANDLE_SKELETONS,           /* handle_skeletons_max       */
+    0,                                  /* handle_skeletons           */
+    0                                   /* handle_skeletons_count     */
 #if GRIB_PTHREADS
     ,
     PTHREAD_MUTEX_INITIALIZER /* mutex */
@@ -371,8 +380,16 @@ static grib_context default_grib_context = {
 /* Hopefully big enough. Note: Definitions and samples path environment variables can contain SEVERAL colon-separated directories */
 #define ECC_PATH_MAXLEN 8192
 
+/* Set once the default context is fully initialised, when it is returned without the lock.
+ * Its member inited is set early, for the calls made while it is initialised
+ */
+static int default_grib_context_ready = 0;
+
 grib_context* grib_context_get_default()
 {
+    if (GRIB_ATOMIC_LOAD(default_grib_context_ready))
+        return &default_grib_context;
+
     GRIB_MUTEX_INIT_ONCE(&once, &init);
     GRIB_MUTEX_LOCK(&mutex_c);
 
@@ -394,6 +411,7 @@ grib_context* grib_context_get_default()
         const char* grib_data_quality_checks            = NULL;
         const char* single_precision                    = NULL;
         const char* file_pool_max_opened_files          = NULL;
+        const char* handle_skeletons                    = NULL;
 
 #ifdef ENABLE_FLOATING_POINT_EXCEPTIONS
         feenableexcept(FE_ALL_EXCEPT & ~FE_INEXACT);
@@ -416,6 +434,7 @@ grib_context* grib_context_get_default()
         no_spd                              = codes_getenv("ECCODES_GRIB_NO_SPD");
         keep_matrix                         = codes_getenv("ECCODES_GRIB_KEEP_MATRIX");
         file_pool_max_opened_files          = getenv("ECCODES_FILE_POOL_MAX_OPENED_FILES");
+        handle_skeletons                    = getenv("ECCODES_GRIB_HANDLE_SKELETONS");
 
         /* On UNIX, when we read from a file we get exactly what is in the file on disk.
          * But on Windows a file can be opened in binary or text mode. In binary mode the system behaves exactly as in UNIX.
@@ -550,6 +569,8 @@ grib_context* grib_context_get_default()
         default_grib_context.grib_data_quality_checks = grib_data_quality_checks ? atoi(grib_data_quality_checks) : 0;
         default_grib_context.single_precision = single_precision ? atoi(single_precision) : 0;
         default_grib_context.file_pool_max_opened_files = file_pool_max_opened_files ? atoi(file_pool_max_opened_files) : DEFAULT_FILE_POOL_MAX_OPENED_FILES;
+        default_grib_context.handle_skeletons_max = handle_skeletons ? atoi(handle_skeletons) : DEFAULT_HANDLE_SKELETONS;
+        GRIB_ATOMIC_STORE(default_grib_context_ready, 1);
     }
 
     GRIB_MUTEX_UNLOCK(&mutex_c);
@@ -680,6 +701,17 @@ static int init_definition_files_dir(grib_context* c)
     return err;
 }
 
+/* The directories of the definitions path, resolved as when looking for a definition file */
+const grib_string_list* grib_context_get_definition_files_dirs(grib_context* c)
+{
+    if (!c)
+        c = grib_context_get_default();
+    GRIB_MUTEX_INIT_ONCE(&once, &init);
+    if (!c->grib_definition_files_dir && init_definition_files_dir(c) != GRIB_SUCCESS)
+        return NULL;
+    return c->grib_definition_files_dir;
+}
+
 char* grib_context_full_defs_path(grib_context* c, const char* basename)
 {
     int err         = 0;
@@ -695,9 +727,8 @@ char* grib_context_full_defs_path(grib_context* c, const char* basename)
         return (char*)basename;
     }
     else {
-        GRIB_MUTEX_LOCK(&mutex_c); /* See ECC-604 */
+        /* The trie is searched without a lock. Its entries are added complete, see ECC-604 */
         fullpath = (grib_string_list*)grib_trie_get(c->def_files, basename);
-        GRIB_MUTEX_UNLOCK(&mutex_c);
         if (fullpath != NULL) {
             return fullpath->value;
         }
@@ -775,6 +806,9 @@ void grib_context_reset(grib_context* c)
     if (!c)
         c = grib_context_get_default();
 
+    /* Their accessors refer to the actions and tables deleted here */
+    grib_handle_skeletons_delete(c);
+
     if (c->grib_reader) {
         grib_action_file* fr = c->grib_reader->first;
         grib_action_file* fn = fr;
@@ -825,6 +859,7 @@ void grib_context_reset(grib_context* c)
         grib_concept_value* cv = c->concepts[i];
         if (cv) {
             grib_trie_delete_container(cv->index);
+            grib_concept_index_delete(c, cv->conditions_index);
         }
         while (cv) {
             grib_concept_value* n = cv->next;
@@ -855,7 +890,13 @@ void grib_context_delete(grib_context* c)
     c->hash_array_index=0;
     grib_trie_delete(c->expanded_descriptors);
     c->expanded_descriptors=0;
+    grib_grid_geometry_cache_delete(c);
+    grib_gaussian_latitudes_cache_delete(c);
+    grib_definitions_cache_delete(c);
+    grib_arena_chunks_delete(c);
 
+    if (c == &default_grib_context)
+        GRIB_ATOMIC_STORE(default_grib_context_ready, 0);
     c->inited = 0;
 }
 
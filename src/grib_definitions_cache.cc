@@ -0,0 +1,857 @@
+/*
+ * (C) Copyright 2005- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities granted to it by
+ * virtue of its status as an intergovernmental organisation nor does it submit to any jurisdiction.
+ */
+
+/*
+ * Description: definitions cache
+ *
+ * The concept files (paramId.def, shortName.def...) and the hash array files hold most of the
+ * text the parser reads to decode a first message. The definitions cache holds their values
+ * already parsed, in a file written by codes_compile_definitions and mapped when the first of
+ * these files is loaded. A file is taken from the cache only if its size and modification time
+ * are still those it had when compiled, otherwise it is parsed as before.
+ *
+ * The cache file is given by ECCODES_DEFINITION_CACHE (an empty value disables it), by default
+ * definitions.cache in the first directory of the definitions path.
+ *
+ * Layout, in native byte order with every part 8-byte aligned:
+ *   identifier    "ECCDEF1\0"
+ *   header        definitions_cache_header
+ *   files         definitions_cache_file[num_files], sorted by path
+ *   values        definitions_cache_value[num_values], the values of each file in order
+ *   conditions    definitions_cache_condition[num_conditions], of the concept values
+ *   longs         int64_t[num_longs], the integer arrays
+ *   strings       the names and paths, nul terminated
+ */
+
+#include "grib_api_internal.h"
+
+#define DEFINITIONS_CACHE_IDENTIFIER "ECCDEF1"
+#define DEFINITIONS_CACHE_VERSION    1
+#define DEFINITIONS_CACHE_BYTE_ORDER 0x01020304
+#define DEFINITIONS_CACHE_ALIGN(n)   (((n) + 7) & ~(uint64_t)7)
+#define DEFINITIONS_CACHE_NAME       "definitions.cache"
+
+/* Types of the files */
+#define DEFINITIONS_CACHE_CONCEPT    1
+#define DEFINITIONS_CACHE_HASH_ARRAY 2
+
+/* Types of the conditions of the concept values */
+#define CONDITION_LONG    1
+#define CONDITION_DOUBLE  2
+#define CONDITION_STRING  3
+#define CONDITION_FUNCTOR 4 /* Without arguments, like missing() */
+#define CONDITION_IARRAY  5
+
+typedef struct definitions_cache_header
+{
+    uint32_t byte_order;
+    uint32_t version;
+    uint64_t num_files;
+    uint64_t num_values;
+    uint64_t num_conditions;
+    uint64_t num_longs;
+    uint64_t files_offset;
+    uint64_t values_offset;
+    uint64_t conditions_offset;
+    uint64_t longs_offset;
+    uint64_t strings_offset;
+    uint64_t strings_size;
+} definitions_cache_header;
+
+typedef struct definitions_cache_file
+{
+    uint64_t path;
+    int64_t size;
+    int64_t mtime;
+    uint64_t first_value;
+    uint32_t num_values;
+    uint32_t type;
+} definitions_cache_file;
+
+/* The conditions of a concept value or the integers of a hash array value */
+typedef struct definitions_cache_value
+{
+    uint64_t name;
+    uint64_t first;
+    uint32_t count;
+    uint32_t unused;
+} definitions_cache_value;
+
+/* 'value' holds a long, the bits of a double, a string or the first of 'count' longs */
+typedef struct definitions_cache_condition
+{
+    uint64_t name;
+    uint64_t value;
+    uint32_t type;
+    uint32_t count;
+} definitions_cache_condition;
+
+struct grib_definitions_cache
+{
+    grib_context* context;
+    grib_mmap_file* mmap_file; /* NULL when the file was read into 'buffer' */
+    unsigned char* buffer;
+    const unsigned char* data;
+    size_t length;
+    const definitions_cache_header* header;
+    const definitions_cache_file* files;
+    const definitions_cache_value* values;
+    const definitions_cache_condition* conditions;
+    const int64_t* longs;
+    const char* strings;
+};
+
+/* Set in the context when there is no cache to use, so it is looked for once */
+static grib_definitions_cache no_definitions_cache;
+
+#if GRIB_PTHREADS
+static pthread_once_t once   = PTHREAD_ONCE_INIT;
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static void init()
+{
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+}
+#elif GRIB_OMP_THREADS
+static int once = 0;
+static omp_nest_lock_t mutex;
+
+static void init()
+{
+    GRIB_OMP_CRITICAL(lock_grib_definitions_cache_c)
+    {
+        if (once == 0) {
+            omp_init_nest_lock(&mutex);
+            once = 1;
+        }
+    }
+}
+#endif
+
+/* The file used when ECCODES_DEFINITION_CACHE is not set, to free. NULL without definitions path */
+char* grib_definitions_cache_default_path(grib_context* c)
+{
+    const grib_string_list* dirs = grib_context_get_definition_files_dirs(c);
+    char* path                   = NULL;
+    size_t len                   = 0;
+
+    if (!dirs || !dirs->value)
+        return NULL;
+    len  = strlen(dirs->value) + strlen(DEFINITIONS_CACHE_NAME) + 2;
+    path = (char*)grib_context_malloc(c, len);
+    if (path)
+        snprintf(path, len, "%s/%s", dirs->value, DEFINITIONS_CACHE_NAME);
+    return path;
+}
+
+/* ---- Writing ---- */
+
+typedef struct definitions_cache_writer
+{
+    grib_context* context;
+    char* strings;
+    size_t strings_size, strings_capacity;
+    uint64_t* string_slots; /* Offsets of the strings + 1 by hash, 0 when free */
+    size_t string_slots_mask, num_strings;
+    definitions_cache_file* files;
+    size_t num_files, files_capacity;
+    definitions_cache_value* values;
+    size_t num_values, values_capacity;
+    definitions_cache_condition* conditions;
+    size_t num_conditions, conditions_capacity;
+    int64_t* longs;
+    size_t num_longs, longs_capacity;
+} definitions_cache_writer;
+
+/* Make room for one more element at position 'size' */
+static int writer_reserve(grib_context* c, void** array, size_t size, size_t* capacity, size_t elsize)
+{
+    void* a = NULL;
+    if (size < *capacity)
+        return GRIB_SUCCESS;
+    a = grib_context_realloc(c, *array, (*capacity ? 2 * *capacity : 1024) * elsize);
+    if (!a)
+        return GRIB_OUT_OF_MEMORY;
+    *array    = a;
+    *capacity = *capacity ? 2 * *capacity : 1024;
+    return GRIB_SUCCESS;
+}
+
+static size_t hash_string(const char* s)
+{
+    size_t h = 2166136261u;
+    while (*s)
+        h = (h ^ (unsigned char)*s++) * 16777619u;
+    return h;
+}
+
+/* The same names come back in most of the conditions: each string is stored once */
+static int writer_add_string(definitions_cache_writer* w, const char* s, uint64_t* offset)
+{
+    size_t len = strlen(s) + 1, i = 0;
+
+    if (2 * (w->num_strings + 1) > w->string_slots_mask + 1 || !w->string_slots) {
+        size_t old_size  = w->string_slots ? w->string_slots_mask + 1 : 0;
+        size_t new_size  = old_size ? 2 * old_size : 4096;
+        uint64_t* slots  = (uint64_t*)grib_context_malloc_clear(w->context, new_size * sizeof(uint64_t));
+        if (!slots)
+            return GRIB_OUT_OF_MEMORY;
+        for (i = 0; i < old_size; i++) {
+            if (w->string_slots[i]) {
+                size_t j = hash_string(w->strings + w->string_slots[i] - 1) & (new_size - 1);
+                while (slots[j])
+                    j = (j + 1) & (new_size - 1);
+                slots[j] = w->string_slots[i];
+            }
+        }
+        grib_context_free(w->context, w->string_slots);
+        w->string_slots      = slots;
+        w->string_slots_mask = new_size - 1;
+    }
+
+    i = hash_string(s) & w->string_slots_mask;
+    while (w->string_slots[i]) {
+        if (strcmp(w->strings + w->string_slots[i] - 1, s) == 0) {
+            *offset = w->string_slots[i] - 1;
+            return GRIB_SUCCESS;
+        }
+        i = (i + 1) & w->string_slots_mask;
+    }
+
+    while (w->strings_size + len > w->strings_capacity) {
+        size_t capacity = w->strings_capacity ? 2 * w->strings_capacity : 65536;
+        char* strings   = (char*)grib_context_realloc(w->context, w->strings, capacity);
+        if (!strings)
+            return GRIB_OUT_OF_MEMORY;
+        w->strings          = strings;
+        w->strings_capacity = capacity;
+    }
+    memcpy(w->strings + w->strings_size, s, len);
+    *offset            = w->strings_size;
+    w->string_slots[i] = w->strings_size + 1;
+    w->strings_size += len;
+    w->num_strings++;
+    return GRIB_SUCCESS;
+}
+
+static int writer_add_longs(definitions_cache_writer* w, grib_iarray* a, uint64_t* first, uint32_t* count)
+{
+    size_t n = grib_iarray_used_size(a), i = 0;
+    int err  = 0;
+
+    *first = w->num_longs;
+    *count = (uint32_t)n;
+    for (i = 0; i < n; i++) {
+        if ((err = writer_reserve(w->context, (void**)&w->longs, w->num_longs, &w->longs_capacity, sizeof(int64_t))) != GRIB_SUCCESS)
+            return err;
+        w->longs[w->num_longs++] = a->v[i];
+    }
+    return GRIB_SUCCESS;
+}
+
+/* GRIB_NOT_IMPLEMENTED for a condition the cache cannot hold: the file is parsed at run time */
+static int writer_add_condition(definitions_cache_writer* w, grib_concept_condition* cond)
+{
+    definitions_cache_condition* dc = NULL;
+    grib_expression* e              = cond->expression;
+    int err                         = 0;
+
+    if ((err = writer_reserve(w->context, (void**)&w->conditions, w->num_conditions, &w->conditions_capacity, sizeof(definitions_cache_condition))) != GRIB_SUCCESS)
+        return err;
+    dc = &w->conditions[w->num_conditions];
+    memset(dc, 0, sizeof(*dc));
+    if ((err = writer_add_string(w, cond->name, &dc->name)) != GRIB_SUCCESS)
+        return err;
+
+    if (!e) {
+        dc->type = CONDITION_IARRAY;
+        err      = writer_add_longs(w, cond->iarray, &dc->value, &dc->count);
+    }
+    else if (strcmp(e->cclass->name, "long") == 0) {
+        long lval = 0;
+        int64_t v = 0;
+        grib_expression_evaluate_long(NULL, e, &lval);
+        v        = lval;
+        dc->type = CONDITION_LONG;
+        memcpy(&dc->value, &v, sizeof(v));
+    }
+    else if (strcmp(e->cclass->name, "double") == 0) {
+        double dval = 0;
+        grib_expression_evaluate_double(NULL, e, &dval);
+        dc->type = CONDITION_DOUBLE;
+        memcpy(&dc->value, &dval, sizeof(dval));
+    }
+    else if (strcmp(e->cclass->name, "string") == 0) {
+        size_t size       = 0;
+        const char* sval  = grib_expression_evaluate_string(NULL, e, NULL, &size, &err);
+        if (err || !sval)
+            return GRIB_NOT_IMPLEMENTED;
+        dc->type = CONDITION_STRING;
+        err      = writer_add_string(w, sval, &dc->value);
+    }
+    else if (grib_expression_functor_name(e)) {
+        dc->type = CONDITION_FUNCTOR;
+        err      = writer_add_string(w, grib_expression_functor_name(e), &dc->value);
+    }
+    else {
+        return GRIB_NOT_IMPLEMENTED;
+    }
+    if (err == GRIB_SUCCESS)
+        w->num_conditions++;
+    return err;
+}
+
+static int writer_add_value(definitions_cache_writer* w, const char* name, uint64_t* offset, definitions_cache_value** value)
+{
+    int err = writer_reserve(w->context, (void**)&w->values, w->num_values, &w->values_capacity, sizeof(definitions_cache_value));
+    if (err)
+        return err;
+    *value = &w->values[w->num_values];
+    memset(*value, 0, sizeof(**value));
+    if ((err = writer_add_string(w, name, offset)) != GRIB_SUCCESS)
+        return err;
+    w->num_values++;
+    return GRIB_SUCCESS;
+}
+
+/* Add a file: the values added for it are dropped again if it cannot be compiled */
+static int writer_add_file(definitions_cache_writer* w, const char* path, const struct stat* st)
+{
+    grib_concept_value* concept        = NULL;
+    grib_hash_array_value* hash_array  = NULL;
+    definitions_cache_file* f          = NULL;
+    size_t num_values = w->num_values, num_conditions = w->num_conditions, num_longs = w->num_longs;
+    int err = 0;
+
+    if (grib_parse_values_file(w->context, path, &concept, &hash_array) != GRIB_SUCCESS || (!concept && !hash_array))
+        return GRIB_NOT_IMPLEMENTED;
+
+    if ((err = writer_reserve(w->context, (void**)&w->files, w->num_files, &w->files_capacity, sizeof(definitions_cache_file))) != GRIB_SUCCESS)
+        goto cleanup;
+    f = &w->files[w->num_files];
+    memset(f, 0, sizeof(*f));
+    f->size        = st->st_size;
+    f->mtime       = st->st_mtime;
+    f->first_value = w->num_values;
+    if ((err = writer_add_string(w, path, &f->path)) != GRIB_SUCCESS)
+        goto cleanup;
+
+    if (concept) {
+        grib_concept_value* v = NULL;
+        f->type               = DEFINITIONS_CACHE_CONCEPT;
+        for (v = concept; v && err == GRIB_SUCCESS; v = v->next) {
+            definitions_cache_value* dv  = NULL;
+            grib_concept_condition* cond = NULL;
+            uint64_t name = 0;
+            if ((err = writer_add_value(w, v->name, &name, &dv)) != GRIB_SUCCESS)
+                break;
+            dv->name  = name;
+            dv->first = w->num_conditions;
+            for (cond = v->conditions; cond && err == GRIB_SUCCESS; cond = cond->next)
+                err = writer_add_condition(w, cond);
+            w->values[w->num_values - 1].count = (uint32_t)(w->num_conditions - w->values[w->num_values - 1].first);
+        }
+    }
+    else {
+        grib_hash_array_value* v = NULL;
+        f->type                  = DEFINITIONS_CACHE_HASH_ARRAY;
+        for (v = hash_array; v && err == GRIB_SUCCESS; v = v->next) {
+            definitions_cache_value* dv = NULL;
+            uint64_t name = 0, first = 0;
+            uint32_t count = 0;
+            if (v->type != GRIB_HASH_ARRAY_TYPE_INTEGER) {
+                err = GRIB_NOT_IMPLEMENTED;
+                break;
+            }
+            if ((err = writer_add_value(w, v->name, &name, &dv)) != GRIB_SUCCESS ||
+                (err = writer_add_longs(w, v->iarray, &first, &count)) != GRIB_SUCCESS)
+                break;
+            dv        = &w->values[w->num_values - 1];
+            dv->name  = name;
+            dv->first = first;
+            dv->count = count;
+        }
+    }
+    if (err == GRIB_SUCCESS) {
+        w->files[w->num_files].num_values = (uint32_t)(w->num_values - w->files[w->num_files].first_value);
+        w->num_files++;
+    }
+
+cleanup:
+    if (err) {
+        w->num_values     = num_values;
+        w->num_conditions = num_conditions;
+        w->num_longs      = num_longs;
+    }
+    while (concept) {
+        grib_concept_value* next = concept->next;
+        grib_concept_value_delete(w->context, concept);
+        concept = next;
+    }
+    while (hash_array) {
+        grib_hash_array_value* next = hash_array->next;
+        grib_hash_array_value_delete(w->context, hash_array);
+        hash_array = next;
+    }
+    return err;
+}
+
+static const char* sorted_strings = NULL;
+static int compare_files(const void* a, const void* b)
+{
+    return strcmp(sorted_strings + ((const definitions_cache_file*)a)->path,
+                  sorted_strings + ((const definitions_cache_file*)b)->path);
+}
+
+static int write_part(FILE* fh, const void* data, size_t size, uint64_t* offset)
+{
+    static const char zeros[8] = {0,};
+    size_t padding             = DEFINITIONS_CACHE_ALIGN(size) - size;
+    if ((size && fwrite(data, 1, size, fh) != size) || (padding && fwrite(zeros, 1, padding, fh) != padding))
+        return GRIB_IO_PROBLEM;
+    *offset += size + padding;
+    return GRIB_SUCCESS;
+}
+
+static int writer_save(definitions_cache_writer* w, const char* filename)
+{
+    char identifier[8]              = DEFINITIONS_CACHE_IDENTIFIER;
+    definitions_cache_header header = {0,};
+    char* tmp                       = NULL;
+    size_t len                      = strlen(filename) + 32;
+    uint64_t offset                 = 0;
+    FILE* fh                        = NULL;
+    int err                         = 0;
+
+    /* The files are searched by path */
+    GRIB_MUTEX_INIT_ONCE(&once, &init);
+    GRIB_MUTEX_LOCK(&mutex);
+    sorted_strings = w->strings;
+    qsort(w->files, w->num_files, sizeof(definitions_cache_file), &compare_files);
+    sorted_strings = NULL;
+    GRIB_MUTEX_UNLOCK(&mutex);
+
+    header.byte_order        = DEFINITIONS_CACHE_BYTE_ORDER;
+    header.version           = DEFINITIONS_CACHE_VERSION;
+    header.num_files         = w->num_files;
+    header.num_values        = w->num_values;
+    header.num_conditions    = w->num_conditions;
+    header.num_longs         = w->num_longs;
+    header.files_offset      = sizeof(identifier) + DEFINITIONS_CACHE_ALIGN(sizeof(header));
+    header.values_offset     = header.files_offset + DEFINITIONS_CACHE_ALIGN(w->num_files * sizeof(definitions_cache_file));
+    header.conditions_offset = header.values_offset + DEFINITIONS_CACHE_ALIGN(w->num_values * sizeof(definitions_cache_value));
+    header.longs_offset      = header.conditions_offset + DEFINITIONS_CACHE_ALIGN(w->num_conditions * sizeof(definitions_cache_condition));
+    header.strings_offset    = header.longs_offset + DEFINITIONS_CACHE_ALIGN(w->num_longs * sizeof(int64_t));
+    header.strings_size      = w->strings_size;
+
+    /* Written aside then renamed: processes may have the previous cache mapped */
+    tmp = (char*)grib_context_malloc(w->context, len);
+    if (!tmp)
+        return GRIB_OUT_OF_MEMORY;
+    snprintf(tmp, len, "%s.%ld.tmp", filename, (long)getpid());
+    fh = fopen(tmp, "wb");
+    if (!fh) {
+        grib_context_log(w->context, (GRIB_LOG_ERROR) | (GRIB_LOG_PERROR), "Unable to write file %s", tmp);
+        grib_context_free(w->context, tmp);
+        return GRIB_IO_PROBLEM;
+    }
+    if ((err = write_part(fh, identifier, sizeof(identifier), &offset)) == GRIB_SUCCESS &&
+        (err = write_part(fh, &header, sizeof(header), &offset)) == GRIB_SUCCESS &&
+        (err = write_part(fh, w->files, w->num_files * sizeof(definitions_cache_file), &offset)) == GRIB_SUCCESS &&
+        (err = write_part(fh, w->values, w->num_values * sizeof(definitions_cache_value), &offset)) == GRIB_SUCCESS &&
+        (err = write_part(fh, w->conditions, w->num_conditions * sizeof(definitions_cache_condition), &offset)) == GRIB_SUCCESS &&
+        (err = write_part(fh, w->longs, w->num_longs * sizeof(int64_t), &offset)) == GRIB_SUCCESS) {
+        err = write_part(fh, w->strings, w->strings_size, &offset);
+    }
+    if (fclose(fh) != 0 && err == GRIB_SUCCESS)
+        err = GRIB_IO_PROBLEM;
+#ifdef ECCODES_ON_WINDOWS
+    if (err == GRIB_SUCCESS)
+        remove(filename);
+#endif
+    if (err == GRIB_SUCCESS && rename(tmp, filename) != 0)
+        err = GRIB_IO_PROBLEM;
+    if (err) {
+        grib_context_log(w->context, (GRIB_LOG_ERROR) | (GRIB_LOG_PERROR), "Unable to write file %s", filename);
+        remove(tmp);
+    }
+    grib_context_free(w->context, tmp);
+    return err;
+}
+
+/* Compile the concept and hash array files among 'files' into the cache 'filename'. The other
+ * definition files, and those with conditions the cache cannot hold, are left out
+ */
+int grib_definitions_cache_write(grib_context* c, const char* filename, char* const* files, size_t num_files, size_t* num_compiled)
+{
+    definitions_cache_writer w;
+    size_t i = 0;
+    int err  = 0;
+
+    if (!c)
+        c = grib_context_get_default();
+    memset(&w, 0, sizeof(w));
+    w.context = c;
+
+    for (i = 0; i < num_files && err == GRIB_SUCCESS; i++) {
+        struct stat st;
+        if (stat(files[i], &st) != 0 || !S_ISREG(st.st_mode)) {
+            grib_context_log(c, (GRIB_LOG_ERROR) | (GRIB_LOG_PERROR), "Unable to read file %s", files[i]);
+            err = GRIB_IO_PROBLEM;
+            break;
+        }
+        err = writer_add_file(&w, files[i], &st);
+        if (err == GRIB_NOT_IMPLEMENTED) {
+            grib_context_log(c, GRIB_LOG_DEBUG, "Definitions cache: %s not compiled", files[i]);
+            err = GRIB_SUCCESS;
+        }
+    }
+    if (err == GRIB_SUCCESS)
+        err = writer_save(&w, filename);
+    if (num_compiled)
+        *num_compiled = err ? 0 : w.num_files;
+
+    grib_context_free(c, w.strings);
+    grib_context_free(c, w.string_slots);
+    grib_context_free(c, w.files);
+    grib_context_free(c, w.values);
+    grib_context_free(c, w.conditions);
+    grib_context_free(c, w.longs);
+    return err;
+}
+
+/* ---- Reading ---- */
+
+static void definitions_cache_free(grib_definitions_cache* cache)
+{
+    if (!cache || cache == &no_definitions_cache)
+        return;
+    if (cache->mmap_file)
+        grib_mmap_file_release(cache->mmap_file);
+    grib_context_free(cache->context, cache->buffer);
+    grib_context_free(cache->context, cache);
+}
+
+/* Check a part of 'count' elements of 'size' bytes lies within the file */
+static int part_ok(const grib_definitions_cache* cache, uint64_t offset, uint64_t count, size_t size)
+{
+    if (offset % 8 != 0 || offset > cache->length)
+        return 0;
+    return count <= (cache->length - offset) / size;
+}
+
+/* Map the cache file, NULL if it cannot be used */
+static grib_definitions_cache* definitions_cache_open(grib_context* c, const char* filename)
+{
+    grib_definitions_cache* cache           = NULL;
+    const definitions_cache_header* header = NULL;
+    struct stat st;
+    int err = 0;
+
+    /* Not having a cache is usual */
+    if (stat(filename, &st) != 0 || !S_ISREG(st.st_mode))
+        return NULL;
+
+    cache = (grib_definitions_cache*)grib_context_malloc_clear(c, sizeof(grib_definitions_cache));
+    if (!cache)
+        return NULL;
+    cache->context = c;
+
+#ifndef ECCODES_ON_WINDOWS
+    cache->mmap_file = codes_mmap_file_open(c, filename, &err);
+    if (!cache->mmap_file) {
+        definitions_cache_free(cache);
+        return NULL;
+    }
+    cache->data = grib_mmap_file_data(cache->mmap_file, &cache->length);
+#else
+    {
+        FILE* fh = fopen(filename, "rb");
+        if (fh && fseeko(fh, 0, SEEK_END) == 0) {
+            cache->length = (size_t)ftello(fh);
+            cache->buffer = (unsigned char*)grib_context_malloc(c, cache->length + 1);
+            if (!cache->buffer || fseeko(fh, 0, SEEK_SET) != 0 ||
+                fread(cache->buffer, 1, cache->length, fh) != cache->length) {
+                fclose(fh);
+                fh = NULL;
+            }
+        }
+        if (!fh) {
+            grib_context_log(c, (GRIB_LOG_ERROR) | (GRIB_LOG_PERROR), "Unable to read file %s", filename);
+            definitions_cache_free(cache);
+            return NULL;
+        }
+        fclose(fh);
+        cache->data = cache->buffer;
+    }
+#endif
+
+    if (cache->length < 8 + sizeof(definitions_cache_header) ||
+        memcmp(cache->data, DEFINITIONS_CACHE_IDENTIFIER, 8) != 0) {
+        grib_context_log(c, GRIB_LOG_WARNING, "%s is not a definitions cache, ignored", filename);
+        definitions_cache_free(cache);
+        return NULL;
+    }
+    header = (const definitions_cache_header*)(cache->data + 8);
+    if (header->byte_order != DEFINITIONS_CACHE_BYTE_ORDER || header->version != DEFINITIONS_CACHE_VERSION) {
+        grib_context_log(c, GRIB_LOG_WARNING, "Definitions cache %s was written by another version or machine, ignored", filename);
+        definitions_cache_free(cache);
+        return NULL;
+    }
+    if (!part_ok(cache, header->files_offset, header->num_files, sizeof(definitions_cache_file)) ||
+        !part_ok(cache, header->values_offset, header->num_values, sizeof(definitions_cache_value)) ||
+        !part_ok(cache, header->conditions_offset, header->num_conditions, sizeof(definitions_cache_condition)) ||
+        !part_ok(cache, header->longs_offset, header->num_longs, sizeof(int64_t)) ||
+        !part_ok(cache, header->strings_offset, header->strings_size, 1) ||
+        header->strings_size == 0 || cache->data[header->strings_offset + header->strings_size - 1] != 0) {
+        grib_context_log(c, GRIB_LOG_WARNING, "Definitions cache %s is corrupted, ignored", filename);
+        definitions_cache_free(cache);
+        return NULL;
+    }
+    cache->header     = header;
+    cache->files      = (const definitions_cache_file*)(cache->data + header->files_offset);
+    cache->values     = (const definitions_cache_value*)(cache->data + header->values_offset);
+    cache->conditions = (const definitions_cache_condition*)(cache->data + header->conditions_offset);
+    cache->longs      = (const int64_t*)(cache->data + header->longs_offset);
+    cache->strings    = (const char*)(cache->data + header->strings_offset);
+    grib_context_log(c, GRIB_LOG_DEBUG, "Using definitions cache %s", filename);
+    return cache;
+}
+
+/* The cache of the context, opened the first time */
+static grib_definitions_cache* definitions_cache_get(grib_context* c)
+{
+    grib_definitions_cache* cache = NULL;
+
+    GRIB_MUTEX_INIT_ONCE(&once, &init);
+    GRIB_MUTEX_LOCK(&mutex);
+    if (!c->definitions_cache) {
+        const char* path = getenv("ECCODES_DEFINITION_CACHE");
+        if (path) {
+            if (*path)
+                cache = definitions_cache_open(c, path);
+        }
+        else {
+            char* default_path = grib_definitions_cache_default_path(c);
+            if (default_path)
+                cache = definitions_cache_open(c, default_path);
+            grib_context_free(c, default_path);
+        }
+        c->definitions_cache = cache ? cache : &no_definitions_cache;
+    }
+    cache = c->definitions_cache;
+    GRIB_MUTEX_UNLOCK(&mutex);
+
+    return cache == &no_definitions_cache ? NULL : cache;
+}
+
+/* The entry of the file, if it has not changed since it was compiled */
+static const definitions_cache_file* find_file(const grib_definitions_cache* cache, const char* filename, uint32_t type)
+{
+    const definitions_cache_header* header = cache->header;
+    const definitions_cache_file* f        = NULL;
+    size_t lo = 0, hi = header->num_files;
+    struct stat st;
+
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        int cmp    = 0;
+        if (cache->files[mid].path >= header->strings_size)
+            return NULL;
+        cmp = strcmp(cache->strings + cache->files[mid].path, filename);
+        if (cmp == 0) {
+            f = &cache->files[mid];
+            break;
+        }
+        if (cmp < 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    if (!f || f->type != type || f->first_value > header->num_values || f->num_values > header->num_values - f->first_value)
+        return NULL;
+
+    if (stat(filename, &st) != 0 || (int64_t)st.st_size != f->size || (int64_t)st.st_mtime != f->mtime) {
+        grib_context_log(cache->context, GRIB_LOG_DEBUG, "Definitions cache: %s has changed, parsing it", filename);
+        return NULL;
+    }
+    return f;
+}
+
+static const char* cached_string(const grib_definitions_cache* cache, uint64_t offset)
+{
+    return offset < cache->header->strings_size ? cache->strings + offset : NULL;
+}
+
+static grib_iarray* cached_iarray(const grib_definitions_cache* cache, uint64_t first, uint32_t count)
+{
+    grib_iarray* a = NULL;
+    uint32_t i     = 0;
+    if (first > cache->header->num_longs || count > cache->header->num_longs - first)
+        return NULL;
+    a = grib_iarray_new(cache->context, count ? count : 1, 100);
+    for (i = 0; a && i < count; i++)
+        grib_iarray_push(a, (long)cache->longs[first + i]);
+    return a;
+}
+
+static grib_concept_condition* cached_condition(const grib_definitions_cache* cache, const definitions_cache_condition* dc)
+{
+    grib_context* c    = cache->context;
+    const char* name   = cached_string(cache, dc->name);
+    grib_expression* e = NULL;
+    grib_iarray* a     = NULL;
+    const char* s      = NULL;
+    int64_t lval       = 0;
+    double dval        = 0;
+
+    if (!name)
+        return NULL;
+    switch (dc->type) {
+        case CONDITION_LONG:
+            memcpy(&lval, &dc->value, sizeof(lval));
+            e = new_long_expression(c, (long)lval);
+            break;
+        case CONDITION_DOUBLE:
+            memcpy(&dval, &dc->value, sizeof(dval));
+            e = new_double_expression(c, dval);
+            break;
+        case CONDITION_STRING:
+            if ((s = cached_string(cache, dc->value)) != NULL)
+                e = new_string_expression(c, s);
+            break;
+        case CONDITION_FUNCTOR:
+            if ((s = cached_string(cache, dc->value)) != NULL)
+                e = new_func_expression(c, s, NULL);
+            break;
+        case CONDITION_IARRAY:
+            a = cached_iarray(cache, dc->value, dc->count);
+            break;
+    }
+    if (!e && !a)
+        return NULL;
+    return grib_concept_condition_new(c, name, e, a);
+}
+
+static void concept_values_delete(grib_context* c, grib_concept_value* v)
+{
+    while (v) {
+        grib_concept_value* next = v->next;
+        grib_concept_value_delete(c, v);
+        v = next;
+    }
+}
+
+/* The values of the concept file from the cache, NULL to parse it */
+grib_concept_value* grib_definitions_cache_get_concept(grib_context* c, const char* filename)
+{
+    const grib_definitions_cache* cache = NULL;
+    const definitions_cache_file* f     = NULL;
+    grib_concept_value *first = NULL, *last = NULL;
+    uint32_t i = 0, j = 0;
+
+    if (!c)
+        c = grib_context_get_default();
+    if ((cache = definitions_cache_get(c)) == NULL ||
+        (f = find_file(cache, filename, DEFINITIONS_CACHE_CONCEPT)) == NULL)
+        return NULL;
+
+    for (i = 0; i < f->num_values; i++) {
+        const definitions_cache_value* dv   = &cache->values[f->first_value + i];
+        const char* name                     = cached_string(cache, dv->name);
+        grib_concept_condition *conds = NULL, *last_cond = NULL;
+        grib_concept_value* v = NULL;
+
+        if (!name || dv->first > cache->header->num_conditions || dv->count > cache->header->num_conditions - dv->first)
+            break;
+        for (j = 0; j < dv->count; j++) {
+            grib_concept_condition* cond = cached_condition(cache, &cache->conditions[dv->first + j]);
+            if (!cond)
+                break;
+            if (last_cond)
+                last_cond->next = cond;
+            else
+                conds = cond;
+            last_cond = cond;
+        }
+        v = grib_concept_value_new(c, name, conds);
+        if (last)
+            last->next = v;
+        else
+            first = v;
+        last = v;
+        if (j < dv->count)
+            break;
+    }
+    if (i < f->num_values) {
+        grib_context_log(c, GRIB_LOG_WARNING, "Definitions cache: %s is corrupted, parsing it", filename);
+        concept_values_delete(c, first);
+        return NULL;
+    }
+    grib_context_log(c, GRIB_LOG_DEBUG, "Definitions cache: loaded %s", filename);
+    return first;
+}
+
+/* The values of the hash array file from the cache, NULL to parse it */
+grib_hash_array_value* grib_definitions_cache_get_hash_array(grib_context* c, const char* filename)
+{
+    const grib_definitions_cache* cache = NULL;
+    const definitions_cache_file* f     = NULL;
+    grib_hash_array_value *first = NULL, *last = NULL;
+    uint32_t i = 0;
+
+    if (!c)
+        c = grib_context_get_default();
+    if ((cache = definitions_cache_get(c)) == NULL ||
+        (f = find_file(cache, filename, DEFINITIONS_CACHE_HASH_ARRAY)) == NULL)
+        return NULL;
+
+    for (i = 0; i < f->num_values; i++) {
+        const definitions_cache_value* dv = &cache->values[f->first_value + i];
+        const char* name                   = cached_string(cache, dv->name);
+        grib_iarray* a                     = NULL;
+        grib_hash_array_value* v           = NULL;
+
+        if (!name || (a = cached_iarray(cache, dv->first, dv->count)) == NULL)
+            break;
+        v = grib_integer_hash_array_value_new(c, name, a);
+        if (last)
+            last->next = v;
+        else
+            first = v;
+        last = v;
+    }
+    if (i < f->num_values) {
+        grib_context_log(c, GRIB_LOG_WARNING, "Definitions cache: %s is corrupted, parsing it", filename);
+        while (first) {
+            grib_hash_array_value* next = first->next;
+            grib_hash_array_value_delete(c, first);
+            first = next;
+        }
+        return NULL;
+    }
+    grib_context_log(c, GRIB_LOG_DEBUG, "Definitions cache: loaded %s", filename);
+    return first;
+}
+
+void grib_definitions_cache_delete(grib_context* c)
+{
+    grib_definitions_cache* cache = NULL;
+    GRIB_MUTEX_INIT_ONCE(&once, &init);
+    GRIB_MUTEX_LOCK(&mutex);
+    cache                = c->definitions_cache;
+    c->definitions_cache = NULL;
+    GRIB_MUTEX_UNLOCK(&mutex);
+    definitions_cache_free(cache);
+}
@@ -26,7 +26,9 @@
    IMPLEMENTS = evaluate_long
    IMPLEMENTS = evaluate_double
    IMPLEMENTS = evaluate_string
+   MEMBERS    = char* name
    MEMBERS    = grib_column* column
+   MEMBERS    = const long* row
    END_CLASS_DEF
 
  */
@@ -58,7 +60,9 @@ static string evaluate_string(grib_expression*,grib_handle*,char*,size_t*,int*);
 typedef struct grib_expression_column{
   grib_expression base;
     /* Members defined in column */
+    char* name;
     grib_column* column;
+    const long* row;
 } grib_expression_column;
 
 
@@ -93,35 +97,70 @@ static const char* get_name(grib_expression* g)
     return e->name;
 }
 
+/* A column of a fieldset, evaluated at the row pointed to by 'row' without any handle.
+ * A row where the key could not be read has no value: GRIB_NOT_FOUND
+ */
 static int evaluate_long(grib_expression* g, grib_handle* h, long* result)
 {
     grib_expression_column* e = (grib_expression_column*)g;
-    int err;
-    if ((err = grib_get_long_internal(h, e->name, result)) != GRIB_SUCCESS)
-        grib_context_log(h->context, GRIB_LOG_DEBUG,
-                         "Error in evaluate_long %s : %s", e->name, grib_get_error_message(err));
-    return err;
+    const long row            = *e->row;
+    if (e->column->errors[row])
+        return GRIB_NOT_FOUND;
+    switch (e->column->type) {
+        case GRIB_TYPE_LONG:
+            *result = e->column->long_values[row];
+            return GRIB_SUCCESS;
+        case GRIB_TYPE_DOUBLE:
+            *result = (long)e->column->double_values[row];
+            return GRIB_SUCCESS;
+        default:
+            return GRIB_INVALID_TYPE;
+    }
 }
 
 static int evaluate_double(grib_expression* g, grib_handle* h, double* result)
 {
     grib_expression_column* e = (grib_expression_column*)g;
-    int err;
-    if ((err = grib_get_double_internal(h, e->name, result)) != GRIB_SUCCESS)
-        grib_context_log(h->context, GRIB_LOG_DEBUG,
-                         "Error in evaluate_double %s : %s", e->name, grib_get_error_message(err));
-    return err;
+    const long row            = *e->row;
+    if (e->column->errors[row])
+        return GRIB_NOT_FOUND;
+    switch (e->column->type) {
+        case GRIB_TYPE_LONG:
+            *result = e->column->long_values[row];
+            return GRIB_SUCCESS;
+        case GRIB_TYPE_DOUBLE:
+            *result = e->column->double_values[row];
+            return GRIB_SUCCESS;
+        default:
+            return GRIB_INVALID_TYPE;
+    }
 }
 
 static string evaluate_string(grib_expression* g, grib_handle* h, char* buf, size_t* size, int* err)
 {
     grib_expression_column* e = (grib_expression_column*)g;
+    const long row            = *e->row;
     Assert(buf);
-    if ((*err = grib_get_string_internal(h, e->name, buf, size)) != GRIB_SUCCESS) {
-        grib_context_log(h->context, GRIB_LOG_DEBUG,
-                         "Error in evaluate_string %s : %s", e->name, grib_get_error_message(err));
+    *err = GRIB_SUCCESS;
+    if (e->column->errors[row]) {
+        *err = GRIB_NOT_FOUND;
         return NULL;
     }
+    switch (e->column->type) {
+        case GRIB_TYPE_LONG:
+            snprintf(buf, *size, "%ld", e->column->long_values[row]);
+            break;
+        case GRIB_TYPE_DOUBLE:
+            snprintf(buf, *size, "%g", e->column->double_values[row]);
+            break;
+        case GRIB_TYPE_STRING:
+            snprintf(buf, *size, "%s", e->column->string_values[row]);
+            break;
+        default:
+            *err = GRIB_INVALID_TYPE;
+            return NULL;
+    }
+    *size = strlen(buf);
     return buf;
 }
 
@@ -131,12 +170,13 @@ static void destroy(grib_context* c, grib_expression* g)
     grib_context_free_persistent(c, e->name);
 }
 
-
-grib_expression* new_column_expression(grib_context* c, const char* name)
+grib_expression* new_column_expression(grib_context* c, const char* name, grib_column* column, const long* row)
 {
-    grib_expression_column* e = grib_context_malloc_clear_persistent(c, sizeof(grib_expression_column));
+    grib_expression_column* e = (grib_expression_column*)grib_context_malloc_clear_persistent(c, sizeof(grib_expression_column));
     e->base.cclass            = grib_expression_class_column;
     e->name                   = grib_context_strdup_persistent(c, name);
+    e->column                 = column;
+    e->row                    = row;
     return (grib_expression*)e;
 }
 
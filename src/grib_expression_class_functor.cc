@@ -202,3 +202,13 @@ static int native_type(grib_expression* g, grib_handle* h)
 {
     return GRIB_TYPE_LONG;
 }
+
+/* The name of a functor called without arguments, like missing() in the concept files.
+ * NULL for any other expression */
+const char* grib_expression_functor_name(grib_expression* g)
+{
+    grib_expression_functor* e = (grib_expression_functor*)g;
+    if (!g || g->cclass != grib_expression_class_functor || e->args)
+        return NULL;
+    return e->name;
+}
@@ -17,11 +17,6 @@
 #define GRIB_START_ARRAY_SIZE 5000
 #define GRIB_ARRAY_INCREMENT 1000
 
-#define SWAP(a, b) \
-    temp = (a);    \
-    (a)  = (b);    \
-    (b)  = temp;
-
 #define GRIB_ORDER_BY_ASC 1
 #define GRIB_ORDER_BY_DESC -1
 
@@ -44,7 +39,7 @@ static grib_fieldset* grib_fieldset_create_from_order_by(grib_context* c, grib_o
 static int grib_fieldset_resize(grib_fieldset* set, size_t newsize);
 static void grib_trim(char** x);
 static grib_order_by* grib_fieldset_new_order_by(grib_context* c, const char* z);
-static void grib_fieldset_sort(grib_fieldset* set, int theStart, int theEnd);
+static int grib_fieldset_sort(grib_fieldset* set);
 static grib_int_array* grib_fieldset_create_int_array(grib_context* c, size_t size);
 static int grib_fieldset_resize_int_array(grib_int_array* a, size_t newsize);
 static void grib_fieldset_delete_int_array(grib_int_array* f);
@@ -287,17 +282,21 @@ grib_fieldset* grib_fieldset_new_from_files(grib_context* c, const char* filenam
         set = grib_fieldset_create_from_keys(c, keys, nkeys, err);
     }
 
-    *err = GRIB_SUCCESS;
-    for (i = 0; i < nfiles; i++) {
-        ret = grib_fieldset_add(set, filenames[i]);
+    /* The where clause selects the fields as they are read */
+    if (where_string) {
+        ret = grib_fieldset_apply_where(set, where_string);
         if (ret != GRIB_SUCCESS) {
+            if (ob && (!set || set->order_by != ob))
+                grib_fieldset_delete_order_by(c, ob);
+            grib_fieldset_delete(set);
             *err = ret;
             return NULL;
         }
     }
 
-    if (where_string) {
-        ret = grib_fieldset_apply_where(set, where_string);
+    *err = GRIB_SUCCESS;
+    for (i = 0; i < nfiles; i++) {
+        ret = grib_fieldset_add(set, filenames[i]);
         if (ret != GRIB_SUCCESS) {
             *err = ret;
             return NULL;
@@ -307,9 +306,10 @@ grib_fieldset* grib_fieldset_new_from_files(grib_context* c, const char* filenam
     if (order_by_string) {
         if (!set->order_by && ob)
             *err = grib_fieldset_set_order_by(set, ob);
+        if (*err == GRIB_SUCCESS)
+            *err = grib_fieldset_sort(set);
         if (*err != GRIB_SUCCESS)
             return NULL;
-        grib_fieldset_sort(set, 0, set->size - 1);
         grib_fieldset_rewind(set);
     }
 
@@ -411,17 +411,376 @@ static grib_fieldset* grib_fieldset_create_from_order_by(grib_context* c, grib_o
     return set;
 }
 
-// Experimental: Needs more work
+/* --------------- where clause ------------------*/
+/*
+ * A where clause is compiled into an expression evaluated on the columns of the fieldset,
+ * so fields are selected without creating their handles. For example:
+ *     (centre == 'ecmf' && number == 1) || step >= 6
+ * The operands are keys of the fieldset, numbers and quoted strings. The comparisons are
+ * ==, =, !=, <>, <, <=, > and >=, strings can only be tested for equality. Conditions are
+ * combined with && (and), || (or), ! (not) and parentheses.
+ * A field without a value for one of the keys of the clause is not selected.
+ */
+#define WHERE_COLUMN 1
+#define WHERE_NUMBER 2
+#define WHERE_STRING 3
+
+typedef struct where_parser
+{
+    grib_fieldset* set;
+    grib_where* where;
+    const char* p; /* Next character to read */
+    int err;
+} where_parser;
+
+typedef struct where_operand
+{
+    int kind;
+    int column;      /* Index of the column, for WHERE_COLUMN */
+    char text[1024]; /* For WHERE_NUMBER and WHERE_STRING */
+} where_operand;
+
+static grib_expression* where_parse_or(where_parser* w);
+
+static void where_error(where_parser* w, const char* message)
+{
+    if (!w->err) {
+        grib_context_log(w->set->context, GRIB_LOG_ERROR, "grib_fieldset_apply_where: %s at \"%s\" in \"%s\"",
+                         message, w->p, w->where->string);
+        w->err = GRIB_INVALID_ARGUMENT;
+    }
+}
+
+static void where_skip_spaces(where_parser* w)
+{
+    while (isspace((unsigned char)*w->p))
+        w->p++;
+}
+
+static int where_is_name_char(char c)
+{
+    return isalnum((unsigned char)c) || c == '_' || c == '.';
+}
+
+/* Accept an operator or a keyword */
+static int where_accept(where_parser* w, const char* token)
+{
+    size_t len = strlen(token);
+    where_skip_spaces(w);
+    if (strncmp(w->p, token, len) != 0)
+        return 0;
+    if (isalpha((unsigned char)token[0]) && where_is_name_char(w->p[len]))
+        return 0; /* A key starting with a keyword */
+    w->p += len;
+    return 1;
+}
+
+static int where_parse_operand(where_parser* w, where_operand* o)
+{
+    const char* start = NULL;
+    size_t len        = 0;
+    int i             = 0;
+
+    where_skip_spaces(w);
+    start = w->p;
+    if (*w->p == '\'' || *w->p == '"') {
+        const char quote = *w->p++;
+        while (*w->p && *w->p != quote)
+            w->p++;
+        if (*w->p != quote) {
+            where_error(w, "missing closing quote");
+            return 0;
+        }
+        o->kind = WHERE_STRING;
+        len     = w->p - start - 1;
+        start++;
+        w->p++;
+    }
+    else if (isdigit((unsigned char)*w->p) || *w->p == '-' || *w->p == '+' || *w->p == '.') {
+        char* end = NULL;
+        strtod(start, &end);
+        if (end == start) {
+            where_error(w, "invalid number");
+            return 0;
+        }
+        o->kind = WHERE_NUMBER;
+        len     = end - start;
+        w->p    = end;
+    }
+    else if (isalpha((unsigned char)*w->p) || *w->p == '_') {
+        while (where_is_name_char(*w->p))
+            w->p++;
+        o->kind = WHERE_COLUMN;
+        len     = w->p - start;
+    }
+    else {
+        where_error(w, "expected a key, a number or a string");
+        return 0;
+    }
+
+    if (len >= sizeof(o->text)) {
+        where_error(w, "value too long");
+        return 0;
+    }
+    memcpy(o->text, start, len);
+    o->text[len] = 0;
+
+    if (o->kind == WHERE_COLUMN) {
+        for (i = 0; i < w->set->columns_size; i++) {
+            if (w->set->columns[i].name && !grib_inline_strcmp(o->text, w->set->columns[i].name))
+                break;
+        }
+        if (i == w->set->columns_size) {
+            grib_context_log(w->set->context, GRIB_LOG_ERROR,
+                             "grib_fieldset_apply_where: Key %s missing from the fieldset", o->text);
+            w->err = GRIB_MISSING_KEY;
+            return 0;
+        }
+        o->column = i;
+    }
+    return 1;
+}
+
+static int where_operand_is_string(const where_parser* w, const where_operand* o)
+{
+    return o->kind == WHERE_STRING ||
+           (o->kind == WHERE_COLUMN && w->set->columns[o->column].type == GRIB_TYPE_STRING);
+}
+
+static grib_expression* where_new_operand(where_parser* w, const where_operand* o, int as_string)
+{
+    grib_context* c = w->set->context;
+    char* end       = NULL;
+    long lval       = 0;
+
+    if (o->kind == WHERE_COLUMN)
+        return new_column_expression(c, o->text, &w->set->columns[o->column], &w->where->row);
+    if (o->kind == WHERE_STRING || as_string)
+        return new_string_expression(c, o->text);
+    lval = strtol(o->text, &end, 10);
+    if (*end == 0)
+        return new_long_expression(c, lval);
+    return new_double_expression(c, strtod(o->text, NULL));
+}
+
+/* Negation of a condition of any type */
+static grib_expression* where_new_not(grib_context* c, grib_expression* e)
+{
+    return new_binop_expression(c, &grib_op_eq, &grib_op_eq_d, e, new_long_expression(c, 0));
+}
+
+static grib_expression* where_parse_comparison(where_parser* w)
+{
+    static const struct
+    {
+        const char* token;
+        grib_binop_long_proc long_func;
+        grib_binop_double_proc double_func;
+    } ops[] = {
+        { "==", &grib_op_eq, &grib_op_eq_d },
+        { "!=", &grib_op_ne, &grib_op_ne_d },
+        { "<>", &grib_op_ne, &grib_op_ne_d },
+        { "<=", &grib_op_le, &grib_op_le_d },
+        { ">=", &grib_op_ge, &grib_op_ge_d },
+        { "=", &grib_op_eq, &grib_op_eq_d },
+        { "<", &grib_op_lt, &grib_op_lt_d },
+        { ">", &grib_op_gt, &grib_op_gt_d },
+    };
+    grib_context* c = w->set->context;
+    where_operand left, right;
+    grib_expression* e = NULL;
+    size_t i = 0, nops = sizeof(ops) / sizeof(ops[0]);
+    int as_string = 0;
+
+    if (!where_parse_operand(w, &left))
+        return NULL;
+    for (i = 0; i < nops; i++) {
+        if (where_accept(w, ops[i].token))
+            break;
+    }
+    if (i == nops) {
+        /* A number or a key on its own is true when not zero */
+        if (where_operand_is_string(w, &left)) {
+            where_error(w, "expected a comparison");
+            return NULL;
+        }
+        return where_new_operand(w, &left, 0);
+    }
+    if (!where_parse_operand(w, &right))
+        return NULL;
+
+    as_string = where_operand_is_string(w, &left) || where_operand_is_string(w, &right);
+    if (!as_string)
+        return new_binop_expression(c, ops[i].long_func, ops[i].double_func,
+                                    where_new_operand(w, &left, 0), where_new_operand(w, &right, 0));
+
+    if (ops[i].long_func != &grib_op_eq && ops[i].long_func != &grib_op_ne) {
+        where_error(w, "strings can only be compared with == or !=");
+        return NULL;
+    }
+    e = new_string_compare_expression(c, where_new_operand(w, &left, 1), where_new_operand(w, &right, 1));
+    return ops[i].long_func == &grib_op_ne ? where_new_not(c, e) : e;
+}
+
+static grib_expression* where_parse_not(where_parser* w)
+{
+    grib_expression* e = NULL;
+
+    if (where_accept(w, "!") || where_accept(w, "not")) {
+        e = where_parse_not(w);
+        return e ? where_new_not(w->set->context, e) : NULL;
+    }
+    if (where_accept(w, "(")) {
+        e = where_parse_or(w);
+        if (e && !where_accept(w, ")")) {
+            where_error(w, "missing closing parenthesis");
+            grib_expression_free(w->set->context, e);
+            return NULL;
+        }
+        return e;
+    }
+    return where_parse_comparison(w);
+}
+
+static grib_expression* where_parse_and(where_parser* w)
+{
+    grib_expression* left  = where_parse_not(w);
+    grib_expression* right = NULL;
+
+    while (left && (where_accept(w, "&&") || where_accept(w, "and"))) {
+        right = where_parse_not(w);
+        if (!right) {
+            grib_expression_free(w->set->context, left);
+            return NULL;
+        }
+        left = new_logical_and_expression(w->set->context, left, right);
+    }
+    return left;
+}
+
+static grib_expression* where_parse_or(where_parser* w)
+{
+    grib_expression* left  = where_parse_and(w);
+    grib_expression* right = NULL;
+
+    while (left && (where_accept(w, "||") || where_accept(w, "or"))) {
+        right = where_parse_and(w);
+        if (!right) {
+            grib_expression_free(w->set->context, left);
+            return NULL;
+        }
+        left = new_logical_or_expression(w->set->context, left, right);
+    }
+    return left;
+}
+
+static void grib_fieldset_delete_where(grib_where* where)
+{
+    if (!where)
+        return;
+    if (where->expression)
+        grib_expression_free(where->context, where->expression);
+    grib_context_free(where->context, where->string);
+    grib_context_free(where->context, where);
+}
+
+static grib_where* grib_fieldset_new_where(grib_fieldset* set, const char* where_string, int* err)
+{
+    grib_context* c = set->context;
+    where_parser w;
+
+    w.set   = set;
+    w.err   = 0;
+    w.where = (grib_where*)grib_context_malloc_clear(c, sizeof(grib_where));
+    if (!w.where) {
+        *err = GRIB_OUT_OF_MEMORY;
+        return NULL;
+    }
+    w.where->context = c;
+    w.where->string  = grib_context_strdup(c, where_string);
+    w.p              = w.where->string;
+
+    w.where->expression = where_parse_or(&w);
+    where_skip_spaces(&w);
+    if (w.where->expression && *w.p != 0)
+        where_error(&w, "unexpected characters");
+    if (!w.where->expression && !w.err)
+        where_error(&w, "invalid clause");
+    if (w.err) {
+        *err = w.err;
+        grib_fieldset_delete_where(w.where);
+        return NULL;
+    }
+    *err = GRIB_SUCCESS;
+    return w.where;
+}
+
+/* Whether the row of the columns matches the where clause of the fieldset */
+static int grib_fieldset_where_match(grib_fieldset* set, long row, int* match)
+{
+    grib_where* where  = set->where;
+    grib_expression* e = where->expression;
+    int err            = 0;
+
+    *match     = 1;
+    where->row = row;
+    if (grib_expression_native_type(NULL, e) == GRIB_TYPE_DOUBLE) {
+        double dres = 0;
+        err         = grib_expression_evaluate_double(NULL, e, &dres);
+        *match      = (dres != 0);
+    }
+    else {
+        long lres = 0;
+        err       = grib_expression_evaluate_long(NULL, e, &lres);
+        *match    = (lres != 0);
+    }
+    if (err == GRIB_NOT_FOUND) {
+        *match = 0;
+        err    = GRIB_SUCCESS;
+    }
+    return err;
+}
+
+/* Select the fields matching the where clause, replacing any previous one.
+ * Fields added to the fieldset afterwards are selected as they are read
+ */
 int grib_fieldset_apply_where(grib_fieldset* set, const char* where_string)
 {
-    // grib_math* m = NULL;
-    // m = grib_math_new(set->context, where_string, &err);
-    // if (err || !m) return err;
+    grib_where* where = NULL;
+    size_t num_rows   = 0;
+    size_t i          = 0;
+    int match         = 0;
+    int err           = 0;
 
-    // print_math(m);
-    // printf("\n");
-    // grib_math_delete(set->context, m);
-    return GRIB_NOT_IMPLEMENTED;
+    if (!set || !where_string)
+        return GRIB_INVALID_ARGUMENT;
+
+    where = grib_fieldset_new_where(set, where_string, &err);
+    if (!where)
+        return err;
+    grib_fieldset_delete_where(set->where);
+    set->where = where;
+
+    /* Keep the matching fields in file order */
+    num_rows  = set->columns_size ? set->columns[0].size : 0;
+    set->size = 0;
+    for (i = 0; i < num_rows; i++) {
+        if (!set->fields[i])
+            continue;
+        if ((err = grib_fieldset_where_match(set, i, &match)) != GRIB_SUCCESS)
+            return err;
+        if (match) {
+            set->filter->el[set->size] = i;
+            set->order->el[set->size]  = set->size;
+            set->size++;
+        }
+    }
+
+    if (set->order_by && (err = grib_fieldset_sort(set)) != GRIB_SUCCESS)
+        return err;
+    grib_fieldset_rewind(set);
+
+    return GRIB_SUCCESS;
 }
 
 int grib_fieldset_apply_order_by(grib_fieldset* set, const char* order_by_string)
@@ -442,97 +801,232 @@ int grib_fieldset_apply_order_by(grib_fieldset* set, const char* order_by_string
         return err;
 
     if (set->order_by)
-        grib_fieldset_sort(set, 0, set->size - 1);
+        err = grib_fieldset_sort(set);
 
     grib_fieldset_rewind(set);
 
     return err;
 }
 
-static int grib_fieldset_compare(grib_fieldset* set, const int* i, const int* j)
+/* --------------- sorting ------------------*/
+/*
+ * The fields are sorted on unsigned integer keys computed once per field and per key of
+ * the order by, in the same order as the values of the column (descending: inverted).
+ * Strings are replaced by their rank among the distinct strings of the column.
+ * Each key is sorted with a stable radix sort, from the last key of the order by to the
+ * first, so fields with the same keys stay in file order.
+ */
+
+static uint64_t fieldset_sort_key_long(long value)
 {
-    int ret           = 0;
-    double d          = 0;
-    int idkey         = 0;
-    grib_order_by* ob = NULL;
-    int ii = 0, jj = 0;
-    int* order = NULL;
+    return (uint64_t)(int64_t)value ^ ((uint64_t)1 << 63);
+}
 
-    if (!set || !set->order_by)
-        return GRIB_INVALID_ARGUMENT;
-    ob    = set->order_by;
-    order = set->order->el;
+static uint64_t fieldset_sort_key_double(double value)
+{
+    uint64_t bits = 0;
+    if (value == 0)
+        value = 0; /* -0 and 0 are equal */
+    memcpy(&bits, &value, sizeof(bits));
+    return (bits >> 63) ? ~bits : bits | ((uint64_t)1 << 63);
+}
 
-    ii = *(set->filter->el + *(order + *i));
-    jj = *(set->filter->el + *(order + *j));
+typedef struct fieldset_string_rank
+{
+    const char* value;
+    size_t id;
+} fieldset_string_rank;
 
-    while (ob) {
-        idkey = ob->idkey;
-        switch (set->columns[idkey].type) {
-            case GRIB_TYPE_STRING:
-                ret = strcmp(set->columns[idkey].string_values[ii],
-                             set->columns[idkey].string_values[jj]);
-                break;
+static int fieldset_compare_string_ranks(const void* a, const void* b)
+{
+    return strcmp(((const fieldset_string_rank*)a)->value, ((const fieldset_string_rank*)b)->value);
+}
 
-            case GRIB_TYPE_DOUBLE:
-                d = set->columns[idkey].double_values[ii] -
-                    set->columns[idkey].double_values[jj];
-                if (d > 0)
-                    ret = 1;
-                else if (d == 0)
-                    ret = 0;
-                else
-                    ret = -1;
-                break;
+static uint64_t fieldset_string_hash(const char* s)
+{
+    uint64_t h = 14695981039346656037ULL; /* FNV-1a */
+    while (*s) {
+        h ^= (unsigned char)*s++;
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
 
-            case GRIB_TYPE_LONG:
-                ret = set->columns[idkey].long_values[ii] -
-                      set->columns[idkey].long_values[jj];
-                break;
-            default:
-                return GRIB_INVALID_TYPE;
+/* Slot of 's' in a table of 'size' (a power of 2) distinct string ids, stored plus one */
+static size_t fieldset_string_slot(const size_t* table, size_t size, const fieldset_string_rank* distinct, const char* s)
+{
+    size_t slot = (size_t)fieldset_string_hash(s) & (size - 1);
+    while (table[slot] && strcmp(distinct[table[slot] - 1].value, s) != 0)
+        slot = (slot + 1) & (size - 1);
+    return slot;
+}
+
+/* Set keys[i] to the rank of the string of field i among the distinct strings */
+static int fieldset_string_keys(grib_context* c, char** values, const int* rows, size_t n, uint64_t* keys)
+{
+    fieldset_string_rank* distinct = NULL;
+    size_t* table                  = NULL;
+    size_t* ranks                  = NULL;
+    size_t size = 64, count = 0, i = 0, j = 0;
+    int err = GRIB_SUCCESS;
+
+    distinct = (fieldset_string_rank*)grib_context_malloc(c, n * sizeof(fieldset_string_rank));
+    table    = (size_t*)grib_context_malloc_clear(c, size * sizeof(size_t));
+    if (!distinct || !table) {
+        err = GRIB_OUT_OF_MEMORY;
+        goto cleanup;
+    }
+
+    /* Intern the strings: keys[i] holds the id of the string until ranks are known */
+    for (i = 0; i < n; i++) {
+        const char* s = values[rows[i]] ? values[rows[i]] : "";
+        size_t slot   = fieldset_string_slot(table, size, distinct, s);
+        if (!table[slot]) {
+            distinct[count].value = s;
+            distinct[count].id    = count;
+            table[slot]           = ++count;
+            if (count * 2 > size) {
+                size_t* bigger = (size_t*)grib_context_malloc_clear(c, 2 * size * sizeof(size_t));
+                if (!bigger) {
+                    err = GRIB_OUT_OF_MEMORY;
+                    goto cleanup;
+                }
+                grib_context_free(c, table);
+                table = bigger;
+                size *= 2;
+                for (j = 0; j < count; j++)
+                    table[fieldset_string_slot(table, size, distinct, distinct[j].value)] = j + 1;
+            }
+            keys[i] = count - 1;
         }
-        if (ret != 0) {
-            ret *= ob->mode;
-            break;
+        else {
+            keys[i] = table[slot] - 1;
         }
-        ob = ob->next;
     }
 
-    return ret;
+    qsort(distinct, count, sizeof(fieldset_string_rank), &fieldset_compare_string_ranks);
+    ranks = (size_t*)grib_context_malloc(c, (count ? count : 1) * sizeof(size_t));
+    if (!ranks) {
+        err = GRIB_OUT_OF_MEMORY;
+        goto cleanup;
+    }
+    for (j = 0; j < count; j++)
+        ranks[distinct[j].id] = j;
+    for (i = 0; i < n; i++)
+        keys[i] = ranks[keys[i]];
+
+cleanup:
+    grib_context_free(c, ranks);
+    grib_context_free(c, table);
+    grib_context_free(c, distinct);
+    return err;
 }
 
-static void grib_fieldset_sort(grib_fieldset* set, int theStart, int theEnd)
+/* Stable sort of the n positions in el on keys[position], least significant byte first,
+ * skipping the bytes equal in all the keys. tmp has the same size as el
+ */
+static void fieldset_radix_sort(int* el, int* tmp, size_t n, const uint64_t* keys)
 {
-    double temp;
-    int l = 0, r = 0;
-    if (theEnd > theStart) {
-        l = theStart + 1;
-        r = theEnd;
-        while (l < r) {
-            if (grib_fieldset_compare(set, &l, &theStart) <= 0) {
-                l++;
-            }
-            else if (grib_fieldset_compare(set, &r, &theStart) >= 0) {
-                r--;
-            }
-            else {
-                SWAP(set->order->el[l], set->order->el[r])
-            }
+    size_t counts[8][256];
+    size_t i = 0, b = 0, sum = 0;
+    int* from = el;
+    int* to   = tmp;
+    int* t    = NULL;
+
+    memset(counts, 0, sizeof(counts));
+    for (i = 0; i < n; i++) {
+        for (b = 0; b < 8; b++)
+            counts[b][(keys[i] >> (8 * b)) & 0xff]++;
+    }
+
+    for (b = 0; b < 8; b++) {
+        size_t* count   = counts[b];
+        const int shift = 8 * b;
+        if (count[(keys[0] >> shift) & 0xff] == n)
+            continue;
+        for (i = 0, sum = 0; i < 256; i++) {
+            size_t c = count[i];
+            count[i] = sum;
+            sum += c;
         }
+        for (i = 0; i < n; i++)
+            to[count[(keys[from[i]] >> shift) & 0xff]++] = from[i];
+        t    = from;
+        from = to;
+        to   = t;
+    }
+    if (from != el)
+        memcpy(el, from, n * sizeof(int));
+}
 
-        if (grib_fieldset_compare(set, &l, &theStart) < 0) {
-            SWAP(set->order->el[l], set->order->el[theStart])
-            l--;
+/* Sort the fields of the fieldset with the order by. Fields with equal keys are in file order */
+static int grib_fieldset_sort(grib_fieldset* set)
+{
+    grib_context* c   = NULL;
+    grib_order_by* ob = NULL;
+    uint64_t* keys    = NULL;
+    int* tmp          = NULL;
+    const int* rows   = NULL;
+    size_t n = 0, nkeys = 0, i = 0, k = 0;
+    int err = GRIB_SUCCESS;
+
+    if (!set || !set->order_by)
+        return GRIB_INVALID_ARGUMENT;
+    c    = set->context;
+    n    = set->size;
+    rows = set->filter->el;
+
+    for (i = 0; i < n; i++)
+        set->order->el[i] = i;
+    if (n < 2)
+        return GRIB_SUCCESS;
+    for (ob = set->order_by; ob; ob = ob->next)
+        nkeys++;
+
+    /* The keys of the k-th key of the order by are at keys + k * n */
+    keys = (uint64_t*)grib_context_malloc(c, n * nkeys * sizeof(uint64_t));
+    tmp  = (int*)grib_context_malloc(c, n * sizeof(int));
+    if (!keys || !tmp) {
+        grib_context_log(c, GRIB_LOG_ERROR, "grib_fieldset_sort: Unable to allocate %zu bytes",
+                         n * (nkeys * sizeof(uint64_t) + sizeof(int)));
+        err = GRIB_OUT_OF_MEMORY;
+        goto cleanup;
+    }
+
+    for (ob = set->order_by, k = 0; ob; ob = ob->next, k++) {
+        grib_column* column = &set->columns[ob->idkey];
+        uint64_t* key       = keys + k * n;
+        switch (column->type) {
+            case GRIB_TYPE_LONG:
+                for (i = 0; i < n; i++)
+                    key[i] = fieldset_sort_key_long(column->long_values[rows[i]]);
+                break;
+            case GRIB_TYPE_DOUBLE:
+                for (i = 0; i < n; i++)
+                    key[i] = fieldset_sort_key_double(column->double_values[rows[i]]);
+                break;
+            case GRIB_TYPE_STRING:
+                err = fieldset_string_keys(c, column->string_values, rows, n, key);
+                if (err)
+                    goto cleanup;
+                break;
+            default:
+                err = GRIB_INVALID_TYPE;
+                goto cleanup;
         }
-        else {
-            l--;
-            SWAP(set->order->el[l], set->order->el[theStart])
+        if (ob->mode == GRIB_ORDER_BY_DESC) {
+            for (i = 0; i < n; i++)
+                key[i] = ~key[i];
         }
-
-        grib_fieldset_sort(set, theStart, l);
-        grib_fieldset_sort(set, r, theEnd);
     }
+
+    for (k = nkeys; k > 0; k--)
+        fieldset_radix_sort(set->order->el, tmp, n, keys + (k - 1) * n);
+
+cleanup:
+    grib_context_free(c, tmp);
+    grib_context_free(c, keys);
+    return err;
 }
 
 void grib_fieldset_delete_order_by(grib_context* c, grib_order_by* order_by)
@@ -638,15 +1132,79 @@ void grib_fieldset_delete(grib_fieldset* set)
     grib_fieldset_delete_int_array(set->order);
     grib_fieldset_delete_int_array(set->filter);
     grib_fieldset_delete_order_by(c, set->order_by);
+    grib_fieldset_delete_where(set->where);
 
     grib_context_free(c, set);
 }
 
+/* Check the columns can be taken from the headers (sections 0 to 4) only, so the rest
+ * of a file can be read without the data sections. Every key must be defined in the
+ * first message 'h' and have the same value when decoding its headers only.
+ */
+static int grib_fieldset_keys_in_headers(grib_fieldset* set, grib_handle* h)
+{
+    const void* message   = NULL;
+    size_t message_length = 0;
+    grib_handle* hh       = NULL;
+    int i                 = 0;
+    int ok                = 1;
+
+    if (h->product_kind != PRODUCT_GRIB || h->context->multi_support_on)
+        return 0;
+    if (grib_get_message(h, &message, &message_length) != GRIB_SUCCESS)
+        return 0;
+    hh = grib_handle_new_from_partial_message(set->context, message, message_length);
+    if (!hh)
+        return 0;
+
+    for (i = 0; ok && i < set->columns_size; i++) {
+        const char* name = set->columns[i].name;
+        int err1 = 0, err2 = 0;
+        if (!strcmp(name, "count") || !strcmp(name, "countTotal")) {
+            ok = 0;
+            break;
+        }
+        switch (set->columns[i].type) {
+            case GRIB_TYPE_LONG: {
+                long v1 = 0, v2 = 0;
+                err1 = grib_get_long(h, name, &v1);
+                err2 = grib_get_long(hh, name, &v2);
+                ok   = (v1 == v2);
+                break;
+            }
+            case GRIB_TYPE_DOUBLE: {
+                double v1 = 0, v2 = 0;
+                err1 = grib_get_double(h, name, &v1);
+                err2 = grib_get_double(hh, name, &v2);
+                ok   = (v1 == v2);
+                break;
+            }
+            case GRIB_TYPE_STRING: {
+                char v1[1024] = {0,}, v2[1024] = {0,};
+                size_t len1 = sizeof(v1), len2 = sizeof(v2);
+                err1 = grib_get_string(h, name, v1, &len1);
+                err2 = grib_get_string(hh, name, v2, &len2);
+                ok   = !strcmp(v1, v2);
+                break;
+            }
+            default:
+                ok = 0;
+        }
+        if (err1 || err2)
+            ok = 0;
+    }
+
+    grib_handle_delete(hh);
+    return ok;
+}
+
 int grib_fieldset_add(grib_fieldset* set, const char* filename)
 {
     int ret        = GRIB_SUCCESS;
     int err        = 0;
     int i          = 0;
+    int headers_only = 0;
+    int first        = 1;
     grib_handle* h = NULL;
     /* int nkeys; */
     grib_file* file;
@@ -664,10 +1222,16 @@ int grib_fieldset_add(grib_fieldset* set, const char* filename)
     if (!file || !file->handle)
         return err;
 
-    while ((h = grib_handle_new_from_file(c, file->handle, &ret)) != NULL || ret != GRIB_SUCCESS) {
+    while ((h = grib_new_from_file(c, file->handle, headers_only, &ret)) != NULL || ret != GRIB_SUCCESS) {
         if (!h)
             return ret;
 
+        /* When all the keys are in the headers, skip reading and decoding the data sections */
+        if (first) {
+            headers_only = grib_fieldset_keys_in_headers(set, h);
+            first        = 0;
+        }
+
         err = GRIB_SUCCESS;
         for (i = 0; i < set->columns_size; i++) {
             err = grib_fieldset_column_copy_from_handle(h, set, i);
@@ -675,6 +1239,8 @@ int grib_fieldset_add(grib_fieldset* set, const char* filename)
                 ret = err;
         }
         if (err == GRIB_SUCCESS || err == GRIB_NOT_FOUND) {
+            const long row = set->columns[0].size - 1; /* Of the columns just read */
+            int match      = 1;
             if (set->fields_array_size < set->columns[0].values_array_size) {
                 ret = grib_fieldset_resize(set, set->columns[0].values_array_size);
                 if (ret != GRIB_SUCCESS)
@@ -682,15 +1248,21 @@ int grib_fieldset_add(grib_fieldset* set, const char* filename)
             }
             offset                       = 0;
             grib_get_double(h, "offset", &offset);
-            set->fields[set->size]       = (grib_field*)grib_context_malloc_clear(c, sizeof(grib_field));
-            set->fields[set->size]->file = file;
+            set->fields[row]       = (grib_field*)grib_context_malloc_clear(c, sizeof(grib_field));
+            set->fields[row]->file = file;
             file->refcount++;
-            set->fields[set->size]->offset = (off_t)offset;
+            set->fields[row]->offset = (off_t)offset;
             grib_get_long(h, "totalLength", &length);
-            set->fields[set->size]->length = length;
-            set->filter->el[set->size]     = set->size;
-            set->order->el[set->size]      = set->size;
-            set->size                      = set->columns[0].size;
+            set->fields[row]->length = length;
+            if (set->where && (ret = grib_fieldset_where_match(set, row, &match)) != GRIB_SUCCESS) {
+                grib_handle_delete(h);
+                return ret;
+            }
+            if (match) {
+                set->filter->el[set->size] = row;
+                set->order->el[set->size]  = set->size;
+                set->size++;
+            }
         }
         grib_handle_delete(h);
     }
@@ -877,7 +1449,8 @@ static int grib_fieldset_resize_fields(grib_fieldset* set, size_t newsize)
 static void grib_fieldset_delete_fields(grib_fieldset* set)
 {
     int i;
-    for (i = 0; i < set->size; i++) {
+    /* Including the fields not selected by the where clause */
+    for (i = 0; i < set->fields_array_size; i++) {
         if (!set->fields[i])
             continue;
         set->fields[i]->file->refcount--;
@@ -149,11 +149,139 @@ static int compute_gaussian_latitudes(long trunc, double* lats)
     return GRIB_SUCCESS;
 }
 
-int grib_get_gaussian_latitudes(long trunc, double* lats)
+/* The latitudes of the last Gaussian grids are kept in the context, most recently used first */
+#define GAUSSIAN_LATITUDES_CACHE_SIZE 16
+
+struct grib_gaussian_latitudes
+{
+    long trunc;
+    double* lats; /* 2*trunc latitudes */
+    grib_gaussian_latitudes* next;
+};
+
+#if GRIB_PTHREADS
+static pthread_once_t once   = PTHREAD_ONCE_INIT;
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static void init()
+{
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+}
+#elif GRIB_OMP_THREADS
+static int once = 0;
+static omp_nest_lock_t mutex;
+
+static void init()
+{
+    GRIB_OMP_CRITICAL(lock_grib_geography_c)
+    {
+        if (once == 0) {
+            omp_init_nest_lock(&mutex);
+            once = 1;
+        }
+    }
+}
+#endif
+
+static void gaussian_latitudes_delete(grib_context* c, grib_gaussian_latitudes* g)
+{
+    grib_context_free(c, g->lats);
+    grib_context_free(c, g);
+}
+
+void grib_gaussian_latitudes_cache_delete(grib_context* c)
 {
+    grib_gaussian_latitudes* g = NULL;
+    GRIB_MUTEX_INIT_ONCE(&once, &init);
+    GRIB_MUTEX_LOCK(&mutex);
+    g                     = c->gaussian_latitudes;
+    c->gaussian_latitudes = NULL;
+    GRIB_MUTEX_UNLOCK(&mutex);
+    while (g) {
+        grib_gaussian_latitudes* next = g->next;
+        gaussian_latitudes_delete(c, g);
+        g = next;
+    }
+}
+
+/* Copy the latitudes from the cache of the context, computing and adding them the first time */
+int grib_context_get_gaussian_latitudes(grib_context* c, long trunc, double* lats)
+{
+    grib_gaussian_latitudes *g = NULL, *prev = NULL;
+    int err = 0, n = 0;
+
     if (trunc <= 0)
         return GRIB_GEOCALCULUS_PROBLEM;
-    return compute_gaussian_latitudes(trunc, lats);
+    if (!c)
+        c = grib_context_get_default();
+
+    GRIB_MUTEX_INIT_ONCE(&once, &init);
+    GRIB_MUTEX_LOCK(&mutex);
+    for (g = c->gaussian_latitudes; g; prev = g, g = g->next) {
+        if (g->trunc == trunc)
+            break;
+    }
+    if (g) {
+        if (prev) {
+            prev->next            = g->next;
+            g->next               = c->gaussian_latitudes;
+            c->gaussian_latitudes = g;
+        }
+        memcpy(lats, g->lats, 2 * trunc * sizeof(double));
+    }
+    GRIB_MUTEX_UNLOCK(&mutex);
+    if (g)
+        return GRIB_SUCCESS;
+
+    /* Computed without holding the lock. Another thread may add the same grid meanwhile */
+    if ((err = compute_gaussian_latitudes(trunc, lats)) != GRIB_SUCCESS)
+        return err;
+    g = (grib_gaussian_latitudes*)grib_context_malloc_clear(c, sizeof(grib_gaussian_latitudes));
+    if (!g)
+        return GRIB_SUCCESS;
+    g->trunc = trunc;
+    g->lats  = (double*)grib_context_malloc(c, 2 * trunc * sizeof(double));
+    if (!g->lats) {
+        grib_context_free(c, g);
+        return GRIB_SUCCESS;
+    }
+    memcpy(g->lats, lats, 2 * trunc * sizeof(double));
+
+    GRIB_MUTEX_LOCK(&mutex);
+    for (prev = c->gaussian_latitudes; prev; prev = prev->next) {
+        if (prev->trunc == trunc)
+            break;
+    }
+    if (prev) {
+        gaussian_latitudes_delete(c, g);
+    }
+    else {
+        g->next               = c->gaussian_latitudes;
+        c->gaussian_latitudes = g;
+        /* Drop the least recently used */
+        for (prev = g, n = 1; prev->next && n < GAUSSIAN_LATITUDES_CACHE_SIZE; prev = prev->next)
+            n++;
+        if (prev->next) {
+            grib_gaussian_latitudes* next = prev->next;
+            prev->next                    = NULL;
+            while (next) {
+                g    = next;
+                next = next->next;
+                gaussian_latitudes_delete(c, g);
+            }
+        }
+    }
+    GRIB_MUTEX_UNLOCK(&mutex);
+    return GRIB_SUCCESS;
+}
+
+int grib_get_gaussian_latitudes(long trunc, double* lats)
+{
+    return grib_context_get_gaussian_latitudes(NULL, trunc, lats);
 }
 
 /* Boolean return type: 1 if the reduced gaussian field is global, 0 for sub area */
@@ -307,6 +435,56 @@ double geographic_distance_spherical(double radius, double lon1, double lat1, do
     return radius * acos(a);
 }
 
+/* Geodetic latitude (radians) from the constant t of the conformal projections, given on an
+ * ellipsoid of eccentricity e. See "Map Projections-A Working Manual-John P. Snyder (1987)":
+ * the conformal latitude chi is pi/2 - 2*arctan(t) (7-13) and the latitude phi follows from
+ * the series (3-5) in sin(2*chi) .. sin(8*chi), summed by Clenshaw's recurrence. Unlike the
+ * iteration (7-9), this costs the same for every point and has no branch, so a row of points
+ * is computed in one vectorisable loop. The series is truncated after the terms in e^8: for
+ * eccentricities above 0.1 the iteration is used instead, to keep the error below 1e-10.
+ * ts and phi can be the same array.
+ */
+int grib_latitudes_from_conformal_t(double e, const double* ts, double* phi, size_t n)
+{
+    const double e2 = e * e, e4 = e2 * e2, e6 = e4 * e2, e8 = e4 * e4;
+    size_t i = 0;
+
+    if (e > 0.1) {
+        const double eccnth = 0.5 * e;
+        for (i = 0; i < n; i++) {
+            const double t = ts[i];
+            double p = M_PI_2 - 2 * atan(t), dphi = 1;
+            int iter = 0;
+            for (iter = 0; iter <= 15 && fabs(dphi) > 0.0000000001; iter++) {
+                const double con = e * sin(p);
+                dphi             = M_PI_2 - 2 * atan(t * pow(((1.0 - con) / (1.0 + con)), eccnth)) - p;
+                p += dphi;
+            }
+            if (fabs(dphi) > 0.0000000001)
+                return GRIB_INTERNAL_ERROR;
+            phi[i] = p;
+        }
+        return GRIB_SUCCESS;
+    }
+    else {
+        const double c1 = e2 / 2 + 5 * e4 / 24 + e6 / 12 + 13 * e8 / 360;
+        const double c2 = 7 * e4 / 48 + 29 * e6 / 240 + 811 * e8 / 11520;
+        const double c3 = 7 * e6 / 120 + 81 * e8 / 1120;
+        const double c4 = 4279 * e8 / 161280;
+        for (i = 0; i < n; i++) {
+            const double chi  = M_PI_2 - 2 * atan(ts[i]);
+            const double s    = sin(2 * chi);
+            const double c    = 2 * cos(2 * chi);
+            const double b4   = c4;
+            const double b3   = c3 + c * b4;
+            const double b2   = c2 + c * b3 - b4;
+            const double b1   = c1 + c * b2 - b3;
+            phi[i] = chi + b1 * s;
+        }
+    }
+    return GRIB_SUCCESS;
+}
+
 // major and minor axes in km, angles in degrees
 // double geographic_distance_ellipsoid(double major, double minor, double lon1, double lat1, double lon2, double lat2)
 // {
@@ -0,0 +1,263 @@
+/*
+ * (C) Copyright 2005- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities granted to it by
+ * virtue of its status as an intergovernmental organisation nor does it submit to any jurisdiction.
+ */
+
+/*
+ * The coordinates of the points of a grid, computed once with the geoiterator and cached in
+ * the context, keyed by the edition and md5GridSection, so that the fields on the same grid
+ * share them. The geometries are reference counted: the cache holds one reference and each
+ * user another, so one evicted while in use is deleted by its last user.
+ */
+
+#include "grib_api_internal.h"
+
+#define GRID_GEOMETRY_CACHE_SIZE 4
+
+#if GRIB_PTHREADS
+static pthread_once_t once   = PTHREAD_ONCE_INIT;
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static void init()
+{
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+}
+#elif GRIB_OMP_THREADS
+static int once = 0;
+static omp_nest_lock_t mutex;
+
+static void init()
+{
+    GRIB_OMP_CRITICAL(lock_grib_grid_geometry_c)
+    {
+        if (once == 0) {
+            omp_init_nest_lock(&mutex);
+            once = 1;
+        }
+    }
+}
+#endif
+
+static void grid_geometry_free(grib_grid_geometry* g)
+{
+    grib_context* c = g->context;
+    grib_nearest_index_delete(c, g->nearest_index);
+    grib_context_free(c, g->fingerprint);
+    grib_context_free(c, g->lats);
+    grib_context_free(c, g->lons);
+    grib_context_free(c, g);
+}
+
+static grib_grid_geometry* grid_geometry_compute(grib_handle* h, int* err)
+{
+    grib_context* c       = h->context;
+    grib_grid_geometry* g = NULL;
+    grib_iterator* iter   = NULL;
+    size_t count = 0, i = 0;
+
+    if ((*err = grib_get_size(h, "values", &count)) != GRIB_SUCCESS)
+        return NULL;
+    if (count == 0) {
+        *err = GRIB_WRONG_GRID;
+        return NULL;
+    }
+    g = (grib_grid_geometry*)grib_context_malloc_clear(c, sizeof(grib_grid_geometry));
+    if (!g) {
+        *err = GRIB_OUT_OF_MEMORY;
+        return NULL;
+    }
+    g->context  = c;
+    g->refcount = 1;
+    g->lats     = (double*)grib_context_malloc(c, count * sizeof(double));
+    g->lons     = (double*)grib_context_malloc(c, count * sizeof(double));
+    if (!g->lats || !g->lons) {
+        grid_geometry_free(g);
+        *err = GRIB_OUT_OF_MEMORY;
+        return NULL;
+    }
+
+    /* ECC-1525 Performance: We do not need the values to be decoded */
+    iter = grib_iterator_new(h, GRIB_GEOITERATOR_NO_VALUES, err);
+    if (*err != GRIB_SUCCESS) {
+        if (iter)
+            grib_iterator_delete(iter);
+        grid_geometry_free(g);
+        return NULL;
+    }
+    while (i < count && grib_iterator_next(iter, &g->lats[i], &g->lons[i], NULL))
+        i++;
+    grib_iterator_delete(iter);
+    if (i != count) {
+        grib_context_log(c, GRIB_LOG_ERROR, "Grid geometry: Grid has %zu points instead of %zu", i, count);
+        grid_geometry_free(g);
+        *err = GRIB_WRONG_GRID;
+        return NULL;
+    }
+    g->count = count;
+    return g;
+}
+
+/* Release the cache's reference of the geometries from g on. Called with the lock held */
+static void grid_geometry_evict(grib_grid_geometry* g)
+{
+    while (g) {
+        grib_grid_geometry* next = g->next;
+        g->next                  = NULL;
+        if (--g->refcount == 0)
+            grid_geometry_free(g);
+        g = next;
+    }
+}
+
+grib_grid_geometry* grib_grid_geometry_new_from_handle(const grib_handle* ch, int* error)
+{
+    grib_handle* h        = (grib_handle*)ch;
+    grib_context* c       = NULL;
+    grib_grid_geometry *g = NULL, *prev = NULL, *computed = NULL;
+    char md5[64]          = {0,};
+    char fingerprint[100] = {0,};
+    size_t len            = sizeof(md5);
+    long edition = 0, disableUnrotate = 0;
+    int n = 0;
+
+    if (!h) {
+        *error = GRIB_INVALID_ARGUMENT;
+        return NULL;
+    }
+    c      = h->context;
+    *error = GRIB_SUCCESS;
+
+    /* Without a fingerprint, the geometry is for this handle only. An unrotated grid
+     * does not have the coordinates of the same rotated grid
+     */
+    if (grib_get_long(h, "iteratorDisableUnrotate", &disableUnrotate) == GRIB_SUCCESS && disableUnrotate)
+        return grid_geometry_compute(h, error);
+    if (grib_get_long(h, "edition", &edition) != GRIB_SUCCESS ||
+        grib_get_string(h, "md5GridSection", md5, &len) != GRIB_SUCCESS) {
+        return grid_geometry_compute(h, error);
+    }
+    snprintf(fingerprint, sizeof(fingerprint), "%ld:%s", edition, md5);
+
+    GRIB_MUTEX_INIT_ONCE(&once, &init);
+    GRIB_MUTEX_LOCK(&mutex);
+    for (g = c->grid_geometries; g; prev = g, g = g->next) {
+        if (strcmp(g->fingerprint, fingerprint) == 0)
+            break;
+    }
+    if (g) {
+        /* Most recently used first */
+        if (prev) {
+            prev->next         = g->next;
+            g->next            = c->grid_geometries;
+            c->grid_geometries = g;
+        }
+        g->refcount++;
+    }
+    GRIB_MUTEX_UNLOCK(&mutex);
+    if (g)
+        return g;
+
+    /* Computed without holding the lock. Another thread may add the same grid meanwhile */
+    computed = grid_geometry_compute(h, error);
+    if (!computed)
+        return NULL;
+    computed->fingerprint = grib_context_strdup(c, fingerprint);
+    if (!computed->fingerprint)
+        return computed;
+
+    GRIB_MUTEX_LOCK(&mutex);
+    for (g = c->grid_geometries; g; g = g->next) {
+        if (strcmp(g->fingerprint, fingerprint) == 0)
+            break;
+    }
+    if (g) {
+        g->refcount++;
+    }
+    else {
+        g                  = computed;
+        computed           = NULL;
+        g->refcount        = 2;
+        g->next            = c->grid_geometries;
+        c->grid_geometries = g;
+        /* Evict the least recently used */
+        for (prev = g, n = 1; prev->next && n < GRID_GEOMETRY_CACHE_SIZE; prev = prev->next)
+            n++;
+        grid_geometry_evict(prev->next);
+        prev->next = NULL;
+    }
+    GRIB_MUTEX_UNLOCK(&mutex);
+    if (computed)
+        grid_geometry_free(computed);
+    return g;
+}
+
+int grib_grid_geometry_get_size(const grib_grid_geometry* g, size_t* size)
+{
+    if (!g || !size)
+        return GRIB_INVALID_ARGUMENT;
+    *size = g->count;
+    return GRIB_SUCCESS;
+}
+
+int grib_grid_geometry_get_latlons(const grib_grid_geometry* g, double* lats, double* lons, size_t* size)
+{
+    if (!g || !size)
+        return GRIB_INVALID_ARGUMENT;
+    if (*size < g->count) {
+        *size = g->count;
+        return GRIB_ARRAY_TOO_SMALL;
+    }
+    if (lats)
+        memcpy(lats, g->lats, g->count * sizeof(double));
+    if (lons)
+        memcpy(lons, g->lons, g->count * sizeof(double));
+    *size = g->count;
+    return GRIB_SUCCESS;
+}
+
+int grib_grid_geometry_equal(const grib_grid_geometry* g1, const grib_grid_geometry* g2)
+{
+    if (!g1 || !g2)
+        return 0;
+    if (g1 == g2)
+        return 1;
+    if (g1->fingerprint && g2->fingerprint)
+        return strcmp(g1->fingerprint, g2->fingerprint) == 0;
+    return g1->count == g2->count &&
+           memcmp(g1->lats, g2->lats, g1->count * sizeof(double)) == 0 &&
+           memcmp(g1->lons, g2->lons, g1->count * sizeof(double)) == 0;
+}
+
+int grib_grid_geometry_delete(grib_grid_geometry* g)
+{
+    int refcount = 0;
+    if (!g)
+        return GRIB_INVALID_ARGUMENT;
+    GRIB_MUTEX_INIT_ONCE(&once, &init);
+    GRIB_MUTEX_LOCK(&mutex);
+    refcount = --g->refcount;
+    GRIB_MUTEX_UNLOCK(&mutex);
+    if (refcount == 0)
+        grid_geometry_free(g);
+    return GRIB_SUCCESS;
+}
+
+void grib_grid_geometry_cache_delete(grib_context* c)
+{
+    if (!c)
+        c = grib_context_get_default();
+    GRIB_MUTEX_INIT_ONCE(&once, &init);
+    GRIB_MUTEX_LOCK(&mutex);
+    grid_geometry_evict(c->grid_geometries);
+    c->grid_geometries = NULL;
+    GRIB_MUTEX_UNLOCK(&mutex);
+}
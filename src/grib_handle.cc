@@ -38,11 +38,12 @@ static GRIB_INLINE int grib_inline_strcmp(const char* a, const char* b)
 
 grib_section* grib_section_create(grib_handle* h, grib_accessor* owner)
 {
-    grib_section* s = (grib_section*)grib_context_malloc_clear(h->context, sizeof(grib_section));
-    s->owner        = owner;
-    s->aclength     = NULL;
-    s->h            = h;
-    s->block        = (grib_block_of_accessors*)grib_context_malloc_clear(h->context, sizeof(grib_block_of_accessors));
+    grib_arena* arena = grib_handle_arena(h);
+    grib_section* s   = (grib_section*)grib_arena_malloc_clear(arena, sizeof(grib_section));
+    s->owner          = owner;
+    s->aclength       = NULL;
+    s->h              = h;
+    s->block          = (grib_block_of_accessors*)grib_arena_malloc_clear(arena, sizeof(grib_block_of_accessors));
     return s;
 }
 
@@ -108,35 +109,39 @@ void grib_empty_section(grib_context* c, grib_section* b)
 
 void grib_section_delete(grib_context* c, grib_section* b)
 {
+    grib_arena* arena = NULL;
     if (!b)
         return;
 
     grib_empty_section(c, b);
-    grib_context_free(c, b->block);
+    arena = grib_handle_arena(b->h);
+    grib_arena_free(arena, b->block, sizeof(grib_block_of_accessors));
     /* printf("++++ deleted %p\n",b); */
-    grib_context_free(c, b);
+    grib_arena_free(arena, b, sizeof(grib_section));
 }
 
 int grib_handle_delete(grib_handle* h)
 {
     if (h != NULL) {
-        grib_context* ct   = h->context;
-        grib_dependency* d = h->dependencies;
-        grib_dependency* n;
+        grib_context* ct = h->context;
 
         if (h->kid != NULL)
             return GRIB_INTERNAL_ERROR;
 
-        while (d) {
-            n = d->next;
-            grib_context_free(ct, d);
-            d = n;
-        }
+        /* Kept to build the next messages of the same layout */
+        if (grib_handle_skeleton_keep(h))
+            return GRIB_SUCCESS;
+
+        /* The dependencies are in the arena */
         h->dependencies = 0;
 
-        grib_buffer_delete(ct, h->buffer);
+        if (h->buffer)
+            grib_buffer_delete(ct, h->buffer);
         grib_section_delete(ct, h->root);
+        grib_arena_delete(h->arena);
         grib_context_free(ct, h->gts_header);
+        grib_mmap_file_release(h->mmap_file);
+        grib_handle_layout_delete(ct, h->layout);
 
         grib_context_log(ct, GRIB_LOG_DEBUG, "grib_handle_delete: deleting handle %p", (void*)h);
         grib_context_free(ct, h);
@@ -145,6 +150,17 @@ int grib_handle_delete(grib_handle* h)
     return GRIB_SUCCESS;
 }
 
+/* The arena of the accessors of the handle. Those built in the temporary handle of a section
+ * being reparsed are moved to its main handle, so they are taken from the arena of the latter */
+grib_arena* grib_handle_arena(grib_handle* h)
+{
+    while (h->main)
+        h = h->main;
+    if (!h->arena)
+        h->arena = grib_arena_new(h->context);
+    return h->arena;
+}
+
 grib_handle* grib_new_handle(grib_context* c)
 {
     grib_handle* g = NULL;
@@ -198,6 +214,10 @@ static grib_handle* grib_handle_create(grib_handle* gl, grib_context* c, const v
 
     gl->buffer->property = CODES_USER_BUFFER;
 
+    /* The values read to build the accessors, to reuse them for the next messages */
+    if (gl->product_kind == PRODUCT_GRIB && !gl->partial)
+        grib_handle_layout_start(gl);
+
     next = gl->context->grib_reader->first->root;
     while (next) {
         if (grib_create_accessor(gl->root, next, NULL) != GRIB_SUCCESS)
@@ -212,6 +232,7 @@ static grib_handle* grib_handle_create(grib_handle* gl, grib_context* c, const v
     }
 
     grib_section_post_init(gl->root);
+    grib_handle_layout_end(gl);
 
     return gl;
 }
@@ -445,10 +466,15 @@ grib_handle* grib_handle_new_from_message(grib_context* c, const void* data, siz
     ProductKind product_kind = PRODUCT_ANY;
     if (c == NULL)
         c = grib_context_get_default();
-    gl               = grib_new_handle(c);
-    gl->product_kind = PRODUCT_GRIB; /* See ECC-480 */
-    h                = grib_handle_create(gl, c, data, buflen);
-    if (!h) return NULL;
+
+    /* The accessors of a handle deleted unchanged, when they would be built the same */
+    h = grib_handle_skeleton_take(c, data, buflen);
+    if (!h) {
+        gl               = grib_new_handle(c);
+        gl->product_kind = PRODUCT_GRIB; /* See ECC-480 */
+        h                = grib_handle_create(gl, c, data, buflen);
+        if (!h) return NULL;
+    }
 
     /* See ECC-448 */
     if (determine_product_kind(h, &product_kind) == GRIB_SUCCESS) {
@@ -0,0 +1,562 @@
+/*
+ * (C) Copyright 2005- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities granted to it by
+ * virtue of its status as an intergovernmental organisation nor does it submit to any jurisdiction.
+ */
+
+/*
+ * Description: reuse of the accessors of deleted GRIB handles
+ *
+ * The accessors of a message are built by running the actions of the definitions, whose "if",
+ * "switch" and template conditions only depend on the values read from the message meanwhile.
+ * These reads, at all depths and in order, are the layout of the handle. A GRIB handle deleted
+ * unchanged is kept by its context as a skeleton: its accessors, sections and dependencies stay,
+ * its message is released. The next message of the same length is bound to a skeleton whose reads,
+ * made again on the new message, give the same values: its accessors would be built the same way,
+ * so neither the actions nor the dependencies are run again.
+ *
+ * The values the accessors cache (tables, statistics...) are reset by their class method reset
+ * each time a skeleton is checked. A handle is not kept when it was changed after it was built,
+ * when a value was packed into its message while it was built, or when the reads made again on the
+ * whole tree differ from those made while it was built (a key read before being defined).
+ *
+ * ECCODES_GRIB_HANDLE_SKELETONS is the number of skeletons kept by a context, 0 to disable them.
+ */
+
+#include "grib_api_internal.h"
+
+/* Types of the values read, besides GRIB_TYPE_LONG, GRIB_TYPE_DOUBLE, GRIB_TYPE_STRING and GRIB_TYPE_BYTES */
+#define LAYOUT_READ_FLOAT   100
+#define LAYOUT_READ_MISSING 101 /* is_missing */
+
+/* Reading a larger value while the accessors are built is not expected */
+#define LAYOUT_MAX_READ_SIZE (1024 * 1024)
+
+/* States of a layout */
+#define LAYOUT_BUILT     0 /* The reads are recorded */
+#define LAYOUT_RECORDING 1 /* The accessors are being built */
+#define LAYOUT_CHECKING  2 /* The reads made again are compared with those recorded */
+
+typedef struct layout_read
+{
+    grib_accessor* accessor;
+    int type;
+    int depth;       /* Number of reads in progress when made */
+    int err;         /* Returned, or the result of is_missing */
+    size_t capacity; /* Number of values asked */
+    size_t length;   /* Number of values returned */
+    size_t offset;   /* Of the values in the layout */
+    size_t size;     /* Bytes of the values */
+} layout_read;
+
+struct grib_handle_layout
+{
+    int state;
+    int depth;
+    int invalid;  /* A value was packed or read in a way not recorded while built */
+    int modified; /* Changed after it was built */
+    int mismatch; /* A read made again gave another value */
+    layout_read* reads;
+    size_t count;
+    size_t reads_capacity;
+    size_t cursor; /* Next read compared */
+    unsigned char* values;
+    size_t values_size;
+    size_t values_capacity;
+    size_t max_read_size;  /* Bytes of the largest value asked */
+    size_t message_length; /* Of a skeleton */
+    grib_handle* next;     /* Next skeleton */
+};
+
+#if GRIB_PTHREADS
+static pthread_once_t once   = PTHREAD_ONCE_INIT;
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static void init()
+{
+    pthread_mutexattr_t attr;
+
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+}
+#elif GRIB_OMP_THREADS
+static int once = 0;
+static omp_nest_lock_t mutex;
+
+static void init()
+{
+    GRIB_OMP_CRITICAL(lock_grib_handle_layout_c)
+    {
+        if (once == 0) {
+            omp_init_nest_lock(&mutex);
+            once = 1;
+        }
+    }
+}
+#endif
+
+void grib_handle_layout_start(grib_handle* h)
+{
+    grib_handle_layout* l = NULL;
+    if (h->context->handle_skeletons_max <= 0 || h->layout)
+        return;
+    l = (grib_handle_layout*)grib_context_malloc_clear(h->context, sizeof(grib_handle_layout));
+    if (l) {
+        l->state  = LAYOUT_RECORDING;
+        h->layout = l;
+    }
+}
+
+void grib_handle_layout_end(grib_handle* h)
+{
+    if (h->layout) {
+        h->layout->state    = LAYOUT_BUILT;
+        h->layout->modified = 0;
+    }
+}
+
+void grib_handle_layout_delete(grib_context* c, grib_handle_layout* l)
+{
+    if (l) {
+        grib_context_free(c, l->reads);
+        grib_context_free(c, l->values);
+        grib_context_free(c, l);
+    }
+}
+
+/* The layout of the handle of the accessor, while its reads are recorded or compared */
+grib_handle_layout* grib_handle_layout_reading(const grib_accessor* a)
+{
+    grib_handle* h = grib_handle_of_accessor(a);
+    if (h && h->layout && h->layout->state != LAYOUT_BUILT)
+        return h->layout;
+    return NULL;
+}
+
+static int layout_add(grib_context* c, grib_handle_layout* l, const layout_read* r, const void* value)
+{
+    if (l->count == l->reads_capacity) {
+        size_t n       = l->reads_capacity ? 2 * l->reads_capacity : 256;
+        layout_read* p = (layout_read*)grib_context_realloc(c, l->reads, n * sizeof(layout_read));
+        if (!p)
+            return GRIB_OUT_OF_MEMORY;
+        l->reads          = p;
+        l->reads_capacity = n;
+    }
+    if (l->values_size + r->size > l->values_capacity) {
+        size_t n         = l->values_capacity ? 2 * l->values_capacity : 4096;
+        unsigned char* p = NULL;
+        while (n < l->values_size + r->size)
+            n *= 2;
+        p = (unsigned char*)grib_context_realloc(c, l->values, n);
+        if (!p)
+            return GRIB_OUT_OF_MEMORY;
+        l->values          = p;
+        l->values_capacity = n;
+    }
+    l->reads[l->count]        = *r;
+    l->reads[l->count].offset = l->values_size;
+    if (r->size)
+        memcpy(l->values + l->values_size, value, r->size);
+    l->values_size += r->size;
+    l->count++;
+    return GRIB_SUCCESS;
+}
+
+/* Records a read made while the accessors are built, or compares it with the one recorded */
+static void layout_read_done(grib_handle_layout* l, grib_accessor* a, int type, int err,
+                             size_t capacity, size_t length, const void* value, size_t size_of_value)
+{
+    layout_read r = {0,};
+
+    r.accessor = a;
+    r.type     = type;
+    r.depth    = l->depth;
+    r.err      = err;
+    r.capacity = capacity;
+    r.length   = err ? 0 : length;
+    r.size     = err ? 0 : length * size_of_value;
+
+    if (l->state == LAYOUT_CHECKING) {
+        const layout_read* e = l->cursor < l->count ? &l->reads[l->cursor] : NULL;
+        if (!e || e->accessor != a || e->type != type || e->depth != r.depth || e->err != err ||
+            e->capacity != capacity || e->length != r.length ||
+            (r.size && memcmp(l->values + e->offset, value, r.size) != 0)) {
+            l->mismatch = 1;
+        }
+        l->cursor++;
+        return;
+    }
+
+    if (capacity * size_of_value > LAYOUT_MAX_READ_SIZE || layout_add(a->context, l, &r, value) != GRIB_SUCCESS) {
+        l->invalid = 1;
+        return;
+    }
+    if (capacity * size_of_value > l->max_read_size)
+        l->max_read_size = capacity * size_of_value;
+}
+
+int grib_handle_layout_unpack_long(grib_handle_layout* l, grib_accessor_class* c, grib_accessor* a, long* v, size_t* len)
+{
+    size_t capacity = *len;
+    int err         = 0;
+    l->depth++;
+    err = c->unpack_long(a, v, len);
+    l->depth--;
+    layout_read_done(l, a, GRIB_TYPE_LONG, err, capacity, *len, v, sizeof(long));
+    return err;
+}
+
+int grib_handle_layout_unpack_double(grib_handle_layout* l, grib_accessor_class* c, grib_accessor* a, double* v, size_t* len)
+{
+    size_t capacity = *len;
+    int err         = 0;
+    l->depth++;
+    err = c->unpack_double(a, v, len);
+    l->depth--;
+    layout_read_done(l, a, GRIB_TYPE_DOUBLE, err, capacity, *len, v, sizeof(double));
+    return err;
+}
+
+int grib_handle_layout_unpack_float(grib_handle_layout* l, grib_accessor_class* c, grib_accessor* a, float* v, size_t* len)
+{
+    size_t capacity = *len;
+    int err         = 0;
+    l->depth++;
+    err = c->unpack_float(a, v, len);
+    l->depth--;
+    layout_read_done(l, a, LAYOUT_READ_FLOAT, err, capacity, *len, v, sizeof(float));
+    return err;
+}
+
+int grib_handle_layout_unpack_string(grib_handle_layout* l, grib_accessor_class* c, grib_accessor* a, char* v, size_t* len)
+{
+    size_t capacity = *len;
+    int err         = 0;
+    l->depth++;
+    err = c->unpack_string(a, v, len);
+    l->depth--;
+    /* Some classes return the length of the string, others that of the buffer */
+    layout_read_done(l, a, GRIB_TYPE_STRING, err, capacity, *len <= capacity ? *len : capacity, v, 1);
+    return err;
+}
+
+int grib_handle_layout_unpack_bytes(grib_handle_layout* l, grib_accessor_class* c, grib_accessor* a, unsigned char* v, size_t* len)
+{
+    size_t capacity = *len;
+    int err         = 0;
+    l->depth++;
+    err = c->unpack_bytes(a, v, len);
+    l->depth--;
+    layout_read_done(l, a, GRIB_TYPE_BYTES, err, capacity, *len <= capacity ? *len : capacity, v, 1);
+    return err;
+}
+
+int grib_handle_layout_is_missing(grib_handle_layout* l, grib_accessor_class* c, grib_accessor* a)
+{
+    int ret = 0;
+    l->depth++;
+    ret = c->is_missing(a);
+    l->depth--;
+    layout_read_done(l, a, LAYOUT_READ_MISSING, ret, 0, 0, NULL, 0);
+    return ret;
+}
+
+/* A read not recorded (an element, a subarray...) */
+void grib_handle_layout_unsupported(const grib_accessor* a)
+{
+    grib_handle_layout* l = grib_handle_layout_reading(a);
+    if (!l)
+        return;
+    if (l->state == LAYOUT_CHECKING)
+        l->mismatch = 1;
+    else
+        l->invalid = 1;
+}
+
+/* The values of the transient keys are not in the message */
+static int packed_into_message(grib_accessor* a)
+{
+    if (a->vvalue)
+        return 0;
+    if (strcmp(a->cclass->name, "variable") == 0 || strcmp(a->cclass->name, "transient") == 0)
+        return 0;
+    return 1;
+}
+
+/* A value of the handle of the accessor is packed: the handle cannot be kept once changed */
+void grib_handle_layout_packed(grib_accessor* a)
+{
+    grib_handle* h = grib_handle_of_accessor(a);
+    if (!h)
+        return;
+    while (h->main)
+        h = h->main;
+    if (!h->layout)
+        return;
+    switch (h->layout->state) {
+        case LAYOUT_RECORDING:
+            if (packed_into_message(a))
+                h->layout->invalid = 1;
+            break;
+        case LAYOUT_CHECKING:
+            h->layout->mismatch = 1;
+            break;
+        default:
+            h->layout->modified = 1;
+            break;
+    }
+}
+
+/* The unpacking of the data sets some transient keys back to their default values: setting a key
+ * which is not in the message to the value it has already does not change the handle */
+static int transient_unchanged(grib_accessor* a, size_t len)
+{
+    grib_handle* h = grib_handle_of_accessor(a);
+    /* The accessors of a section being built again are not all initialised */
+    if (!h || h->main || len != 1 || packed_into_message(a))
+        return 0;
+    return h->layout && h->layout->state == LAYOUT_BUILT;
+}
+
+void grib_handle_layout_packed_double(grib_accessor* a, const double* v, size_t len)
+{
+    double current = 0;
+    size_t n       = 1;
+    if (v && transient_unchanged(a, len) && grib_unpack_double(a, &current, &n) == GRIB_SUCCESS && n == 1 && current == v[0])
+        return;
+    grib_handle_layout_packed(a);
+}
+
+void grib_handle_layout_packed_long(grib_accessor* a, const long* v, size_t len)
+{
+    long current = 0;
+    size_t n     = 1;
+    if (v && transient_unchanged(a, len) && grib_unpack_long(a, &current, &n) == GRIB_SUCCESS && n == 1 && current == v[0])
+        return;
+    grib_handle_layout_packed(a);
+}
+
+void grib_handle_layout_changed(grib_handle* h)
+{
+    while (h->main)
+        h = h->main;
+    if (h->layout)
+        h->layout->modified = 1;
+}
+
+static void reset_section(grib_section* s)
+{
+    grib_accessor* a = (s && s->block) ? s->block->first : NULL;
+    while (a) {
+        grib_accessor_reset(a);
+        reset_section(a->sub_section);
+        a = a->next;
+    }
+}
+
+/* Makes the reads recorded again, on the whole tree and the message of the handle */
+static int layout_matches(grib_handle* h)
+{
+    grib_handle_layout* l = h->layout;
+    void* value           = NULL;
+    size_t i = 0, len = 0;
+
+    reset_section(h->root);
+    if (l->max_read_size) {
+        value = grib_context_malloc(h->context, l->max_read_size);
+        if (!value)
+            return 0;
+    }
+
+    l->state    = LAYOUT_CHECKING;
+    l->cursor   = 0;
+    l->mismatch = 0;
+    for (i = 0; i < l->count && !l->mismatch; i++) {
+        const layout_read* r = &l->reads[i];
+        if (r->depth)
+            continue;
+        len = r->capacity;
+        switch (r->type) {
+            case GRIB_TYPE_LONG:
+                grib_unpack_long(r->accessor, (long*)value, &len);
+                break;
+            case GRIB_TYPE_DOUBLE:
+                grib_unpack_double(r->accessor, (double*)value, &len);
+                break;
+            case LAYOUT_READ_FLOAT:
+                grib_unpack_float(r->accessor, (float*)value, &len);
+                break;
+            case GRIB_TYPE_STRING:
+                grib_unpack_string(r->accessor, (char*)value, &len);
+                break;
+            case GRIB_TYPE_BYTES:
+                grib_unpack_bytes(r->accessor, (unsigned char*)value, &len);
+                break;
+            case LAYOUT_READ_MISSING:
+                grib_is_missing_internal(r->accessor);
+                break;
+            default:
+                l->mismatch = 1;
+                break;
+        }
+    }
+    l->state = LAYOUT_BUILT;
+    grib_context_free(h->context, value);
+
+    return !l->mismatch && l->cursor == l->count;
+}
+
+static void skeletons_delete(grib_context* c, grib_handle* h)
+{
+    while (h) {
+        grib_handle* next = h->layout->next;
+        grib_handle_layout_delete(c, h->layout);
+        h->layout = NULL;
+        grib_handle_delete(h);
+        h = next;
+    }
+}
+
+/* Keeps a deleted handle as a skeleton. Returns 1 when kept, 0 when it is to be deleted */
+int grib_handle_skeleton_keep(grib_handle* h)
+{
+    grib_context* c       = h->context;
+    grib_handle_layout* l = h->layout;
+    grib_handle* last     = NULL;
+    grib_handle* evicted  = NULL;
+
+    if (!l || l->state != LAYOUT_BUILT || l->invalid || l->modified || c->handle_skeletons_max <= 0)
+        return 0;
+    if (h->product_kind != PRODUCT_GRIB || h->main || h->kid || h->partial || h->loader || !h->buffer || !h->root)
+        return 0;
+
+    /* Also checks that the values a key defined later would give are those read while built */
+    if (!layout_matches(h))
+        return 0;
+
+    l->message_length = h->buffer->ulength;
+    grib_buffer_delete(c, h->buffer);
+    h->buffer = NULL;
+    grib_context_free(c, h->gts_header);
+    h->gts_header     = NULL;
+    h->gts_header_len = 0;
+    grib_mmap_file_release(h->mmap_file);
+    h->mmap_file = NULL;
+    h->offset    = 0;
+
+    GRIB_MUTEX_INIT_ONCE(&once, &init);
+    GRIB_MUTEX_LOCK(&mutex);
+    l->next             = c->handle_skeletons;
+    c->handle_skeletons = h;
+    if (++c->handle_skeletons_count > (size_t)c->handle_skeletons_max) {
+        /* The least recently kept */
+        for (last = h; last->layout->next->layout->next; last = last->layout->next)
+            ;
+        evicted             = last->layout->next;
+        last->layout->next  = NULL;
+        c->handle_skeletons_count--;
+    }
+    GRIB_MUTEX_UNLOCK(&mutex);
+
+    if (evicted)
+        skeletons_delete(c, evicted);
+    return 1;
+}
+
+/* A skeleton bound to the message when it would be built the same, NULL otherwise */
+grib_handle* grib_handle_skeleton_take(grib_context* c, const void* data, size_t buflen)
+{
+    grib_handle* candidates = NULL;
+    grib_handle* rejected   = NULL;
+    grib_handle* h          = NULL;
+    grib_handle** p         = NULL;
+    grib_handle** last      = &candidates;
+
+    if (c->handle_skeletons_max <= 0)
+        return NULL;
+
+    GRIB_MUTEX_INIT_ONCE(&once, &init);
+    GRIB_MUTEX_LOCK(&mutex);
+    p = &c->handle_skeletons;
+    while (*p) {
+        grib_handle* k = *p;
+        if (k->layout->message_length == buflen) {
+            /* In the order they were kept, the most recent first */
+            *p              = k->layout->next;
+            k->layout->next = NULL;
+            *last           = k;
+            last            = &k->layout->next;
+            c->handle_skeletons_count--;
+        }
+        else {
+            p = &k->layout->next;
+        }
+    }
+    GRIB_MUTEX_UNLOCK(&mutex);
+
+    while (candidates) {
+        h               = candidates;
+        candidates      = h->layout->next;
+        h->layout->next = NULL;
+
+        h->buffer = grib_new_buffer(c, (const unsigned char*)data, buflen);
+        if (!h->buffer) {
+            h->layout->next = rejected;
+            rejected        = h;
+            h               = NULL;
+            continue;
+        }
+        h->buffer->property = CODES_USER_BUFFER;
+        if (layout_matches(h))
+            break;
+
+        grib_buffer_delete(c, h->buffer);
+        h->buffer       = NULL;
+        h->layout->next = rejected;
+        rejected        = h;
+        h               = NULL;
+    }
+
+    /* The others are kept for the next messages */
+    if (candidates || rejected) {
+        GRIB_MUTEX_LOCK(&mutex);
+        while (candidates || rejected) {
+            grib_handle* k = candidates ? candidates : rejected;
+            if (k == candidates)
+                candidates = k->layout->next;
+            else
+                rejected = k->layout->next;
+            k->layout->next     = c->handle_skeletons;
+            c->handle_skeletons = k;
+            c->handle_skeletons_count++;
+        }
+        GRIB_MUTEX_UNLOCK(&mutex);
+    }
+
+    if (h)
+        h->layout->modified = 0;
+    return h;
+}
+
+void grib_handle_skeletons_delete(grib_context* c)
+{
+    grib_handle* h = NULL;
+    if (!c)
+        c = grib_context_get_default();
+
+    GRIB_MUTEX_INIT_ONCE(&once, &init);
+    GRIB_MUTEX_LOCK(&mutex);
+    h                         = c->handle_skeletons;
+    c->handle_skeletons       = NULL;
+    c->handle_skeletons_count = 0;
+    GRIB_MUTEX_UNLOCK(&mutex);
+
+    skeletons_delete(c, h);
+}
@@ -305,6 +305,21 @@ int grib_ieee_decode_array<float>(grib_context* c, unsigned char* buf, size_t nv
 #endif
             }
             break;
+        case 8:
+            for (i = 0; i < nvals; i++) {
+                double dval;
+#if IEEE_LE
+                unsigned char s8[8];
+                for (j = 7; j >= 0; j--)
+                    s8[j] = *(buf++);
+                memcpy(&dval, s8, 8);
+#elif IEEE_BE
+                memcpy(&dval, buf, 8);
+                buf += 8;
+#endif
+                val[i] = (float)dval;
+            }
+            break;
         default:
             grib_context_log(c, GRIB_LOG_ERROR,
                              "grib_ieee_decode_array_float: %d bits not implemented", bytes * 8);
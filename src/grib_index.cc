@@ -62,6 +62,9 @@ static int grib_filesid = -1;
 static int index_count;
 static long values_count = 0;
 
+static int grib_index_flat_thaw(grib_index* index);
+static void grib_index_flat_delete(grib_index_flat* flat);
+
 static char* get_key(char** keys, int* type)
 {
     char* key = NULL;
@@ -131,6 +134,169 @@ static int compare_string(const void* a, const void* b)
     return *arg1 < *arg2 ? -1 : 1;
 }
 
+/* Hash table finding the item of a list with a given value in constant time.
+ * The lists are the values of each key (the owner is the key) and the siblings in
+ * the field tree (the owner is the parent node, or the index for the first level).
+ * The last item of each list is kept under a NULL value, so new values can be
+ * appended keeping the file order. So is the last field of a leaf node, which has
+ * no children.
+ */
+typedef struct grib_index_hash_entry
+{
+    const void* owner; /* NULL for an empty entry */
+    const char* value; /* Belongs to the item */
+    void* item;
+} grib_index_hash_entry;
+
+struct grib_index_hash
+{
+    grib_context* context;
+    grib_index_hash_entry* entries;
+    size_t size; /* A power of two */
+    size_t count;
+};
+
+static size_t index_hash_code(const void* owner, const char* value)
+{
+    /* FNV-1a */
+    uint64_t h = 14695981039346656037ULL ^ (uint64_t)(uintptr_t)owner;
+    h *= 1099511628211ULL;
+    if (value) {
+        for (; *value; value++) {
+            h ^= (unsigned char)*value;
+            h *= 1099511628211ULL;
+        }
+    }
+    return (size_t)(h ^ (h >> 32));
+}
+
+static grib_index_hash_entry* index_hash_slot(const grib_index_hash* hash, const void* owner, const char* value)
+{
+    const size_t mask = hash->size - 1;
+    size_t i          = index_hash_code(owner, value) & mask;
+
+    for (;;) {
+        grib_index_hash_entry* e = &hash->entries[i];
+        if (!e->owner)
+            return e;
+        if (e->owner == owner && (value ? e->value && !strcmp(e->value, value) : !e->value))
+            return e;
+        i = (i + 1) & mask;
+    }
+}
+
+static void* index_hash_get(const grib_index_hash* hash, const void* owner, const char* value)
+{
+    if (hash->count == 0)
+        return NULL;
+    return index_hash_slot(hash, owner, value)->item;
+}
+
+static int index_hash_set(grib_index_hash* hash, const void* owner, const char* value, void* item)
+{
+    grib_index_hash_entry* e = NULL;
+
+    if (2 * (hash->count + 1) > hash->size) {
+        grib_index_hash_entry* old = hash->entries;
+        size_t old_size            = hash->size;
+        size_t i                   = 0;
+
+        hash->size    = old_size ? 2 * old_size : 64;
+        hash->entries = (grib_index_hash_entry*)grib_context_malloc_clear(hash->context,
+                                                                          hash->size * sizeof(grib_index_hash_entry));
+        if (!hash->entries) {
+            hash->entries = old;
+            hash->size    = old_size;
+            return GRIB_OUT_OF_MEMORY;
+        }
+        for (i = 0; i < old_size; i++) {
+            if (old[i].owner)
+                *index_hash_slot(hash, old[i].owner, old[i].value) = old[i];
+        }
+        grib_context_free(hash->context, old);
+    }
+
+    e = index_hash_slot(hash, owner, value);
+    if (!e->owner) {
+        e->owner = owner;
+        e->value = value;
+        hash->count++;
+    }
+    e->item = item;
+    return GRIB_SUCCESS;
+}
+
+static void grib_index_hash_delete(grib_index_hash* hash)
+{
+    if (!hash)
+        return;
+    grib_context_free(hash->context, hash->entries);
+    grib_context_free(hash->context, hash);
+}
+
+static int index_hash_add_tree(grib_index_hash* hash, const void* owner, grib_field_tree* tree)
+{
+    grib_field_tree* last = NULL;
+    int err               = 0;
+
+    for (; tree && !err; tree = tree->next) {
+        if (!tree->value)
+            continue;
+        err = index_hash_set(hash, owner, tree->value, tree);
+        if (!err && tree->next_level) {
+            err = index_hash_add_tree(hash, tree, tree->next_level);
+        }
+        else if (!err && tree->field) {
+            grib_field* field = tree->field;
+            while (field->next)
+                field = field->next;
+            err = index_hash_set(hash, tree, NULL, field);
+        }
+        last = tree;
+    }
+    if (!err && last)
+        err = index_hash_set(hash, owner, NULL, last);
+    return err;
+}
+
+/* Build the hash table of an index read from a file or compressed */
+static int grib_index_hash_build(grib_index* index)
+{
+    grib_context* c        = index->context;
+    grib_index_hash* hash  = NULL;
+    grib_index_key* k      = NULL;
+    int err                = 0;
+
+    if (index->hash)
+        return GRIB_SUCCESS;
+    hash = (grib_index_hash*)grib_context_malloc_clear(c, sizeof(grib_index_hash));
+    if (!hash)
+        return GRIB_OUT_OF_MEMORY;
+    hash->context = c;
+
+    for (k = index->keys; k && !err; k = k->next) {
+        grib_string_list* v    = NULL;
+        grib_string_list* last = NULL;
+        for (v = k->values; v && !err; v = v->next) {
+            if (v->value) {
+                err  = index_hash_set(hash, k, v->value, v);
+                last = v;
+            }
+        }
+        if (!err && last)
+            err = index_hash_set(hash, k, NULL, last);
+    }
+    if (!err)
+        err = index_hash_add_tree(hash, index, index->fields);
+
+    if (err) {
+        grib_index_hash_delete(hash);
+        return err;
+    }
+    index->hash = hash;
+    return GRIB_SUCCESS;
+}
+
 static int grib_index_keys_compress(grib_context* c, grib_index* index, int* compress)
 {
     grib_index_key* keys = index->keys->next;
@@ -214,9 +380,16 @@ int grib_index_compress(grib_index* index)
     grib_context* c   = index->context;
     int compress[200] = {0,};
 
+    err = grib_index_flat_thaw(index);
+    if (err) return err;
+
     if (!index->keys->next)
         return 0;
 
+    /* Keys and nodes are removed */
+    grib_index_hash_delete(index->hash);
+    index->hash = NULL;
+
     err = grib_index_keys_compress(c, index, compress);
     if (err) return err;
 
@@ -394,7 +567,20 @@ char* grib_read_string(grib_context* c, FILE* fh, int* err)
     return s;
 }
 
-static int grib_write_field(FILE* fh, grib_field* field)
+/* Id in the index of the file of a field. The files of the fields come from the file pool,
+ * whose ids can differ from the ids of the files of the index
+ */
+static int index_file_id(const grib_file* files, const grib_file* file)
+{
+    const grib_file* f = files;
+    for (; f; f = f->next) {
+        if (f == file || (f->name && file->name && !strcmp(f->name, file->name)))
+            return f->id;
+    }
+    return file->id;
+}
+
+static int grib_write_field(FILE* fh, const grib_file* files, grib_field* field)
 {
     int err;
     if (!field)
@@ -404,7 +590,7 @@ static int grib_write_field(FILE* fh, grib_field* field)
     if (err)
         return err;
 
-    err = grib_write_short(fh, field->file->id);
+    err = grib_write_short(fh, index_file_id(files, field->file));
     if (err)
         return err;
 
@@ -416,7 +602,7 @@ static int grib_write_field(FILE* fh, grib_field* field)
     if (err)
         return err;
 
-    err = grib_write_field(fh, field->next);
+    err = grib_write_field(fh, files, field->next);
     if (err)
         return err;
 
@@ -462,7 +648,7 @@ static grib_field* grib_read_field(grib_context* c, FILE* fh, grib_file** files,
     return field;
 }
 
-static int grib_write_field_tree(FILE* fh, grib_field_tree* tree)
+static int grib_write_field_tree(FILE* fh, const grib_file* files, grib_field_tree* tree)
 {
     int err = 0;
 
@@ -473,7 +659,7 @@ static int grib_write_field_tree(FILE* fh, grib_field_tree* tree)
     if (err)
         return err;
 
-    err = grib_write_field(fh, tree->field);
+    err = grib_write_field(fh, files, tree->field);
     if (err)
         return err;
 
@@ -481,11 +667,11 @@ static int grib_write_field_tree(FILE* fh, grib_field_tree* tree)
     if (err)
         return err;
 
-    err = grib_write_field_tree(fh, tree->next_level);
+    err = grib_write_field_tree(fh, files, tree->next_level);
     if (err)
         return err;
 
-    err = grib_write_field_tree(fh, tree->next);
+    err = grib_write_field_tree(fh, files, tree->next);
     if (err)
         return err;
     return GRIB_SUCCESS;
@@ -551,6 +737,7 @@ grib_index* grib_index_new(grib_context* c, const char* key, int* err)
     index->context = c;
     index->product_kind = PRODUCT_GRIB;
     index->unpack_bufr = 0;
+    index->num_threads = 1;
 
     while ((key = get_key(&p, &type)) != NULL) {
         keys = grib_index_new_key(c, keys, key, type, err);
@@ -571,14 +758,12 @@ grib_index* grib_index_new(grib_context* c, const char* key, int* err)
 
 static void grib_index_values_delete(grib_context* c, grib_string_list* values)
 {
-    if (!values)
-        return;
-
-    grib_index_values_delete(c, values->next);
-    grib_context_free(c, values->value);
-    grib_context_free(c, values);
-
-    return;
+    while (values) {
+        grib_string_list* next = values->next;
+        grib_context_free(c, values->value);
+        grib_context_free(c, values);
+        values = next;
+    }
 }
 
 static void grib_index_key_delete(grib_context* c, grib_index_key* keys)
@@ -714,36 +899,35 @@ static int grib_write_index_keys(FILE* fh, grib_index_key* keys)
     return GRIB_SUCCESS;
 }
 
+/* The lists of fields and of sibling nodes can be very long: free them in a loop */
 static void grib_field_delete(grib_context* c, grib_field* field)
 {
     int err = 0;
 
-    if (!field)
-        return;
-
-    grib_field_delete(c, field->next);
-
-    if (field->file) {
-        grib_file_close(field->file->name, 0, &err);
-        field->file = NULL;
+    while (field) {
+        grib_field* next = field->next;
+        if (field->file) {
+            grib_file_close(field->file->name, 0, &err);
+            field->file = NULL;
+        }
+        grib_context_free(c, field);
+        field = next;
     }
-
-    grib_context_free(c, field);
 }
 
 static void grib_field_tree_delete(grib_context* c, grib_field_tree* tree)
 {
-    if (!tree)
-        return;
-
-    grib_field_delete(c, tree->field);
-    grib_context_free(c, tree->value);
+    while (tree) {
+        grib_field_tree* next = tree->next;
 
-    grib_field_tree_delete(c, tree->next_level);
+        grib_field_delete(c, tree->field);
+        grib_context_free(c, tree->value);
 
-    grib_field_tree_delete(c, tree->next);
+        grib_field_tree_delete(c, tree->next_level);
 
-    grib_context_free(c, tree);
+        grib_context_free(c, tree);
+        tree = next;
+    }
 }
 
 static void grib_field_list_delete(grib_context* c, grib_field_list* field_list)
@@ -763,6 +947,8 @@ void grib_index_delete(grib_index* index)
     grib_file* file = index->files;
     grib_index_key_delete(index->context, index->keys);
     grib_field_tree_delete(index->context, index->fields);
+    grib_index_flat_delete(index->flat);
+    grib_index_hash_delete(index->hash);
     grib_field_list_delete(index->context, index->fieldset);
     while (file) {
         grib_file* f = file;
@@ -806,7 +992,7 @@ static grib_file* grib_read_files(grib_context* c, FILE* fh, int* err)
         return NULL;
     }
 
-    file       = (grib_file*)grib_context_malloc(c, sizeof(grib_file));
+    file       = (grib_file*)grib_context_malloc_clear(c, sizeof(grib_file));
     file->name = grib_read_string(c, fh, err);
     if (*err)
         return NULL;
@@ -823,12 +1009,815 @@ static grib_file* grib_read_files(grib_context* c, FILE* fh, int* err)
     return file;
 }
 
+/* ======================================= */
+/* Flat index format (version 2)
+ *
+ * The field tree is stored level by level as sorted arrays of fixed-size records
+ * referring to each other by position, followed by one pool of strings. The file is
+ * mapped and queried in place: opening it only reads the keys and the file names,
+ * whatever the number of fields.
+ *
+ *   identifier    "GRBIDX2" or "BFRIDX2", same encoding as version 1
+ *   header        index_v2_header
+ *   files         index_v2_file[num_files]
+ *   keys          index_v2_key[num_keys]
+ *   values        uint64_t[num_values], the values of all the keys in the strings pool
+ *   nodes         index_v2_node[num_nodes], the first num_roots are the first level.
+ *                 The children of a node are contiguous and sorted by value (strcmp)
+ *   fields        index_v2_field[num_fields], contiguous for each leaf in file order
+ *   strings       NUL-terminated strings
+ *
+ * Numbers are in the byte order of the machine which wrote the file. Every part
+ * starts on a multiple of 8 bytes.
+ */
+
+#define INDEX_V2_VERSION    2
+#define INDEX_V2_BYTE_ORDER 0x01020304
+#define INDEX_V2_ALIGN(n)   (((n) + 7) & ~(uint64_t)7)
+
+typedef struct index_v2_header
+{
+    uint32_t byte_order;
+    uint32_t version;
+    uint32_t num_files;
+    uint32_t num_keys;
+    uint64_t num_values;
+    uint64_t num_nodes;
+    uint64_t num_roots;
+    uint64_t num_fields;
+    uint64_t files_offset;
+    uint64_t keys_offset;
+    uint64_t values_offset;
+    uint64_t nodes_offset;
+    uint64_t fields_offset;
+    uint64_t strings_offset;
+    uint64_t strings_size;
+} index_v2_header;
+
+typedef struct index_v2_file
+{
+    uint64_t name;
+    int32_t id;
+    uint32_t unused;
+} index_v2_file;
+
+typedef struct index_v2_key
+{
+    uint64_t name;
+    uint64_t first_value;
+    uint32_t num_values;
+    int32_t type;
+} index_v2_key;
+
+typedef struct index_v2_node
+{
+    uint64_t value;
+    uint64_t first_child;
+    uint64_t first_field;
+    uint32_t num_children;
+    uint32_t num_fields;
+} index_v2_node;
+
+typedef struct index_v2_field
+{
+    uint64_t offset;
+    uint64_t length;
+    int32_t file_id;
+    uint32_t unused;
+} index_v2_field;
+
+struct grib_index_flat
+{
+    grib_context* context;
+    grib_mmap_file* mmap_file; /* NULL when the file was read into 'buffer' */
+    unsigned char* buffer;
+    const unsigned char* data;
+    size_t length;
+    const index_v2_header* header;
+    const index_v2_file* files_table;
+    const index_v2_node* nodes;
+    const index_v2_field* fields;
+    const char* strings;
+    grib_file** files; /* By file id */
+    int files_size;
+    uint64_t current;  /* Position of the field returned last */
+    uint64_t end;      /* End of the selected fields */
+    grib_field field;  /* The field returned last */
+};
+
+/* ---- Writing ---- */
+
+typedef struct index_v2_string
+{
+    const char* value;
+    uint64_t offset;
+} index_v2_string;
+
+typedef struct index_v2_writer
+{
+    grib_context* context;
+    char* strings;
+    size_t strings_size, strings_capacity;
+    index_v2_node* nodes;
+    size_t num_nodes, nodes_capacity;
+    grib_field_tree** trees; /* The tree node written to each node */
+    uint32_t* depths;
+    size_t trees_capacity;
+    index_v2_field* fields;
+    size_t num_fields, fields_capacity;
+    grib_field_tree** siblings;
+    size_t siblings_capacity;
+    index_v2_string** key_values; /* Sorted values of each key with their offset in the strings */
+    const index_v2_key* keys;
+    int num_keys;
+    const grib_file* files; /* Of the index */
+} index_v2_writer;
+
+/* Make room for one more element at position 'size' */
+static int index_v2_reserve(grib_context* c, void** array, size_t size, size_t* capacity, size_t elsize)
+{
+    void* a = NULL;
+    if (size < *capacity)
+        return GRIB_SUCCESS;
+    a = grib_context_realloc(c, *array, (*capacity ? 2 * *capacity : 1024) * elsize);
+    if (!a)
+        return GRIB_OUT_OF_MEMORY;
+    *array    = a;
+    *capacity = *capacity ? 2 * *capacity : 1024;
+    return GRIB_SUCCESS;
+}
+
+static int index_v2_add_string(index_v2_writer* w, const char* s, uint64_t* offset)
+{
+    size_t len = strlen(s) + 1;
+    while (w->strings_size + len > w->strings_capacity) {
+        size_t capacity = w->strings_capacity ? 2 * w->strings_capacity : 4096;
+        char* strings   = (char*)grib_context_realloc(w->context, w->strings, capacity);
+        if (!strings)
+            return GRIB_OUT_OF_MEMORY;
+        w->strings          = strings;
+        w->strings_capacity = capacity;
+    }
+    memcpy(w->strings + w->strings_size, s, len);
+    *offset = w->strings_size;
+    w->strings_size += len;
+    return GRIB_SUCCESS;
+}
+
+static int compare_index_v2_string(const void* a, const void* b)
+{
+    return strcmp(((const index_v2_string*)a)->value, ((const index_v2_string*)b)->value);
+}
+
+static int compare_field_tree_value(const void* a, const void* b)
+{
+    return strcmp((*(grib_field_tree* const*)a)->value, (*(grib_field_tree* const*)b)->value);
+}
+
+/* Append a list of siblings at the given depth of the tree as a block of nodes sorted by value */
+static int index_v2_add_siblings(index_v2_writer* w, grib_field_tree* tree, uint32_t depth,
+                                 uint64_t* first, uint32_t* count)
+{
+    grib_context* c = w->context;
+    size_t n = 0, i = 0;
+    int err  = 0;
+
+    for (; tree; tree = tree->next) {
+        if (!tree->value)
+            continue; /* Root of an empty index */
+        if ((err = index_v2_reserve(c, (void**)&w->siblings, n, &w->siblings_capacity, sizeof(grib_field_tree*))))
+            return err;
+        w->siblings[n++] = tree;
+    }
+    qsort(w->siblings, n, sizeof(grib_field_tree*), &compare_field_tree_value);
+
+    *first = w->num_nodes;
+    *count = (uint32_t)n;
+    for (i = 0; i < n; i++) {
+        index_v2_string value = { w->siblings[i]->value, 0 };
+        index_v2_string* found = NULL;
+        index_v2_node* node    = NULL;
+        size_t trees_capacity  = w->trees_capacity;
+
+        if ((err = index_v2_reserve(c, (void**)&w->nodes, w->num_nodes, &w->nodes_capacity, sizeof(index_v2_node))) ||
+            (err = index_v2_reserve(c, (void**)&w->trees, w->num_nodes, &w->trees_capacity, sizeof(grib_field_tree*))) ||
+            (err = index_v2_reserve(c, (void**)&w->depths, w->num_nodes, &trees_capacity, sizeof(uint32_t))))
+            return err;
+
+        node = &w->nodes[w->num_nodes];
+        memset(node, 0, sizeof(index_v2_node));
+        w->trees[w->num_nodes]  = w->siblings[i];
+        w->depths[w->num_nodes] = depth;
+
+        /* The values of the nodes are the values of the key at their level */
+        if (depth < (uint32_t)w->num_keys)
+            found = (index_v2_string*)bsearch(&value, w->key_values[depth], w->keys[depth].num_values,
+                                              sizeof(index_v2_string), &compare_index_v2_string);
+        if (found)
+            node->value = found->offset;
+        else if ((err = index_v2_add_string(w, value.value, &node->value)))
+            return err;
+        w->num_nodes++;
+    }
+    return GRIB_SUCCESS;
+}
+
+static int index_v2_add_fields(index_v2_writer* w, const grib_field* field, uint64_t* first, uint32_t* count)
+{
+    int err = 0;
+    *first  = w->num_fields;
+    *count  = 0;
+    for (; field; field = field->next) {
+        index_v2_field* f = NULL;
+        if ((err = index_v2_reserve(w->context, (void**)&w->fields, w->num_fields, &w->fields_capacity, sizeof(index_v2_field))))
+            return err;
+        f = &w->fields[w->num_fields++];
+        memset(f, 0, sizeof(index_v2_field));
+        f->offset  = (uint64_t)field->offset;
+        f->length  = (uint64_t)field->length;
+        f->file_id = field->file ? index_file_id(w->files, field->file) : -1;
+        (*count)++;
+    }
+    return GRIB_SUCCESS;
+}
+
+static int index_v2_write_part(FILE* fh, const void* data, size_t size, uint64_t* pos)
+{
+    static const char zeros[8] = {0,};
+    size_t padding = (size_t)(INDEX_V2_ALIGN(*pos + size) - (*pos + size));
+    if (size && fwrite(data, 1, size, fh) != size)
+        return GRIB_IO_PROBLEM;
+    if (padding && fwrite(zeros, 1, padding, fh) != padding)
+        return GRIB_IO_PROBLEM;
+    *pos += size + padding;
+    return GRIB_SUCCESS;
+}
+
+/* Write the index in the flat format after its identifier, i.e. 8 bytes from the start of the file */
+static int grib_index_write_flat(grib_index* index, FILE* fh)
+{
+    grib_context* c        = index->context;
+    index_v2_header header = {0,};
+    index_v2_writer w;
+    index_v2_file* files = NULL;
+    index_v2_key* keys   = NULL;
+    uint64_t* values     = NULL;
+    grib_file* f         = NULL;
+    grib_index_key* k    = NULL;
+    grib_string_list* v  = NULL;
+    uint64_t pos         = 8;
+    size_t i = 0, num_values = 0;
+    int num_files = 0;
+    int err       = 0;
+
+    memset(&w, 0, sizeof(w));
+    w.context = c;
+    w.files   = index->files;
+    for (f = index->files; f; f = f->next)
+        num_files++;
+    for (k = index->keys; k; k = k->next) {
+        w.num_keys++;
+        for (v = k->values; v; v = v->next)
+            num_values++;
+    }
+
+    files        = (index_v2_file*)grib_context_malloc_clear(c, (num_files + 1) * sizeof(index_v2_file));
+    keys         = (index_v2_key*)grib_context_malloc_clear(c, (w.num_keys + 1) * sizeof(index_v2_key));
+    values       = (uint64_t*)grib_context_malloc_clear(c, (num_values + 1) * sizeof(uint64_t));
+    w.key_values = (index_v2_string**)grib_context_malloc_clear(c, (w.num_keys + 1) * sizeof(index_v2_string*));
+    w.keys       = keys;
+    if (!files || !keys || !values || !w.key_values) {
+        err = GRIB_OUT_OF_MEMORY;
+        goto cleanup;
+    }
+
+    for (f = index->files, i = 0; f; f = f->next, i++) {
+        files[i].id = f->id;
+        if ((err = index_v2_add_string(&w, f->name, &files[i].name)))
+            goto cleanup;
+    }
+
+    num_values = 0;
+    for (k = index->keys, i = 0; k; k = k->next, i++) {
+        index_v2_key* key = &keys[i];
+        key->type         = k->type;
+        key->first_value  = num_values;
+        if ((err = index_v2_add_string(&w, k->name, &key->name)))
+            goto cleanup;
+        for (v = k->values; v; v = v->next)
+            key->num_values++;
+        w.key_values[i] = (index_v2_string*)grib_context_malloc_clear(c, (key->num_values + 1) * sizeof(index_v2_string));
+        if (!w.key_values[i]) {
+            err = GRIB_OUT_OF_MEMORY;
+            goto cleanup;
+        }
+        key->num_values = 0;
+        for (v = k->values; v; v = v->next) {
+            if (!v->value)
+                continue; /* Key of an empty index */
+            if ((err = index_v2_add_string(&w, v->value, &values[num_values])))
+                goto cleanup;
+            w.key_values[i][key->num_values].value  = v->value;
+            w.key_values[i][key->num_values].offset = values[num_values];
+            key->num_values++;
+            num_values++;
+        }
+        qsort(w.key_values[i], key->num_values, sizeof(index_v2_string), &compare_index_v2_string);
+    }
+
+    /* The tree breadth first, so the children of a node are contiguous */
+    {
+        uint64_t first_root = 0;
+        uint32_t num_roots  = 0;
+        if ((err = index_v2_add_siblings(&w, index->fields, 0, &first_root, &num_roots)))
+            goto cleanup;
+        header.num_roots = num_roots;
+    }
+    for (i = 0; i < w.num_nodes; i++) {
+        grib_field_tree* tree = w.trees[i];
+        uint64_t first_child = 0, first_field = 0;
+        uint32_t num_children = 0, num_fields = 0;
+        if ((err = index_v2_add_fields(&w, tree->field, &first_field, &num_fields)) ||
+            (err = index_v2_add_siblings(&w, tree->next_level, w.depths[i] + 1, &first_child, &num_children)))
+            goto cleanup;
+        w.nodes[i].first_field  = first_field;
+        w.nodes[i].num_fields   = num_fields;
+        w.nodes[i].first_child  = first_child;
+        w.nodes[i].num_children = num_children;
+    }
+
+    header.byte_order     = INDEX_V2_BYTE_ORDER;
+    header.version        = INDEX_V2_VERSION;
+    header.num_files      = num_files;
+    header.num_keys       = w.num_keys;
+    header.num_values     = num_values;
+    header.num_nodes      = w.num_nodes;
+    header.num_fields     = w.num_fields;
+    header.files_offset   = INDEX_V2_ALIGN(pos + sizeof(header));
+    header.keys_offset    = INDEX_V2_ALIGN(header.files_offset + num_files * sizeof(index_v2_file));
+    header.values_offset  = INDEX_V2_ALIGN(header.keys_offset + w.num_keys * sizeof(index_v2_key));
+    header.nodes_offset   = INDEX_V2_ALIGN(header.values_offset + num_values * sizeof(uint64_t));
+    header.fields_offset  = INDEX_V2_ALIGN(header.nodes_offset + w.num_nodes * sizeof(index_v2_node));
+    header.strings_offset = INDEX_V2_ALIGN(header.fields_offset + w.num_fields * sizeof(index_v2_field));
+    header.strings_size   = w.strings_size;
+
+    if ((err = index_v2_write_part(fh, &header, sizeof(header), &pos)) ||
+        (err = index_v2_write_part(fh, files, num_files * sizeof(index_v2_file), &pos)) ||
+        (err = index_v2_write_part(fh, keys, w.num_keys * sizeof(index_v2_key), &pos)) ||
+        (err = index_v2_write_part(fh, values, num_values * sizeof(uint64_t), &pos)) ||
+        (err = index_v2_write_part(fh, w.nodes, w.num_nodes * sizeof(index_v2_node), &pos)) ||
+        (err = index_v2_write_part(fh, w.fields, w.num_fields * sizeof(index_v2_field), &pos)) ||
+        (err = index_v2_write_part(fh, w.strings, w.strings_size, &pos)))
+        goto cleanup;
+    Assert(pos == INDEX_V2_ALIGN(header.strings_offset + header.strings_size));
+
+cleanup:
+    if (w.key_values) {
+        for (i = 0; i < (size_t)w.num_keys; i++)
+            grib_context_free(c, w.key_values[i]);
+        grib_context_free(c, w.key_values);
+    }
+    grib_context_free(c, files);
+    grib_context_free(c, keys);
+    grib_context_free(c, values);
+    grib_context_free(c, w.strings);
+    grib_context_free(c, w.nodes);
+    grib_context_free(c, w.trees);
+    grib_context_free(c, w.depths);
+    grib_context_free(c, w.fields);
+    grib_context_free(c, w.siblings);
+    return err;
+}
+
+/* ---- Reading ---- */
+
+static void grib_index_flat_delete(grib_index_flat* flat)
+{
+    grib_context* c = NULL;
+    int i = 0, err = 0;
+
+    if (!flat)
+        return;
+    c = flat->context;
+    for (i = 0; i < flat->files_size; i++) {
+        if (flat->files[i])
+            grib_file_close(flat->files[i]->name, 0, &err);
+    }
+    grib_context_free(c, flat->files);
+    if (flat->mmap_file)
+        grib_mmap_file_release(flat->mmap_file);
+    grib_context_free(c, flat->buffer);
+    grib_context_free(c, flat);
+}
+
+/* Check a part of 'count' elements of 'size' bytes lies within the file */
+static int index_v2_part_ok(const grib_index_flat* flat, uint64_t offset, uint64_t count, size_t size)
+{
+    if (offset % 8 != 0 || offset > flat->length)
+        return 0;
+    return count <= (flat->length - offset) / size;
+}
+
+static int index_v2_string_ok(const grib_index_flat* flat, uint64_t offset)
+{
+    return offset < flat->header->strings_size;
+}
+
+/* Map the index file. The mapping is only read */
+static grib_index_flat* grib_index_flat_open(grib_context* c, const char* filename, int* err)
+{
+    grib_index_flat* flat = (grib_index_flat*)grib_context_malloc_clear(c, sizeof(grib_index_flat));
+    const index_v2_header* header = NULL;
+
+    if (!flat) {
+        *err = GRIB_OUT_OF_MEMORY;
+        return NULL;
+    }
+    flat->context = c;
+
+#ifndef ECCODES_ON_WINDOWS
+    flat->mmap_file = codes_mmap_file_open(c, filename, err);
+    if (!flat->mmap_file) {
+        grib_index_flat_delete(flat);
+        return NULL;
+    }
+    flat->data = grib_mmap_file_data(flat->mmap_file, &flat->length);
+#else
+    {
+        FILE* fh = fopen(filename, "rb");
+        if (fh && fseeko(fh, 0, SEEK_END) == 0) {
+            flat->length = (size_t)ftello(fh);
+            flat->buffer = (unsigned char*)grib_context_malloc(c, flat->length + 1);
+            if (!flat->buffer || fseeko(fh, 0, SEEK_SET) != 0 ||
+                fread(flat->buffer, 1, flat->length, fh) != flat->length) {
+                fclose(fh);
+                fh = NULL;
+            }
+        }
+        if (!fh) {
+            grib_context_log(c, (GRIB_LOG_ERROR) | (GRIB_LOG_PERROR), "Unable to read file %s", filename);
+            grib_index_flat_delete(flat);
+            *err = GRIB_IO_PROBLEM;
+            return NULL;
+        }
+        fclose(fh);
+        flat->data = flat->buffer;
+    }
+#endif
+
+    *err = GRIB_CORRUPTED_INDEX;
+    if (flat->length < 8 + sizeof(index_v2_header)) {
+        grib_index_flat_delete(flat);
+        return NULL;
+    }
+    header = (const index_v2_header*)(flat->data + 8);
+    if (header->byte_order != INDEX_V2_BYTE_ORDER) {
+        grib_context_log(c, GRIB_LOG_ERROR, "Index file %s was written on a machine with a different byte order", filename);
+        grib_index_flat_delete(flat);
+        return NULL;
+    }
+    flat->header = header;
+    if (header->version != INDEX_V2_VERSION ||
+        !index_v2_part_ok(flat, header->files_offset, header->num_files, sizeof(index_v2_file)) ||
+        !index_v2_part_ok(flat, header->keys_offset, header->num_keys, sizeof(index_v2_key)) ||
+        !index_v2_part_ok(flat, header->values_offset, header->num_values, sizeof(uint64_t)) ||
+        !index_v2_part_ok(flat, header->nodes_offset, header->num_nodes, sizeof(index_v2_node)) ||
+        !index_v2_part_ok(flat, header->fields_offset, header->num_fields, sizeof(index_v2_field)) ||
+        !index_v2_part_ok(flat, header->strings_offset, header->strings_size, 1) ||
+        header->num_roots > header->num_nodes ||
+        (header->strings_size > 0 && flat->data[header->strings_offset + header->strings_size - 1] != 0)) {
+        grib_index_flat_delete(flat);
+        return NULL;
+    }
+    flat->files_table = (const index_v2_file*)(flat->data + header->files_offset);
+    flat->nodes       = (const index_v2_node*)(flat->data + header->nodes_offset);
+    flat->fields      = (const index_v2_field*)(flat->data + header->fields_offset);
+    flat->strings     = (const char*)(flat->data + header->strings_offset);
+
+    *err = GRIB_SUCCESS;
+    return flat;
+}
+
+/* Read an index file in the flat format. Only the keys and the files are loaded */
+static grib_index* grib_index_read_flat(grib_context* c, const char* filename, ProductKind product_kind, int* err)
+{
+    grib_index* index         = NULL;
+    grib_index_flat* flat     = NULL;
+    const index_v2_key* keys  = NULL;
+    const uint64_t* values    = NULL;
+    grib_index_key* last_key  = NULL;
+    uint32_t i = 0, j = 0;
+
+    flat = grib_index_flat_open(c, filename, err);
+    if (!flat)
+        return NULL;
+
+    index = (grib_index*)grib_context_malloc_clear(c, sizeof(grib_index));
+    if (!index) {
+        grib_index_flat_delete(flat);
+        *err = GRIB_OUT_OF_MEMORY;
+        return NULL;
+    }
+    index->context      = c;
+    index->product_kind = product_kind;
+    index->num_threads  = 1;
+    index->flat         = flat;
+    index->count        = (int)flat->header->num_fields;
+
+    /* Files */
+    for (i = 0; i < flat->header->num_files; i++) {
+        const index_v2_file* file = &flat->files_table[i];
+        if (file->id < 0 || file->id > SHRT_MAX || !index_v2_string_ok(flat, file->name)) {
+            *err = GRIB_CORRUPTED_INDEX;
+            goto fail;
+        }
+        if (file->id >= flat->files_size)
+            flat->files_size = file->id + 1;
+    }
+    flat->files = (grib_file**)grib_context_malloc_clear(c, (flat->files_size + 1) * sizeof(grib_file*));
+    if (!flat->files) {
+        *err = GRIB_OUT_OF_MEMORY;
+        goto fail;
+    }
+    for (i = 0; i < flat->header->num_files; i++) {
+        const index_v2_file* file = &flat->files_table[i];
+        const char* name          = flat->strings + file->name;
+        grib_file_open(name, "r", err);
+        if (*err)
+            goto fail;
+        flat->files[file->id] = grib_get_file(name, err); /* fetch from pool */
+        if (*err)
+            goto fail;
+    }
+
+    /* Keys and their values */
+    keys   = (const index_v2_key*)(flat->data + flat->header->keys_offset);
+    values = (const uint64_t*)(flat->data + flat->header->values_offset);
+    for (i = 0; i < flat->header->num_keys; i++) {
+        grib_index_key* key     = NULL;
+        grib_string_list* last  = NULL;
+        if (!index_v2_string_ok(flat, keys[i].name) || keys[i].first_value > flat->header->num_values ||
+            keys[i].num_values > flat->header->num_values - keys[i].first_value) {
+            *err = GRIB_CORRUPTED_INDEX;
+            goto fail;
+        }
+        key = (grib_index_key*)grib_context_malloc_clear(c, sizeof(grib_index_key));
+        if (!key) {
+            *err = GRIB_OUT_OF_MEMORY;
+            goto fail;
+        }
+        if (last_key)
+            last_key->next = key;
+        else
+            index->keys = key;
+        last_key           = key;
+        key->name          = grib_context_strdup(c, flat->strings + keys[i].name);
+        key->type          = keys[i].type;
+        key->values_count  = (int)keys[i].num_values;
+        for (j = 0; j < keys[i].num_values; j++) {
+            uint64_t value         = values[keys[i].first_value + j];
+            grib_string_list* sl   = NULL;
+            if (!index_v2_string_ok(flat, value)) {
+                *err = GRIB_CORRUPTED_INDEX;
+                goto fail;
+            }
+            sl = (grib_string_list*)grib_context_malloc_clear(c, sizeof(grib_string_list));
+            if (!sl) {
+                *err = GRIB_OUT_OF_MEMORY;
+                goto fail;
+            }
+            sl->value = grib_context_strdup(c, flat->strings + value);
+            if (last)
+                last->next = sl;
+            else
+                key->values = sl;
+            last = sl;
+        }
+        if (!key->values) /* Like a new key */
+            key->values = (grib_string_list*)grib_context_malloc_clear(c, sizeof(grib_string_list));
+    }
+
+    *err = GRIB_SUCCESS;
+    return index;
+
+fail:
+    if (*err == GRIB_CORRUPTED_INDEX)
+        grib_context_log(c, GRIB_LOG_ERROR, "Index file %s is corrupted", filename);
+    grib_index_delete(index);
+    return NULL;
+}
+
+/* Find the node with the given value among 'count' sorted nodes */
+static const index_v2_node* index_v2_find(const grib_index_flat* flat, uint64_t first, uint64_t count, const char* value)
+{
+    uint64_t lo = first, hi = first + count;
+    while (lo < hi) {
+        uint64_t mid              = lo + (hi - lo) / 2;
+        const index_v2_node* node = &flat->nodes[mid];
+        int cmp                   = 0;
+        if (!index_v2_string_ok(flat, node->value))
+            return NULL;
+        cmp = strcmp(flat->strings + node->value, value);
+        if (cmp == 0)
+            return node;
+        if (cmp < 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return NULL;
+}
+
+/* Select the fields matching the values of the keys */
+static int grib_index_flat_execute(grib_index* index)
+{
+    grib_index_flat* flat = index->flat;
+    grib_index_key* keys  = index->keys;
+    uint64_t first = 0, count = flat->header->num_roots;
+
+    index->rewind = 0;
+    flat->current = flat->end = 0;
+
+    while (keys) {
+        const index_v2_node* node = NULL;
+        if (!keys->value[0]) {
+            grib_context_log(index->context, GRIB_LOG_ERROR,
+                             "please select a value for index key \"%s\"", keys->name);
+            return GRIB_NOT_FOUND;
+        }
+        node = index_v2_find(flat, first, count, keys->value);
+        if (!node)
+            return GRIB_END_OF_INDEX;
+        if (node->num_children) {
+            if (node->first_child > flat->header->num_nodes ||
+                node->num_children > flat->header->num_nodes - node->first_child)
+                return GRIB_CORRUPTED_INDEX;
+            first = node->first_child;
+            count = node->num_children;
+            keys  = keys->next;
+        }
+        else {
+            if (node->num_fields == 0 || node->first_field > flat->header->num_fields ||
+                node->num_fields > flat->header->num_fields - node->first_field)
+                return GRIB_END_OF_INDEX;
+            flat->current = node->first_field;
+            flat->end     = node->first_field + node->num_fields;
+            return GRIB_SUCCESS;
+        }
+    }
+    return GRIB_END_OF_INDEX;
+}
+
+/* Next field of the selection, following the same protocol as the field tree */
+static grib_handle* grib_index_flat_new_handle(grib_index* index, int message_type, int* err)
+{
+    grib_index_flat* flat       = index->flat;
+    const index_v2_field* field = NULL;
+
+    if (index->rewind) {
+        *err = grib_index_flat_execute(index);
+        if (*err)
+            return NULL;
+    }
+    else if (flat->current < flat->end) {
+        flat->current++;
+    }
+    if (flat->current >= flat->end) {
+        *err = GRIB_END_OF_INDEX;
+        return NULL;
+    }
+
+    field = &flat->fields[flat->current];
+    if (field->file_id < 0 || field->file_id >= flat->files_size || !flat->files[field->file_id]) {
+        *err = GRIB_CORRUPTED_INDEX;
+        return NULL;
+    }
+    flat->field.file   = flat->files[field->file_id];
+    flat->field.offset = (off_t)field->offset;
+    flat->field.length = (long)field->length;
+    flat->field.next   = NULL;
+
+    if (!index->fieldset) {
+        index->fieldset = (grib_field_list*)grib_context_malloc_clear(index->context, sizeof(grib_field_list));
+        if (!index->fieldset) {
+            *err = GRIB_OUT_OF_MEMORY;
+            return NULL;
+        }
+    }
+    index->current        = index->fieldset;
+    index->current->field = &flat->field;
+
+    return codes_index_get_handle(&flat->field, message_type, err);
+}
+
+/* Turn a flat index into a field tree, so it can be changed */
+static int grib_index_flat_thaw(grib_index* index)
+{
+    grib_context* c       = index->context;
+    grib_index_flat* flat = index->flat;
+    grib_field_tree** trees = NULL; /* The tree node of each node */
+    grib_file* last_file  = NULL;
+    uint64_t i = 0, j = 0;
+    int err = 0;
+
+    if (!flat)
+        return GRIB_SUCCESS;
+
+    trees = (grib_field_tree**)grib_context_malloc_clear(c, (flat->header->num_nodes + 1) * sizeof(grib_field_tree*));
+    if (!trees)
+        return GRIB_OUT_OF_MEMORY;
+    for (i = 0; !err && i < flat->header->num_nodes; i++) {
+        trees[i] = (grib_field_tree*)grib_context_malloc_clear(c, sizeof(grib_field_tree));
+        if (!trees[i])
+            err = GRIB_OUT_OF_MEMORY;
+        else if (!index_v2_string_ok(flat, flat->nodes[i].value))
+            err = GRIB_CORRUPTED_INDEX;
+        else
+            trees[i]->value = grib_context_strdup(c, flat->strings + flat->nodes[i].value);
+    }
+
+    for (i = 0; !err && i < flat->header->num_nodes; i++) {
+        const index_v2_node* node = &flat->nodes[i];
+        grib_field** last_field   = &trees[i]->field;
+        if (node->first_child > flat->header->num_nodes || node->num_children > flat->header->num_nodes - node->first_child ||
+            node->first_field > flat->header->num_fields || node->num_fields > flat->header->num_fields - node->first_field) {
+            err = GRIB_CORRUPTED_INDEX;
+            break;
+        }
+        if (node->num_children)
+            trees[i]->next_level = trees[node->first_child];
+        for (j = 1; j < node->num_children; j++)
+            trees[node->first_child + j - 1]->next = trees[node->first_child + j];
+        for (j = 0; j < node->num_fields; j++) {
+            const index_v2_field* f = &flat->fields[node->first_field + j];
+            grib_field* field       = NULL;
+            if (f->file_id < 0 || f->file_id >= flat->files_size || !flat->files[f->file_id]) {
+                err = GRIB_CORRUPTED_INDEX;
+                break;
+            }
+            field = (grib_field*)grib_context_malloc_clear(c, sizeof(grib_field));
+            if (!field) {
+                err = GRIB_OUT_OF_MEMORY;
+                break;
+            }
+            field->file   = flat->files[f->file_id];
+            field->offset = (off_t)f->offset;
+            field->length = (long)f->length;
+            *last_field   = field;
+            last_field    = &field->next;
+        }
+    }
+    for (i = 1; i < flat->header->num_roots; i++)
+        trees[i - 1]->next = trees[i];
+
+    if (err) {
+        for (i = 0; i < flat->header->num_nodes && trees[i]; i++) {
+            trees[i]->next = trees[i]->next_level = NULL;
+            grib_field_tree_delete(c, trees[i]);
+        }
+        grib_context_free(c, trees);
+        return err;
+    }
+
+    grib_field_tree_delete(c, index->fields);
+    index->fields = flat->header->num_roots ? trees[0]
+                                            : (grib_field_tree*)grib_context_malloc_clear(c, sizeof(grib_field_tree));
+    grib_context_free(c, trees);
+
+    /* The files, so the index can be written again */
+    for (i = 0; i < flat->header->num_files; i++) {
+        const index_v2_file* file = &flat->files_table[i];
+        grib_file* f              = (grib_file*)grib_context_malloc_clear(c, sizeof(grib_file));
+        if (!f)
+            return GRIB_OUT_OF_MEMORY;
+        f->id   = file->id;
+        f->name = strdup(flat->strings + file->name);
+        if (last_file)
+            last_file->next = f;
+        else
+            index->files = f;
+        last_file = f;
+    }
+
+    if (index->fieldset)
+        index->fieldset->field = NULL;
+    index->current = NULL;
+    index->flat    = NULL;
+    grib_index_flat_delete(flat);
+    return GRIB_SUCCESS;
+}
+
 int grib_index_write(grib_index* index, const char* filename)
 {
     int err = 0;
     FILE* fh;
     grib_file* files;
     const char* identifier = NULL;
+    const char* version    = getenv("ECCODES_INDEX_FORMAT_VERSION");
+    const int flat         = !(version && strcmp(version, "1") == 0);
+
+    if (index->flat && (err = grib_index_flat_thaw(index)) != GRIB_SUCCESS)
+        return err;
 
     fh = fopen(filename, "w");
     if (!fh) {
@@ -838,8 +1827,8 @@ int grib_index_write(grib_index* index, const char* filename)
         return GRIB_IO_PROBLEM;
     }
 
-    if (index->product_kind == PRODUCT_GRIB) identifier = "GRBIDX1";
-    if (index->product_kind == PRODUCT_BUFR) identifier = "BFRIDX1";
+    if (index->product_kind == PRODUCT_GRIB) identifier = flat ? "GRBIDX2" : "GRBIDX1";
+    if (index->product_kind == PRODUCT_BUFR) identifier = flat ? "BFRIDX2" : "BFRIDX1";
     Assert(identifier);
     err = grib_write_identifier(fh, identifier);
     if (err) {
@@ -849,6 +1838,18 @@ int grib_index_write(grib_index* index, const char* filename)
         return err;
     }
 
+    if (flat) {
+        err = grib_index_write_flat(index, fh);
+        if (fclose(fh) != 0 && !err)
+            err = GRIB_IO_PROBLEM;
+        if (err) {
+            grib_context_log(index->context, (GRIB_LOG_ERROR) | (GRIB_LOG_PERROR),
+                             "Unable to write in file %s", filename);
+            perror(filename);
+        }
+        return err;
+    }
+
     if (!index)
         return grib_write_null_marker(fh);
 
@@ -875,7 +1876,7 @@ int grib_index_write(grib_index* index, const char* filename)
         return err;
     }
 
-    err = grib_write_field_tree(fh, index->fields);
+    err = grib_write_field_tree(fh, index->files, index->fields);
     if (err) {
         grib_context_log(index->context, (GRIB_LOG_ERROR) | (GRIB_LOG_PERROR),
                          "Unable to write in file %s", filename);
@@ -922,7 +1923,12 @@ grib_index* grib_index_read(grib_context* c, const char* filename, int* err)
         return NULL;
     }
 
-    if (strcmp(identifier, "BFRIDX1")==0) product_kind = PRODUCT_BUFR;
+    if (strcmp(identifier, "BFRIDX1")==0 || strcmp(identifier, "BFRIDX2")==0) product_kind = PRODUCT_BUFR;
+    if (strcmp(identifier, "GRBIDX2")==0 || strcmp(identifier, "BFRIDX2")==0) {
+        grib_context_free(c, identifier);
+        fclose(fh);
+        return grib_index_read_flat(c, filename, product_kind, err);
+    }
     grib_context_free(c, identifier);
 
     *err = grib_read_uchar(fh, &marker);
@@ -958,16 +1964,11 @@ grib_index* grib_index_read(grib_context* c, const char* filename, int* err)
         f            = f->next;
     }
 
-    while (file) {
-        f    = file;
-        file = file->next;
-        grib_context_free(c, f->name);
-        grib_context_free(c, f);
-    }
-
     index          = (grib_index*)grib_context_malloc_clear(c, sizeof(grib_index));
     index->context = c;
+    index->files   = file; /* Kept to write the index again */
     index->product_kind = product_kind;
+    index->num_threads  = 1;
 
     index->keys = grib_read_index_keys(c, fh, err);
     if (*err)
@@ -985,110 +1986,688 @@ grib_index* grib_index_read(grib_context* c, const char* filename, int* err)
     return index;
 }
 
-int grib_index_search_same(grib_index* index, grib_handle* h)
+int grib_index_search_same(grib_index* index, grib_handle* h)
+{
+    int err        = 0;
+    char buf[STRING_VALUE_LEN] = {0,};
+    size_t buflen = STRING_VALUE_LEN;
+    grib_index_key* keys;
+    long lval   = 0;
+    double dval = 0.0;
+    grib_context* c = NULL;
+
+    if (!index)
+        return GRIB_NULL_INDEX;
+    c = index->context;
+
+    keys = index->keys;
+
+    while (keys) {
+        if (keys->type == GRIB_TYPE_UNDEFINED) {
+            err = grib_get_native_type(h, keys->name, &(keys->type));
+            if (err)
+                keys->type = GRIB_TYPE_STRING;
+        }
+        buflen = STRING_VALUE_LEN;
+        switch (keys->type) {
+            case GRIB_TYPE_STRING:
+                err = grib_get_string(h, keys->name, buf, &buflen);
+                if (err == GRIB_NOT_FOUND)
+                    snprintf(buf, sizeof(buf), GRIB_KEY_UNDEF);
+                break;
+            case GRIB_TYPE_LONG:
+                err = grib_get_long(h, keys->name, &lval);
+                if (err == GRIB_NOT_FOUND)
+                    snprintf(buf, sizeof(buf), GRIB_KEY_UNDEF);
+                else
+                    snprintf(buf, sizeof(buf), "%ld", lval);
+                break;
+            case GRIB_TYPE_DOUBLE:
+                err = grib_get_double(h, keys->name, &dval);
+                if (err == GRIB_NOT_FOUND)
+                    snprintf(buf, sizeof(buf), GRIB_KEY_UNDEF);
+                else
+                    snprintf(buf, sizeof(buf), "%g", dval);
+                break;
+            default:
+                err = GRIB_WRONG_TYPE;
+                return err;
+        }
+        if (err && err != GRIB_NOT_FOUND) {
+            grib_context_log(c, GRIB_LOG_ERROR,
+                             "unable to create index. \"%s\": %s",
+                             keys->name, grib_get_error_message(err));
+            return err;
+        }
+        snprintf(keys->value, sizeof(buf), "%s", buf);
+        keys = keys->next;
+    }
+    grib_index_rewind(index);
+    return 0;
+}
+
+int grib_index_add_file(grib_index* index, const char* filename)
+{
+    int message_type = 0;
+    if (index->product_kind == PRODUCT_GRIB) message_type = CODES_GRIB;
+    else if (index->product_kind == PRODUCT_BUFR) message_type = CODES_BUFR;
+    else return GRIB_INVALID_ARGUMENT;
+
+    return ecc__codes_index_add_file(index, filename, message_type);
+}
+
+static grib_handle* new_message_from_file(int message_type, grib_context* c, FILE* f, int* error)
+{
+    if (message_type == CODES_GRIB)
+        return grib_new_from_file(c, f, 0, error);
+    if (message_type == CODES_BUFR)
+        return bufr_new_from_file(c, f, error);
+    Assert(!"new_message_from_file: invalid message type");
+    return NULL;
+}
+
+#define MAX_NUM_KEYS 40
+
+/* Keys set on every message before indexing it (see ECCODES_INDEX_SET_KEYS) */
+typedef struct index_set_keys
+{
+    grib_values values[MAX_NUM_KEYS];
+    int count;
+} index_set_keys;
+
+static void index_set_keys_init(grib_context* c, index_set_keys* set_keys)
+{
+    char* envsetkeys = getenv("ECCODES_INDEX_SET_KEYS");
+
+    set_keys->count = 0;
+    if (envsetkeys) {
+        /* The parser modifies its input so work on a copy */
+        char* copy      = grib_context_strdup(c, envsetkeys);
+        set_keys->count = MAX_NUM_KEYS;
+        if (parse_keyval_string(NULL, copy, 1, GRIB_TYPE_UNDEFINED, set_keys->values, &set_keys->count))
+            set_keys->count = 0;
+        grib_context_free(c, copy);
+    }
+}
+
+static void index_set_keys_delete(index_set_keys* set_keys)
 {
-    int err        = 0;
-    char buf[STRING_VALUE_LEN] = {0,};
-    size_t buflen = STRING_VALUE_LEN;
-    grib_index_key* keys;
-    long lval   = 0;
-    double dval = 0.0;
-    grib_context* c = NULL;
+    int i = 0;
+    for (i = 0; i < set_keys->count; i++)
+        free((char*)set_keys->values[i].name);
+    set_keys->count = 0;
+}
 
-    if (!index)
-        return GRIB_NULL_INDEX;
-    c = index->context;
+/* Get the values of all the index keys from the handle as strings.
+ * The types of the keys must already be known unless 'detect_types' is set.
+ * Safe to call from several threads at once on different handles when 'detect_types' is 0.
+ */
+static int index_get_key_values(grib_index* index, grib_handle* h, const index_set_keys* set_keys,
+                                int detect_types, size_t message_count, char** values, long* length)
+{
+    double dval;
+    long lval;
+    size_t svallen;
+    char buf[1024]            = {0,};
+    int err                   = 0;
+    int i                     = 0;
+    grib_context* c           = index->context;
+    grib_index_key* index_key = index->keys;
+
+    if (set_keys->count != 0) {
+        grib_values set_values[MAX_NUM_KEYS];
+        memcpy(set_values, set_keys->values, set_keys->count * sizeof(grib_values));
+        err = grib_set_values(h, set_values, set_keys->count);
+        if (err) {
+            grib_context_log(c, GRIB_LOG_ERROR, "codes_index_add_file: unable to set %s\n", getenv("ECCODES_INDEX_SET_KEYS"));
+            return err;
+        }
+    }
 
-    keys = index->keys;
+    if (index->product_kind == PRODUCT_BUFR && index->unpack_bufr) {
+        err = grib_set_long(h, "unpack", 1);
+        if (err) {
+            grib_context_log(c, GRIB_LOG_ERROR, "unable to unpack BUFR to create index. \"%s\": %s",
+                             index_key->name, grib_get_error_message(err));
+            return err;
+        }
+    }
 
-    while (keys) {
-        if (keys->type == GRIB_TYPE_UNDEFINED) {
-            err = grib_get_native_type(h, keys->name, &(keys->type));
+    for (i = 0; index_key; index_key = index_key->next, i++) {
+        if (index_key->type == GRIB_TYPE_UNDEFINED) {
+            Assert(detect_types);
+            err = grib_get_native_type(h, index_key->name, &(index_key->type));
             if (err)
-                keys->type = GRIB_TYPE_STRING;
+                index_key->type = GRIB_TYPE_STRING;
         }
-        buflen = STRING_VALUE_LEN;
-        switch (keys->type) {
+        svallen = 1024;
+        switch (index_key->type) {
             case GRIB_TYPE_STRING:
-                err = grib_get_string(h, keys->name, buf, &buflen);
+                err = grib_get_string(h, index_key->name, buf, &svallen);
                 if (err == GRIB_NOT_FOUND)
                     snprintf(buf, sizeof(buf), GRIB_KEY_UNDEF);
                 break;
             case GRIB_TYPE_LONG:
-                err = grib_get_long(h, keys->name, &lval);
+                err = grib_get_long(h, index_key->name, &lval);
                 if (err == GRIB_NOT_FOUND)
                     snprintf(buf, sizeof(buf), GRIB_KEY_UNDEF);
                 else
                     snprintf(buf, sizeof(buf), "%ld", lval);
                 break;
             case GRIB_TYPE_DOUBLE:
-                err = grib_get_double(h, keys->name, &dval);
+                err = grib_get_double(h, index_key->name, &dval);
                 if (err == GRIB_NOT_FOUND)
                     snprintf(buf, sizeof(buf), GRIB_KEY_UNDEF);
                 else
                     snprintf(buf, sizeof(buf), "%g", dval);
                 break;
             default:
-                err = GRIB_WRONG_TYPE;
-                return err;
+                return GRIB_WRONG_TYPE;
         }
         if (err && err != GRIB_NOT_FOUND) {
-            grib_context_log(c, GRIB_LOG_ERROR,
-                             "unable to create index. \"%s\": %s",
-                             keys->name, grib_get_error_message(err));
+            grib_context_log(c, GRIB_LOG_ERROR, "unable to create index. key=\"%s\" (message #%lu): %s",
+                             index_key->name, message_count, grib_get_error_message(err));
             return err;
         }
-        snprintf(keys->value, sizeof(buf), "%s", buf);
-        keys = keys->next;
+        values[i] = grib_context_strdup(c, buf);
+    }
+
+    return grib_get_long(h, "totalLength", length);
+}
+
+/* Insert a message into the value lists of the keys and into the field tree.
+ * Messages must be added in file order for the index to be reproducible.
+ */
+static int index_add_field(grib_index* index, grib_file* file, char** values, off_t offset, long length)
+{
+    grib_context* c             = index->context;
+    grib_index_key* index_key   = index->keys;
+    grib_field_tree* field_tree = NULL;
+    const void* owner           = index; /* Of the siblings at the current level */
+    grib_field* field           = NULL;
+    const char* buf             = NULL;
+    int err                     = 0;
+    int i                       = 0;
+
+    if ((err = grib_index_hash_build(index)) != GRIB_SUCCESS)
+        return err;
+
+    index_key->value[0] = 0;
+
+    for (i = 0; index_key; index_key = index_key->next, i++) {
+        buf = values[i];
+        if (!index_hash_get(index->hash, index_key, buf)) {
+            grib_string_list* v = index_key->values;
+            if (v->value) {
+                grib_string_list* last = (grib_string_list*)index_hash_get(index->hash, index_key, NULL);
+                v = (grib_string_list*)grib_context_malloc_clear(c, sizeof(grib_string_list));
+                if (!v)
+                    return GRIB_OUT_OF_MEMORY;
+                last->next = v;
+            }
+            v->value = grib_context_strdup(c, buf);
+            if (!v->value)
+                return GRIB_OUT_OF_MEMORY;
+            index_key->values_count++;
+            if ((err = index_hash_set(index->hash, index_key, v->value, v)) != GRIB_SUCCESS ||
+                (err = index_hash_set(index->hash, index_key, NULL, v)) != GRIB_SUCCESS)
+                return err;
+        }
+
+        field_tree = (grib_field_tree*)index_hash_get(index->hash, owner, buf);
+        if (!field_tree) {
+            /* The first node of a level is allocated empty */
+            field_tree = owner == index ? index->fields : ((grib_field_tree*)owner)->next_level;
+            if (!field_tree) {
+                field_tree = (grib_field_tree*)grib_context_malloc_clear(c, sizeof(grib_field_tree));
+                if (!field_tree)
+                    return GRIB_OUT_OF_MEMORY;
+                ((grib_field_tree*)owner)->next_level = field_tree;
+            }
+            if (field_tree->value) {
+                grib_field_tree* last = (grib_field_tree*)index_hash_get(index->hash, owner, NULL);
+                field_tree = (grib_field_tree*)grib_context_malloc_clear(c, sizeof(grib_field_tree));
+                if (!field_tree)
+                    return GRIB_OUT_OF_MEMORY;
+                last->next = field_tree;
+            }
+            field_tree->value = grib_context_strdup(c, buf);
+            if (!field_tree->value)
+                return GRIB_OUT_OF_MEMORY;
+            if ((err = index_hash_set(index->hash, owner, field_tree->value, field_tree)) != GRIB_SUCCESS ||
+                (err = index_hash_set(index->hash, owner, NULL, field_tree)) != GRIB_SUCCESS)
+                return err;
+        }
+        owner = field_tree;
+    }
+
+    field = (grib_field*)grib_context_malloc_clear(c, sizeof(grib_field));
+    if (!field)
+        return GRIB_OUT_OF_MEMORY;
+    field->file = file;
+    index->count++;
+    field->offset = offset;
+    field->length = length;
+
+    if (field_tree->field)
+        ((grib_field*)index_hash_get(index->hash, field_tree, NULL))->next = field;
+    else
+        field_tree->field = field;
+    return index_hash_set(index->hash, field_tree, NULL, field);
+}
+
+static void index_values_free(grib_context* c, char** values, int num_keys)
+{
+    int i = 0;
+    for (i = 0; i < num_keys; i++) {
+        grib_context_free(c, values[i]);
+        values[i] = NULL;
+    }
+}
+
+/* Keys whose values depend on the order the handles are created in */
+static int index_has_counter_keys(const grib_index* index)
+{
+    const grib_index_key* k = index->keys;
+    for (; k; k = k->next) {
+        if (!strcmp(k->name, "count") || !strcmp(k->name, "countTotal"))
+            return 1;
     }
-    grib_index_rewind(index);
     return 0;
 }
 
-int grib_index_add_file(grib_index* index, const char* filename)
+/* Check the index keys can be taken from the headers (sections 0 to 4) only, so the rest
+ * of the file can be read without the data sections. The first message was fully decoded
+ * in 'h' giving 'values' and 'length'. Every key must have the same value when decoding
+ * the headers only.
+ */
+static int index_keys_in_headers(grib_index* index, grib_handle* h, const index_set_keys* set_keys,
+                                 char** values, long length)
+{
+    grib_context* c       = index->context;
+    grib_handle* hh       = NULL;
+    const void* message   = NULL;
+    size_t message_length = 0;
+    char** hvalues        = NULL;
+    long hlength          = 0;
+    int num_keys          = 0;
+    int i                 = 0;
+    int ok                = 1;
+    grib_index_key* k     = NULL;
+
+    if (index->product_kind != PRODUCT_GRIB || h->product_kind != PRODUCT_GRIB)
+        return 0;
+    if (set_keys->count != 0 || index_has_counter_keys(index) || c->gts_header_on)
+        return 0;
+
+    for (k = index->keys; k; k = k->next, num_keys++) {
+        /* A missing key might be in the data sections of other messages.
+         * The MARS keys are all defined in the headers */
+        if (!strcmp(values[num_keys], GRIB_KEY_UNDEF) && strncmp(k->name, "mars.", 5) != 0)
+            return 0;
+    }
+
+    if (grib_get_message(h, &message, &message_length) != GRIB_SUCCESS)
+        return 0;
+    hh = grib_handle_new_from_partial_message(c, message, message_length);
+    if (!hh)
+        return 0;
+
+    hvalues = (char**)grib_context_malloc_clear(c, num_keys * sizeof(char*));
+    if (!hvalues || index_get_key_values(index, hh, set_keys, /*detect_types=*/0, 1, hvalues, &hlength) != GRIB_SUCCESS) {
+        ok = 0;
+    }
+    else {
+        ok = (hlength == length);
+        for (i = 0; ok && i < num_keys; i++)
+            ok = (hvalues[i] && !strcmp(hvalues[i], values[i]));
+    }
+
+    if (hvalues) {
+        index_values_free(c, hvalues, num_keys);
+        grib_context_free(c, hvalues);
+    }
+    grib_handle_delete(hh);
+    return ok;
+}
+
+/* Messages handed to each worker thread per batch */
+#define INDEX_MESSAGES_PER_THREAD 32
+
+typedef struct index_message
 {
-    int message_type = 0;
-    if (index->product_kind == PRODUCT_GRIB) message_type = CODES_GRIB;
-    else if (index->product_kind == PRODUCT_BUFR) message_type = CODES_BUFR;
-    else return GRIB_INVALID_ARGUMENT;
+    void* data;
+    size_t size;
+    off_t offset;
+    char** values;
+    long length;
+    int err;
+} index_message;
 
-    return ecc__codes_index_add_file(index, filename, message_type);
+typedef struct index_batch
+{
+    grib_index* index;
+    const index_set_keys* set_keys;
+    int message_type;
+    int headers_only;
+    index_message* messages;
+    size_t count;
+    size_t first_message_count;
+    size_t next;
+#if GRIB_PTHREADS
+    pthread_mutex_t mutex;
+#endif
+} index_batch;
+
+/* Create the handle of a message read by the batch. The handle takes the ownership of the data */
+static grib_handle* index_message_handle(const index_batch* batch, index_message* m)
+{
+    grib_context* c = batch->index->context;
+    grib_handle* h  = NULL;
+
+    if (batch->headers_only)
+        h = grib_handle_new_from_partial_message(c, m->data, m->size);
+    else
+        h = grib_handle_new_from_message(c, m->data, m->size);
+    if (!h)
+        return NULL;
+    h->buffer->property = CODES_MY_BUFFER;
+    h->offset           = m->offset;
+    h->product_kind     = batch->message_type == CODES_BUFR ? PRODUCT_BUFR : PRODUCT_GRIB;
+    m->data             = NULL;
+    return h;
 }
 
-static grib_handle* new_message_from_file(int message_type, grib_context* c, FILE* f, int* error)
+static void* index_worker(void* arg)
 {
-    if (message_type == CODES_GRIB)
-        return grib_new_from_file(c, f, 0, error); /* headers_only=0 */
-    if (message_type == CODES_BUFR)
-        return bufr_new_from_file(c, f, error);
-    Assert(!"new_message_from_file: invalid message type");
+    index_batch* batch = (index_batch*)arg;
+
+    for (;;) {
+        size_t i          = 0;
+        index_message* m  = NULL;
+        grib_handle* h    = NULL;
+
+#if GRIB_PTHREADS
+        pthread_mutex_lock(&batch->mutex);
+#endif
+        i = batch->next++;
+#if GRIB_PTHREADS
+        pthread_mutex_unlock(&batch->mutex);
+#endif
+        if (i >= batch->count)
+            break;
+
+        m = &batch->messages[i];
+        h = index_message_handle(batch, m);
+        if (!h) {
+            m->err = GRIB_DECODING_ERROR;
+            continue;
+        }
+        m->err = index_get_key_values(batch->index, h, batch->set_keys, /*detect_types=*/0,
+                                      batch->first_message_count + i, m->values, &m->length);
+        grib_handle_delete(h);
+    }
     return NULL;
 }
 
-#define MAX_NUM_KEYS 40
+/* Number of fields in a GRIB2 message, i.e. of data sections (section 7).
+ * When the message was read without its data sections, the section headers are
+ * read from the file and the position in the file is restored.
+ */
+static int index_grib2_num_fields(FILE* f, const index_message* m)
+{
+    const unsigned char* p = (const unsigned char*)m->data;
+    unsigned char sec[5];
+    size_t total_length = 0, pos = 16, seclen = 0;
+    off_t end_offset    = 0;
+    int from_file = 0, num_fields = 0;
+
+    if (m->size < 16 || p[7] != 2)
+        return 1;
+    total_length = (size_t)grib_decode_unsigned_byte_long(p, 8, 8);
+
+    while (pos + 5 <= total_length) {
+        if (pos + 5 <= m->size) {
+            memcpy(sec, p + pos, 5);
+        }
+        else {
+            if (!from_file) {
+                end_offset = ftello(f);
+                from_file  = 1;
+            }
+            if (fseeko(f, m->offset + pos, SEEK_SET) != 0 || fread(sec, 1, 5, f) != 5)
+                break;
+        }
+        if (memcmp(sec, "7777", 4) == 0)
+            break;
+        seclen = (size_t)grib_decode_unsigned_byte_long(sec, 0, 4);
+        if (seclen < 5)
+            break;
+        if (sec[4] == 7)
+            num_fields++;
+        pos += seclen;
+    }
+
+    if (from_file)
+        fseeko(f, end_offset, SEEK_SET);
+    return num_fields;
+}
+
+/* Messages can be read and decoded independently of each other */
+static int index_can_read_messages(const grib_index* index)
+{
+    const grib_context* c = index->context;
+    return !c->gts_header_on && !c->no_fail_on_wrong_length && !index_has_counter_keys(index);
+}
+
+/* Index the messages of the file in batches.
+ * The main thread reads a batch of messages in file order, the workers decode them and
+ * extract the keys, then the results are added to the index in file order. So the index
+ * is identical whatever the number of threads.
+ * The keys of the first message are extracted in the main thread to find their types and
+ * whether the data sections of the following messages can be skipped.
+ * With multi-field support on, the reading stops at a message holding several fields:
+ * the file is positioned at this message and its number of fields is returned in
+ * '*multi_fields' for the caller to index it one field at a time.
+ */
+static int index_add_messages(grib_index* index, grib_file* file, int message_type,
+                              const index_set_keys* set_keys, size_t* message_count, int* multi_fields)
+{
+    grib_context* c     = index->context;
+    const int nthreads  = index->num_threads;
+    const size_t nmax   = (size_t)nthreads * INDEX_MESSAGES_PER_THREAD;
+    const int check_multi = message_type == CODES_GRIB && c->multi_support_on;
+    int first           = 1;
+    int num_keys        = 0;
+    int err             = 0;
+    int read_err        = 0;
+    size_t i            = 0;
+    grib_index_key* k   = NULL;
+#if GRIB_PTHREADS
+    pthread_t* threads  = NULL;
+#endif
+    char** values       = NULL;
+    index_batch batch;
+
+    *multi_fields = 0;
+    for (k = index->keys; k; k = k->next)
+        num_keys++;
+
+    batch.index        = index;
+    batch.set_keys     = set_keys;
+    batch.message_type = message_type;
+    batch.headers_only = 0;
+    batch.messages = (index_message*)grib_context_malloc_clear(c, nmax * sizeof(index_message));
+    values         = (char**)grib_context_malloc_clear(c, nmax * num_keys * sizeof(char*));
+#if GRIB_PTHREADS
+    threads = (pthread_t*)grib_context_malloc_clear(c, nthreads * sizeof(pthread_t));
+    if (!threads) {
+        grib_context_free(c, batch.messages);
+        grib_context_free(c, values);
+        return GRIB_OUT_OF_MEMORY;
+    }
+    pthread_mutex_init(&batch.mutex, NULL);
+#endif
+    if (!batch.messages || !values) {
+        err = GRIB_OUT_OF_MEMORY;
+    }
+
+    while (!err && !read_err && !*multi_fields) {
+        /* Read the next batch in file order */
+        batch.count = 0;
+        while (batch.count < nmax) {
+            index_message* m = &batch.messages[batch.count];
+            memset(m, 0, sizeof(index_message));
+            if (message_type == CODES_BUFR)
+                m->data = wmo_read_bufr_from_file_malloc(file->handle, 0, &m->size, &m->offset, &read_err);
+            else
+                m->data = wmo_read_grib_from_file_malloc(file->handle, batch.headers_only, &m->size, &m->offset, &read_err);
+            if (read_err) {
+                grib_context_free(c, m->data);
+                m->data = NULL;
+                if (read_err == GRIB_END_OF_FILE)
+                    read_err = GRIB_SUCCESS;
+                break;
+            }
+            if (check_multi) {
+                int num_fields = index_grib2_num_fields(file->handle, m);
+                if (num_fields > 1) {
+                    /* Leave it to the caller */
+                    grib_context_free(c, m->data);
+                    m->data       = NULL;
+                    *multi_fields = num_fields;
+                    fseeko(file->handle, m->offset, SEEK_SET);
+                    break;
+                }
+            }
+            m->values = values + batch.count * num_keys;
+            if (m->offset == 0)
+                grib_context_set_handle_file_count(c, 1);
+            grib_context_increment_handle_file_count(c);
+            grib_context_increment_handle_total_count(c);
+            batch.count++;
+        }
+        if (batch.count == 0)
+            break;
+
+        batch.first_message_count = *message_count + 1;
+        batch.next                = 0;
+
+        if (first) {
+            index_message* m = &batch.messages[0];
+            grib_handle* h   = index_message_handle(&batch, m);
+            if (!h) {
+                m->err = GRIB_DECODING_ERROR;
+            }
+            else {
+                m->err = index_get_key_values(index, h, set_keys, /*detect_types=*/1,
+                                              batch.first_message_count, m->values, &m->length);
+                /* When all the keys are in the headers, skip reading and decoding the data sections */
+                if (!m->err)
+                    batch.headers_only = index_keys_in_headers(index, h, set_keys, m->values, m->length);
+                grib_handle_delete(h);
+            }
+            batch.next = 1;
+            first      = 0;
+        }
+
+#if GRIB_PTHREADS
+        if (nthreads > 1 && batch.count > batch.next) {
+            /* The messages already read keep the way they were read */
+            int nstarted = 0;
+            for (i = 0; i < (size_t)nthreads && i < batch.count - batch.next; i++) {
+                if (pthread_create(&threads[i], NULL, index_worker, &batch) != 0)
+                    break;
+                nstarted++;
+            }
+            if (nstarted == 0)
+                index_worker(&batch); /* Could not start any thread */
+            for (i = 0; i < (size_t)nstarted; i++)
+                pthread_join(threads[i], NULL);
+        }
+        else
+#endif
+        {
+            index_worker(&batch);
+        }
+
+        /* Merge in file order, stopping at the first failed message */
+        for (i = 0; i < batch.count; i++) {
+            index_message* m = &batch.messages[i];
+            if (!err) {
+                (*message_count)++;
+                err = m->err;
+                if (!err)
+                    err = index_add_field(index, file, m->values, m->offset, m->length);
+            }
+            index_values_free(c, m->values, num_keys);
+            grib_context_free(c, m->data);
+        }
+        if (read_err && !err)
+            err = read_err;
+        if (batch.count < nmax)
+            break;
+    }
+
+#if GRIB_PTHREADS
+    pthread_mutex_destroy(&batch.mutex);
+    grib_context_free(c, threads);
+#endif
+    grib_context_free(c, batch.messages);
+    grib_context_free(c, values);
+    return err;
+}
+
+/* Index the next messages one handle at a time. Reads the whole file unless 'max_handles' is positive */
+static int index_add_handles(grib_index* index, grib_file* file, int message_type, const index_set_keys* set_keys,
+                             char** values, int num_keys, int max_handles, size_t* message_count)
+{
+    grib_context* c = index->context;
+    grib_handle* h  = NULL;
+    long length     = 0;
+    int err         = 0;
+    int n           = 0;
+
+    while ((max_handles <= 0 || n < max_handles) &&
+           (h = new_message_from_file(message_type, c, file->handle, &err)) != NULL) {
+        n++;
+        (*message_count)++;
+        err = index_get_key_values(index, h, set_keys, /*detect_types=*/1, *message_count, values, &length);
+        if (!err)
+            err = index_add_field(index, file, values, h->offset, length);
+        index_values_free(c, values, num_keys);
+        grib_handle_delete(h);
+        if (err)
+            break;
+    }/*foreach message*/
+    return err;
+}
 
 int ecc__codes_index_add_file(grib_index* index, const char* filename, int message_type)
 {
-    double dval;
-    size_t svallen;
     size_t message_count = 0;
-    long length, lval;
-    char buf[1024] = {0,};
-    int err = 0;
+    int err              = 0;
+    int num_keys         = 0;
+    int multi_fields     = 0;
+    char** values        = NULL;
     grib_file* indfile;
     grib_file* newfile;
+    const grib_file* f;
 
     grib_index_key* index_key = NULL;
-    grib_handle* h            = NULL;
-    grib_field* field;
-    grib_field_tree* field_tree;
-    grib_file* file = NULL;
+    grib_file* file           = NULL;
     grib_context* c;
+    index_set_keys set_keys;
 
     if (!index)
         return GRIB_NULL_INDEX;
     c = index->context;
 
+    /* A flat index read from a file cannot be changed in place */
+    err = grib_index_flat_thaw(index);
+    if (err)
+        return err;
+
     file = grib_file_open(filename, "r", &err);
 
     if (!file || !file->handle)
@@ -1112,6 +2691,11 @@ int ecc__codes_index_add_file(grib_index* index, const char* filename, int messa
         indfile = index->files;
         while (indfile->next)
             indfile = indfile->next;
+        /* The index may have been read with ids from another process */
+        for (f = index->files; f; f = f->next) {
+            if (grib_filesid < f->id)
+                grib_filesid = f->id;
+        }
         grib_filesid++;
         newfile         = (grib_file*)grib_context_malloc_clear(c, sizeof(grib_file));
         newfile->id     = grib_filesid;
@@ -1120,144 +2704,32 @@ int ecc__codes_index_add_file(grib_index* index, const char* filename, int messa
         indfile->next   = newfile;
     }
 
-    fseeko(file->handle, 0, SEEK_SET);
-
-    while ((h = new_message_from_file(message_type, c, file->handle, &err)) != NULL) {
-        grib_string_list* v = 0;
-        index_key           = index->keys;
-        field_tree          = index->fields;
-        index_key->value[0] = 0;
-        message_count++;
-
-        {
-            char* envsetkeys = getenv("ECCODES_INDEX_SET_KEYS");
-            if (envsetkeys) {
-                grib_values set_values[MAX_NUM_KEYS];
-                int set_values_count = MAX_NUM_KEYS;
-                int error = parse_keyval_string(NULL, envsetkeys, 1, GRIB_TYPE_UNDEFINED,
-                        set_values, &set_values_count);
-                if (!error && set_values_count != 0) {
-                    err = grib_set_values(h, set_values, set_values_count);
-                    if (err) {
-                        grib_context_log(c, GRIB_LOG_ERROR,"codes_index_add_file: unable to set %s\n", envsetkeys);
-                        return err;
-                    }
-                }
-            }
-        }
-
-        if (index->product_kind == PRODUCT_BUFR && index->unpack_bufr) {
-            err = grib_set_long(h, "unpack", 1);
-            if (err) {
-                grib_context_log(c, GRIB_LOG_ERROR, "unable to unpack BUFR to create index. \"%s\": %s",
-                                 index_key->name, grib_get_error_message(err));
-                return err;
-            }
-        }
-
-        while (index_key) {
-            if (index_key->type == GRIB_TYPE_UNDEFINED) {
-                err = grib_get_native_type(h, index_key->name, &(index_key->type));
-                if (err)
-                    index_key->type = GRIB_TYPE_STRING;
-            }
-            svallen = 1024;
-            switch (index_key->type) {
-                case GRIB_TYPE_STRING:
-                    err = grib_get_string(h, index_key->name, buf, &svallen);
-                    if (err == GRIB_NOT_FOUND)
-                        snprintf(buf, sizeof(buf), GRIB_KEY_UNDEF);
-                    break;
-                case GRIB_TYPE_LONG:
-                    err = grib_get_long(h, index_key->name, &lval);
-                    if (err == GRIB_NOT_FOUND)
-                        snprintf(buf, sizeof(buf), GRIB_KEY_UNDEF);
-                    else
-                        snprintf(buf, sizeof(buf), "%ld", lval);
-                    break;
-                case GRIB_TYPE_DOUBLE:
-                    err = grib_get_double(h, index_key->name, &dval);
-                    if (err == GRIB_NOT_FOUND)
-                        snprintf(buf, sizeof(buf), GRIB_KEY_UNDEF);
-                    else
-                        snprintf(buf, sizeof(buf), "%g", dval);
-                    break;
-                default:
-                    err = GRIB_WRONG_TYPE;
-                    return err;
-            }
-            if (err && err != GRIB_NOT_FOUND) {
-                grib_context_log(c, GRIB_LOG_ERROR, "unable to create index. key=\"%s\" (message #%lu): %s",
-                                 index_key->name, message_count, grib_get_error_message(err));
-                return err;
-            }
-
-            if (!index_key->values->value) {
-                index_key->values->value = grib_context_strdup(c, buf);
-                index_key->values_count++;
-            }
-            else {
-                v = index_key->values;
-                while (v->next && strcmp(v->value, buf))
-                    v = v->next;
-                if (strcmp(v->value, buf)) {
-                    index_key->values_count++;
-                    if (v->next)
-                        v = v->next;
-                    v->next        = (grib_string_list*)grib_context_malloc_clear(c, sizeof(grib_string_list));
-                    v->next->value = grib_context_strdup(c, buf);
-                }
-            }
+    for (index_key = index->keys; index_key; index_key = index_key->next)
+        num_keys++;
+    values = (char**)grib_context_malloc_clear(c, num_keys * sizeof(char*));
+    if (!values)
+        return GRIB_OUT_OF_MEMORY;
+    index_set_keys_init(c, &set_keys);
 
-            if (!field_tree->value) {
-                field_tree->value = grib_context_strdup(c, buf);
-            }
-            else {
-                while (field_tree->next &&
-                       (field_tree->value == NULL ||
-                        strcmp(field_tree->value, buf)))
-                    field_tree = field_tree->next;
-
-                if (!field_tree->value || strcmp(field_tree->value, buf)) {
-                    field_tree->next =
-                        (grib_field_tree*)grib_context_malloc_clear(c,
-                                                                    sizeof(grib_field_tree));
-                    field_tree        = field_tree->next;
-                    field_tree->value = grib_context_strdup(c, buf);
-                }
-            }
+    fseeko(file->handle, 0, SEEK_SET);
 
-            if (index_key->next) {
-                if (!field_tree->next_level) {
-                    field_tree->next_level =
-                        (grib_field_tree*)grib_context_malloc_clear(c, sizeof(grib_field_tree));
-                }
-                field_tree = field_tree->next_level;
+    if (index_can_read_messages(index)) {
+        do {
+            err = index_add_messages(index, file, message_type, &set_keys, &message_count, &multi_fields);
+            if (!err && multi_fields) {
+                size_t count = message_count;
+                err = index_add_handles(index, file, message_type, &set_keys, values, num_keys, multi_fields, &message_count);
+                if (message_count - count != (size_t)multi_fields)
+                    break; /* Could not get all the fields */
             }
-            index_key = index_key->next;
-        }
-
-        field       = (grib_field*)grib_context_malloc_clear(c, sizeof(grib_field));
-        field->file = file;
-        index->count++;
-        field->offset = h->offset;
-
-        err = grib_get_long(h, "totalLength", &length);
-        if (err)
-            return err;
-        field->length = length;
-
-        if (field_tree->field) {
-            grib_field* pfield = field_tree->field;
-            while (pfield->next)
-                pfield = pfield->next;
-            pfield->next = field;
-        }
-        else
-            field_tree->field = field;
+        } while (!err && multi_fields);
+    }
+    else {
+        err = index_add_handles(index, file, message_type, &set_keys, values, num_keys, 0, &message_count);
+    }
 
-        grib_handle_delete(h);
-    }/*foreach message*/
+    grib_context_free(c, values);
+    index_set_keys_delete(&set_keys);
 
     grib_file_close(file->name, 0, &err);
 
@@ -1545,6 +3017,30 @@ int grib_index_get_double(const grib_index* index, const char* key, double* valu
     return GRIB_SUCCESS;
 }
 
+/* Values are compared as the type of the key, e.g. "0850" selects the level 850 of an
+ * integer key. They are stored the way the index writes values of that type
+ */
+static void index_key_set_string_value(grib_index_key* key, const char* value)
+{
+    char* end = NULL;
+
+    if (*value && key->type == GRIB_TYPE_LONG) {
+        long lval = strtol(value, &end, 10);
+        if (*end == 0) {
+            snprintf(key->value, sizeof(key->value), "%ld", lval);
+            return;
+        }
+    }
+    else if (*value && key->type == GRIB_TYPE_DOUBLE) {
+        double dval = strtod(value, &end);
+        if (*end == 0) {
+            snprintf(key->value, sizeof(key->value), "%g", dval);
+            return;
+        }
+    }
+    snprintf(key->value, sizeof(key->value), "%s", value);
+}
+
 int grib_index_select_long(grib_index* index, const char* skey, long value)
 {
     grib_index_key* key = NULL;
@@ -1572,7 +3068,10 @@ int grib_index_select_long(grib_index* index, const char* skey, long value)
         return err;
     }
     Assert(key);
-    snprintf(key->value, sizeof(key->value), "%ld", value);
+    if (key->type == GRIB_TYPE_DOUBLE)
+        snprintf(key->value, sizeof(key->value), "%g", (double)value);
+    else
+        snprintf(key->value, sizeof(key->value), "%ld", value);
     grib_index_rewind(index);
     return 0;
 }
@@ -1604,7 +3103,10 @@ int grib_index_select_double(grib_index* index, const char* skey, double value)
         return err;
     }
     Assert(key);
-    snprintf(key->value, sizeof(key->value), "%g", value);
+    if (key->type == GRIB_TYPE_LONG && value == floor(value) && fabs(value) < 1e15)
+        snprintf(key->value, sizeof(key->value), "%ld", (long)value);
+    else
+        snprintf(key->value, sizeof(key->value), "%g", value);
     grib_index_rewind(index);
     return 0;
 }
@@ -1636,7 +3138,7 @@ int grib_index_select_string(grib_index* index, const char* skey, const char* va
         return err;
     }
     Assert(key);
-    snprintf(key->value, sizeof(key->value), "%s", value);
+    index_key_set_string_value(key, value);
     grib_index_rewind(index);
     return 0;
 }
@@ -1683,12 +3185,16 @@ static int grib_index_execute(grib_index* index)
 {
     grib_index_key* keys = NULL;
     grib_field_tree* fields;
+    const void* owner = NULL;
+    int err           = 0;
 
     if (!index)
         return GRIB_INTERNAL_ERROR;
     keys = index->keys;
 
-    fields        = index->fields;
+    if ((err = grib_index_hash_build(index)) != GRIB_SUCCESS)
+        return err;
+    owner         = index;
     index->rewind = 0;
 
     while (keys) {
@@ -1702,12 +3208,11 @@ static int grib_index_execute(grib_index* index)
             return GRIB_NOT_FOUND;
         }
 
-        while (fields && strcmp(fields->value, value))
-            fields = fields->next;
-        if (fields && !strcmp(fields->value, value)) {
+        fields = (grib_field_tree*)index_hash_get(index->hash, owner, value);
+        if (fields) {
             if (fields->next_level) {
-                keys   = keys->next;
-                fields = fields->next_level;
+                keys  = keys->next;
+                owner = fields;
             }
             else {
                 index->current = index->fieldset;
@@ -1793,10 +3298,16 @@ int grib_index_dump_file(FILE* fout, const char* filename)
     if (err)
         return err;
 
+    if (index->flat) {
+        const grib_index_flat* flat = index->flat;
+        uint32_t i = 0;
+        for (i = 0; i < flat->header->num_files; i++)
+            fprintf(fout, "%s File: %s\n",
+                    index->product_kind == PRODUCT_GRIB ? "GRIB" : "BUFR", flat->strings + flat->files_table[i].name);
+    }
     /* To get the GRIB files referenced we have */
     /* to resort to low level reading of the index file! */
-    fh = fopen(filename, "r");
-    if (fh) {
+    else if ((fh = fopen(filename, "r")) != NULL) {
         grib_file *file, *f;
         unsigned char marker = 0;
         char* identifier     = grib_read_string(c, fh, &err);
@@ -1879,6 +3390,8 @@ grib_handle* codes_new_from_index(grib_index* index, int message_type, int* err)
     if (!index)
         return NULL;
     c = index->context;
+    if (index->flat)
+        return grib_index_flat_new_handle(index, message_type, err);
     if (!index->rewind) {
         if (!index->current) {
             *err = GRIB_END_OF_INDEX;
@@ -1991,6 +3504,16 @@ int codes_index_set_unpack_bufr(grib_index* index, int unpack)
     return GRIB_SUCCESS;
 }
 
+/* Number of threads used to extract the keys of the messages in grib_index_add_file.
+ * Without thread support the files are always indexed serially */
+int codes_index_set_num_threads(grib_index* index, int num_threads)
+{
+    if (!index || num_threads < 1)
+        return GRIB_INVALID_ARGUMENT;
+    index->num_threads = num_threads;
+    return GRIB_SUCCESS;
+}
+
 /* Return 1 if the file is an index file. 0 otherwise */
 int is_index_file(const char* filename)
 {
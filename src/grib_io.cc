@@ -10,6 +10,11 @@
 
 #include "grib_api_internal.h"
 
+#ifndef ECCODES_ON_WINDOWS
+#include <fcntl.h>
+#include <sys/mman.h>
+#endif
+
 #if GRIB_PTHREADS
 static pthread_once_t once    = PTHREAD_ONCE_INIT;
 static pthread_mutex_t mutex1 = PTHREAD_MUTEX_INITIALIZER;
@@ -272,6 +277,13 @@ static int read_GRIB(reader* r, int no_alloc)
                 i += 8;
 
                 total_length = length;
+                if ((total_length & 0x800000) && sec4len < 120) {
+                    /* Large GRIBs */
+                    total_length &= 0x7fffff;
+                    total_length *= 120;
+                    total_length -= sec4len;
+                    total_length += 4;
+                }
                 /* length=8+sec1len + sec2len+sec3len+11; */
                 length = i;
                 r->seek(r->read_data, total_length - length - 1);
@@ -415,6 +427,37 @@ static int read_GRIB(reader* r, int no_alloc)
                     i++;
                 }
             }
+
+            if (r->headers_only && edition == 2) {
+                /* Read sections 1 to 4 and the start of section 5. We don't read the data */
+                total_length = length;
+                for (;;) {
+                    size_t seclen = 0;
+                    GROW_BUF_IF_REQUIRED(i + 5);
+                    if (r->read(r->read_data, &tmp[i], 4, &err) != 4 || err)
+                        return err;
+                    if (tmp[i] == '7' && tmp[i + 1] == '7' && tmp[i + 2] == '7' && tmp[i + 3] == '7') {
+                        i += 4;
+                        break;
+                    }
+                    for (j = 0; j < 4; j++) {
+                        seclen <<= 8;
+                        seclen |= tmp[i + j];
+                    }
+                    if (r->read(r->read_data, &tmp[i + 4], 1, &err) != 1 || err)
+                        return err;
+                    i += 5;
+                    if (tmp[i - 1] >= 5 || seclen < 5 || i - 5 + seclen > total_length)
+                        break;
+
+                    GROW_BUF_IF_REQUIRED(i + seclen - 5);
+                    if ((r->read(r->read_data, tmp + i, seclen - 5, &err) != seclen - 5) || err)
+                        return err;
+                    i += seclen - 5;
+                }
+                length = i;
+                r->seek(r->read_data, total_length - length);
+            }
             break;
 
         default:
@@ -1891,3 +1934,233 @@ int codes_extract_offsets_malloc(grib_context* c, const char* filename, ProductK
     fclose(f);
     return err;
 }
+
+/* ======================================= */
+/* Memory-mapped files: handles point straight into a private mapping of the file.
+ * Each handle holds a reference so the mapping outlives codes_mmap_file_close */
+
+struct grib_mmap_file
+{
+    grib_context* context;
+    unsigned char* data;
+    size_t length;
+    size_t pos;   /* where the next message is looked for */
+    int refcount; /* the file itself plus each live handle */
+};
+
+typedef struct mmap_read_data
+{
+    const unsigned char* data;
+    size_t length;
+    size_t pos;
+} mmap_read_data;
+
+static off_t mmap_tell(void* data)
+{
+    mmap_read_data* m = (mmap_read_data*)data;
+    return (off_t)m->pos;
+}
+
+static int mmap_seek(void* data, off_t len)
+{
+    mmap_read_data* m = (mmap_read_data*)data;
+    if (len < 0 && (size_t)(-len) > m->pos)
+        return GRIB_IO_PROBLEM;
+    /* Like fseeko, going past the end is fine: the next read will fail */
+    m->pos = (len > 0 && (size_t)len > m->length - m->pos) ? m->length : m->pos + len;
+    return 0;
+}
+
+static int mmap_seek_from_start(void* data, off_t len)
+{
+    mmap_read_data* m = (mmap_read_data*)data;
+    if (len < 0)
+        return GRIB_IO_PROBLEM;
+    m->pos = (size_t)len > m->length ? m->length : (size_t)len;
+    return 0;
+}
+
+static size_t mmap_read(void* data, void* buf, size_t len, int* err)
+{
+    mmap_read_data* m = (mmap_read_data*)data;
+    size_t n          = len > m->length - m->pos ? m->length - m->pos : len;
+
+    memcpy(buf, m->data + m->pos, n);
+    m->pos += n;
+    if (n != len)
+        *err = GRIB_END_OF_FILE;
+    return n;
+}
+
+grib_mmap_file* codes_mmap_file_open(grib_context* c, const char* filename, int* err)
+{
+#ifdef ECCODES_ON_WINDOWS
+    if (!c) c = grib_context_get_default();
+    grib_context_log(c, GRIB_LOG_ERROR, "%s: Memory-mapped files are not supported on this platform", __func__);
+    *err = GRIB_NOT_IMPLEMENTED;
+    return NULL;
+#else
+    grib_mmap_file* mf = NULL;
+    struct stat st;
+    int fd = -1;
+
+    *err = GRIB_SUCCESS;
+    if (!c) c = grib_context_get_default();
+
+    if (path_is_directory(filename)) {
+        grib_context_log(c, GRIB_LOG_ERROR, "%s: \"%s\" is a directory", __func__, filename);
+        *err = GRIB_IO_PROBLEM;
+        return NULL;
+    }
+    fd = open(filename, O_RDONLY);
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        grib_context_log(c, (GRIB_LOG_ERROR) | (GRIB_LOG_PERROR), "%s: Unable to read file \"%s\"", __func__, filename);
+        if (fd >= 0) close(fd);
+        *err = GRIB_IO_PROBLEM;
+        return NULL;
+    }
+
+    mf = (grib_mmap_file*)grib_context_malloc_clear(c, sizeof(grib_mmap_file));
+    if (!mf) {
+        close(fd);
+        *err = GRIB_OUT_OF_MEMORY;
+        return NULL;
+    }
+    mf->context  = c;
+    mf->length   = (size_t)st.st_size;
+    mf->refcount = 1;
+
+    if (mf->length > 0) {
+        /* Private and writable: setting keys in place only touches our copy of the page */
+        void* p = mmap(NULL, mf->length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+            grib_context_log(c, (GRIB_LOG_ERROR) | (GRIB_LOG_PERROR), "%s: Unable to map file \"%s\"", __func__, filename);
+            grib_context_free(c, mf);
+            close(fd);
+            *err = GRIB_IO_PROBLEM;
+            return NULL;
+        }
+        mf->data = (unsigned char*)p;
+#ifdef MADV_SEQUENTIAL
+        madvise(p, mf->length, MADV_SEQUENTIAL);
+#endif
+    }
+    close(fd); /* The mapping stays valid */
+
+    return mf;
+#endif
+}
+
+void grib_mmap_file_release(grib_mmap_file* mf)
+{
+    int refcount = 0;
+    if (!mf) return;
+
+    GRIB_MUTEX_INIT_ONCE(&once, &init);
+    GRIB_MUTEX_LOCK(&mutex2);
+    refcount = --mf->refcount;
+    GRIB_MUTEX_UNLOCK(&mutex2);
+
+    if (refcount == 0) {
+#ifndef ECCODES_ON_WINDOWS
+        if (mf->data)
+            munmap(mf->data, mf->length);
+#endif
+        grib_context_free(mf->context, mf);
+    }
+}
+
+/* Start and length of the mapped file */
+const unsigned char* grib_mmap_file_data(const grib_mmap_file* mf, size_t* length)
+{
+    *length = mf->length;
+    return mf->data;
+}
+
+int codes_mmap_file_close(grib_mmap_file* mf)
+{
+    grib_mmap_file_release(mf);
+    return GRIB_SUCCESS;
+}
+
+grib_handle* codes_handle_new_from_mmap(grib_context* c, grib_mmap_file* mf, ProductKind product, int* err)
+{
+    unsigned char buffer[64] = {0,};
+    user_buffer_t u;
+    mmap_read_data m;
+    reader r;
+    grib_handle* h = NULL;
+
+    *err = GRIB_SUCCESS;
+    if (!c) c = grib_context_get_default();
+    if (!mf) {
+        *err = GRIB_INVALID_ARGUMENT;
+        return NULL;
+    }
+    if (product != PRODUCT_GRIB && product != PRODUCT_BUFR && product != PRODUCT_ANY) {
+        grib_context_log(c, GRIB_LOG_ERROR, "%s: Not supported for given product", __func__);
+        *err = GRIB_INVALID_ARGUMENT;
+        return NULL;
+    }
+    if (product == PRODUCT_GRIB && c->multi_support_on) {
+        grib_context_log(c, GRIB_LOG_ERROR, "%s: Multi-field GRIBs not supported", __func__);
+        *err = GRIB_NOT_IMPLEMENTED;
+        return NULL;
+    }
+
+    u.user_buffer = buffer;
+    u.buffer_size = sizeof(buffer);
+
+    r.read_data       = &m;
+    r.read            = &mmap_read;
+    r.alloc_data      = &u;
+    r.alloc           = &user_provider_buffer;
+    r.headers_only    = 0;
+    r.seek            = &mmap_seek;
+    r.seek_from_start = &mmap_seek_from_start;
+    r.tell            = &mmap_tell;
+    r.offset          = 0;
+    r.message_size    = 0;
+
+    /* Only the headers and the final 7777 are read, the rest is skipped */
+    GRIB_MUTEX_INIT_ONCE(&once, &init);
+    GRIB_MUTEX_LOCK(&mutex2);
+    m.data   = mf->data;
+    m.length = mf->length;
+    m.pos    = mf->pos;
+    *err     = read_any(&r, /*no_alloc=*/1, product != PRODUCT_BUFR, product != PRODUCT_GRIB,
+                        product == PRODUCT_ANY, product == PRODUCT_ANY);
+    mf->pos = m.pos;
+    if (*err == GRIB_SUCCESS) {
+        if ((size_t)r.offset + r.message_size > mf->length)
+            *err = GRIB_PREMATURE_END_OF_FILE;
+        else
+            mf->refcount++; /* for the handle */
+    }
+    GRIB_MUTEX_UNLOCK(&mutex2);
+
+    if (*err != GRIB_SUCCESS) {
+        if (*err == GRIB_END_OF_FILE)
+            *err = GRIB_SUCCESS;
+        return NULL;
+    }
+
+    h = grib_handle_new_from_message(c, mf->data + r.offset, r.message_size);
+    if (!h) {
+        *err = GRIB_DECODING_ERROR;
+        grib_context_log(c, GRIB_LOG_ERROR, "%s: cannot create handle", __func__);
+        grib_mmap_file_release(mf);
+        return NULL;
+    }
+
+    h->offset    = r.offset;
+    h->mmap_file = mf;
+    if (product == PRODUCT_BUFR) h->product_kind = PRODUCT_BUFR;
+    if (product == PRODUCT_ANY)  h->product_kind = PRODUCT_ANY;
+    grib_context_increment_handle_file_count(c);
+    grib_context_increment_handle_total_count(c);
+    if (h->offset == 0)
+        grib_context_set_handle_file_count(c, 1);
+
+    return h;
+}
@@ -126,7 +126,7 @@ static int init(grib_iterator* i, grib_handle* h, grib_arguments* args)
 
     lats = (double*)grib_context_malloc(h->context, size * sizeof(double));
 
-    ret = grib_get_gaussian_latitudes(trunc, lats);
+    ret = grib_context_get_gaussian_latitudes(h->context, trunc, lats);
 
     if (ret != GRIB_SUCCESS) {
         grib_context_log(h->context, GRIB_LOG_ERROR, "Error calculating gaussian points: %s", grib_get_error_message(ret));
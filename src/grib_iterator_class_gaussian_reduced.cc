@@ -327,7 +327,7 @@ static int init(grib_iterator* iter, grib_handle* h, grib_arguments* args)
     lats    = (double*)grib_context_malloc(h->context, sizeof(double) * numlats);
     if (!lats)
         return GRIB_OUT_OF_MEMORY;
-    if ((ret = grib_get_gaussian_latitudes(order, lats)) != GRIB_SUCCESS)
+    if ((ret = grib_context_get_gaussian_latitudes(h->context, order, lats)) != GRIB_SUCCESS)
         return ret;
 
     if ((ret = grib_get_size(h, spl, &plsize)) != GRIB_SUCCESS)
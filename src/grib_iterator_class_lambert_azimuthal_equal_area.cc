@@ -133,10 +133,19 @@ static void pj_authset(double es, double* APA)
     APA[1] += t * P11;
     APA[2] = t * P20;
 }
-static double pj_authlat(double beta, const double* APA)
+/* The latitude from the authalic latitude beta, given by its sine. The series in sin(2*beta),
+ * sin(4*beta) and sin(6*beta) is summed by Clenshaw's recurrence, from sin(2*beta) and
+ * cos(2*beta) which need no trigonometric function
+ */
+static double pj_authlat(double sinbeta, const double* APA)
 {
-    double t = beta + beta;
-    return (beta + APA[0] * sin(t) + APA[1] * sin(t + t) + APA[2] * sin(t + t + t));
+    const double cosbeta = sqrt(1.0 - sinbeta * sinbeta);
+    const double s       = 2.0 * sinbeta * cosbeta;             /* sin(2*beta) */
+    const double c       = 2.0 * (1.0 - 2.0 * sinbeta * sinbeta); /* 2*cos(2*beta) */
+    const double b3      = APA[2];
+    const double b2      = APA[1] + c * b3;
+    const double b1      = APA[0] + c * b2 - b3;
+    return asin(sinbeta) + b1 * s;
 }
 
 static double pj_qsfn(double sinphi, double e, double one_es)
@@ -177,6 +186,7 @@ static int init_oblate(grib_handle* h,
     double e, es, temp, one_es;
     double APA[3] = {0,};
     double xFirst, yFirst;
+    double *xs = NULL, *ys = NULL; /* Coordinates of the columns and rows on the plane */
 
     Dx = iScansNegatively == 0 ? Dx / 1000 : -Dx / 1000;
     Dy = jScansPositively == 1 ? Dy / 1000 : -Dy / 1000;
@@ -240,48 +250,85 @@ static int init_oblate(grib_handle* h,
     lats = self->lats;
     lons = self->lons;
 
-    /* Populate the lat and lon arrays */
-    {
-        xFirst = x0;
-        yFirst = y0;
-        y      = yFirst;
-        for (j = 0; j < ny; j++) {
-            x = xFirst;
-            for (i = 0; i < nx; i++) {
-                double cCe, sCe, rho, ab = 0.0, lp__lam, lp__phi, xy_x = x, xy_y = y;
-                xy_x /= Q__dd;
-                xy_y *= Q__dd;
-                rho = hypot(xy_x, xy_y);
-                Assert(rho >= EPS10); /* TODO(masn): check */
-                sCe = 2. * asin(.5 * rho / Q__rq);
-                cCe = cos(sCe);
-                sCe = sin(sCe);
-                xy_x *= sCe;
-                /* if oblique */
-                ab   = cCe * Q__sinb1 + xy_y * sCe * Q__cosb1 / rho;
-                xy_y = rho * Q__cosb1 * cCe - xy_y * Q__sinb1 * sCe;
-                /*  else
-                    ab = xy.y * sCe / rho;
-                    xy.y = rho * cCe;
-                */
-                lp__lam = atan2(xy_x, xy_y);         /* longitude */
-                lp__phi = pj_authlat(asin(ab), APA); /* latitude */
-
-                *lats = lp__phi * RAD2DEG;
-                *lons = (lp__lam + centralLongitudeInRadians) * RAD2DEG;
-
-                lons++;
-                lats++;
-
-                x += Dx / earthMajorAxisInMetres;
-            }
-            y += Dy / earthMajorAxisInMetres;
+    /* Populate the lat and lon arrays, the rows in parallel. The coordinates on the
+     * plane are sums of increments, added up once the same way for every row
+     */
+    xFirst = x0;
+    yFirst = y0;
+    xs     = (double*)grib_context_malloc(h->context, nx * sizeof(double));
+    ys     = (double*)grib_context_malloc(h->context, ny * sizeof(double));
+    if (!xs || !ys) {
+        grib_context_log(h->context, GRIB_LOG_ERROR, "%s: Error allocating %zu bytes", ITER, (nx + ny) * sizeof(double));
+        grib_context_free(h->context, xs);
+        grib_context_free(h->context, ys);
+        return GRIB_OUT_OF_MEMORY;
+    }
+    for (x = xFirst, i = 0; i < nx; i++, x += Dx / earthMajorAxisInMetres)
+        xs[i] = x;
+    for (y = yFirst, j = 0; j < ny; j++, y += Dy / earthMajorAxisInMetres)
+        ys[j] = y;
+
+#if GRIB_OMP_THREADS
+#pragma omp parallel for schedule(static)
+#endif
+    for (j = 0; j < ny; j++) {
+        double* rlats = lats + (size_t)j * nx;
+        double* rlons = lons + (size_t)j * nx;
+        long k;
+        for (k = 0; k < nx; k++) {
+            double cCe, sCe, rho, hrho, ab = 0.0, lp__lam, lp__phi, xy_x = xs[k], xy_y = ys[j];
+            xy_x /= Q__dd;
+            xy_y *= Q__dd;
+            rho = hypot(xy_x, xy_y);
+            Assert(rho >= EPS10); /* TODO(masn): check */
+            /* sCe = 2 * asin(hrho), then its cosine and sine */
+            hrho = .5 * rho / Q__rq;
+            cCe  = 1.0 - 2.0 * hrho * hrho;
+            sCe  = 2.0 * hrho * sqrt(1.0 - hrho * hrho);
+            xy_x *= sCe;
+            /* if oblique */
+            ab   = cCe * Q__sinb1 + xy_y * sCe * Q__cosb1 / rho;
+            xy_y = rho * Q__cosb1 * cCe - xy_y * Q__sinb1 * sCe;
+            /*  else
+                ab = xy.y * sCe / rho;
+                xy.y = rho * cCe;
+            */
+            lp__lam = atan2(xy_x, xy_y);   /* longitude */
+            lp__phi = pj_authlat(ab, APA); /* latitude */
+
+            rlats[k] = lp__phi * RAD2DEG;
+            rlons[k] = (lp__lam + centralLongitudeInRadians) * RAD2DEG;
         }
     }
+    grib_context_free(h->context, xs);
+    grib_context_free(h->context, ys);
 
     return GRIB_SUCCESS;
 }
 
+/* Inverse projection of the point x,y on the sphere. With c = 2 * asin(h), cos(c) and
+ * sin(c) are 1 - 2h^2 and 2h * sqrt(1 - h^2)
+ */
+static void inverse_sphere(double x, double y, double radius, double phi1, double lambda0,
+                           double sinphi1, double cosphi1, double d2r, double* lat, double* lon)
+{
+    const double epsilon = 1.0e-20;
+    const double rho     = sqrt(x * x + y * y);
+    if (rho > epsilon) {
+        const double hc   = rho / (2.0 * radius);
+        const double cosc = 1.0 - 2.0 * hc * hc;
+        const double sinc = 2.0 * hc * sqrt(1.0 - hc * hc);
+        *lat = asin(cosc * sinphi1 + y * sinc * cosphi1 / rho) / d2r;
+        *lon = (lambda0 + atan2(x * sinc, rho * cosphi1 * cosc - y * sinphi1 * sinc)) / d2r;
+    }
+    else {
+        *lat = phi1 / d2r;
+        *lon = lambda0 / d2r;
+    }
+    if (*lon < 0)
+        *lon += 360;
+}
+
 static int init_sphere(grib_handle* h,
                        grib_iterator_lambert_azimuthal_equal_area* self,
                        size_t nv, long nx, long ny,
@@ -294,11 +341,9 @@ static int init_sphere(grib_handle* h,
     double phi1, lambda0, xFirst, yFirst, x, y;
     double kp, sinphi1, cosphi1;
     double sinphi, cosphi, cosdlambda, sindlambda;
-    double cosc, sinc;
+    double *xs = NULL, *ys = NULL; /* Coordinates of the columns and rows on the plane */
     long i, j;
-    double c, rho;
-    const double epsilon = 1.0e-20;
-    const double d2r     = acos(0.0) / 90.0;
+    const double d2r = acos(0.0) / 90.0;
 
     lambda0 = centralLongitudeInRadians;
     phi1    = standardParallelInRadians;
@@ -330,62 +375,47 @@ static int init_sphere(grib_handle* h,
     xFirst     = kp * cosphi * sindlambda;
     yFirst     = kp * (cosphi1 * sinphi - sinphi1 * cosphi * cosdlambda);
 
+    /* The coordinates on the plane are sums of increments: add them up once, the same way
+     * for every row or column, so these can be computed in parallel
+     */
+    xs = (double*)grib_context_malloc(h->context, nx * sizeof(double));
+    ys = (double*)grib_context_malloc(h->context, ny * sizeof(double));
+    if (!xs || !ys) {
+        grib_context_log(h->context, GRIB_LOG_ERROR, "%s: Error allocating %zu bytes", ITER, (nx + ny) * sizeof(double));
+        grib_context_free(h->context, xs);
+        grib_context_free(h->context, ys);
+        return GRIB_OUT_OF_MEMORY;
+    }
+    for (x = xFirst, i = 0; i < nx; i++, x += Dx)
+        xs[i] = x;
+    for (y = yFirst, j = 0; j < ny; j++, y += Dy)
+        ys[j] = y;
+
     if (jPointsAreConsecutive) {
-        x = xFirst;
+#if GRIB_OMP_THREADS
+#pragma omp parallel for schedule(static)
+#endif
         for (i = 0; i < nx; i++) {
-            double xsq = x * x;
-            y          = yFirst;
-            for (j = 0; j < ny; j++) {
-                rho = sqrt(xsq + y * y);
-                if (rho > epsilon) {
-                    c     = 2 * asin(rho / (2.0 * radius));
-                    cosc  = cos(c);
-                    sinc  = sin(c);
-                    *lats = asin(cosc * sinphi1 + y * sinc * cosphi1 / rho) / d2r;
-                    *lons = (lambda0 + atan2(x * sinc, rho * cosphi1 * cosc - y * sinphi1 * sinc)) / d2r;
-                }
-                else {
-                    *lats = phi1 / d2r;
-                    *lons = lambda0 / d2r;
-                }
-                if (*lons < 0)
-                    *lons += 360;
-                lons++;
-                lats++;
-
-                y += Dy;
-            }
-            x += Dx;
+            long k;
+            for (k = 0; k < ny; k++)
+                inverse_sphere(xs[i], ys[k], radius, phi1, lambda0, sinphi1, cosphi1, d2r,
+                               &lats[(size_t)i * ny + k], &lons[(size_t)i * ny + k]);
         }
     }
     else {
-        y = yFirst;
+#if GRIB_OMP_THREADS
+#pragma omp parallel for schedule(static)
+#endif
         for (j = 0; j < ny; j++) {
-            double ysq = y * y;
-            x          = xFirst;
-            for (i = 0; i < nx; i++) {
-                rho = sqrt(x * x + ysq);
-                if (rho > epsilon) {
-                    c     = 2 * asin(rho / (2.0 * radius));
-                    cosc  = cos(c);
-                    sinc  = sin(c);
-                    *lats = asin(cosc * sinphi1 + y * sinc * cosphi1 / rho) / d2r;
-                    *lons = (lambda0 + atan2(x * sinc, rho * cosphi1 * cosc - y * sinphi1 * sinc)) / d2r;
-                }
-                else {
-                    *lats = phi1 / d2r;
-                    *lons = lambda0 / d2r;
-                }
-                if (*lons < 0)
-                    *lons += 360;
-                lons++;
-                lats++;
-
-                x += Dx;
-            }
-            y += Dy;
+            long k;
+            for (k = 0; k < nx; k++)
+                inverse_sphere(xs[k], ys[j], radius, phi1, lambda0, sinphi1, cosphi1, d2r,
+                               &lats[(size_t)j * nx + k], &lons[(size_t)j * nx + k]);
         }
     }
+    grib_context_free(h->context, xs);
+    grib_context_free(h->context, ys);
+
     return GRIB_SUCCESS;
 }
 
@@ -107,35 +107,6 @@ static double adjust_lon_radians(double lon)
     return lon;
 }
 
-/* Function to compute the latitude angle, phi2, for the inverse
- * From the book "Map Projections-A Working Manual-John P. Snyder (1987)"
- * Equation (7-9) involves rapidly converging iteration: Calculate t from (15-11)
- * Then, assuming an initial trial phi equal to (pi/2 - 2*arctan t) in the right side of equation (7-9),
- * calculate phi on the left side. Substitute the calculated phi) into the right side,
- * calculate a new phi, etc., until phi does not change significantly from the preceding trial value of phi
- */
-static double compute_phi(
-    double eccent, /* Spheroid eccentricity */
-    double ts,     /* Constant value t */
-    int* error)
-{
-    double eccnth, phi, con, dphi, sinpi;
-    int i, MAX_ITER = 15;
-
-    eccnth = 0.5 * eccent;
-    phi    = M_PI_2 - 2 * atan(ts);
-    for (i = 0; i <= MAX_ITER; i++) {
-        sinpi = sin(phi);
-        con   = eccent * sinpi;
-        dphi  = M_PI_2 - 2 * atan(ts * (pow(((1.0 - con) / (1.0 + con)), eccnth))) - phi;
-        phi += dphi;
-        if (fabs(dphi) <= 0.0000000001)
-            return (phi);
-    }
-    *error = GRIB_INTERNAL_ERROR;
-    return 0;
-}
-
 /* Compute the constant small m which is the radius of
    a parallel of latitude, phi, divided by the semimajor axis */
 static double compute_m(double eccent, double sinphi, double cosphi)
@@ -171,9 +142,9 @@ static int init_sphere(grib_handle* h,
                        double LoVInRadians, double Latin1InRadians, double Latin2InRadians,
                        double LaDInRadians)
 {
-    int i, j;
-    double f, n, rho, rho0, angle, x0, y0, x, y, tmp, tmp2;
-    double latDeg, lonDeg, lonDiff;
+    long j;
+    double f, n, rho, rho0, angle, x0, y0;
+    double lonDiff;
 
     if (fabs(Latin1InRadians - Latin2InRadians) < 1E-09) {
         n = sin(Latin1InRadians);
@@ -213,17 +184,23 @@ static int init_sphere(grib_handle* h,
         return GRIB_OUT_OF_MEMORY;
     }
 
-    /* Populate our arrays */
+    /* Populate our arrays, the rows in parallel */
+#if GRIB_OMP_THREADS
+#pragma omp parallel for schedule(static)
+#endif
     for (j = 0; j < ny; j++) {
-        y = y0 + j * Dy;
+        double* lats = self->lats + (size_t)j * nx;
+        double* lons = self->lons + (size_t)j * nx;
+        double y     = y0 + j * Dy;
+        double tmp, tmp2;
+        int i;
         if (n < 0) { /* adjustment for southern hemisphere */
             y = -y;
         }
         tmp  = rho0 - y;
         tmp2 = tmp * tmp;
         for (i = 0; i < nx; i++) {
-            int index = i + j * nx;
-            x         = x0 + i * Dx;
+            double x = x0 + i * Dx, angle, rho, latDeg, lonDeg;
             if (n < 0) { /* adjustment for southern hemisphere */
                 x = -x;
             }
@@ -233,8 +210,8 @@ static int init_sphere(grib_handle* h,
             lonDeg = LoVInDegrees + (angle / n) * RAD2DEG;
             latDeg = (2.0 * atan(pow(radius * f / rho, 1.0 / n)) - M_PI_2) * RAD2DEG;
             lonDeg = normalise_longitude_in_degrees(lonDeg);
-            self->lons[index] = lonDeg;
-            self->lats[index] = latDeg;
+            lons[i] = lonDeg;
+            lats[i] = latDeg;
         }
     }
 
@@ -252,8 +229,9 @@ static int init_oblate(grib_handle* h,
                        double LoVInRadians, double Latin1InRadians, double Latin2InRadians,
                        double LaDInRadians)
 {
-    int i, j, err = 0;
-    double x0, y0, x, y, latRad, lonRad, latDeg, lonDeg, sinphi, ts, rh1, theta;
+    long j;
+    int failed = 0;
+    double x0, y0, sinphi, ts, rh1, theta;
     double false_easting;  /* x offset in meters */
     double false_northing; /* y offset in meters */
 
@@ -324,51 +302,52 @@ static int init_oblate(grib_handle* h,
         return GRIB_OUT_OF_MEMORY;
     }
 
-    /* Populate our arrays */
+    /* Populate our arrays, the rows in parallel. The values of t of a row are
+     * turned into latitudes together, see grib_latitudes_from_conformal_t
+     */
     false_easting  = x0;
     false_northing = y0;
+#if GRIB_OMP_THREADS
+#pragma omp parallel for schedule(static) reduction(| : failed)
+#endif
     for (j = 0; j < ny; j++) {
-        y = j * Dy;
+        double* lats    = self->lats + (size_t)j * nx;
+        double* lons    = self->lons + (size_t)j * nx;
+        const double y  = j * Dy;
+        const double _y = rh - y + false_northing;
+        int i;
         for (i = 0; i < nx; i++) {
-            const int index = i + j * nx;
-            double _x, _y;
-            x = i * Dx;
             /* Inverse projection to convert from x,y to lat,lon */
-            _x = x - false_easting;
-            _y = rh - y + false_northing;
-            rh1 = sqrt(_x * _x + _y * _y);
-            con = 1.0;
+            const double x  = i * Dx;
+            const double _x = x - false_easting;
+            double rh1 = sqrt(_x * _x + _y * _y), con = 1.0, theta = 0.0, lonRad;
             if (ns <= 0) {
                 rh1 = -rh1;
                 con = -con;
             }
-            theta = 0.0;
             if (rh1 != 0)
                 theta = atan2((con * _x), (con * _y));
-            if ((rh1 != 0) || (ns > 0.0)) {
-                con    = 1.0 / ns;
-                ts     = pow((rh1 / (earthMajorAxisInMetres * F)), con);
-                latRad = compute_phi(e, ts, &err);
-                if (err) {
-                    grib_context_log(h->context, GRIB_LOG_ERROR,
-                                     "%s: Failed to compute the latitude angle, phi2, for the inverse", ITER);
-                    grib_context_free(h->context, self->lats);
-                    grib_context_free(h->context, self->lons);
-                    return err;
-                }
-            } else {
-                latRad = -M_PI_2;
-            }
-            lonRad = adjust_lon_radians(theta / ns + LoVInRadians);
-            if (i == 0 && j == 0) {
-                DEBUG_ASSERT(fabs(latFirstInRadians - latRad) <= EPSILON);
-            }
-            latDeg = latRad * RAD2DEG;  /* Convert to degrees */
-            lonDeg = normalise_longitude_in_degrees(lonRad * RAD2DEG);
-            self->lons[index] = lonDeg;
-            self->lats[index] = latDeg;
+            if ((rh1 != 0) || (ns > 0.0))
+                lats[i] = pow((rh1 / (earthMajorAxisInMetres * F)), 1.0 / ns);
+            else
+                lats[i] = HUGE_VAL; /* The south pole */
+            lonRad  = adjust_lon_radians(theta / ns + LoVInRadians);
+            lons[i] = normalise_longitude_in_degrees(lonRad * RAD2DEG);
         }
+        if (grib_latitudes_from_conformal_t(e, lats, lats, nx) != GRIB_SUCCESS)
+            failed = 1;
+        for (i = 0; i < nx; i++)
+            lats[i] *= RAD2DEG; /* Convert to degrees */
+    }
+    if (failed) {
+        grib_context_log(h->context, GRIB_LOG_ERROR,
+                         "%s: Failed to compute the latitude angle, phi2, for the inverse", ITER);
+        grib_context_free(h->context, self->lats);
+        grib_context_free(h->context, self->lons);
+        self->lats = self->lons = NULL;
+        return GRIB_INTERNAL_ERROR;
     }
+    DEBUG_ASSERT(fabs(latFirstInRadians - self->lats[0] * DEG2RAD) <= EPSILON);
     return GRIB_SUCCESS;
 }
 
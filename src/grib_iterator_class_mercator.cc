@@ -158,7 +158,7 @@ static int init_mercator(grib_handle* h,
                          double LaDInRadians, double orientationInRadians)
 {
     int i, j, err = 0;
-    double x0, y0, x, y, latRad, lonRad, latDeg, lonDeg, sinphi, ts;
+    double x0, y0, x, y, latRad, lonRad, latDeg, sinphi, ts;
     double false_easting;  /* x offset in meters */
     double false_northing; /* y offset in meters */
     double m1;             /* small value m */
@@ -195,35 +195,37 @@ static int init_mercator(grib_handle* h,
         return GRIB_OUT_OF_MEMORY;
     }
 
-    /* Populate our arrays */
+    /* Populate our arrays. The latitude of a point depends only on its row and
+     * its longitude only on its column, so each is computed once then copied
+     */
     false_easting  = x0;
     false_northing = y0;
+    for (i = 0; i < nx; i++) {
+        x      = i * DiInMetres;
+        lonRad = adjust_lon_radians(orientationInRadians + (x - false_easting) / (earthMajorAxisInMetres * m1));
+        self->lons[i] = normalise_longitude_in_degrees(lonRad * RAD2DEG);
+    }
     for (j = 0; j < ny; j++) {
-        y = j * DiInMetres;
-        for (i = 0; i < nx; i++) {
-            const int index = i + j * nx;
-            double _x, _y;
-            x = i * DiInMetres;
-            /* Inverse projection to convert from x,y to lat,lon */
-            _x     = x - false_easting;
-            _y     = y - false_northing;
-            ts     = exp(-_y / (earthMajorAxisInMetres * m1));
-            latRad = compute_phi(e, ts, &err);
-            if (err) {
-                grib_context_log(h->context, GRIB_LOG_ERROR, "%s: Failed to compute the latitude angle, phi2, for the inverse", ITER);
-                grib_context_free(h->context, self->lats);
-                grib_context_free(h->context, self->lons);
-                return err;
-            }
-            lonRad = adjust_lon_radians(orientationInRadians + _x / (earthMajorAxisInMetres * m1));
-            if (i == 0 && j == 0) {
-                DEBUG_ASSERT(fabs(latFirstInRadians - latRad) <= EPSILON);
-            }
-            latDeg            = latRad * RAD2DEG; /* Convert to degrees */
-            lonDeg            = normalise_longitude_in_degrees(lonRad * RAD2DEG);
-            self->lons[index] = lonDeg;
-            self->lats[index] = latDeg;
+        double* lats = self->lats + (size_t)j * nx;
+        /* Inverse projection to convert from x,y to lat,lon */
+        y      = j * DiInMetres;
+        ts     = exp(-(y - false_northing) / (earthMajorAxisInMetres * m1));
+        latRad = compute_phi(e, ts, &err);
+        if (err) {
+            grib_context_log(h->context, GRIB_LOG_ERROR, "%s: Failed to compute the latitude angle, phi2, for the inverse", ITER);
+            grib_context_free(h->context, self->lats);
+            grib_context_free(h->context, self->lons);
+            self->lats = self->lons = NULL;
+            return err;
+        }
+        if (j == 0) {
+            DEBUG_ASSERT(fabs(latFirstInRadians - latRad) <= EPSILON);
         }
+        latDeg = latRad * RAD2DEG; /* Convert to degrees */
+        for (i = 0; i < nx; i++)
+            lats[i] = latDeg;
+        if (j > 0)
+            memcpy(self->lons + (size_t)j * nx, self->lons, nx * sizeof(double));
     }
     return GRIB_SUCCESS;
 }
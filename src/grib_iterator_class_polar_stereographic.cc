@@ -123,6 +123,7 @@ static int init(grib_iterator* iter, grib_handle* h, grib_arguments* args)
     double *lats, *lons; /* arrays for latitudes and longitudes */
     double lonFirstInDegrees, latFirstInDegrees, radius;
     double x, y, Dx, Dy;
+    double *xs = NULL, *ys = NULL; /* Coordinates of the columns and rows on the plane */
     long nx, ny, centralLongitudeInDegrees, centralLatitudeInDegrees;
     long alternativeRowScanning, iScansNegatively, i, j;
     long jScansPositively, jPointsAreConsecutive, southPoleOnPlane;
@@ -258,40 +259,56 @@ static int init(grib_iterator* iter, grib_handle* h, grib_arguments* args)
     /* Dx = iScansNegatively == 0 ? Dx : -Dx; */
     /* Dy = jScansPositively == 1 ? Dy : -Dy; */
 
-    y = 0;
+    /* The coordinates on the plane are sums of increments: add them up once, the same
+     * way for every row, so the rows can be computed in parallel
+     */
+    xs = (double*)grib_context_malloc(h->context, nx * sizeof(double));
+    ys = (double*)grib_context_malloc(h->context, ny * sizeof(double));
+    if (!xs || !ys) {
+        grib_context_log(h->context, GRIB_LOG_ERROR, "%s: Error allocating %zu bytes", ITER, (nx + ny) * sizeof(double));
+        grib_context_free(h->context, xs);
+        grib_context_free(h->context, ys);
+        return GRIB_OUT_OF_MEMORY;
+    }
+    for (x = 0, i = 0; i < nx; i++, x += Dx)
+        xs[i] = x;
+    for (y = 0, j = 0; j < ny; j++, y += Dy)
+        ys[j] = y;
+
+#if GRIB_OMP_THREADS
+#pragma omp parallel for schedule(static)
+#endif
     for (j = 0; j < ny; j++) {
-        x = 0;
-        for (i = 0; i < nx; i++) {
+        double* rlats   = lats + (size_t)j * nx;
+        double* rlons   = lons + (size_t)j * nx;
+        const double _y = (ys[j] - inv_proj_data.false_northing) * inv_proj_data.sign;
+        long k;
+        for (k = 0; k < nx; k++) {
             /* Inverse projection from x,y to lat,lon */
-            /* int index =i+j*nx; */
-            double _x = (x - inv_proj_data.false_easting) * inv_proj_data.sign;
-            double _y = (y - inv_proj_data.false_northing) * inv_proj_data.sign;
-            double rh = sqrt(_x * _x + _y * _y);
+            const double _x = (xs[k] - inv_proj_data.false_easting) * inv_proj_data.sign;
+            const double rh = sqrt(_x * _x + _y * _y);
+            double t, lat, lon;
             if (inv_proj_data.ind)
-                ts = rh * inv_proj_data.tcs / (radius * inv_proj_data.mcs);
+                t = rh * inv_proj_data.tcs / (radius * inv_proj_data.mcs);
+            else
+                t = rh / (radius * 2.0);
+            lat = inv_proj_data.sign * (PI_OVER_2 - 2 * atan(t));
+            if (rh == 0)
+                lon = inv_proj_data.sign * inv_proj_data.centre_lon;
             else
-                ts = rh / (radius * 2.0);
-            *lats = inv_proj_data.sign * (PI_OVER_2 - 2 * atan(ts));
-            if (rh == 0) {
-                *lons = inv_proj_data.sign * inv_proj_data.centre_lon;
-            }
-            else {
-                double temp = atan2(_x, -_y);
-                *lons       = inv_proj_data.sign * temp + inv_proj_data.centre_lon;
-            }
-            *lats = *lats * RAD2DEG;
-            *lons = *lons * RAD2DEG;
-            while (*lons < 0)
-                *lons += 360;
-            while (*lons > 360)
-                *lons -= 360;
-            lons++;
-            lats++;
-
-            x += Dx;
+                lon = inv_proj_data.sign * atan2(_x, -_y) + inv_proj_data.centre_lon;
+            lat = lat * RAD2DEG;
+            lon = lon * RAD2DEG;
+            while (lon < 0)
+                lon += 360;
+            while (lon > 360)
+                lon -= 360;
+            rlats[k] = lat;
+            rlons[k] = lon;
         }
-        y += Dy;
     }
+    grib_context_free(h->context, xs);
+    grib_context_free(h->context, ys);
 
 //     /*standardParallel = (southPoleOnPlane == 1) ? -90 : +90;*/
 //     if (jPointsAreConsecutive)
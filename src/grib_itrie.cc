@@ -337,27 +337,21 @@ void grib_itrie_delete(grib_itrie* t)
 int grib_itrie_get_id(grib_itrie* t, const char* key)
 {
     const char* k    = key;
-    grib_itrie* last = t;
+    grib_itrie* root = t;
+    int id           = -1;
     if (!t) {
         Assert(!"grib_itrie_get_id: grib_trie==NULL");
         return -1;
     }
 
-    GRIB_MUTEX_INIT_ONCE(&once, &init);
-    GRIB_MUTEX_LOCK(&mutex);
-
+    /* Without the lock: the nodes are only added and their id set once, see grib_itrie_insert */
     while (*k && t)
-        t = t->next[mapping[(int)*k++]];
+        t = GRIB_ATOMIC_LOAD(t->next[mapping[(int)*k++]]);
 
-    if (t != NULL && t->id != -1) {
-        GRIB_MUTEX_UNLOCK(&mutex);
-        return t->id;
-    }
-    else {
-        int ret = grib_itrie_insert(last, key);
-        GRIB_MUTEX_UNLOCK(&mutex);
-        return ret;
-    }
+    if (t != NULL && (id = GRIB_ATOMIC_LOAD(t->id)) != -1)
+        return id;
+
+    return grib_itrie_insert(root, key);
 }
 
 int grib_itrie_insert(grib_itrie* t, const char* key)
@@ -365,6 +359,7 @@ int grib_itrie_insert(grib_itrie* t, const char* key)
     const char* k    = key;
     grib_itrie* last = t;
     int* count;
+    int id = -1;
 
     if (!t) {
         Assert(!"grib_itrie_insert: grib_trie==NULL");
@@ -383,29 +378,39 @@ int grib_itrie_insert(grib_itrie* t, const char* key)
             k++;
     }
 
-    if (*k != 0) {
-        t = last;
-        while (*k) {
-            int j      = mapping[(int)*k++];
-            t->next[j] = grib_itrie_new(t->context, count);
-            t          = t->next[j];
-        }
+    if (*k == 0 && t->id != -1) {
+        /* Inserted by another thread since it was searched */
+        id = t->id;
     }
-    if (*(t->count) < MAX_NUM_CONCEPTS) {
-        t->id = *(t->count);
-        (*(t->count))++;
+    else if (*count < MAX_NUM_CONCEPTS) {
+        id = (*count)++;
+        if (*k != 0) {
+            /* The new branch is linked to the trie once complete */
+            grib_itrie *branch = NULL, *n = NULL;
+            int first = mapping[(int)*k++];
+            branch = n = grib_itrie_new(last->context, count);
+            while (*k) {
+                int j = mapping[(int)*k++];
+                n = n->next[j] = grib_itrie_new(last->context, count);
+            }
+            n->id = id;
+            GRIB_ATOMIC_STORE(last->next[first], branch);
+        }
+        else {
+            GRIB_ATOMIC_STORE(t->id, id);
+        }
     }
     else {
-        grib_context_log(t->context, GRIB_LOG_ERROR,
+        grib_context_log(last->context, GRIB_LOG_ERROR,
                          "grib_itrie_insert: too many accessors, increase MAX_NUM_CONCEPTS\n");
-        Assert(*(t->count) < MAX_NUM_CONCEPTS);
+        Assert(*count < MAX_NUM_CONCEPTS);
     }
 
     GRIB_MUTEX_UNLOCK(&mutex);
 
-    /*printf("grib_itrie_get_id: %s -> %d\n",key,t->id);*/
+    /*printf("grib_itrie_get_id: %s -> %d\n",key,id);*/
 
-    return t->id;
+    return id;
 }
 
 int grib_itrie_get_size(grib_itrie* t)
@@ -337,6 +337,7 @@ static int grib_hash_keys_insert(grib_itrie* t, const char* key)
     const char* k    = key;
     grib_itrie* last = t;
     int* count;
+    int id = -1;
 
     GRIB_MUTEX_INIT_ONCE(&once, &init);
     GRIB_MUTEX_LOCK(&mutex);
@@ -353,29 +354,39 @@ static int grib_hash_keys_insert(grib_itrie* t, const char* key)
             k++;
     }
 
-    if (*k != 0) {
-        t = last;
-        while (*k) {
-            int j      = mapping[(int)*k++];
-            t->next[j] = grib_hash_keys_new(t->context, count);
-            t          = t->next[j];
-        }
+    if (*k == 0 && t->id != -1) {
+        /* Inserted by another thread since it was searched */
+        id = t->id;
     }
-    if (*(t->count) + TOTAL_KEYWORDS < ACCESSORS_ARRAY_SIZE) {
-        t->id = *(t->count);
-        (*(t->count))++;
+    else if (*count + TOTAL_KEYWORDS < ACCESSORS_ARRAY_SIZE) {
+        id = (*count)++;
+        if (*k != 0) {
+            /* The new branch is linked to the trie once complete */
+            grib_itrie *branch = NULL, *n = NULL;
+            int first = mapping[(int)*k++];
+            branch = n = grib_hash_keys_new(last->context, count);
+            while (*k) {
+                int j = mapping[(int)*k++];
+                n = n->next[j] = grib_hash_keys_new(last->context, count);
+            }
+            n->id = id;
+            GRIB_ATOMIC_STORE(last->next[first], branch);
+        }
+        else {
+            GRIB_ATOMIC_STORE(t->id, id);
+        }
     }
     else {
-        grib_context_log(t->context, GRIB_LOG_ERROR,
+        grib_context_log(last->context, GRIB_LOG_ERROR,
                          "grib_hash_keys_insert: too many accessors, increase ACCESSORS_ARRAY_SIZE\n");
-        Assert(*(t->count) + TOTAL_KEYWORDS < ACCESSORS_ARRAY_SIZE);
+        Assert(*count + TOTAL_KEYWORDS < ACCESSORS_ARRAY_SIZE);
     }
 
     GRIB_MUTEX_UNLOCK(&mutex);
 
-    /*printf("grib_hash_keys_get_id: %s -> %d\n",key,t->id);*/
+    /*printf("grib_hash_keys_get_id: %s -> %d\n",key,id);*/
 
-    return t->id;
+    return id;
 }
 
 int grib_hash_keys_get_id(grib_itrie* t, const char* key)
@@ -390,23 +401,17 @@ int grib_hash_keys_get_id(grib_itrie* t, const char* key)
     /* printf("+++ \"%s\"\n",key); */
     {
         const char* k    = key;
-        grib_itrie* last = t;
-
-        GRIB_MUTEX_INIT_ONCE(&once, &init);
-        GRIB_MUTEX_LOCK(&mutex);
+        grib_itrie* root = t;
+        int id           = -1;
 
+        /* Without the lock: the nodes are only added and their id set once, see grib_hash_keys_insert */
         while (*k && t)
-            t = t->next[mapping[(int)*k++]];
+            t = GRIB_ATOMIC_LOAD(t->next[mapping[(int)*k++]]);
 
-        if (t != NULL && t->id != -1) {
-            GRIB_MUTEX_UNLOCK(&mutex);
-            return t->id + TOTAL_KEYWORDS + 1;
-        }
-        else {
-            int ret = grib_hash_keys_insert(last, key);
-            GRIB_MUTEX_UNLOCK(&mutex);
-            return ret + TOTAL_KEYWORDS + 1;
-        }
+        if (t != NULL && (id = GRIB_ATOMIC_LOAD(t->id)) != -1)
+            return id + TOTAL_KEYWORDS + 1;
+
+        return grib_hash_keys_insert(root, key) + TOTAL_KEYWORDS + 1;
     }
 }
 
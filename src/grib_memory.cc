@@ -383,3 +383,220 @@ void* grib_buffer_realloc(const grib_context* c, void* p, size_t s)
  */
 
 #endif
+
+/*
+ * Arena of a handle: its accessors, sections and dependencies are carved from chunks, and released
+ * all together when the handle is deleted. The chunks go back to the context, for the next handles.
+ * An object freed before then is kept on a free list of its size, to be reused by the handle.
+ */
+
+#define ARENA_CHUNK_SIZE      (64 * 1024)
+#define ARENA_ALIGN           16
+#define ARENA_MAX_FREE_CHUNKS 128 /* Kept by the context once the handles are deleted */
+
+struct grib_arena_chunk
+{
+    grib_arena_chunk* next;
+    size_t size; /* Usable bytes, after the header */
+};
+
+#define ARENA_ROUND(s)    (((s) + ARENA_ALIGN - 1) / ARENA_ALIGN * ARENA_ALIGN)
+#define ARENA_HEADER_SIZE ARENA_ROUND(sizeof(grib_arena_chunk))
+#define ARENA_CHUNK_DATA(k) ((char*)(k) + ARENA_HEADER_SIZE)
+
+/* Larger objects (no accessor is, so far) get a chunk of their own, released with the arena */
+#define ARENA_MAX_OBJECT_SIZE 1024
+#define ARENA_NUM_FREE_LISTS  (ARENA_MAX_OBJECT_SIZE / ARENA_ALIGN)
+
+struct grib_arena
+{
+    grib_context* context;
+    grib_arena_chunk* chunks; /* The first one is being filled */
+    size_t used;              /* Bytes taken from the first chunk */
+    void* free_lists[ARENA_NUM_FREE_LISTS];
+};
+
+#if GRIB_PTHREADS
+static pthread_once_t arena_once   = PTHREAD_ONCE_INIT;
+static pthread_mutex_t arena_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static void arena_init()
+{
+    pthread_mutexattr_t attr;
+
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&arena_mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+}
+#elif GRIB_OMP_THREADS
+static int arena_once = 0;
+static omp_nest_lock_t arena_mutex;
+
+static void arena_init()
+{
+    GRIB_OMP_CRITICAL(lock_grib_memory_c_arena)
+    {
+        if (arena_once == 0) {
+            omp_init_nest_lock(&arena_mutex);
+            arena_once = 1;
+        }
+    }
+}
+#endif
+
+grib_arena* grib_arena_new(grib_context* c)
+{
+    grib_arena* a = NULL;
+    if (!c)
+        c = grib_context_get_default();
+    a = (grib_arena*)grib_context_malloc_clear(c, sizeof(grib_arena));
+    if (a)
+        a->context = c;
+    return a;
+}
+
+static grib_arena_chunk* arena_chunk_new(grib_arena* a, size_t size)
+{
+    grib_context* c     = a->context;
+    grib_arena_chunk* k = NULL;
+
+    if (size == ARENA_CHUNK_SIZE) {
+        GRIB_MUTEX_INIT_ONCE(&arena_once, &arena_init);
+        GRIB_MUTEX_LOCK(&arena_mutex);
+        k = c->arena_chunks;
+        if (k) {
+            c->arena_chunks = k->next;
+            c->arena_chunks_count--;
+        }
+        GRIB_MUTEX_UNLOCK(&arena_mutex);
+    }
+    if (!k) {
+        k = (grib_arena_chunk*)grib_context_malloc(c, ARENA_HEADER_SIZE + size);
+        if (!k)
+            return NULL;
+        k->size = size;
+    }
+    return k;
+}
+
+void* grib_arena_malloc_clear(grib_arena* a, size_t size)
+{
+    grib_arena_chunk* k = NULL;
+    void* p             = NULL;
+    size_t i            = 0;
+
+    size = size ? ARENA_ROUND(size) : ARENA_ALIGN;
+    i    = size / ARENA_ALIGN - 1;
+
+    if (i < ARENA_NUM_FREE_LISTS && a->free_lists[i]) {
+        p                = a->free_lists[i];
+        a->free_lists[i] = *(void**)p;
+    }
+    else if (size > ARENA_MAX_OBJECT_SIZE) {
+        /* Behind the chunk being filled */
+        if ((k = arena_chunk_new(a, size)) == NULL)
+            return NULL;
+        if (a->chunks) {
+            k->next         = a->chunks->next;
+            a->chunks->next = k;
+        }
+        else {
+            k->next   = NULL;
+            a->chunks = k;
+            a->used   = size;
+        }
+        p = ARENA_CHUNK_DATA(k);
+    }
+    else {
+        if (!a->chunks || a->used + size > a->chunks->size) {
+            if ((k = arena_chunk_new(a, ARENA_CHUNK_SIZE)) == NULL)
+                return NULL;
+            k->next   = a->chunks;
+            a->chunks = k;
+            a->used   = 0;
+        }
+        p = ARENA_CHUNK_DATA(a->chunks) + a->used;
+        a->used += size;
+    }
+    memset(p, 0, size);
+    return p;
+}
+
+void grib_arena_free(grib_arena* a, void* p, size_t size)
+{
+    size_t i = 0;
+    if (!p)
+        return;
+    size = size ? ARENA_ROUND(size) : ARENA_ALIGN;
+    i    = size / ARENA_ALIGN - 1;
+    if (i < ARENA_NUM_FREE_LISTS) {
+        *(void**)p       = a->free_lists[i];
+        a->free_lists[i] = p;
+    }
+    /* else released with the arena */
+}
+
+/* Bytes taken from the heap by the arena */
+size_t grib_arena_size(const grib_arena* a)
+{
+    const grib_arena_chunk* k = a ? a->chunks : NULL;
+    size_t size               = 0;
+    for (; k; k = k->next)
+        size += ARENA_HEADER_SIZE + k->size;
+    return size;
+}
+
+void grib_arena_delete(grib_arena* a)
+{
+    grib_context* c         = NULL;
+    grib_arena_chunk* k     = NULL;
+    grib_arena_chunk* freed = NULL;
+
+    if (!a)
+        return;
+    c = a->context;
+
+    /* The context keeps a bounded number of chunks, the others are freed */
+    k = a->chunks;
+    GRIB_MUTEX_INIT_ONCE(&arena_once, &arena_init);
+    GRIB_MUTEX_LOCK(&arena_mutex);
+    while (k) {
+        grib_arena_chunk* next = k->next;
+        if (k->size == ARENA_CHUNK_SIZE && c->arena_chunks_count < ARENA_MAX_FREE_CHUNKS) {
+            k->next         = c->arena_chunks;
+            c->arena_chunks = k;
+            c->arena_chunks_count++;
+        }
+        else {
+            k->next = freed;
+            freed   = k;
+        }
+        k = next;
+    }
+    GRIB_MUTEX_UNLOCK(&arena_mutex);
+
+    while (freed) {
+        k = freed->next;
+        grib_context_free(c, freed);
+        freed = k;
+    }
+    grib_context_free(c, a);
+}
+
+/* The chunks kept by the context */
+void grib_arena_chunks_delete(grib_context* c)
+{
+    grib_arena_chunk* k = NULL;
+    GRIB_MUTEX_INIT_ONCE(&arena_once, &arena_init);
+    GRIB_MUTEX_LOCK(&arena_mutex);
+    k                     = c->arena_chunks;
+    c->arena_chunks       = NULL;
+    c->arena_chunks_count = 0;
+    GRIB_MUTEX_UNLOCK(&arena_mutex);
+    while (k) {
+        grib_arena_chunk* next = k->next;
+        grib_context_free(c, k);
+        k = next;
+    }
+}
@@ -439,3 +439,335 @@ int grib_nearest_find_generic(
     free(neighbours);
     return GRIB_SUCCESS;
 }
+
+/* --------------- Batched search with a spatial index ------------------*/
+/*
+ * The points of the grid are put in a k-d tree on their unit vectors: the nearest point
+ * in straight line is the nearest on the sphere, whatever the projection of the grid.
+ * The tree is built once per grid and kept with its geometry, cached in the context,
+ * so that the fields on the same grid share it.
+ */
+
+#define NEAREST_INDEX_LEAF_SIZE 8
+
+struct grib_nearest_index
+{
+    size_t count;          /* Number of points of the grid */
+    double* points;        /* x, y and z of the points in tree order */
+    size_t* indexes;       /* Index in the grid of the points in tree order */
+    unsigned char* axes;   /* Axis split by each node, stored at the middle of its range */
+    double box_min[3];     /* Bounding box of the points */
+    double box_max[3];
+};
+
+#if GRIB_PTHREADS
+static pthread_once_t once   = PTHREAD_ONCE_INIT;
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static void init()
+{
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+}
+#elif GRIB_OMP_THREADS
+static int once = 0;
+static omp_nest_lock_t mutex;
+
+static void init()
+{
+    GRIB_OMP_CRITICAL(lock_grib_nearest_c)
+    {
+        if (once == 0) {
+            omp_init_nest_lock(&mutex);
+            once = 1;
+        }
+    }
+}
+#endif
+
+void grib_nearest_index_delete(grib_context* c, grib_nearest_index* index)
+{
+    if (!index)
+        return;
+    grib_context_free(c, index->points);
+    grib_context_free(c, index->indexes);
+    grib_context_free(c, index->axes);
+    grib_context_free(c, index);
+}
+
+static void nearest_index_unit_vector(double lat, double lon, double* p)
+{
+    const double rlat = lat * M_PI / 180.0;
+    const double rlon = lon * M_PI / 180.0;
+    p[0]              = cos(rlat) * cos(rlon);
+    p[1]              = cos(rlat) * sin(rlon);
+    p[2]              = sin(rlat);
+}
+
+static void nearest_index_swap(grib_nearest_index* index, size_t a, size_t b)
+{
+    double* pa = index->points + 3 * a;
+    double* pb = index->points + 3 * b;
+    double t   = 0;
+    size_t i   = 0;
+    for (i = 0; i < 3; i++) {
+        t     = pa[i];
+        pa[i] = pb[i];
+        pb[i] = t;
+    }
+    i                 = index->indexes[a];
+    index->indexes[a] = index->indexes[b];
+    index->indexes[b] = i;
+}
+
+/* Partially sort the points in [lo,hi) on the axis so the k-th is in place.
+ * Hoare partitions stop on keys equal to the pivot, so the rows of a grid sharing a
+ * coordinate are split evenly
+ */
+static void nearest_index_select(grib_nearest_index* index, size_t lo, size_t hi, size_t k, int axis)
+{
+    const double* p = index->points;
+    while (hi - lo > 2) {
+        const double a = p[3 * lo + axis], b = p[3 * (lo + (hi - lo) / 2) + axis], c = p[3 * (hi - 1) + axis];
+        /* Median of three */
+        const double pivot = a < b ? (b < c ? b : (a < c ? c : a)) : (a < c ? a : (b < c ? c : b));
+        long i = lo, j = hi - 1;
+        while (i <= j) {
+            while (p[3 * i + axis] < pivot)
+                i++;
+            while (p[3 * j + axis] > pivot)
+                j--;
+            if (i <= j)
+                nearest_index_swap(index, i++, j--);
+        }
+        /* [lo,j] <= pivot, [i,hi) >= pivot and equal to it in between */
+        if ((long)k <= j)
+            hi = j + 1;
+        else if ((long)k >= i)
+            lo = i;
+        else
+            return;
+    }
+    if (hi - lo == 2 && p[3 * lo + axis] > p[3 * (lo + 1) + axis])
+        nearest_index_swap(index, lo, lo + 1);
+}
+
+/* Each node splits its range at the middle point on the axis of largest extent of its box.
+ * The boxes of the children are the box of the node cut at the split, not rescanned
+ */
+static void nearest_index_build_tree(grib_nearest_index* index, size_t lo, size_t hi, const double* box_min, const double* box_max)
+{
+    double min[3], max[3];
+    int j = 0;
+    for (j = 0; j < 3; j++) {
+        min[j] = box_min[j];
+        max[j] = box_max[j];
+    }
+    while (hi - lo > NEAREST_INDEX_LEAF_SIZE) {
+        const size_t mid = lo + (hi - lo) / 2;
+        double split     = 0;
+        int axis         = 0;
+        for (j = 1; j < 3; j++) {
+            if (max[j] - min[j] > max[axis] - min[axis])
+                axis = j;
+        }
+        nearest_index_select(index, lo, hi, mid, axis);
+        index->axes[mid] = (unsigned char)axis;
+        split            = index->points[3 * mid + axis];
+        {
+            const double saved = max[axis];
+            max[axis]          = split;
+            nearest_index_build_tree(index, lo, mid, min, max);
+            max[axis] = saved;
+        }
+        min[axis] = split;
+        lo        = mid + 1;
+    }
+}
+
+static grib_nearest_index* nearest_index_new(const grib_grid_geometry* g, int* err)
+{
+    grib_context* c           = g->context;
+    grib_nearest_index* index = NULL;
+    const size_t count        = g->count;
+    double box_min[3] = { 1, 1, 1 }, box_max[3] = { -1, -1, -1 };
+    size_t i = 0;
+    int j = 0;
+
+    index = (grib_nearest_index*)grib_context_malloc_clear(c, sizeof(grib_nearest_index));
+    if (!index) {
+        *err = GRIB_OUT_OF_MEMORY;
+        return NULL;
+    }
+    index->points  = (double*)grib_context_malloc(c, 3 * count * sizeof(double));
+    index->indexes = (size_t*)grib_context_malloc(c, count * sizeof(size_t));
+    index->axes    = (unsigned char*)grib_context_malloc_clear(c, count);
+    if (!index->points || !index->indexes || !index->axes) {
+        grib_nearest_index_delete(c, index);
+        *err = GRIB_OUT_OF_MEMORY;
+        return NULL;
+    }
+
+    for (i = 0; i < count; i++) {
+        index->indexes[i] = i;
+        nearest_index_unit_vector(g->lats[i], g->lons[i], index->points + 3 * i);
+        for (j = 0; j < 3; j++) {
+            if (index->points[3 * i + j] < box_min[j]) box_min[j] = index->points[3 * i + j];
+            if (index->points[3 * i + j] > box_max[j]) box_max[j] = index->points[3 * i + j];
+        }
+    }
+    index->count = count;
+    for (j = 0; j < 3; j++) {
+        index->box_min[j] = box_min[j];
+        index->box_max[j] = box_max[j];
+    }
+    nearest_index_build_tree(index, 0, count, box_min, box_max);
+    return index;
+}
+
+/* Position in the tree of the point nearest to the unit vector q. Ties go to the lowest grid index.
+ * offsets are the distances from q to the box of the range on each axis, and box_d2 the squared
+ * distance to the box: ranges whose box is farther than the best point are skipped
+ */
+static void nearest_index_search(const grib_nearest_index* index, size_t lo, size_t hi, const double* q,
+                                 const double* offsets, double box_d2, size_t* best, double* best_d2)
+{
+    const double* p = index->points;
+    double off[3]   = { offsets[0], offsets[1], offsets[2] };
+    size_t i        = 0;
+
+    while (hi - lo > NEAREST_INDEX_LEAF_SIZE) {
+        const size_t mid  = lo + (hi - lo) / 2;
+        const int axis    = index->axes[mid];
+        const double diff = q[axis] - p[3 * mid + axis];
+        const double dx = q[0] - p[3 * mid], dy = q[1] - p[3 * mid + 1], dz = q[2] - p[3 * mid + 2];
+        const double d2 = dx * dx + dy * dy + dz * dz;
+        if (d2 < *best_d2 || (d2 == *best_d2 && index->indexes[mid] < index->indexes[*best])) {
+            *best_d2 = d2;
+            *best    = mid;
+        }
+        /* The near side first, then the far side if its box can hold a nearer point */
+        if (diff < 0)
+            nearest_index_search(index, lo, mid, q, off, box_d2, best, best_d2);
+        else
+            nearest_index_search(index, mid + 1, hi, q, off, box_d2, best, best_d2);
+        box_d2 += diff * diff - off[axis] * off[axis];
+        off[axis] = diff;
+        if (box_d2 > *best_d2)
+            return;
+        if (diff < 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    for (i = lo; i < hi; i++) {
+        const double dx = q[0] - p[3 * i], dy = q[1] - p[3 * i + 1], dz = q[2] - p[3 * i + 2];
+        const double d2 = dx * dx + dy * dy + dz * dz;
+        if (d2 < *best_d2 || (d2 == *best_d2 && index->indexes[i] < index->indexes[*best])) {
+            *best_d2 = d2;
+            *best    = i;
+        }
+    }
+}
+
+/* The index of the grid, built by its first search */
+static grib_nearest_index* nearest_index_get(grib_grid_geometry* g, int* err)
+{
+    grib_nearest_index *index = NULL, *built = NULL;
+
+    GRIB_MUTEX_INIT_ONCE(&once, &init);
+    GRIB_MUTEX_LOCK(&mutex);
+    index = g->nearest_index;
+    GRIB_MUTEX_UNLOCK(&mutex);
+    if (index)
+        return index;
+
+    /* Built without holding the lock. Another thread may build it meanwhile */
+    built = nearest_index_new(g, err);
+    if (!built)
+        return NULL;
+    GRIB_MUTEX_LOCK(&mutex);
+    if (!g->nearest_index) {
+        g->nearest_index = built;
+        built            = NULL;
+    }
+    index = g->nearest_index;
+    GRIB_MUTEX_UNLOCK(&mutex);
+    grib_nearest_index_delete(g->context, built);
+    return index;
+}
+
+/* Note: The 'values' argument can be NULL in which case the data section will not be decoded */
+int grib_nearest_find_batch(
+    const grib_handle* ch,
+    const double* inlats, const double* inlons, size_t npoints,
+    double* outlats, double* outlons,
+    double* values, double* distances, int* indexes)
+{
+    grib_handle* h            = (grib_handle*)ch;
+    grib_context* c           = NULL;
+    grib_grid_geometry* g     = NULL;
+    grib_nearest_index* index = NULL;
+    double* all_values        = NULL;
+    double radiusInKm         = 0;
+    size_t i = 0, size = 0;
+    int err = 0;
+
+    if (!h || (npoints && (!inlats || !inlons || !outlats || !outlons || !distances || !indexes)))
+        return GRIB_INVALID_ARGUMENT;
+    c = h->context;
+
+    if ((err = grib_nearest_get_radius(h, &radiusInKm)) != GRIB_SUCCESS)
+        return err;
+    g = grib_grid_geometry_new_from_handle(h, &err);
+    if (!g)
+        return err;
+    index = nearest_index_get(g, &err);
+    if (!index)
+        goto cleanup;
+
+    if (values) {
+        size       = index->count;
+        all_values = (double*)grib_context_malloc(c, size * sizeof(double));
+        if (!all_values) {
+            err = GRIB_OUT_OF_MEMORY;
+            goto cleanup;
+        }
+        if ((err = grib_get_double_array(h, "values", all_values, &size)) != GRIB_SUCCESS)
+            goto cleanup;
+        if (size != index->count) {
+            err = GRIB_WRONG_GRID;
+            goto cleanup;
+        }
+    }
+
+    for (i = 0; i < npoints; i++) {
+        double q[3], offsets[3];
+        double best_d2 = 10; /* The largest squared distance between unit vectors is 4 */
+        double box_d2  = 0;
+        size_t best = 0, idx = 0;
+        int j = 0;
+        nearest_index_unit_vector(inlats[i], inlons[i], q);
+        for (j = 0; j < 3; j++) {
+            offsets[j] = q[j] < index->box_min[j] ? q[j] - index->box_min[j] : q[j] > index->box_max[j] ? q[j] - index->box_max[j] : 0;
+            box_d2 += offsets[j] * offsets[j];
+        }
+        nearest_index_search(index, 0, index->count, q, offsets, box_d2, &best, &best_d2);
+        idx          = index->indexes[best];
+        outlats[i]   = g->lats[idx];
+        outlons[i]   = g->lons[idx];
+        indexes[i]   = (int)idx;
+        distances[i] = geographic_distance_spherical(radiusInKm, normalise_longitude_in_degrees(inlons[i]), inlats[i],
+                                                     normalise_longitude_in_degrees(outlons[i]), outlats[i]);
+        if (values)
+            values[i] = all_values[idx];
+    }
+
+cleanup:
+    grib_context_free(c, all_values);
+    grib_grid_geometry_delete(g);
+    return err;
+}
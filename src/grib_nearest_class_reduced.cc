@@ -29,6 +29,8 @@
    MEMBERS    = double lon_first
    MEMBERS    = double lon_last
    MEMBERS    = int legacy
+   MEMBERS    = size_t* row_offsets
+   MEMBERS    = long* row_counts
    END_CLASS_DEF
 
  */
@@ -69,6 +71,8 @@ typedef struct grib_nearest_reduced{
     double lon_first;
     double lon_last;
     int legacy;
+    size_t* row_offsets;
+    long* row_counts;
 } grib_nearest_reduced;
 
 extern grib_nearest_class* grib_nearest_class_gen;
@@ -145,6 +149,64 @@ static int is_legacy(grib_handle* h, int* legacy)
     return GRIB_SUCCESS;
 }
 
+/* The offset of the first point and the number of points of each row, computed once per grid */
+static int compute_rows(grib_nearest* nearest, grib_handle* h, get_reduced_row_proc get_reduced_row_func)
+{
+    grib_nearest_reduced* self = (grib_nearest_reduced*)nearest;
+    long* pla                  = NULL;
+    long* pl                   = NULL;
+    size_t plsize = 0, nrows = 0, jj = 0, offset = 0;
+    long row_count = 0, ilon_first = 0, ilon_last = 0;
+    int err = 0;
+
+    if ((err = grib_get_size(h, self->pl, &plsize)) != GRIB_SUCCESS)
+        return err;
+    pla = (long*)grib_context_malloc(h->context, plsize * sizeof(long));
+    if (!pla)
+        return GRIB_OUT_OF_MEMORY;
+    if ((err = grib_get_long_array(h, self->pl, pla, &plsize)) != GRIB_SUCCESS) {
+        grib_context_free(h->context, pla);
+        return err;
+    }
+
+    pl    = pla;
+    nrows = plsize;
+    while (nrows > 0 && *pl == 0) {
+        pl++;
+        nrows--;
+    }
+    if (nrows < (size_t)self->lats_count) {
+        grib_context_free(h->context, pla);
+        return GRIB_WRONG_GRID;
+    }
+
+    grib_context_free(nearest->context, self->row_offsets);
+    grib_context_free(nearest->context, self->row_counts);
+    self->row_offsets = (size_t*)grib_context_malloc(nearest->context, nrows * sizeof(size_t));
+    self->row_counts  = (long*)grib_context_malloc(nearest->context, nrows * sizeof(long));
+    if (!self->row_offsets || !self->row_counts) {
+        grib_context_free(h->context, pla);
+        return GRIB_OUT_OF_MEMORY;
+    }
+    for (jj = 0; jj < nrows; jj++) {
+        if (self->global) {
+            row_count = pl[jj];
+        }
+        else {
+            row_count  = 0;
+            ilon_first = 0;
+            ilon_last  = 0;
+            get_reduced_row_func(pl[jj], self->lon_first, self->lon_last, &row_count, &ilon_first, &ilon_last);
+        }
+        self->row_offsets[jj] = offset;
+        self->row_counts[jj]  = row_count;
+        offset += row_count;
+    }
+
+    grib_context_free(h->context, pla);
+    return GRIB_SUCCESS;
+}
+
 static int find(grib_nearest* nearest, grib_handle* h,
                 double inlat, double inlon, unsigned long flags,
                 double* outlats, double* outlons, double* values,
@@ -189,8 +251,6 @@ static int find_global(grib_nearest* nearest, grib_handle* h,
     grib_nearest_reduced* self = (grib_nearest_reduced*)nearest;
     int err = 0, kk = 0, ii = 0;
     size_t jj = 0;
-    long* pla           = NULL;
-    long* pl            = NULL;
     size_t nvalues      = 0;
     grib_iterator* iter = NULL;
     double lat = 0, lon = 0;
@@ -266,6 +326,9 @@ static int find_global(grib_nearest* nearest, grib_handle* h,
         }
         self->lats_count = ilat;
         grib_iterator_delete(iter);
+
+        if ((err = compute_rows(nearest, h, get_reduced_row_func)) != GRIB_SUCCESS)
+            return err;
     }
     nearest->h = h;
 
@@ -274,11 +337,9 @@ static int find_global(grib_nearest* nearest, grib_handle* h,
      * we only do this once and reuse for other messages */
     if (!self->distances || (flags & GRIB_NEAREST_SAME_POINT) == 0 || (flags & GRIB_NEAREST_SAME_GRID) == 0) {
         double* lons           = NULL;
-        int nlon               = 0;
-        size_t plsize          = 0;
+        size_t nlon            = 0;
         long nplm1             = 0;
         int nearest_lons_found = 0;
-        long row_count, ilon_first, ilon_last;
 
         if (self->global) {
             inlon = normalise_longitude_in_degrees(inlon);
@@ -308,41 +369,8 @@ static int find_global(grib_nearest* nearest, grib_handle* h,
         grib_binary_search(self->lats, ilat - 1, inlat,
                            &(self->j[0]), &(self->j[1]));
 
-        plsize = self->lats_count;
-        if ((err = grib_get_size(h, self->pl, &plsize)) != GRIB_SUCCESS)
-            return err;
-        pla = (long*)grib_context_malloc(h->context, plsize * sizeof(long));
-        if (!pla)
-            return GRIB_OUT_OF_MEMORY;
-        if ((err = grib_get_long_array(h, self->pl, pla, &plsize)) != GRIB_SUCCESS)
-            return err;
-
-        pl = pla;
-        while ((*pl) == 0) {
-            pl++;
-        }
-
-        nlon = 0;
-        if (self->global) {
-            for (jj = 0; jj < self->j[0]; jj++)
-                nlon += pl[jj];
-            nplm1 = pl[self->j[0]] - 1;
-        }
-        else {
-            nlon = 0;
-            for (jj = 0; jj < self->j[0]; jj++) {
-                row_count  = 0;
-                ilon_first = 0;
-                ilon_last  = 0;
-                get_reduced_row_func(pl[jj], self->lon_first, self->lon_last, &row_count, &ilon_first, &ilon_last);
-                nlon += row_count;
-            }
-            row_count  = 0;
-            ilon_first = 0;
-            ilon_last  = 0;
-            get_reduced_row_func(pl[self->j[0]], self->lon_first, self->lon_last, &row_count, &ilon_first, &ilon_last);
-            nplm1 = row_count - 1;
-        }
+        nlon  = self->row_offsets[self->j[0]];
+        nplm1 = self->row_counts[self->j[0]] - 1;
         lons = self->lons + nlon;
 
         nearest_lons_found = 0;
@@ -375,42 +403,14 @@ static int find_global(grib_nearest* nearest, grib_handle* h,
         }
 
         if (!nearest_lons_found) {
-            if (!self->global) {
-                row_count  = 0;
-                ilon_first = 0;
-                ilon_last  = 0;
-                get_reduced_row_func(pl[self->j[0]], self->lon_first, self->lon_last, &row_count, &ilon_first, &ilon_last);
-            }
-            else {
-                row_count = pl[self->j[0]];
-            }
-
-            grib_binary_search(lons, row_count - 1, inlon,
+            grib_binary_search(lons, self->row_counts[self->j[0]] - 1, inlon,
                                &(self->k[0]), &(self->k[1]));
         }
         self->k[0] += nlon;
         self->k[1] += nlon;
 
-        nlon = 0;
-        if (self->global) {
-            for (jj = 0; jj < self->j[1]; jj++)
-                nlon += pl[jj];
-            nplm1 = pl[self->j[1]] - 1;
-        }
-        else {
-            for (jj = 0; jj < self->j[1]; jj++) {
-                row_count  = 0;
-                ilon_first = 0;
-                ilon_last  = 0;
-                get_reduced_row_func(pl[jj], self->lon_first, self->lon_last, &row_count, &ilon_first, &ilon_last);
-                nlon += row_count;
-            }
-            row_count  = 0;
-            ilon_first = 0;
-            ilon_last  = 0;
-            get_reduced_row_func(pl[self->j[1]], self->lon_first, self->lon_last, &nplm1, &ilon_first, &ilon_last);
-            nplm1--;
-        }
+        nlon  = self->row_offsets[self->j[1]];
+        nplm1 = self->row_counts[self->j[1]] - 1;
         lons = self->lons + nlon;
 
         nearest_lons_found = 0;
@@ -440,17 +440,7 @@ static int find_global(grib_nearest* nearest, grib_handle* h,
         }
 
         if (!nearest_lons_found) {
-            if (!self->global) {
-                row_count  = 0;
-                ilon_first = 0;
-                ilon_last  = 0;
-                get_reduced_row_func(pl[self->j[1]], self->lon_first, self->lon_last, &row_count, &ilon_first, &ilon_last);
-            }
-            else {
-                row_count = pl[self->j[1]];
-            }
-
-            grib_binary_search(lons, row_count - 1, inlon,
+            grib_binary_search(lons, self->row_counts[self->j[1]] - 1, inlon,
                                &(self->k[2]), &(self->k[3]));
         }
 
@@ -465,8 +455,6 @@ static int find_global(grib_nearest* nearest, grib_handle* h,
                 kk++;
             }
         }
-
-        grib_context_free(h->context, pla);
     }
 
     kk = 0;
@@ -512,6 +500,8 @@ static int destroy(grib_nearest* nearest)
         grib_context_free(nearest->context, self->k);
     if (self->distances)
         grib_context_free(nearest->context, self->distances);
+    grib_context_free(nearest->context, self->row_offsets);
+    grib_context_free(nearest->context, self->row_counts);
 
     return GRIB_SUCCESS;
 }
@@ -546,23 +546,25 @@ GRIB_INLINE static int grib_inline_strcmp(const char* a, const char* b)
     return (*a == 0 && *b == 0) ? 0 : 1;
 }
 
+/* Also called without the lock: the files are only appended, see grib_push_action_file */
 grib_action_file* grib_find_action_file(const char* fname, grib_action_file_list* afl)
 {
-    grib_action_file* act = afl->first;
+    grib_action_file* act = GRIB_ATOMIC_LOAD(afl->first);
     while (act) {
         if (grib_inline_strcmp(act->filename, fname) == 0)
             return act;
-        act = act->next;
+        act = GRIB_ATOMIC_LOAD(act->next);
     }
     return 0;
 }
 
+/* af is complete when appended, and is then visible to the readers */
 static void grib_push_action_file(grib_action_file* af, grib_action_file_list* afl)
 {
     if (!afl->first)
-        afl->first = afl->last = af;
+        GRIB_ATOMIC_STORE(afl->first, af);
     else
-        afl->last->next = af;
+        GRIB_ATOMIC_STORE(afl->last->next, af);
     afl->last = af;
 }
 
@@ -770,10 +772,15 @@ static grib_action* grib_parse_stream(grib_context* gc, const char* filename)
 
 grib_concept_value* grib_parse_concept_file(grib_context* gc, const char* filename)
 {
+    grib_concept_value* cached = NULL;
+
+    gc = gc ? gc : grib_context_get_default();
+    if ((cached = grib_definitions_cache_get_concept(gc, filename)) != NULL)
+        return cached;
+
     GRIB_MUTEX_INIT_ONCE(&once, &init);
     GRIB_MUTEX_LOCK(&mutex_file);
 
-    gc                  = gc ? gc : grib_context_get_default();
     grib_parser_context = gc;
 
     if (parse(gc, filename) == 0) {
@@ -788,10 +795,15 @@ grib_concept_value* grib_parse_concept_file(grib_context* gc, const char* filena
 
 grib_hash_array_value* grib_parse_hash_array_file(grib_context* gc, const char* filename)
 {
+    grib_hash_array_value* cached = NULL;
+
+    gc = gc ? gc : grib_context_get_default();
+    if ((cached = grib_definitions_cache_get_hash_array(gc, filename)) != NULL)
+        return cached;
+
     GRIB_MUTEX_INIT_ONCE(&once, &init);
     GRIB_MUTEX_LOCK(&mutex_file);
 
-    gc                  = gc ? gc : grib_context_get_default();
     grib_parser_context = gc;
 
     if (parse(gc, filename) == 0) {
@@ -804,6 +816,44 @@ grib_hash_array_value* grib_parse_hash_array_file(grib_context* gc, const char*
     }
 }
 
+/* Parse a definitions file, never from the definitions cache. A file of concept values or of
+ * hash array values gives them in 'concept' or 'hash_array', a file of instructions neither
+ * and its actions are deleted
+ */
+int grib_parse_values_file(grib_context* gc, const char* filename, grib_concept_value** concept, grib_hash_array_value** hash_array)
+{
+    int err = 0;
+
+    GRIB_MUTEX_INIT_ONCE(&once, &init);
+    GRIB_MUTEX_LOCK(&mutex_file);
+
+    gc                      = gc ? gc : grib_context_get_default();
+    grib_parser_context     = gc;
+    grib_parser_all_actions = 0;
+    grib_parser_concept     = 0;
+    grib_parser_hash_array  = 0;
+    *concept                = NULL;
+    *hash_array             = NULL;
+
+    err = parse(gc, filename);
+    if (grib_parser_all_actions) {
+        grib_action* a = grib_parser_all_actions;
+        while (a) {
+            grib_action* next = a->next;
+            grib_action_delete(gc, a);
+            a = next;
+        }
+        grib_parser_all_actions = 0;
+    }
+    if (err == 0) {
+        *concept    = grib_parser_concept;
+        *hash_array = grib_parser_hash_array;
+    }
+
+    GRIB_MUTEX_UNLOCK(&mutex_file);
+    return err;
+}
+
 // grib_rule* grib_parse_rules_file(grib_context* gc, const char* filename)
 // {
 //     if (!gc) gc = grib_context_get_default();
@@ -823,19 +873,24 @@ grib_hash_array_value* grib_parse_hash_array_file(grib_context* gc, const char*
 
 grib_action* grib_parse_file(grib_context* gc, const char* filename)
 {
-    grib_action_file* af;
+    grib_action_file* af       = 0;
+    grib_action_file_list* afl = NULL;
 
-    GRIB_MUTEX_INIT_ONCE(&once, &init);
-    GRIB_MUTEX_LOCK(&mutex_file);
+    gc = gc ? gc : grib_context_get_default();
 
-    af = 0;
+    /* The files already parsed, most of the calls, are found without the lock */
+    if ((afl = GRIB_ATOMIC_LOAD(gc->grib_reader)) != NULL && (af = grib_find_action_file(filename, afl)) != NULL) {
+        grib_context_log(gc, GRIB_LOG_DEBUG, "Using cached version of %s", filename);
+        return af->root;
+    }
 
-    gc = gc ? gc : grib_context_get_default();
+    GRIB_MUTEX_INIT_ONCE(&once, &init);
+    GRIB_MUTEX_LOCK(&mutex_file);
 
     grib_parser_context = gc;
 
     if (!gc->grib_reader)
-        gc->grib_reader = (grib_action_file_list*)grib_context_malloc_clear_persistent(gc, sizeof(grib_action_file_list));
+        GRIB_ATOMIC_STORE(gc->grib_reader, (grib_action_file_list*)grib_context_malloc_clear_persistent(gc, sizeof(grib_action_file_list)));
     else {
         af = grib_find_action_file(filename, gc->grib_reader);
     }
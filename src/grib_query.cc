@@ -135,7 +135,7 @@ static grib_accessor* _search_and_cache(grib_handle* h, const char* name, const
     }
 }
 
-static char* get_rank(grib_context* c, const char* name, int* rank)
+char* grib_split_name_rank(grib_context* c, const char* name, int* rank)
 {
     char* p   = (char*)name;
     char* end = p;
@@ -157,7 +157,7 @@ static char* get_rank(grib_context* c, const char* name, int* rank)
     return ret;
 }
 
-static char* get_condition(const char* name, codes_condition* condition)
+char* grib_split_name_condition(const char* name, codes_condition* condition)
 {
     char* equal        = (char*)name;
     char* endCondition = NULL;
@@ -243,7 +243,7 @@ static grib_accessor* search_by_rank(grib_handle* h, const char* name, int rank,
     }
     else {
         int rank2;
-        char* str          = get_rank(h->context, name, &rank2);
+        char* str          = grib_split_name_rank(h->context, name, &rank2);
         grib_accessor* ret = _search_and_cache(h, str, the_namespace);
         grib_context_free(h->context, str);
         return ret;
@@ -466,7 +466,7 @@ grib_accessors_list* grib_find_accessors_list(const grib_handle* ch, const char*
 
     if (name[0] == '/') {
         condition = (codes_condition*)grib_context_malloc_clear(h->context, sizeof(codes_condition));
-        str       = get_condition(name, condition);
+        str       = grib_split_name_condition(name, condition);
         if (str) {
             al = search_by_condition(h, str, condition);
             grib_context_free(h->context, str);
@@ -483,7 +483,7 @@ grib_accessors_list* grib_find_accessors_list(const grib_handle* ch, const char*
             char* str2;
             int r;
             al   = (grib_accessors_list*)grib_context_malloc_clear(h->context, sizeof(grib_accessors_list));
-            str2 = get_rank(h->context, name, &r);
+            str2 = grib_split_name_rank(h->context, name, &r);
             grib_accessors_list_push(al, a, r);
             grib_context_free(h->context, str2);
         }
@@ -505,7 +505,7 @@ static grib_accessor* search_and_cache(grib_handle* h, const char* name, const c
 
     if (name[0] == '#') {
         int rank       = -1;
-        char* basename = get_rank(h->context, name, &rank);
+        char* basename = grib_split_name_rank(h->context, name, &rank);
         a              = search_by_rank(h, basename, rank, the_namespace);
         grib_context_free(h->context, basename);
     }
@@ -388,6 +388,34 @@ void grib_trie_clear(grib_trie* t)
     }
 }
 
+/* Add the nodes of the rest k of the key below t, with data in the last one. Readers search
+ * without the lock, so the new branch is linked to t only once complete
+ */
+static grib_trie* insert_branch(grib_trie* t, const char* key, const char* k, void* data)
+{
+    grib_trie *branch = NULL, *n = NULL;
+    int first = 0;
+
+    DebugCheckBounds((int)*k, key);
+    first  = mapping[(int)*k++];
+    branch = n = grib_trie_new(t->context);
+    while (*k) {
+        int j = 0;
+        DebugCheckBounds((int)*k, key);
+        j        = mapping[(int)*k++];
+        n->first = n->last = j;
+        n = n->next[j] = grib_trie_new(t->context);
+    }
+    n->data = data;
+
+    if (first < t->first)
+        t->first = first;
+    if (first > t->last)
+        t->last = first;
+    GRIB_ATOMIC_STORE(t->next[first], branch);
+    return n;
+}
+
 void* grib_trie_insert(grib_trie* t, const char* key, void* data)
 {
     grib_trie* last = t;
@@ -411,23 +439,11 @@ void* grib_trie_insert(grib_trie* t, const char* key, void* data)
     }
 
     if (*k == 0) {
-        old     = t->data;
-        t->data = data;
+        old = t->data;
+        GRIB_ATOMIC_STORE(t->data, data);
     }
     else {
-        t = last;
-        while (*k) {
-            int j = 0;
-            DebugCheckBounds((int)*k, key);
-            j = mapping[(int)*k++];
-            if (j < t->first)
-                t->first = j;
-            if (j > t->last)
-                t->last = j;
-            t = t->next[j] = grib_trie_new(t->context);
-        }
-        old     = t->data;
-        t->data = data;
+        insert_branch(last, key, k, data);
     }
     GRIB_MUTEX_UNLOCK(&mutex);
     return data == old ? NULL : old;
@@ -451,42 +467,28 @@ void* grib_trie_insert_no_replace(grib_trie* t, const char* key, void* data)
             k++;
     }
 
-    if (*k != 0) {
-        t = last;
-        while (*k) {
-            int j = 0;
-            DebugCheckBounds((int)*k, key);
-            j = mapping[(int)*k++];
-            if (j < t->first)
-                t->first = j;
-            if (j > t->last)
-                t->last = j;
-            t = t->next[j] = grib_trie_new(t->context);
-        }
-    }
+    if (*k != 0)
+        return insert_branch(last, key, k, data)->data;
 
     if (!t->data)
-        t->data = data;
+        GRIB_ATOMIC_STORE(t->data, data);
 
     return t->data;
 }
 
+/* Without the lock: while a trie is shared, its nodes and data are only added, see insert_branch */
 void* grib_trie_get(grib_trie* t, const char* key)
 {
     const char* k = key;
-    GRIB_MUTEX_INIT_ONCE(&once, &init);
-    GRIB_MUTEX_LOCK(&mutex);
+    void* data    = NULL;
 
     while (*k && t) {
         DebugCheckBounds((int)*k, key);
-        t = t->next[mapping[(int)*k++]];
+        t = GRIB_ATOMIC_LOAD(t->next[mapping[(int)*k++]]);
     }
 
-    if (*k == 0 && t != NULL && t->data != NULL) {
-        GRIB_MUTEX_UNLOCK(&mutex);
-        return t->data;
-    }
-    GRIB_MUTEX_UNLOCK(&mutex);
+    if (*k == 0 && t != NULL && (data = GRIB_ATOMIC_LOAD(t->data)) != NULL)
+        return data;
     return NULL;
 }
 
@@ -662,6 +662,7 @@ int grib_set_flag(grib_handle* h, const char* name, unsigned long flag)
         return GRIB_NOT_FOUND;
 
     a->flags |= flag;
+    grib_handle_layout_changed(h);
 
     return GRIB_SUCCESS;
 }
@@ -951,6 +952,8 @@ int grib_attributes_count(grib_accessor* a, size_t* size)
 {
     if (a) {
         *size = 0;
+        if (a->flags & GRIB_ACCESSOR_FLAG_LAZY_ATTRIBUTES)
+            accessor_bufr_data_element_add_attributes(a);
         while (a->attributes[*size] != NULL) {
             (*size)++;
         }
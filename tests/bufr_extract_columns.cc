@@ -0,0 +1,119 @@
+/*
+ * (C) Copyright 2005- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities granted to it by
+ * virtue of its status as an intergovernmental organisation nor does it submit to any jurisdiction.
+ */
+
+/*
+ * The columns extracted are the values of the keys, and their extraction creates no key:
+ * usage: bufr_extract_columns [-u] file key1 key2 ...
+ *   -u: the keys are created, the quality information of the message named after its bitmap
+ */
+
+#include "grib_api_internal.h"
+
+static grib_handle* open_bufr(grib_context* c, const char* filename)
+{
+    FILE* f        = fopen(filename, "rb");
+    grib_handle* h = NULL;
+    int err        = 0;
+    Assert(f);
+    h = codes_handle_new_from_file(c, f, PRODUCT_BUFR, &err);
+    Assert(h && !err);
+    fclose(f);
+    return h;
+}
+
+/* The values of the keys, after unpack=1 */
+static void compare_with_keys(grib_handle* h, const char** keys, size_t num_keys, double** columns, size_t* sizes)
+{
+    size_t k = 0, i = 0;
+
+    GRIB_CHECK(grib_set_long(h, "unpack", 1), 0);
+    for (k = 0; k < num_keys; k++) {
+        size_t size     = 0;
+        double* values  = NULL;
+        GRIB_CHECK(grib_get_size(h, keys[k], &size), keys[k]);
+        values = (double*)malloc(size * sizeof(double));
+        Assert(values);
+        GRIB_CHECK(grib_get_double_array(h, keys[k], values, &size), keys[k]);
+        if (size != sizes[k]) {
+            fprintf(stderr, "%s: %zu values in its column, %zu in the key\n", keys[k], sizes[k], size);
+            Assert(!"Sizes differ");
+        }
+        for (i = 0; i < size; i++) {
+            if (columns[k][i] != values[i]) {
+                fprintf(stderr, "%s[%zu]: %g in its column, %g in the key\n", keys[k], i, columns[k][i], values[i]);
+                Assert(!"Values differ");
+            }
+        }
+        free(values);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    grib_context* c     = grib_context_get_default();
+    const char** keys   = NULL;
+    const char* missing = "nonExistingElement";
+    double** columns    = NULL;
+    size_t* sizes       = NULL;
+    size_t num_keys = 0, k = 0;
+    grib_handle* h  = NULL;
+    const char* filename = NULL;
+    int unpacked = 0, i = 1;
+
+    if (argc > 1 && strcmp(argv[1], "-u") == 0) {
+        unpacked = 1;
+        i++;
+    }
+    Assert(argc > i + 1);
+    filename = argv[i];
+    keys     = (const char**)(argv + i + 1);
+    num_keys = argc - i - 1;
+    columns  = (double**)calloc(num_keys, sizeof(double*));
+    sizes    = (size_t*)calloc(num_keys, sizeof(size_t));
+    Assert(columns && sizes);
+
+    /* The columns compared with the keys of another handle */
+    h = open_bufr(c, filename);
+    GRIB_CHECK(codes_bufr_extract_columns_malloc(h, keys, num_keys, columns, sizes), 0);
+    for (k = 0; k < num_keys; k++) {
+        Assert(columns[k] && sizes[k] > 0);
+        printf("%s: %zu values\n", keys[k], sizes[k]);
+    }
+    /* No element has its accessor */
+    for (k = 0; k < num_keys; k++) {
+        if (keys[k][0] != '#' && keys[k][0] != '/')
+            Assert((grib_find_accessor(h, keys[k]) != NULL) == unpacked);
+    }
+    grib_handle_delete(h);
+
+    h = open_bufr(c, filename);
+    compare_with_keys(h, keys, num_keys, columns, sizes);
+    grib_handle_delete(h);
+
+    /* The keys of the values decoded for their columns are created by the unpack */
+    h = open_bufr(c, filename);
+    for (k = 0; k < num_keys; k++)
+        free(columns[k]);
+    GRIB_CHECK(codes_bufr_extract_columns_malloc(h, keys, num_keys, columns, sizes), 0);
+    compare_with_keys(h, keys, num_keys, columns, sizes);
+
+    /* A key of no element: no column at all */
+    for (k = 0; k < num_keys; k++)
+        free(columns[k]);
+    keys[num_keys - 1] = missing;
+    Assert(codes_bufr_extract_columns_malloc(h, keys, num_keys, columns, sizes) == GRIB_NOT_FOUND);
+    for (k = 0; k < num_keys; k++)
+        Assert(columns[k] == NULL && sizes[k] == 0);
+    grib_handle_delete(h);
+
+    free(columns);
+    free(sizes);
+    return 0;
+}
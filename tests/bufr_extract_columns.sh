@@ -0,0 +1,97 @@
+#!/bin/sh
+# (C) Copyright 2005- ECMWF.
+#
+# This software is licensed under the terms of the Apache Licence Version 2.0
+# which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+#
+# In applying this licence, ECMWF does not waive the privileges and immunities granted to it by
+# virtue of its status as an intergovernmental organisation nor does it submit to any jurisdiction.
+#
+
+. ./include.ctest.sh
+
+label="bufr_extract_columns_test"
+tempFilt="temp.${label}.filt"
+tempUncompressed="temp.${label}.uncompressed.bufr"
+tempCompressed="temp.${label}.compressed.bufr"
+tempQuality="temp.${label}.quality.bufr"
+tempBufr="temp.${label}.bufr"
+tempOut="temp.${label}.txt"
+
+sample=$ECCODES_SAMPLES_PATH/BUFR4.tmpl
+
+# Subsets of the same descriptors, each element of several ranks
+cat > $tempFilt <<EOF
+set compressedData=0;
+set numberOfSubsets=12;
+set unexpandedDescriptors={301011,301012,301021,7004,12101,7004,12101};
+set pack=1;
+write;
+EOF
+${tools_dir}/bufr_filter -o $tempBufr $tempFilt $sample
+cat > $tempFilt <<EOF
+set unpack=1;
+set #3#pressure=85000;
+set #3#airTemperature=271.5;
+set #4#airTemperature=270.25;
+set #7#pressure=85000;
+set #13#airTemperature=268;
+set #8#latitude=-12.5;
+set pack=1;
+write;
+EOF
+${tools_dir}/bufr_filter -o $tempUncompressed $tempFilt $tempBufr
+
+$EXEC ${test_dir}/bufr_extract_columns $tempUncompressed \
+    airTemperature pressure latitude '#4#airTemperature' '#13#airTemperature' \
+    '/pressure=85000/airTemperature' '/subsetNumber=8/latitude' '/subsetNumber=3/airTemperature' > $tempOut
+cat $tempOut
+grep -q "^airTemperature: 24 values" $tempOut
+grep -q "^/pressure=85000/airTemperature: 2 values" $tempOut
+grep -q "^/subsetNumber=3/airTemperature: 2 values" $tempOut
+
+# Compressed, constant and varying values
+cat > $tempFilt <<EOF
+set compressedData=1;
+set numberOfSubsets=3;
+set unexpandedDescriptors={301011,301013,301021,7004,12101,7004,12101};
+set latitude={40.5,41,41.5};
+set #1#pressure=85000;
+set #2#pressure=50000;
+set #1#airTemperature={280,281,282};
+set #2#airTemperature=250;
+set pack=1;
+write;
+EOF
+${tools_dir}/bufr_filter -o $tempCompressed $tempFilt $sample
+
+$EXEC ${test_dir}/bufr_extract_columns $tempCompressed \
+    airTemperature latitude longitude '#2#airTemperature' '#2#pressure' '/pressure=50000/airTemperature' > $tempOut
+cat $tempOut
+grep -q "^airTemperature: 4 values" $tempOut
+grep -q "^latitude: 3 values" $tempOut
+grep -q "^/pressure=50000/airTemperature: 1 values" $tempOut
+
+# Quality information with a data present bitmap: named after the bitmap, the keys are created
+cat > $tempFilt <<EOF
+set compressedData=1;
+set numberOfSubsets=3;
+set unexpandedDescriptors={301011,301013,301021,12101,12103,222000,236000,101002,31031,1031,1032,101002,33007};
+set airTemperature={280,281,282};
+set dewpointTemperature={270,271,272};
+set pack=1;
+write;
+EOF
+${tools_dir}/bufr_filter -o $tempBufr $tempFilt $sample
+cat > $tempFilt <<EOF
+set unpack=1;
+set airTemperature->percentConfidence={75,65,74};
+set pack=1;
+write;
+EOF
+${tools_dir}/bufr_filter -o $tempQuality $tempFilt $tempBufr
+
+$EXEC ${test_dir}/bufr_extract_columns -u $tempQuality airTemperature dewpointTemperature '#1#airTemperature'
+
+# Clean up
+rm -f $tempFilt $tempUncompressed $tempCompressed $tempQuality $tempBufr $tempOut
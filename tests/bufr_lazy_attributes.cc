@@ -0,0 +1,148 @@
+/*
+ * (C) Copyright 2005- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities granted to it by
+ * virtue of its status as an intergovernmental organisation nor does it submit to any jurisdiction.
+ */
+
+/*
+ * The attributes of the data elements are created when first looked for: their values do not
+ * depend on the order in which the elements are queried, and iterating the keys creates none
+ */
+
+#include "grib_api_internal.h"
+
+#define MAX_KEYS 4096
+
+static const char* attribute_names[] = { "index", "code", "units", "scale", "reference", "width" };
+#define NUMBER_OF_ATTRIBUTES (sizeof(attribute_names) / sizeof(attribute_names[0]))
+
+static int is_lazy(grib_handle* h, const char* name)
+{
+    grib_accessor* a = grib_find_accessor(h, name);
+    Assert(a);
+    return (a->flags & GRIB_ACCESSOR_FLAG_LAZY_ATTRIBUTES) != 0;
+}
+
+static char* attributes_of(grib_handle* h, const char* key)
+{
+    char* result = (char*)calloc(NUMBER_OF_ATTRIBUTES, 128);
+    size_t i     = 0;
+    Assert(result);
+    for (i = 0; i < NUMBER_OF_ATTRIBUTES; i++) {
+        char name[512], value[100] = {0,};
+        size_t len = sizeof(value);
+        snprintf(name, sizeof(name), "%s->%s", key, attribute_names[i]);
+        if (grib_get_string(h, name, value, &len) != GRIB_SUCCESS)
+            strcpy(value, "-");
+        strcat(result, value);
+        strcat(result, " ");
+    }
+    return result;
+}
+
+static void test_file(grib_context* c, const char* filename)
+{
+    FILE* f                   = fopen(filename, "rb");
+    grib_handle* h1           = NULL;
+    grib_handle* h2           = NULL;
+    bufr_keys_iterator* kiter = NULL;
+    char* keys[MAX_KEYS];
+    char* forward[MAX_KEYS];
+    char* backward[MAX_KEYS];
+    size_t count = 0, i = 0, lazy = 0;
+    int err = 0;
+
+    Assert(f);
+    h1 = codes_handle_new_from_file(c, f, PRODUCT_BUFR, &err);
+    Assert(h1 && !err);
+    rewind(f);
+    h2 = codes_handle_new_from_file(c, f, PRODUCT_BUFR, &err);
+    Assert(h2 && !err);
+    fclose(f);
+    GRIB_CHECK(grib_set_long(h1, "unpack", 1), 0);
+    GRIB_CHECK(grib_set_long(h2, "unpack", 1), 0);
+
+    /* The keys iterated, the attributes of the elements are not created */
+    kiter = codes_bufr_data_section_keys_iterator_new(h1);
+    Assert(kiter);
+    while (codes_bufr_keys_iterator_next(kiter)) {
+        const char* name = codes_bufr_keys_iterator_get_name(kiter);
+        Assert(count < MAX_KEYS);
+        if (strstr(name, "->") == NULL && strcmp(name, "subsetNumber") != 0) {
+            keys[count] = strdup(name);
+            if (is_lazy(h1, name))
+                lazy++;
+            count++;
+        }
+    }
+    codes_bufr_keys_iterator_delete(kiter);
+    Assert(count > 0 && lazy > 0);
+
+    /* The elements queried from the first, and from the last in the other handle */
+    for (i = 0; i < count; i++)
+        forward[i] = attributes_of(h1, keys[i]);
+    for (i = count; i > 0; i--)
+        backward[i - 1] = attributes_of(h2, keys[i - 1]);
+
+    for (i = 0; i < count; i++) {
+        if (strcmp(forward[i], backward[i]) != 0) {
+            fprintf(stderr, "%s: %s: attributes '%s', queried the other way '%s'\n", filename, keys[i], forward[i], backward[i]);
+            Assert(!"Attributes differ");
+        }
+        Assert(!is_lazy(h1, keys[i]) && !is_lazy(h2, keys[i]));
+        free(keys[i]);
+        free(forward[i]);
+        free(backward[i]);
+    }
+    printf("%s: %zu elements, %zu with their attributes created when queried\n", filename, count, lazy);
+
+    grib_handle_delete(h1);
+    grib_handle_delete(h2);
+}
+
+/* The attributes of the elements of the same name are linked: created for the last one, those of the previous ones are too */
+static void test_same_linked(grib_context* c, const char* filename, const char* key, long rank)
+{
+    FILE* f        = fopen(filename, "rb");
+    grib_handle* h = NULL;
+    grib_accessor* a = NULL;
+    char name[256], units[64] = {0,};
+    size_t len = sizeof(units);
+    long r     = 0;
+    int err    = 0;
+
+    Assert(f);
+    h = codes_handle_new_from_file(c, f, PRODUCT_BUFR, &err);
+    Assert(h && !err);
+    fclose(f);
+    GRIB_CHECK(grib_set_long(h, "unpack", 1), 0);
+
+    snprintf(name, sizeof(name), "#%ld#%s->units", rank, key);
+    GRIB_CHECK(grib_get_string(h, name, units, &len), 0);
+    for (r = 1; r <= rank; r++) {
+        grib_accessor* attribute = NULL;
+        snprintf(name, sizeof(name), "#%ld#%s", r, key);
+        a = grib_find_accessor(h, name);
+        Assert(a && !(a->flags & GRIB_ACCESSOR_FLAG_LAZY_ATTRIBUTES));
+        attribute = grib_accessor_get_attribute(a, "units");
+        Assert(attribute);
+        Assert(r == 1 || (a->same && attribute->same == grib_accessor_get_attribute(a->same, "units")));
+    }
+    grib_handle_delete(h);
+}
+
+int main(int argc, char** argv)
+{
+    grib_context* c = grib_context_get_default();
+    int i           = 0;
+
+    Assert(argc > 1);
+    for (i = 1; i < argc; i++)
+        test_file(c, argv[i]);
+    test_same_linked(c, argv[1], "airTemperature", 5);
+    return 0;
+}
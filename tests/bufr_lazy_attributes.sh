@@ -0,0 +1,87 @@
+#!/bin/sh
+# (C) Copyright 2005- ECMWF.
+#
+# This software is licensed under the terms of the Apache Licence Version 2.0
+# which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+#
+# In applying this licence, ECMWF does not waive the privileges and immunities granted to it by
+# virtue of its status as an intergovernmental organisation nor does it submit to any jurisdiction.
+#
+
+. ./include.ctest.sh
+
+label="bufr_lazy_attributes_test"
+tempFilt="temp.${label}.filt"
+tempUncompressed="temp.${label}.uncompressed.bufr"
+tempQuality="temp.${label}.quality.bufr"
+tempAssociated="temp.${label}.associated.bufr"
+tempBufr="temp.${label}.bufr"
+
+sample=$ECCODES_SAMPLES_PATH/BUFR4.tmpl
+
+# Subsets of the same descriptors, each element of several ranks
+cat > $tempFilt <<EOF
+set compressedData=0;
+set numberOfSubsets=20;
+set unexpandedDescriptors={301011,301012,301021,7004,12101,11001,11002};
+set pack=1;
+write;
+EOF
+${tools_dir}/bufr_filter -o $tempUncompressed $tempFilt $sample
+
+# Quality information with a data present bitmap
+cat > $tempFilt <<EOF
+set compressedData=1;
+set numberOfSubsets=3;
+set unexpandedDescriptors={301011,301013,301021,12101,12103,222000,236000,101002,31031,1031,1032,101002,33007};
+set airTemperature={280,281,282};
+set dewpointTemperature={270,271,272};
+set pack=1;
+write;
+EOF
+${tools_dir}/bufr_filter -o $tempBufr $tempFilt $sample
+cat > $tempFilt <<EOF
+set unpack=1;
+set airTemperature->percentConfidence={75,65,74};
+set dewpointTemperature->percentConfidence={64,73,63};
+set pack=1;
+write;
+EOF
+${tools_dir}/bufr_filter -o $tempQuality $tempFilt $tempBufr
+
+# Associated fields
+cat > $tempFilt <<EOF
+set compressedData=0;
+set numberOfSubsets=2;
+set unexpandedDescriptors={301011,204001,31021,12101,12103,204000,1031};
+set pack=1;
+write;
+EOF
+${tools_dir}/bufr_filter -o $tempAssociated $tempFilt $sample
+
+$EXEC ${test_dir}/bufr_lazy_attributes $tempUncompressed $tempQuality $tempAssociated
+
+# The attributes of the elements queried
+cat > $tempFilt <<EOF
+set unpack=1;
+print "[#20#airTemperature->units] [#20#airTemperature->code] [#4#airTemperature->scale] [#3#airTemperature->index] [#1#airTemperature->width]";
+EOF
+result=`${tools_dir}/bufr_filter $tempFilt $tempUncompressed`
+[ "$result" = "K 012101 2 31 16" ]
+
+cat > $tempFilt <<EOF
+set unpack=1;
+print "[airTemperature->percentConfidence] [airTemperature->percentConfidence->units] [dewpointTemperature->percentConfidence->code]";
+EOF
+result=`${tools_dir}/bufr_filter $tempFilt $tempQuality`
+[ "$result" = "75 65 74 % 033007" ]
+
+cat > $tempFilt <<EOF
+set unpack=1;
+print "[#2#dewpointTemperature->associatedField->associatedFieldSignificance->code] [#2#dewpointTemperature->code]";
+EOF
+result=`${tools_dir}/bufr_filter $tempFilt $tempAssociated`
+[ "$result" = "031021 012103" ]
+
+# Clean up
+rm -f $tempFilt $tempUncompressed $tempQuality $tempAssociated $tempBufr
@@ -0,0 +1,124 @@
+/*
+ * (C) Copyright 2005- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities granted to it by
+ * virtue of its status as an intergovernmental organisation nor does it submit to any jurisdiction.
+ */
+
+/* Check handles created from a memory-mapped file match those read with stdio */
+
+#include "eccodes.h"
+#include "grib_api_internal.h"
+
+#define MAX_MESSAGES 100
+
+static int count_in_mmap(const char* filename, ProductKind product)
+{
+    int err = 0, count = 0;
+    codes_handle* h     = NULL;
+    codes_mmap_file* mf = codes_mmap_file_open(NULL, filename, &err);
+    Assert(mf && !err);
+
+    while ((h = codes_handle_new_from_mmap(NULL, mf, product, &err)) != NULL) {
+        count++;
+        codes_handle_delete(h);
+    }
+    Assert(!err);
+    codes_mmap_file_close(mf);
+    return count;
+}
+
+int main(int argc, char** argv)
+{
+    int err = 0, i = 0, n = 0, num_grib = 0, num_bufr = 0;
+    FILE* in                          = NULL;
+    codes_handle* h                   = NULL;
+    codes_mmap_file* mf               = NULL;
+    void* expected[MAX_MESSAGES]      = {0,};
+    size_t expected_len[MAX_MESSAGES] = {0,};
+    long expected_offset[MAX_MESSAGES] = {0,};
+    codes_handle* handles[MAX_MESSAGES] = {0,};
+    const void* msg = NULL;
+    size_t msg_len  = 0;
+    char kind[32]   = {0,};
+    size_t len      = 0;
+    const char* filename = NULL;
+
+    Assert(argc == 2);
+    filename = argv[1];
+
+    /* Reference: the usual copying reader */
+    in = fopen(filename, "rb");
+    Assert(in);
+    while ((h = codes_handle_new_from_file(NULL, in, PRODUCT_ANY, &err)) != NULL) {
+        Assert(n < MAX_MESSAGES);
+        CODES_CHECK(codes_get_message(h, &msg, &msg_len), 0);
+        expected[n] = malloc(msg_len);
+        memcpy(expected[n], msg, msg_len);
+        expected_len[n] = msg_len;
+        CODES_CHECK(codes_get_long(h, "offset", &expected_offset[n]), 0);
+        len = sizeof(kind);
+        CODES_CHECK(codes_get_string(h, "identifier", kind, &len), 0);
+        if (strcmp(kind, "GRIB") == 0) num_grib++;
+        if (strcmp(kind, "BUFR") == 0) num_bufr++;
+        codes_handle_delete(h);
+        n++;
+    }
+    Assert(!err);
+    fclose(in);
+
+    /* Same messages at the same offsets through the mapping */
+    mf = codes_mmap_file_open(NULL, filename, &err);
+    Assert(mf && !err);
+    for (i = 0; i < n; i++) {
+        long offset = 0;
+        handles[i]  = codes_handle_new_from_mmap(NULL, mf, PRODUCT_ANY, &err);
+        Assert(handles[i] && !err);
+        CODES_CHECK(codes_get_long(handles[i], "offset", &offset), 0);
+        Assert(offset == expected_offset[i]);
+    }
+    h = codes_handle_new_from_mmap(NULL, mf, PRODUCT_ANY, &err);
+    Assert(!h && !err);
+
+    /* The handles keep the mapping alive */
+    codes_mmap_file_close(mf);
+    for (i = 0; i < n; i++) {
+        CODES_CHECK(codes_get_message(handles[i], &msg, &msg_len), 0);
+        Assert(msg_len == expected_len[i]);
+        Assert(memcmp(msg, expected[i], msg_len) == 0);
+    }
+
+    /* Changing a key must not touch the file */
+    if (n > 0) {
+        len = sizeof(kind);
+        CODES_CHECK(codes_get_string(handles[0], "identifier", kind, &len), 0);
+        if (strcmp(kind, "GRIB") == 0) {
+            CODES_CHECK(codes_set_long(handles[0], "centre", 80), 0);
+        }
+    }
+    for (i = 0; i < n; i++)
+        codes_handle_delete(handles[i]);
+
+    if (n > 0) {
+        in = fopen(filename, "rb");
+        Assert(in);
+        h = codes_handle_new_from_file(NULL, in, PRODUCT_ANY, &err);
+        Assert(h);
+        CODES_CHECK(codes_get_message(h, &msg, &msg_len), 0);
+        Assert(msg_len == expected_len[0] && memcmp(msg, expected[0], msg_len) == 0);
+        codes_handle_delete(h);
+        fclose(in);
+    }
+
+    /* Product filtering */
+    Assert(count_in_mmap(filename, PRODUCT_GRIB) == num_grib);
+    Assert(count_in_mmap(filename, PRODUCT_BUFR) == num_bufr);
+
+    printf("%s: %d messages (%d GRIB, %d BUFR)\n", filename, n, num_grib, num_bufr);
+    for (i = 0; i < n; i++)
+        free(expected[i]);
+    return 0;
+}
@@ -0,0 +1,30 @@
+#!/bin/sh
+# (C) Copyright 2005- ECMWF.
+#
+# This software is licensed under the terms of the Apache Licence Version 2.0
+# which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+#
+# In applying this licence, ECMWF does not waive the privileges and immunities granted to it by
+# virtue of its status as an intergovernmental organisation nor does it submit to any jurisdiction.
+#
+
+. ./include.ctest.sh
+
+label="codes_mmap_file_test"
+tempData=temp.$label.dat
+
+# Mixed GRIB and BUFR with some junk in between
+cat $ECCODES_SAMPLES_PATH/GRIB1.tmpl $ECCODES_SAMPLES_PATH/BUFR4.tmpl > $tempData
+printf "junk" >> $tempData
+cat $ECCODES_SAMPLES_PATH/GRIB2.tmpl $ECCODES_SAMPLES_PATH/BUFR3_local.tmpl >> $tempData
+cat $ECCODES_SAMPLES_PATH/regular_ll_sfc_grib2.tmpl >> $tempData
+$EXEC ${test_dir}/codes_mmap_file $tempData
+
+# Single message
+$EXEC ${test_dir}/codes_mmap_file $ECCODES_SAMPLES_PATH/BUFR4.tmpl
+
+# Empty file
+> $tempData
+$EXEC ${test_dir}/codes_mmap_file $tempData
+
+rm -f $tempData
@@ -0,0 +1,114 @@
+/*
+ * (C) Copyright 2005- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities granted to it by
+ * virtue of its status as an intergovernmental organisation nor does it submit to any jurisdiction.
+ */
+
+/*
+ * The values of a field with a bitmap, read one at a time or as a set, are those of the whole field,
+ * also after a new bitmap is set
+ */
+
+#include "grib_api_internal.h"
+
+#define MISSING 9999
+
+/* Missing: some of each word, all of a block of words; present: all of another block */
+static int is_missing(size_t i, int pattern)
+{
+    if (i >= 512 && i < 640)
+        return 0;
+    if (i >= 128 && i < 320)
+        return 1;
+    return (i % (7 + pattern)) == 0 || (i % 64) == 63;
+}
+
+static void set_values(grib_handle* h, size_t n, int pattern)
+{
+    double* values = (double*)malloc(n * sizeof(double));
+    size_t i       = 0;
+    Assert(values);
+    for (i = 0; i < n; i++)
+        values[i] = is_missing(i, pattern) ? MISSING : (double)(i % 100) + pattern;
+    GRIB_CHECK(grib_set_double_array(h, "values", values, n), 0);
+    free(values);
+}
+
+static void check_values(grib_handle* h, size_t n, int pattern)
+{
+    double* values   = (double*)malloc(n * sizeof(double));
+    double* elements = (double*)malloc(n * sizeof(double));
+    float* fvalues   = (float*)malloc(n * sizeof(float));
+    size_t* indexes  = (size_t*)malloc(n * sizeof(size_t));
+    size_t i = 0, len = n;
+    long missing = 0;
+
+    Assert(values && elements && fvalues && indexes);
+    GRIB_CHECK(grib_get_double_array(h, "values", values, &len), 0);
+    Assert(len == n);
+    len = n;
+    GRIB_CHECK(grib_get_float_array(h, "values", fvalues, &len), 0);
+    Assert(len == n);
+
+    for (i = 0; i < n; i++) {
+        double value = 0;
+        GRIB_CHECK(grib_get_double_element(h, "values", i, &value), 0);
+        Assert(value == values[i]);
+        Assert(fabs(values[i] - fvalues[i]) <= 1e-5 * fabs(values[i]));
+        Assert((values[i] == MISSING) == is_missing(i, pattern));
+        if (values[i] == MISSING)
+            missing++;
+    }
+
+    /* Backwards, as a set */
+    for (i = 0; i < n; i++)
+        indexes[i] = n - 1 - i;
+    GRIB_CHECK(grib_get_double_element_set(h, "values", indexes, n, elements), 0);
+    for (i = 0; i < n; i++)
+        Assert(elements[i] == values[n - 1 - i]);
+
+    printf("%zu values, %ld missing: the same one at a time\n", n, missing);
+    free(values);
+    free(elements);
+    free(fvalues);
+    free(indexes);
+}
+
+static void test_sample(grib_context* c, const char* sample, long Ni, long Nj)
+{
+    grib_handle* h = grib_handle_new_from_samples(c, sample);
+    size_t n       = Ni * Nj;
+    double value   = 0;
+
+    Assert(h);
+    GRIB_CHECK(grib_set_long(h, "Ni", Ni), 0);
+    GRIB_CHECK(grib_set_long(h, "Nj", Nj), 0);
+    GRIB_CHECK(grib_set_long(h, "bitmapPresent", 1), 0);
+    GRIB_CHECK(grib_set_double(h, "missingValue", MISSING), 0);
+
+    printf("%s: ", sample);
+    set_values(h, n, 0);
+    check_values(h, n, 0);
+
+    /* The bitmap changed, the values read are of the new one */
+    printf("%s: ", sample);
+    set_values(h, n, 3);
+    check_values(h, n, 3);
+
+    Assert(grib_get_double_element(h, "values", n, &value) == GRIB_INVALID_ARGUMENT);
+    grib_handle_delete(h);
+}
+
+int main(int argc, char** argv)
+{
+    grib_context* c = grib_context_get_default();
+
+    test_sample(c, "GRIB2", 37, 29);
+    test_sample(c, "GRIB2", 64, 16);
+    test_sample(c, "GRIB1", 41, 27);
+    return 0;
+}
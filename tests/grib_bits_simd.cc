@@ -0,0 +1,126 @@
+/*
+ * (C) Copyright 2005- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities granted to it by
+ * virtue of its status as an intergovernmental organisation nor does it submit to any jurisdiction.
+ */
+
+/* Check the SIMD bit packing kernels are bit-identical to the scalar code */
+
+#include "grib_api_internal.h"
+#include "grib_bits_any_endian_simple.h"
+
+#define NUMBER(x) (sizeof(x) / sizeof(x[0]))
+
+static const long bits_per_values[] = { 1, 7, 8, 11, 12, 13, 16, 20, 24, 25, 31, 32 };
+static const size_t num_values[]    = { 0, 1, 3, 7, 8, 9, 15, 16, 17, 63, 1001 };
+
+static unsigned long random_value(long bpv)
+{
+    unsigned long v = ((unsigned long)rand() << 31) ^ (unsigned long)rand();
+    return bpv == 64 ? v : v & ((1UL << bpv) - 1);
+}
+
+static void test_decode(long bpv, size_t n, int level)
+{
+    const double reference_value = -273.15;
+    const double s               = grib_power(-7, 2);
+    const double d               = grib_power(-2, 10);
+    size_t nbytes = (n * bpv + 7) / 8 + 8, i = 0, count = 0;
+    unsigned char* buf = (unsigned char*)calloc(nbytes, 1);
+    double* expected   = (double*)calloc(n + 1, sizeof(double));
+    double* dvals      = (double*)calloc(n + 1, sizeof(double));
+    float* fexpected   = (float*)calloc(n + 1, sizeof(float));
+    float* fvals       = (float*)calloc(n + 1, sizeof(float));
+    long pos           = 0;
+
+    for (i = 0; i < n; i++) {
+        unsigned long lvalue = random_value(bpv);
+        if (i == 0) lvalue = (1UL << bpv) - 1; /* all bits on */
+        grib_encode_unsigned_longb(buf, lvalue, &pos, bpv);
+        expected[i]  = ((lvalue * s) + reference_value) * d;
+        fexpected[i] = (float)(((lvalue * s) + reference_value) * d);
+    }
+
+    /* The kernel on its own */
+    count = grib_decode_array_simd(level, buf, bpv, reference_value, s, d, n, dvals);
+    Assert(count <= n);
+    Assert((count * bpv) % 8 == 0);
+    Assert(memcmp(dvals, expected, count * sizeof(double)) == 0);
+    count = grib_decode_array_simd(level, buf, bpv, reference_value, s, d, n, fvals);
+    Assert(count <= n);
+    Assert(memcmp(fvals, fexpected, count * sizeof(float)) == 0);
+
+    /* And through the dispatching decoder */
+    pos = 0;
+    grib_decode_array<double>(buf, &pos, bpv, reference_value, s, d, n, dvals);
+    Assert(memcmp(dvals, expected, n * sizeof(double)) == 0);
+    pos = 0;
+    grib_decode_array<float>(buf, &pos, bpv, reference_value, s, d, n, fvals);
+    Assert(memcmp(fvals, fexpected, n * sizeof(float)) == 0);
+
+    free(buf);
+    free(expected);
+    free(dvals);
+    free(fexpected);
+    free(fvals);
+}
+
+static void test_encode(long bpv, size_t n, int level)
+{
+    const double reference_value = 12.5;
+    const double d               = grib_power(2, 10);
+    const double divisor         = grib_power(5, 2);
+    const double range           = bpv == 32 ? 4294967295.0 : (double)((1UL << bpv) - 1);
+    size_t nbytes = (n * bpv + 7) / 8 + 8, i = 0, count = 0;
+    unsigned char* expected = (unsigned char*)calloc(nbytes, 1);
+    unsigned char* encoded  = (unsigned char*)calloc(nbytes, 1);
+    double* vals            = (double*)calloc(n + 1, sizeof(double));
+    long pos                = 0;
+
+    for (i = 0; i < n; i++) {
+        /* Spread the values over the whole range, including both ends */
+        double x = (i == 0) ? 0 : (i == 1) ? range : range * rand() / RAND_MAX;
+        vals[i]  = ((x / divisor) + reference_value) / d;
+        x        = (((vals[i] * d) - reference_value) * divisor) + 0.5;
+        grib_encode_unsigned_longb(expected, (unsigned long)x, &pos, bpv);
+    }
+
+    count = grib_encode_double_array_simd(level, n, vals, bpv, reference_value, d, divisor, encoded);
+    Assert(count <= n);
+    Assert((count * bpv) % 8 == 0);
+    Assert(memcmp(encoded, expected, count * bpv / 8) == 0);
+
+    memset(encoded, 0, nbytes);
+    pos = 0;
+    grib_encode_double_array(n, vals, bpv, reference_value, d, divisor, encoded, &pos);
+    Assert(pos == (long)(n * bpv));
+    Assert(memcmp(encoded, expected, (n * bpv + 7) / 8) == 0);
+
+    free(expected);
+    free(encoded);
+    free(vals);
+}
+
+int main(int argc, char** argv)
+{
+    size_t i = 0, j = 0;
+    int level = 0;
+    const int max_level = grib_bits_simd_level();
+
+    printf("SIMD level: %d\n", max_level);
+    srand(1234);
+    for (level = GRIB_SIMD_NONE; level <= max_level; level++) {
+        for (i = 0; i < NUMBER(bits_per_values); i++) {
+            for (j = 0; j < NUMBER(num_values); j++) {
+                test_decode(bits_per_values[i], num_values[j], level);
+                test_encode(bits_per_values[i], num_values[j], level);
+            }
+        }
+        printf("Level %d: OK\n", level);
+    }
+    return 0;
+}
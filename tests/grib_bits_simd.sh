@@ -0,0 +1,17 @@
+#!/bin/sh
+# (C) Copyright 2005- ECMWF.
+#
+# This software is licensed under the terms of the Apache Licence Version 2.0
+# which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+#
+# In applying this licence, ECMWF does not waive the privileges and immunities granted to it by
+# virtue of its status as an intergovernmental organisation nor does it submit to any jurisdiction.
+#
+
+. ./include.ctest.sh
+
+# Whatever the CPU supports, all levels up to it are compared with the scalar code
+$EXEC ${test_dir}/grib_bits_simd
+
+# The scalar code on its own must still work
+ECCODES_GRIB_NO_SIMD=1 $EXEC ${test_dir}/grib_bits_simd
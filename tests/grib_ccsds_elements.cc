@@ -0,0 +1,146 @@
+/*
+ * (C) Copyright 2005- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities granted to it by
+ * virtue of its status as an intergovernmental organisation nor does it submit to any jurisdiction.
+ */
+
+/*
+ * The values of a CCSDS packed field read one at a time or as a set, each from its own
+ * reference sample interval, are those of the whole field decoded
+ */
+
+#include "grib_api_internal.h"
+
+#define NI 97
+#define NJ 53
+
+/* Smooth, constant for long runs (zero blocks) and noisy (uncompressed blocks) parts */
+static double sample(size_t i, long bits_per_value, int pattern)
+{
+    const double max     = (double)((1UL << bits_per_value) - 1);
+    static unsigned long seed = 1;
+    switch ((i / 700 + pattern) % 3) {
+        case 0:
+            return floor(max * (0.5 + 0.5 * sin(i / 50.0)));
+        case 1:
+            return (i / 3000) % 2 ? max : 0;
+        default:
+            seed = seed * 1103515245 + 12345;
+            return (double)((seed >> 8) % ((1UL << bits_per_value) - 1));
+    }
+}
+
+static void check_elements(grib_handle* h, const char* what)
+{
+    size_t n = 0, i = 0, len = 0;
+    double* values   = NULL;
+    double* elements = NULL;
+    size_t* indexes  = NULL;
+    double value     = 0;
+
+    GRIB_CHECK(grib_get_size(h, "values", &n), 0);
+    values   = (double*)malloc(n * sizeof(double));
+    elements = (double*)malloc(n * sizeof(double));
+    indexes  = (size_t*)malloc(n * sizeof(size_t));
+    Assert(values && elements && indexes);
+    GRIB_CHECK(grib_get_double_array(h, "values", values, &n), 0);
+
+    for (i = 0; i < n; i += 7) {
+        GRIB_CHECK(grib_get_double_element(h, "values", i, &value), 0);
+        if (value != values[i]) {
+            fprintf(stderr, "%s: values[%zu]=%.17g, element %.17g\n", what, i, values[i], value);
+            Assert(!"Element differs");
+        }
+    }
+    GRIB_CHECK(grib_get_double_element(h, "values", n - 1, &value), 0);
+    Assert(value == values[n - 1]);
+    Assert(grib_get_double_element(h, "values", n, &value) == GRIB_INVALID_ARGUMENT);
+
+    /* Backwards, as a set */
+    for (i = 0; i < n; i++)
+        indexes[i] = n - 1 - i;
+    GRIB_CHECK(grib_get_double_element_set(h, "values", indexes, n, elements), 0);
+    for (i = 0; i < n; i++) {
+        if (elements[i] != values[n - 1 - i]) {
+            fprintf(stderr, "%s: values[%zu]=%.17g, element %.17g\n", what, n - 1 - i, values[n - 1 - i], elements[i]);
+            Assert(!"Element of the set differs");
+        }
+    }
+
+    /* Most of them, the intervals of some missing */
+    for (i = 0, len = 0; i < n; i++) {
+        if ((i / 100) % 7 != 3)
+            indexes[len++] = i;
+    }
+    GRIB_CHECK(grib_get_double_element_set(h, "values", indexes, len, elements), 0);
+    for (i = 0; i < len; i++)
+        Assert(elements[i] == values[indexes[i]]);
+
+    free(values);
+    free(elements);
+    free(indexes);
+}
+
+static void test_packing(grib_context* c, long flags, long block_size, long rsi, long bits_per_value)
+{
+    grib_handle* h = grib_handle_new_from_samples(c, "GRIB2");
+    grib_handle* h2 = NULL;
+    const size_t n = NI * NJ;
+    double* values = (double*)malloc(n * sizeof(double));
+    const void* message = NULL;
+    size_t size = 0, i = 0;
+    int pattern = 0;
+    char what[128];
+
+    Assert(h && values);
+    GRIB_CHECK(grib_set_long(h, "Ni", NI), 0);
+    GRIB_CHECK(grib_set_long(h, "Nj", NJ), 0);
+    GRIB_CHECK(grib_set_string(h, "packingType", "grid_ccsds", &size), 0);
+    GRIB_CHECK(grib_set_long(h, "ccsdsFlags", flags), 0);
+    GRIB_CHECK(grib_set_long(h, "ccsdsBlockSize", block_size), 0);
+    GRIB_CHECK(grib_set_long(h, "ccsdsRsi", rsi), 0);
+    GRIB_CHECK(grib_set_long(h, "bitsPerValue", bits_per_value), 0);
+    snprintf(what, sizeof(what), "flags=%ld blockSize=%ld rsi=%ld bitsPerValue=%ld", flags, block_size, rsi, bits_per_value);
+
+    /* The values set again, the elements read are the new ones */
+    for (pattern = 0; pattern < 2; pattern++) {
+        for (i = 0; i < n; i++)
+            values[i] = sample(i, bits_per_value, pattern);
+        GRIB_CHECK(grib_set_double_array(h, "values", values, n), 0);
+        check_elements(h, what);
+    }
+
+    GRIB_CHECK(grib_get_message(h, &message, &size), 0);
+    h2 = grib_handle_new_from_message_copy(c, message, size);
+    Assert(h2);
+    check_elements(h2, what);
+    printf("%s: %zu values, the same one at a time\n", what, n);
+
+    grib_handle_delete(h2);
+    grib_handle_delete(h);
+    free(values);
+}
+
+int main(int argc, char** argv)
+{
+    grib_context* c = grib_context_get_default();
+    const long block_sizes[] = { 8, 16, 32, 64 };
+    const long rsis[]        = { 1, 5, 128 };
+    const long bits[]        = { 4, 8, 12, 16, 20, 24 };
+    size_t b = 0, r = 0, i = 0;
+
+    for (b = 0; b < sizeof(block_sizes) / sizeof(block_sizes[0]); b++)
+        for (r = 0; r < sizeof(rsis) / sizeof(rsis[0]); r++)
+            for (i = 0; i < sizeof(bits) / sizeof(bits[0]); i++)
+                test_packing(c, 14, block_sizes[b], rsis[r], bits[i]);
+
+    /* Restricted set of options of few bits per value, no preprocessing */
+    test_packing(c, 14 | 16, 16, 3, 2);
+    test_packing(c, 14 | 16, 32, 7, 4);
+    test_packing(c, 14 & ~8, 32, 5, 16);
+    return 0;
+}
@@ -0,0 +1,120 @@
+/*
+ * (C) Copyright 2005- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities granted to it by
+ * virtue of its status as an intergovernmental organisation nor does it submit to any jurisdiction.
+ */
+
+/*
+ * Time of extracting points of CCSDS packed fields (e.g. O1280): as a set of elements, one element
+ * at a time, and from all the values decoded. Each time from a new handle of the message
+ */
+
+#include "grib_api_internal.h"
+
+#if ECCODES_TIMER
+
+void usage(char* prog)
+{
+    printf("usage: %s grib_file points repetitions\n", prog);
+    exit(1);
+}
+
+static grib_handle* new_handle(grib_context* c, const void* message, size_t size)
+{
+    grib_handle* h = grib_handle_new_from_message(c, message, size);
+    Assert(h);
+    return h;
+}
+
+int main(int argc, char* argv[])
+{
+    grib_context* c = grib_context_get_default();
+    grib_handle* h  = NULL;
+    grib_timer* tset   = grib_get_timer(c, "element set", 0, 1);
+    grib_timer* tone   = grib_get_timer(c, "elements one at a time", 0, 1);
+    grib_timer* tall   = grib_get_timer(c, "all values", 0, 1);
+    FILE* fin          = NULL;
+    size_t* indexes    = NULL;
+    double* elements   = NULL;
+    double* values     = NULL;
+    unsigned long seed = 1;
+    size_t points = 0, i = 0, n = 0, count = 0;
+    int repeat = 0, r = 0, e = 0;
+
+    if (argc != 4)
+        usage(argv[0]);
+    fin = fopen(argv[1], "rb");
+    if (!fin) {
+        perror(argv[1]);
+        exit(1);
+    }
+    points = atol(argv[2]);
+    repeat = atoi(argv[3]);
+    if (points < 1 || repeat < 1)
+        usage(argv[0]);
+    indexes  = (size_t*)malloc(points * sizeof(size_t));
+    elements = (double*)malloc(points * sizeof(double));
+    Assert(indexes && elements);
+    tset->timer_ = tone->timer_ = tall->timer_ = 0;
+
+    while ((h = codes_handle_new_from_file(c, fin, PRODUCT_GRIB, &e)) != NULL) {
+        const void* message = NULL;
+        size_t size = 0;
+        GRIB_CHECK(grib_get_message(h, &message, &size), 0);
+        GRIB_CHECK(grib_get_size(h, "values", &n), 0);
+        values = (double*)realloc(values, n * sizeof(double));
+        Assert(values);
+        for (i = 0; i < points; i++) {
+            seed       = seed * 1103515245 + 12345;
+            indexes[i] = (seed >> 8) % n;
+        }
+
+        for (r = 0; r < repeat; r++) {
+            grib_handle* h2 = new_handle(c, message, size);
+            grib_timer_start(tset);
+            GRIB_CHECK(grib_get_double_element_set(h2, "values", indexes, points, elements), 0);
+            grib_timer_stop(tset, 0);
+            grib_handle_delete(h2);
+
+            h2 = new_handle(c, message, size);
+            grib_timer_start(tone);
+            for (i = 0; i < points; i++)
+                GRIB_CHECK(grib_get_double_element(h2, "values", indexes[i], &elements[i]), 0);
+            grib_timer_stop(tone, 0);
+            grib_handle_delete(h2);
+
+            h2 = new_handle(c, message, size);
+            grib_timer_start(tall);
+            GRIB_CHECK(grib_get_double_array(h2, "values", values, &n), 0);
+            grib_timer_stop(tall, 0);
+            grib_handle_delete(h2);
+
+            for (i = 0; i < points; i++)
+                Assert(elements[i] == values[indexes[i]]);
+        }
+        grib_handle_delete(h);
+        count++;
+    }
+    GRIB_CHECK(e, 0);
+    fclose(fin);
+
+    printf("%zu messages, %zu points: %g s as a set, %g s one at a time, %g s decoding all the values\n",
+           count, points, tset->timer_ / (repeat * count), tone->timer_ / (repeat * count), tall->timer_ / (repeat * count));
+
+    free(indexes);
+    free(elements);
+    free(values);
+    return 0;
+}
+#else
+
+int main(int argc, char* argv[])
+{
+    return 0;
+}
+
+#endif
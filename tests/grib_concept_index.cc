@@ -0,0 +1,109 @@
+/*
+ * (C) Copyright 2005- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities granted to it by
+ * virtue of its status as an intergovernmental organisation nor does it submit to any jurisdiction.
+ */
+
+/*
+ * Check the concepts give the same values with their index as when evaluating all their entries,
+ * on messages set to the entries of the concepts in turn
+ */
+
+#include "eccodes.h"
+#include "grib_api_internal.h"
+
+static const char* checked_keys[] = { "paramId", "shortName", "name", "units", "cfVarName", "typeOfLevel", "stepType" };
+#define NUM_CHECKED_KEYS (sizeof(checked_keys) / sizeof(checked_keys[0]))
+
+static grib_concept_value* get_concept(codes_handle* h, const char* key)
+{
+    grib_accessor* a = grib_find_accessor(h, key);
+    Assert(a);
+    return action_concept_get_concept(a);
+}
+
+/* The value of the key, with or without the index of its concept */
+static int get_value(codes_handle* h, const char* key, int indexed, char* value, size_t len)
+{
+    grib_concept_value* concept = get_concept(h, key);
+    grib_concept_index* index   = concept->conditions_index;
+    int err                     = 0;
+    if (!indexed)
+        concept->conditions_index = NULL;
+    err = codes_get_string(h, key, value, &len);
+    concept->conditions_index = index;
+    return err;
+}
+
+static int check_keys(codes_handle* h, const char* set_key, const char* set_value)
+{
+    size_t k = 0;
+    int indexed = 0;
+    for (k = 0; k < NUM_CHECKED_KEYS; k++) {
+        char value[1024] = {0,}, expected[1024] = {0,};
+        int err  = get_value(h, checked_keys[k], 1, value, sizeof(value));
+        int err2 = get_value(h, checked_keys[k], 0, expected, sizeof(expected));
+        if (get_concept(h, checked_keys[k])->conditions_index)
+            indexed = 1;
+        if (err != err2 || strcmp(value, expected) != 0) {
+            fprintf(stderr, "ERROR: %s=%s: %s is '%s' (%d) instead of '%s' (%d)\n",
+                    set_key, set_value, checked_keys[k], value, err, expected, err2);
+            exit(1);
+        }
+    }
+    return indexed;
+}
+
+/* Set the key to every stride-th entry of its concept */
+static void check_concept(const char* sample, const char* centre, const char* key, size_t stride)
+{
+    codes_handle* h             = codes_grib_handle_new_from_samples(NULL, sample);
+    grib_concept_value* concept = NULL;
+    size_t i = 0, checked = 0, len = 0;
+    Assert(h);
+    len = strlen(centre);
+    CODES_CHECK(codes_set_string(h, "centre", centre, &len), 0);
+
+    for (concept = get_concept(h, key); concept; concept = concept->next, i++) {
+        codes_handle* clone = NULL;
+        if (i % stride)
+            continue;
+        clone = codes_handle_clone(h);
+        len   = strlen(concept->name);
+        if (codes_set_string(clone, key, concept->name, &len) == GRIB_SUCCESS) {
+            Assert(check_keys(clone, key, concept->name));
+            checked++;
+        }
+        codes_handle_delete(clone);
+    }
+    codes_handle_delete(h);
+    printf("%s centre=%s: %zu values of %s checked\n", sample, centre, checked, key);
+    Assert(checked > 0);
+}
+
+/* Setting keys to values some messages cannot have logs errors */
+static void no_log(const grib_context* c, int level, const char* mesg)
+{
+}
+
+int main(int argc, char** argv)
+{
+    static const char* samples[] = { "GRIB1", "GRIB2" };
+    static const char* centres[] = { "ecmf", "kwbc" };
+    size_t s = 0, c = 0;
+
+    grib_context_set_logging_proc(grib_context_get_default(), &no_log);
+
+    for (s = 0; s < 2; s++) {
+        for (c = 0; c < 2; c++) {
+            check_concept(samples[s], centres[c], "paramId", 5);
+            check_concept(samples[s], centres[c], "typeOfLevel", 1);
+            check_concept(samples[s], centres[c], "stepType", 1);
+        }
+    }
+    return 0;
+}
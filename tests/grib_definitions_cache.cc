@@ -0,0 +1,214 @@
+/*
+ * (C) Copyright 2005- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities granted to it by
+ * virtue of its status as an intergovernmental organisation nor does it submit to any jurisdiction.
+ */
+
+/*
+ * The values of the definition files given from the definitions cache are those parsed, and a
+ * file which changed after it was compiled is parsed again
+ */
+
+#include "grib_api_internal.h"
+
+#define TEMP_DEF   "temp.grib_definitions_cache.def"
+#define TEMP_CACHE "temp.grib_definitions_cache.cache"
+
+static void compare_conditions(grib_concept_condition* a, grib_concept_condition* b)
+{
+    for (; a && b; a = a->next, b = b->next) {
+        Assert(strcmp(a->name, b->name) == 0);
+        Assert((a->expression == NULL) == (b->expression == NULL));
+        if (a->expression) {
+            const char* type = a->expression->cclass->name;
+            Assert(strcmp(type, b->expression->cclass->name) == 0);
+            if (strcmp(type, "long") == 0) {
+                long la = 0, lb = 0;
+                GRIB_CHECK(grib_expression_evaluate_long(NULL, a->expression, &la), 0);
+                GRIB_CHECK(grib_expression_evaluate_long(NULL, b->expression, &lb), 0);
+                Assert(la == lb);
+            }
+            else if (strcmp(type, "double") == 0) {
+                double da = 0, db = 0;
+                GRIB_CHECK(grib_expression_evaluate_double(NULL, a->expression, &da), 0);
+                GRIB_CHECK(grib_expression_evaluate_double(NULL, b->expression, &db), 0);
+                Assert(da == db);
+            }
+            else if (strcmp(type, "string") == 0) {
+                size_t size = 0;
+                int err     = 0;
+                const char* sa = grib_expression_evaluate_string(NULL, a->expression, NULL, &size, &err);
+                const char* sb = grib_expression_evaluate_string(NULL, b->expression, NULL, &size, &err);
+                Assert(sa && sb && strcmp(sa, sb) == 0);
+            }
+            else {
+                Assert(grib_expression_functor_name(a->expression));
+                Assert(strcmp(grib_expression_functor_name(a->expression), grib_expression_functor_name(b->expression)) == 0);
+            }
+        }
+        else {
+            size_t i = 0;
+            Assert(a->iarray->n == b->iarray->n);
+            for (i = 0; i < a->iarray->n; i++)
+                Assert(a->iarray->v[i] == b->iarray->v[i]);
+        }
+    }
+    Assert(a == NULL && b == NULL);
+}
+
+static size_t compare_concepts(grib_concept_value* a, grib_concept_value* b)
+{
+    size_t n = 0;
+    for (; a && b; a = a->next, b = b->next, n++) {
+        Assert(strcmp(a->name, b->name) == 0);
+        compare_conditions(a->conditions, b->conditions);
+    }
+    Assert(a == NULL && b == NULL);
+    return n;
+}
+
+static size_t compare_hash_arrays(grib_hash_array_value* a, grib_hash_array_value* b)
+{
+    size_t n = 0, i = 0;
+    for (; a && b; a = a->next, b = b->next, n++) {
+        Assert(strcmp(a->name, b->name) == 0);
+        Assert(a->type == b->type && a->iarray->n == b->iarray->n);
+        for (i = 0; i < a->iarray->n; i++)
+            Assert(a->iarray->v[i] == b->iarray->v[i]);
+    }
+    Assert(a == NULL && b == NULL);
+    return n;
+}
+
+static void concepts_delete(grib_context* c, grib_concept_value* v)
+{
+    while (v) {
+        grib_concept_value* next = v->next;
+        grib_concept_value_delete(c, v);
+        v = next;
+    }
+}
+
+static void hash_arrays_delete(grib_context* c, grib_hash_array_value* v)
+{
+    while (v) {
+        grib_hash_array_value* next = v->next;
+        grib_hash_array_value_delete(c, v);
+        v = next;
+    }
+}
+
+/* A file compiled in the cache of the environment */
+static void test_compiled_file(grib_context* c, const char* basename)
+{
+    const char* path                  = grib_context_full_defs_path(c, basename);
+    grib_concept_value* concept       = NULL;
+    grib_hash_array_value* hash_array = NULL;
+    size_t n = 0;
+
+    Assert(path);
+    GRIB_CHECK(grib_parse_values_file(c, path, &concept, &hash_array), 0);
+    if (concept) {
+        grib_concept_value* cached = grib_definitions_cache_get_concept(c, path);
+        Assert(cached);
+        Assert(grib_definitions_cache_get_hash_array(c, path) == NULL);
+        n = compare_concepts(cached, concept);
+        concepts_delete(c, cached);
+        concepts_delete(c, concept);
+    }
+    else {
+        grib_hash_array_value* cached = grib_definitions_cache_get_hash_array(c, path);
+        Assert(hash_array && cached);
+        n = compare_hash_arrays(cached, hash_array);
+        hash_arrays_delete(c, cached);
+        hash_arrays_delete(c, hash_array);
+    }
+    printf("%s: %zu values OK\n", basename, n);
+}
+
+static void write_file(const char* path, const char* text)
+{
+    FILE* f = fopen(path, "w");
+    Assert(f);
+    fputs(text, f);
+    fclose(f);
+}
+
+/* A concept file compiled in a cache of its own, then changed */
+static void test_changed_file(grib_context* c)
+{
+    char* files[] = { (char*)TEMP_DEF };
+    grib_concept_value *cached = NULL, *parsed = NULL;
+    grib_hash_array_value* hash_array = NULL;
+    size_t n = 0, length = 0;
+    FILE* f = NULL;
+    char* data = NULL;
+
+    write_file(TEMP_DEF,
+               "'t' = { discipline = 0; parameterCategory = 0; parameterNumber = 0; }\n"
+               "'2t' = { discipline = 0; typeOfFirstFixedSurface = 103; scaleFactorOfFirstFixedSurface = missing(); }\n"
+               "'r' = { level = 3.5; typeOfLevel = \"isobaricInhPa\"; numbers = [1, 2, 3]; }\n");
+    GRIB_CHECK(grib_definitions_cache_write(c, TEMP_CACHE, files, 1, &n), 0);
+    Assert(n == 1);
+    setenv("ECCODES_DEFINITION_CACHE", TEMP_CACHE, 1);
+    grib_definitions_cache_delete(c);
+
+    cached = grib_definitions_cache_get_concept(c, TEMP_DEF);
+    Assert(cached);
+    GRIB_CHECK(grib_parse_values_file(c, TEMP_DEF, &parsed, &hash_array), 0);
+    Assert(compare_concepts(cached, parsed) == 3);
+    concepts_delete(c, cached);
+    concepts_delete(c, parsed);
+    printf("%s: compiled\n", TEMP_DEF);
+
+    /* Changed since it was compiled: parsed again */
+    write_file(TEMP_DEF, "'q' = { discipline = 0; parameterCategory = 1; parameterNumber = 0; }\n");
+    Assert(grib_definitions_cache_get_concept(c, TEMP_DEF) == NULL);
+    cached = grib_parse_concept_file(c, TEMP_DEF);
+    Assert(cached && strcmp(cached->name, "q") == 0 && cached->next == NULL);
+    concepts_delete(c, cached);
+    printf("%s: changed, parsed again\n", TEMP_DEF);
+
+    /* Conditions the cache cannot hold leave the file out */
+    write_file(TEMP_DEF, "'q' = { discipline = 1 + 1; }\n");
+    GRIB_CHECK(grib_definitions_cache_write(c, TEMP_CACHE, files, 1, &n), 0);
+    Assert(n == 0);
+    grib_definitions_cache_delete(c);
+    Assert(grib_definitions_cache_get_concept(c, TEMP_DEF) == NULL);
+
+    /* A truncated cache is not used */
+    write_file(TEMP_DEF, "'t' = { discipline = 0; parameterCategory = 0; parameterNumber = 0; }\n");
+    GRIB_CHECK(grib_definitions_cache_write(c, TEMP_CACHE, files, 1, &n), 0);
+    f = fopen(TEMP_CACHE, "rb");
+    Assert(f && fseeko(f, 0, SEEK_END) == 0);
+    length = (size_t)ftello(f);
+    data   = (char*)malloc(length);
+    Assert(data && fseeko(f, 0, SEEK_SET) == 0 && fread(data, 1, length, f) == length);
+    fclose(f);
+    f = fopen(TEMP_CACHE, "wb");
+    Assert(f && fwrite(data, 1, length - 16, f) == length - 16);
+    fclose(f);
+    free(data);
+    grib_definitions_cache_delete(c);
+    Assert(grib_definitions_cache_get_concept(c, TEMP_DEF) == NULL);
+    printf("%s: truncated cache ignored\n", TEMP_CACHE);
+
+    grib_definitions_cache_delete(c);
+    remove(TEMP_DEF);
+    remove(TEMP_CACHE);
+}
+
+int main(int argc, char** argv)
+{
+    grib_context* c = grib_context_get_default();
+    int i = 0;
+
+    for (i = 1; i < argc; i++)
+        test_compiled_file(c, argv[i]);
+    test_changed_file(c);
+    return 0;
+}
@@ -0,0 +1,41 @@
+#!/bin/sh
+# (C) Copyright 2005- ECMWF.
+#
+# This software is licensed under the terms of the Apache Licence Version 2.0
+# which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+#
+# In applying this licence, ECMWF does not waive the privileges and immunities granted to it by
+# virtue of its status as an intergovernmental organisation nor does it submit to any jurisdiction.
+#
+
+. ./include.ctest.sh
+
+label="grib_definitions_cache_test"
+tempCache="temp.${label}.cache"
+tempOut1="temp.${label}.1.txt"
+tempOut2="temp.${label}.2.txt"
+
+${tools_dir}/codes_compile_definitions -o $tempCache
+
+# The cached values are those parsed
+ECCODES_DEFINITION_CACHE=$tempCache $EXEC ${test_dir}/grib_definitions_cache \
+    grib1/name.def grib1/localConcepts/ecmf/paramId.def \
+    grib2/paramId.def grib2/shortName.def grib2/units.def grib2/cfVarName.def \
+    grib2/localConcepts/ecmf/paramId.def grib2/typeOfLevelConcept.def \
+    bufr/tables/0/wmo/35/sequence.def
+
+# Decoding is the same with and without the cache
+for f in GRIB1.tmpl GRIB2.tmpl reduced_gg_pl_320_grib2.tmpl regular_ll_sfc_grib2.tmpl sh_ml_grib1.tmpl; do
+  ECCODES_DEFINITION_CACHE=$tempCache ${tools_dir}/grib_ls -p paramId,shortName,name,units,cfVarName,typeOfLevel,stepType \
+      $ECCODES_SAMPLES_PATH/$f > $tempOut1
+  ECCODES_DEFINITION_CACHE= ${tools_dir}/grib_ls -p paramId,shortName,name,units,cfVarName,typeOfLevel,stepType \
+      $ECCODES_SAMPLES_PATH/$f > $tempOut2
+  diff $tempOut1 $tempOut2
+done
+
+ECCODES_DEFINITION_CACHE=$tempCache ${tools_dir}/bufr_dump -p $ECCODES_SAMPLES_PATH/BUFR4.tmpl > $tempOut1
+ECCODES_DEFINITION_CACHE= ${tools_dir}/bufr_dump -p $ECCODES_SAMPLES_PATH/BUFR4.tmpl > $tempOut2
+diff $tempOut1 $tempOut2
+
+# Clean up
+rm -f $tempCache $tempOut1 $tempOut2
@@ -0,0 +1,172 @@
+/*
+ * (C) Copyright 2005- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities granted to it by
+ * virtue of its status as an intergovernmental organisation nor does it submit to any jurisdiction.
+ */
+
+/*
+ * Check fieldsets are sorted on one or more keys, ascending or descending, with fields
+ * having the same keys in file order, on input presorted, reversed or with many duplicates.
+ */
+
+#include "eccodes.h"
+#include "grib_api_internal.h"
+
+#define NUM_FIELDS 2400
+
+static const char* short_names[] = { "z", "t", "u", "v", "q" };
+
+typedef struct field_keys
+{
+    long offset;
+    long level;
+    long step;
+    double lat;
+    const char* shortName;
+} field_keys;
+
+static field_keys fields[NUM_FIELDS];
+
+/* Steps descending through the file, levels cycling, few distinct names and latitudes */
+static void write_messages(const char* filename)
+{
+    size_t len = 0, i = 0;
+    long offset     = 0;
+    const void* msg = NULL;
+    FILE* out       = fopen(filename, "wb");
+    codes_handle* h = codes_grib_handle_new_from_samples(NULL, "GRIB2");
+    Assert(out && h);
+
+    CODES_CHECK(codes_set_string(h, "typeOfLevel", "isobaricInhPa", &len), 0);
+    for (i = 0; i < NUM_FIELDS; i++) {
+        field_keys* k = &fields[i];
+        k->offset     = offset;
+        k->step       = (NUM_FIELDS - i) / 8;
+        k->level      = 100 * (1 + (long)(i * 7 % 10));
+        k->shortName  = short_names[(i / 3) % 5];
+        k->lat        = (i % 4 == 0) ? -45.5 : (i % 4 == 1) ? 0.0 : (i % 4 == 2) ? 30.25 : 90.0;
+        len           = strlen(k->shortName);
+        CODES_CHECK(codes_set_string(h, "shortName", k->shortName, &len), 0);
+        CODES_CHECK(codes_set_long(h, "level", k->level), 0);
+        CODES_CHECK(codes_set_long(h, "step", k->step), 0);
+        CODES_CHECK(codes_set_double(h, "latitudeOfFirstGridPointInDegrees", k->lat), 0);
+        CODES_CHECK(codes_get_message(h, &msg, &len), 0);
+        Assert(fwrite(msg, 1, len, out) == len);
+        offset += len;
+    }
+    codes_handle_delete(h);
+    fclose(out);
+}
+
+static int compare_long(long a, long b) { return a < b ? -1 : a > b ? 1 : 0; }
+static int compare_double(double a, double b) { return a < b ? -1 : a > b ? 1 : 0; }
+
+/* Order of the fields for the given sort, as a sequence of key letters: upper case descending */
+static int compare_fields(const field_keys* a, const field_keys* b, const char* sort)
+{
+    int ret = 0;
+    for (; *sort && ret == 0; sort++) {
+        switch (*sort | 0x20) {
+            case 'l': ret = compare_long(a->level, b->level); break;
+            case 's': ret = compare_long(a->step, b->step); break;
+            case 'n': ret = strcmp(a->shortName, b->shortName); break;
+            case 'd': ret = compare_double(a->lat, b->lat); break;
+            default: Assert(0);
+        }
+        if (*sort >= 'A' && *sort <= 'Z')
+            ret = -ret;
+    }
+    return ret;
+}
+
+static const field_keys* find_field(long offset)
+{
+    size_t i = 0;
+    for (i = 0; i < NUM_FIELDS; i++)
+        if (fields[i].offset == offset)
+            return &fields[i];
+    Assert(0);
+    return NULL;
+}
+
+static void check_sorted(codes_fieldset* set, const char* sort, const char* order_by)
+{
+    int err = 0;
+    size_t n = 0;
+    long offset = 0;
+    const field_keys* prev = NULL;
+    codes_handle* h = NULL;
+
+    while ((h = codes_fieldset_next_handle(set, &err)) != NULL) {
+        const field_keys* k = NULL;
+        CODES_CHECK(codes_get_long(h, "offset", &offset), 0);
+        codes_handle_delete(h);
+        k = find_field(offset);
+        if (prev) {
+            int c = compare_fields(prev, k, sort);
+            /* Equal keys: stable, in file order */
+            if (c > 0 || (c == 0 && prev->offset > k->offset)) {
+                fprintf(stderr, "ERROR: order by %s: field at %ld before field at %ld\n",
+                        order_by, prev->offset, k->offset);
+                exit(1);
+            }
+        }
+        prev = k;
+        n++;
+    }
+    Assert(n == NUM_FIELDS);
+}
+
+int main(int argc, char** argv)
+{
+    static const struct
+    {
+        const char* order_by;
+        const char* sort;
+    } cases[] = {
+        { "step", "s" },
+        { "step desc", "S" },
+        { "shortName", "n" },
+        { "shortName desc,level asc", "Nl" },
+        { "level,step", "ls" },
+        { "level desc,shortName,step desc", "LnS" },
+        { "latitudeOfFirstGridPointInDegrees", "d" },
+        { "latitudeOfFirstGridPointInDegrees desc,step", "Ds" },
+    };
+    static const char* keys[] = { "level:l", "step:l", "shortName:s", "latitudeOfFirstGridPointInDegrees:d" };
+    char filename[1024]       = {0,};
+    const char* filenames[1];
+    codes_fieldset* set = NULL;
+    size_t i = 0;
+    int err  = 0;
+
+    Assert(argc == 2);
+    snprintf(filename, sizeof(filename), "%s.grib", argv[1]);
+    filenames[0] = filename;
+    write_messages(filename);
+
+    /* Sorted when created */
+    for (i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        set = codes_fieldset_new_from_files(NULL, filenames, 1, keys, 4, NULL, cases[i].order_by, &err);
+        Assert(set && !err);
+        check_sorted(set, cases[i].sort, cases[i].order_by);
+        codes_fieldset_delete(set);
+    }
+
+    /* Sorted again: ties are in file order whatever the previous order */
+    set = codes_fieldset_new_from_files(NULL, filenames, 1, keys, 4, NULL, NULL, &err);
+    Assert(set && !err);
+    for (i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        CODES_CHECK(codes_fieldset_apply_order_by(set, cases[i].order_by), 0);
+        check_sorted(set, cases[i].sort, cases[i].order_by);
+    }
+    codes_fieldset_delete(set);
+
+    printf("%d fields sorted %zu ways\n", NUM_FIELDS, sizeof(cases) / sizeof(cases[0]));
+    remove(filename);
+    return 0;
+}
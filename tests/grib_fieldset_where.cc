@@ -0,0 +1,224 @@
+/*
+ * (C) Copyright 2005- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities granted to it by
+ * virtue of its status as an intergovernmental organisation nor does it submit to any jurisdiction.
+ */
+
+/*
+ * Check the fields selected by a where clause are those for which the same condition,
+ * written in C, is true on the keys of the messages written, in file order and sorted.
+ */
+
+#include "eccodes.h"
+#include "grib_api_internal.h"
+
+#define MAX_FIELDS 1000
+
+static const long levels[]       = { 1000, 850, 500 };
+static const char* short_names[] = { "t", "z" };
+
+typedef struct field_keys
+{
+    long offset;
+    long level;
+    long step;
+    long number; /* -1 for the fields without perturbationNumber */
+    char shortName[64];
+} field_keys;
+
+typedef int (*predicate)(const field_keys*);
+
+static int p_level_850(const field_keys* k) { return k->level == 850; }
+static int p_level_step(const field_keys* k) { return k->level == 850 && k->step >= 6; }
+static int p_or(const field_keys* k) { return (!strcmp(k->shortName, "t") && k->level == 500) || k->step == 0; }
+static int p_not(const field_keys* k) { return !(k->level < 850) && strcmp(k->shortName, "z") != 0; }
+static int p_double(const field_keys* k) { return k->step > 5.5 && k->level < 900.5; }
+static int p_string_number(const field_keys* k) { return k->level == 1000; }
+static int p_number(const field_keys* k) { return k->number >= 0; }
+static int p_not_number(const field_keys* k) { return k->number >= 0 && k->number != 1; }
+static int p_none(const field_keys* k) { return 0; }
+static int p_all(const field_keys* k) { return 1; }
+
+static const struct
+{
+    const char* where;
+    predicate p;
+} cases[] = {
+    { "level == 850", &p_level_850 },
+    { "level=850 and step>=6", &p_level_step },
+    { "(shortName == 't' && level == 500) || step == 0", &p_or },
+    { "!(level < 850) && shortName != \"z\"", &p_not },
+    { "not level<850 and not shortName=='z'", &p_not },
+    { "step > 5.5 && level < 900.5", &p_double },
+    { "level == '1000'", &p_string_number },
+    { "perturbationNumber >= 0", &p_number },
+    /* A field with a missing key is not selected, whatever the clause */
+    { "!(perturbationNumber >= 0) || perturbationNumber != 1", &p_not_number },
+    { "step < 0", &p_none },
+    { "step >= 0 or level<>level", &p_all },
+    { "level", &p_all },
+};
+
+static const char* keys[] = { "level:d", "step:l", "shortName:s", "perturbationNumber:l" };
+
+/* Write messages for every level, step and parameter, the last ones from an ensemble */
+static size_t write_messages(const char* filename, field_keys* fields)
+{
+    size_t n = 0, len = 0, i = 0, j = 0;
+    long step = 0, offset = 0;
+    const void* msg = NULL;
+    FILE* out       = fopen(filename, "wb");
+    codes_handle* h = codes_grib_handle_new_from_samples(NULL, "GRIB2");
+    Assert(out && h);
+
+    CODES_CHECK(codes_set_string(h, "typeOfLevel", "isobaricInhPa", &len), 0);
+    for (step = 0; step <= 12; step += 3) {
+        if (step == 9) {
+            CODES_CHECK(codes_set_long(h, "productDefinitionTemplateNumber", 1), 0);
+            CODES_CHECK(codes_set_long(h, "numberOfForecastsInEnsemble", 10), 0);
+        }
+        for (i = 0; i < sizeof(levels) / sizeof(levels[0]); i++) {
+            for (j = 0; j < sizeof(short_names) / sizeof(short_names[0]); j++) {
+                Assert(n < MAX_FIELDS);
+                len = strlen(short_names[j]);
+                CODES_CHECK(codes_set_string(h, "shortName", short_names[j], &len), 0);
+                CODES_CHECK(codes_set_long(h, "level", levels[i]), 0);
+                CODES_CHECK(codes_set_long(h, "step", step), 0);
+                fields[n].number = -1;
+                if (step >= 9) {
+                    fields[n].number = (long)(n % 3);
+                    CODES_CHECK(codes_set_long(h, "perturbationNumber", fields[n].number), 0);
+                }
+                fields[n].offset = offset;
+                fields[n].level  = levels[i];
+                fields[n].step   = step;
+                snprintf(fields[n].shortName, sizeof(fields[n].shortName), "%s", short_names[j]);
+                CODES_CHECK(codes_get_message(h, &msg, &len), 0);
+                Assert(fwrite(msg, 1, len, out) == len);
+                offset += len;
+                n++;
+            }
+        }
+    }
+    codes_handle_delete(h);
+    fclose(out);
+    return n;
+}
+
+/* Offsets of the fields of the fieldset, in its order */
+static size_t fieldset_offsets(codes_fieldset* set, long* offsets)
+{
+    int err = 0;
+    size_t n = 0;
+    codes_handle* h = NULL;
+    while ((h = codes_fieldset_next_handle(set, &err)) != NULL) {
+        Assert(n < MAX_FIELDS);
+        CODES_CHECK(codes_get_long(h, "offset", &offsets[n++]), 0);
+        codes_handle_delete(h);
+    }
+    Assert(n == (size_t)codes_fieldset_count(set));
+    return n;
+}
+
+static const field_keys* find_field(const field_keys* fields, size_t n, long offset)
+{
+    size_t i = 0;
+    for (i = 0; i < n; i++)
+        if (fields[i].offset == offset)
+            return &fields[i];
+    Assert(0);
+    return NULL;
+}
+
+int main(int argc, char** argv)
+{
+    static field_keys fields[MAX_FIELDS];
+    long offsets[MAX_FIELDS];
+    char filename[1024] = {0,};
+    const char* filenames[1];
+    const size_t nkeys = sizeof(keys) / sizeof(keys[0]);
+    size_t nfields = 0, ncases = sizeof(cases) / sizeof(cases[0]);
+    size_t i = 0, j = 0, n = 0, expected = 0;
+    codes_fieldset* set = NULL;
+    int err = 0;
+
+    Assert(argc == 2);
+    snprintf(filename, sizeof(filename), "%s.grib", argv[1]);
+    filenames[0] = filename;
+    nfields      = write_messages(filename, fields);
+
+    for (i = 0; i < ncases; i++) {
+        /* The fields in file order */
+        set = codes_fieldset_new_from_files(NULL, filenames, 1, keys, nkeys, cases[i].where, NULL, &err);
+        Assert(set && !err);
+        n        = fieldset_offsets(set, offsets);
+        expected = 0;
+        for (j = 0; j < nfields; j++) {
+            if (cases[i].p(&fields[j])) {
+                Assert(expected < n && offsets[expected] == fields[j].offset);
+                expected++;
+            }
+        }
+        if (n != expected) {
+            fprintf(stderr, "ERROR: where %s: %zu fields instead of %zu\n", cases[i].where, n, expected);
+            return 1;
+        }
+        printf("%s: %zu fields\n", cases[i].where, n);
+
+        /* Sorted on level then step descending */
+        codes_fieldset_apply_order_by(set, "level:l asc,step:l desc");
+        Assert(fieldset_offsets(set, offsets) == n);
+        for (j = 0; j < n; j++) {
+            const field_keys* k = find_field(fields, nfields, offsets[j]);
+            Assert(cases[i].p(k));
+            if (j > 0) {
+                const field_keys* prev = find_field(fields, nfields, offsets[j - 1]);
+                Assert(prev->level < k->level || (prev->level == k->level && prev->step >= k->step));
+            }
+        }
+        codes_fieldset_delete(set);
+    }
+
+    /* Where clause with order by, then another where clause on the same fieldset */
+    set = codes_fieldset_new_from_files(NULL, filenames, 1, keys, nkeys, "shortName == 't'", "step desc", &err);
+    Assert(set && !err);
+    n = fieldset_offsets(set, offsets);
+    Assert(n > 0);
+    for (j = 0; j < n; j++) {
+        const field_keys* k = find_field(fields, nfields, offsets[j]);
+        Assert(!strcmp(k->shortName, "t"));
+        if (j > 0)
+            Assert(find_field(fields, nfields, offsets[j - 1])->step >= k->step);
+    }
+    CODES_CHECK(grib_fieldset_apply_where(set, "level == 500"), 0);
+    n = fieldset_offsets(set, offsets);
+    for (j = 0, expected = 0; j < nfields; j++)
+        expected += (fields[j].level == 500);
+    Assert(n == expected);
+    for (j = 0; j < n; j++) {
+        const field_keys* k = find_field(fields, nfields, offsets[j]);
+        Assert(k->level == 500);
+        if (j > 0)
+            Assert(find_field(fields, nfields, offsets[j - 1])->step >= k->step);
+    }
+    codes_fieldset_delete(set);
+
+    /* Invalid clauses */
+    set = codes_fieldset_new_from_files(NULL, filenames, 1, keys, nkeys, "number == 1", NULL, &err);
+    Assert(!set && err == GRIB_MISSING_KEY);
+    set = codes_fieldset_new_from_files(NULL, filenames, 1, keys, nkeys, "level ==", NULL, &err);
+    Assert(!set && err == GRIB_INVALID_ARGUMENT);
+    set = codes_fieldset_new_from_files(NULL, filenames, 1, keys, nkeys, "(level == 1", NULL, &err);
+    Assert(!set && err == GRIB_INVALID_ARGUMENT);
+    set = codes_fieldset_new_from_files(NULL, filenames, 1, keys, nkeys, "shortName < 't'", NULL, &err);
+    Assert(!set && err == GRIB_INVALID_ARGUMENT);
+    set = codes_fieldset_new_from_files(NULL, filenames, 1, keys, nkeys, "level == 1 step", NULL, &err);
+    Assert(!set && err == GRIB_INVALID_ARGUMENT);
+
+    remove(filename);
+    return 0;
+}
@@ -0,0 +1,102 @@
+/*
+ * (C) Copyright 2005- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities granted to it by
+ * virtue of its status as an intergovernmental organisation nor does it submit to any jurisdiction.
+ */
+
+/*
+ * Check the Gaussian latitudes cached in the context are those computed, for more grids
+ * than the cache holds, and the iterators give the same points whether they are cached or not
+ */
+
+#include "eccodes.h"
+#include "grib_api_internal.h"
+
+static void check_latitudes(grib_context* c, long N)
+{
+    double* computed = (double*)malloc(2 * N * sizeof(double));
+    double* cached   = (double*)malloc(2 * N * sizeof(double));
+    double others[80];
+    Assert(computed && cached);
+
+    grib_gaussian_latitudes_cache_delete(c);
+    CODES_CHECK(grib_context_get_gaussian_latitudes(c, N, computed), 0);
+    CODES_CHECK(grib_context_get_gaussian_latitudes(c, N, cached), 0);
+    Assert(memcmp(computed, cached, 2 * N * sizeof(double)) == 0);
+
+    /* Others grids fill the cache */
+    for (long i = 1; i <= 40; i++) {
+        CODES_CHECK(grib_context_get_gaussian_latitudes(c, i, others), 0);
+        CODES_CHECK(grib_context_get_gaussian_latitudes(c, N, cached), 0);
+        Assert(memcmp(computed, cached, 2 * N * sizeof(double)) == 0);
+    }
+    CODES_CHECK(codes_get_gaussian_latitudes(N, cached), 0);
+    Assert(memcmp(computed, cached, 2 * N * sizeof(double)) == 0);
+
+    free(computed);
+    free(cached);
+}
+
+/* The points of the iterator of the sample */
+static size_t get_points(const char* sample, double** lats, double** lons)
+{
+    codes_handle* h = codes_grib_handle_new_from_samples(NULL, sample);
+    codes_iterator* iter = NULL;
+    size_t count = 0, i = 0;
+    int err = 0;
+    Assert(h);
+    CODES_CHECK(codes_get_size(h, "values", &count), 0);
+    *lats = (double*)malloc(count * sizeof(double));
+    *lons = (double*)malloc(count * sizeof(double));
+    Assert(*lats && *lons);
+    iter = codes_grib_iterator_new(h, 0, &err);
+    Assert(iter && !err);
+    for (i = 0; i < count; i++)
+        Assert(codes_grib_iterator_next(iter, &(*lats)[i], &(*lons)[i], NULL));
+    codes_grib_iterator_delete(iter);
+    codes_handle_delete(h);
+    return count;
+}
+
+static void check_iterator(grib_context* c, const char* sample)
+{
+    double *lats1 = NULL, *lons1 = NULL, *lats2 = NULL, *lons2 = NULL;
+    size_t count1 = 0, count2 = 0;
+
+    grib_gaussian_latitudes_cache_delete(c);
+    count1 = get_points(sample, &lats1, &lons1);
+    Assert(c->gaussian_latitudes);
+    count2 = get_points(sample, &lats2, &lons2);
+    Assert(count1 == count2);
+    Assert(memcmp(lats1, lats2, count1 * sizeof(double)) == 0);
+    Assert(memcmp(lons1, lons2, count1 * sizeof(double)) == 0);
+    printf("%s: %zu points\n", sample, count1);
+
+    free(lats1);
+    free(lons1);
+    free(lats2);
+    free(lons2);
+}
+
+int main(int argc, char** argv)
+{
+    grib_context* c = grib_context_get_default();
+    double lat      = 0;
+
+    check_latitudes(c, 1);
+    check_latitudes(c, 32);
+    check_latitudes(c, 640);
+    Assert(grib_context_get_gaussian_latitudes(c, 0, &lat) == GRIB_GEOCALCULUS_PROBLEM);
+
+    check_iterator(c, "reduced_gg_pl_48_grib2");
+    check_iterator(c, "reduced_gg_pl_320_grib1");
+    check_iterator(c, "regular_gg_pl_grib2");
+
+    grib_gaussian_latitudes_cache_delete(c);
+    Assert(c->gaussian_latitudes == NULL);
+    return 0;
+}
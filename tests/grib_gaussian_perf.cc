@@ -0,0 +1,96 @@
+/*
+ * (C) Copyright 2005- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities granted to it by
+ * virtue of its status as an intergovernmental organisation nor does it submit to any jurisdiction.
+ */
+
+/*
+ * Time of setting up the geoiterator of each field of a Gaussian grid: computing
+ * the latitudes for each field, as done before they were cached in the context,
+ * then reusing them for the fields on the same grid
+ */
+
+#include "grib_api_internal.h"
+
+#if ECCODES_TIMER
+
+void usage(char* prog)
+{
+    printf("usage: %s grib_file repetitions\n", prog);
+    exit(1);
+}
+
+static void iterator_setup(grib_handle* h)
+{
+    int err             = 0;
+    grib_iterator* iter = grib_iterator_new(h, 0, &err);
+    GRIB_CHECK(err, 0);
+    grib_iterator_delete(iter);
+}
+
+int main(int argc, char* argv[])
+{
+    grib_handle* h  = NULL;
+    grib_context* c = grib_context_get_default();
+    FILE* fin       = NULL;
+    grib_timer *tu, *tc;
+    int repeat = 0, i = 0, e = 0;
+    long N = 0;
+    char gridType[50] = {0,};
+    size_t len = sizeof(gridType);
+
+    if (argc != 3)
+        usage(argv[0]);
+    fin = fopen(argv[1], "rb");
+    if (!fin) {
+        perror(argv[1]);
+        exit(1);
+    }
+    repeat = atoi(argv[2]);
+    if (repeat < 1)
+        usage(argv[0]);
+
+    while ((h = grib_handle_new_from_file(c, fin, &e)) != NULL) {
+        len = sizeof(gridType);
+        GRIB_CHECK(grib_get_string(h, "gridType", gridType, &len), 0);
+        if (grib_get_long(h, "N", &N) != GRIB_SUCCESS) {
+            grib_handle_delete(h);
+            continue;
+        }
+        tu = grib_get_timer(c, "iterator setup, latitudes computed", 0, 1);
+        tc = grib_get_timer(c, "iterator setup, latitudes cached", 0, 1);
+        tu->timer_ = tc->timer_ = 0;
+
+        for (i = 0; i < repeat; i++) {
+            grib_gaussian_latitudes_cache_delete(c);
+            grib_timer_start(tu);
+            iterator_setup(h);
+            grib_timer_stop(tu, 0);
+        }
+        iterator_setup(h);
+        for (i = 0; i < repeat; i++) {
+            grib_timer_start(tc);
+            iterator_setup(h);
+            grib_timer_stop(tc, 0);
+        }
+        printf("%s N=%ld: per field %g s with the latitudes computed, %g s cached\n",
+               gridType, N, tu->timer_ / repeat, tc->timer_ / repeat);
+        grib_handle_delete(h);
+    }
+    GRIB_CHECK(e, 0);
+    fclose(fin);
+
+    return 0;
+}
+#else
+
+int main(int argc, char* argv[])
+{
+    return 0;
+}
+
+#endif
@@ -0,0 +1,133 @@
+/*
+ * (C) Copyright 2005- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities granted to it by
+ * virtue of its status as an intergovernmental organisation nor does it submit to any jurisdiction.
+ */
+
+/*
+ * Check the grid geometry of each message of the input has the coordinates of the geoiterator,
+ * is shared by the messages on the same grid and differs between the grids
+ */
+
+#include "eccodes.h"
+#include "grib_api_internal.h"
+
+#define MAX_MESSAGES 32
+
+static void check_latlons(codes_handle* h, codes_grid_geometry* g)
+{
+    double *lats = NULL, *lons = NULL, *values = NULL, *glats = NULL, *glons = NULL;
+    size_t count = 0, size = 0;
+
+    CODES_CHECK(codes_get_size(h, "values", &count), 0);
+    CODES_CHECK(codes_grid_geometry_get_size(g, &size), 0);
+    Assert(size == count);
+    lats   = (double*)malloc(count * sizeof(double));
+    lons   = (double*)malloc(count * sizeof(double));
+    values = (double*)malloc(count * sizeof(double));
+    glats  = (double*)malloc(count * sizeof(double));
+    glons  = (double*)malloc(count * sizeof(double));
+    Assert(lats && lons && values && glats && glons);
+
+    CODES_CHECK(codes_grib_get_data(h, lats, lons, values), 0);
+    size = count;
+    CODES_CHECK(codes_grid_geometry_get_latlons(g, glats, glons, &size), 0);
+    Assert(size == count);
+    Assert(memcmp(lats, glats, count * sizeof(double)) == 0);
+    Assert(memcmp(lons, glons, count * sizeof(double)) == 0);
+
+    /* The keys give them too */
+    size = count;
+    CODES_CHECK(codes_get_double_array(h, "latitudes", glats, &size), 0);
+    Assert(memcmp(lats, glats, count * sizeof(double)) == 0);
+    size = count;
+    CODES_CHECK(codes_get_double_array(h, "longitudes", glons, &size), 0);
+    Assert(memcmp(lons, glons, count * sizeof(double)) == 0);
+
+    /* Only the longitudes */
+    size = count;
+    CODES_CHECK(codes_grid_geometry_get_latlons(g, NULL, glons, &size), 0);
+    Assert(memcmp(lons, glons, count * sizeof(double)) == 0);
+    size = count - 1;
+    Assert(codes_grid_geometry_get_latlons(g, glats, glons, &size) == GRIB_ARRAY_TOO_SMALL);
+    Assert(size == count);
+
+    free(lats);
+    free(lons);
+    free(values);
+    free(glats);
+    free(glons);
+}
+
+int main(int argc, char** argv)
+{
+    grib_context* c                         = grib_context_get_default();
+    codes_grid_geometry* geometries[MAX_MESSAGES] = {0,};
+    codes_handle* h                         = NULL;
+    FILE* in                                = NULL;
+    int err = 0, m = 0, i = 0, j = 0;
+
+    Assert(argc == 2);
+    in = fopen(argv[1], "rb");
+    Assert(in);
+    while ((h = codes_handle_new_from_file(NULL, in, PRODUCT_GRIB, &err)) != NULL) {
+        codes_handle* clone    = NULL;
+        codes_grid_geometry* g = NULL;
+        char gridType[64]      = {0,};
+        size_t len             = sizeof(gridType);
+        long isRotated         = 0;
+        Assert(m < MAX_MESSAGES);
+
+        CODES_CHECK(codes_get_string(h, "gridType", gridType, &len), 0);
+        geometries[m] = codes_grid_geometry_new_from_handle(h, &err);
+        Assert(geometries[m] && !err);
+        check_latlons(h, geometries[m]);
+
+        /* Another field on the same grid shares the geometry */
+        clone = codes_handle_clone(h);
+        CODES_CHECK(codes_set_long(clone, "step", 12), 0);
+        g = codes_grid_geometry_new_from_handle(clone, &err);
+        Assert(g && !err);
+        Assert(g == geometries[m]);
+        Assert(codes_grid_geometry_equal(g, geometries[m]));
+        CODES_CHECK(codes_grid_geometry_delete(g), 0);
+
+        /* The coordinates of a rotated grid before unrotating are its own */
+        if (codes_get_long(h, "isRotatedGrid", &isRotated) == 0 && isRotated) {
+            CODES_CHECK(codes_set_long(clone, "iteratorDisableUnrotate", 1), 0);
+            g = codes_grid_geometry_new_from_handle(clone, &err);
+            Assert(g && !err);
+            Assert(!g->fingerprint);
+            Assert(!codes_grid_geometry_equal(g, geometries[m]));
+            check_latlons(clone, g);
+            CODES_CHECK(codes_grid_geometry_delete(g), 0);
+        }
+        codes_handle_delete(clone);
+
+        printf("%s: %zu points OK\n", gridType, geometries[m]->count);
+        codes_handle_delete(h);
+        m++;
+    }
+    fclose(in);
+    Assert(m > 1);
+
+    /* The grids of the input all differ */
+    for (i = 0; i < m; i++)
+        for (j = 0; j < m; j++)
+            Assert(codes_grid_geometry_equal(geometries[i], geometries[j]) == (i == j));
+
+    /* The geometries outlive the cache */
+    grib_grid_geometry_cache_delete(c);
+    Assert(c->grid_geometries == NULL);
+    for (i = 0; i < m; i++) {
+        Assert(geometries[i]->refcount == 1);
+        CODES_CHECK(codes_grid_geometry_delete(geometries[i]), 0);
+    }
+    Assert(codes_grid_geometry_delete(NULL) == GRIB_INVALID_ARGUMENT);
+    Assert(codes_grid_geometry_new_from_handle(NULL, &err) == NULL && err == GRIB_INVALID_ARGUMENT);
+    return 0;
+}
@@ -0,0 +1,28 @@
+#!/bin/sh
+# (C) Copyright 2005- ECMWF.
+#
+# This software is licensed under the terms of the Apache Licence Version 2.0
+# which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+#
+# In applying this licence, ECMWF does not waive the privileges and immunities granted to it by
+# virtue of its status as an intergovernmental organisation nor does it submit to any jurisdiction.
+#
+
+. ./include.ctest.sh
+
+label="grib_grid_geometry_test"
+tempGrib="temp.${label}.grib"
+
+# Grids of the samples, all different
+cat $ECCODES_SAMPLES_PATH/GRIB1.tmpl \
+    $ECCODES_SAMPLES_PATH/GRIB2.tmpl \
+    $ECCODES_SAMPLES_PATH/reduced_gg_pl_32_grib1.tmpl \
+    $ECCODES_SAMPLES_PATH/reduced_gg_pl_48_grib2.tmpl \
+    $ECCODES_SAMPLES_PATH/regular_gg_pl_grib2.tmpl \
+    $ECCODES_SAMPLES_PATH/rotated_ll_sfc_grib2.tmpl \
+    $ECCODES_SAMPLES_PATH/polar_stereographic_sfc_grib2.tmpl > $tempGrib
+
+$EXEC ${test_dir}/grib_grid_geometry $tempGrib
+
+# Clean up
+rm -f $tempGrib
@@ -0,0 +1,105 @@
+/*
+ * (C) Copyright 2005- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities granted to it by
+ * virtue of its status as an intergovernmental organisation nor does it submit to any jurisdiction.
+ */
+
+/*
+ * The accessors of a handle are in its arena: the chunks of a deleted handle are reused by the
+ * next one, and the arena of a handle does not grow when its sections are built again
+ */
+
+#include "grib_api_internal.h"
+
+static void test_chunks_reused(grib_context* c, const char* sample)
+{
+    grib_handle* h = grib_handle_new_from_samples(c, sample);
+    size_t kept = 0, size = 0;
+    Assert(h && h->arena);
+    size = grib_arena_size(h->arena);
+    Assert(size > 0);
+    grib_handle_delete(h);
+
+    /* The next handle takes the chunks the context kept */
+    kept = c->arena_chunks_count;
+    Assert(kept > 0);
+    h = grib_handle_new_from_samples(c, sample);
+    Assert(h && grib_arena_size(h->arena) == size);
+    Assert(c->arena_chunks_count < kept);
+    grib_handle_delete(h);
+    Assert(c->arena_chunks_count == kept);
+    printf("%s: %zu bytes of arena, reused\n", sample, size);
+}
+
+/* The accessors of a reparsed section, built in a temporary handle, are in the arena of the main one */
+static void test_section_reparsed(grib_context* c)
+{
+    grib_handle* h = grib_handle_new_from_samples(c, "GRIB2");
+    size_t size = 0, len = 0;
+    long pdtn = 0, number = 0;
+    int i = 0;
+    char shortName[64];
+
+    Assert(h);
+    GRIB_CHECK(grib_set_long(h, "productDefinitionTemplateNumber", 1), 0);
+    GRIB_CHECK(grib_set_long(h, "productDefinitionTemplateNumber", 0), 0);
+    size = grib_arena_size(h->arena);
+
+    /* The accessors of the sections deleted are reused: only the dependencies, kept until
+     * the handle is deleted, take more of the arena */
+    for (i = 0; i < 100; i++) {
+        GRIB_CHECK(grib_set_long(h, "productDefinitionTemplateNumber", 1), 0);
+        GRIB_CHECK(grib_set_long(h, "perturbationNumber", i), 0);
+        GRIB_CHECK(grib_set_long(h, "productDefinitionTemplateNumber", 0), 0);
+    }
+    Assert(grib_arena_size(h->arena) < 2 * size);
+
+    GRIB_CHECK(grib_set_long(h, "productDefinitionTemplateNumber", 1), 0);
+    GRIB_CHECK(grib_set_long(h, "number", 7), 0);
+    GRIB_CHECK(grib_get_long(h, "productDefinitionTemplateNumber", &pdtn), 0);
+    GRIB_CHECK(grib_get_long(h, "number", &number), 0);
+    Assert(pdtn == 1 && number == 7);
+    len = sizeof(shortName);
+    GRIB_CHECK(grib_get_string(h, "shortName", shortName, &len), 0);
+    grib_handle_delete(h);
+    printf("GRIB2: sections reparsed, %zu bytes of arena\n", size);
+}
+
+/* The data accessors of BUFR are built again at each unpack */
+static void test_bufr_unpacked(grib_context* c)
+{
+    grib_handle* h = codes_bufr_handle_new_from_samples(c, "BUFR4");
+    size_t size = 0;
+    int i = 0;
+
+    Assert(h);
+    GRIB_CHECK(grib_set_long(h, "unpack", 1), 0);
+    GRIB_CHECK(grib_set_long(h, "unpack", 1), 0);
+    size = grib_arena_size(h->arena);
+    for (i = 0; i < 100; i++)
+        GRIB_CHECK(grib_set_long(h, "unpack", 1), 0);
+    Assert(grib_arena_size(h->arena) == size);
+    grib_handle_delete(h);
+    printf("BUFR4: unpacked again, %zu bytes of arena\n", size);
+}
+
+int main(int argc, char** argv)
+{
+    grib_context* c = grib_context_get_default();
+
+    /* The handles deleted, none kept as skeletons */
+    c->handle_skeletons_max = 0;
+    test_chunks_reused(c, "GRIB1");
+    test_chunks_reused(c, "GRIB2");
+    test_chunks_reused(c, "reduced_gg_pl_320_grib2");
+    test_section_reparsed(c);
+    test_bufr_unpacked(c);
+
+    grib_arena_chunks_delete(c);
+    Assert(c->arena_chunks == NULL && c->arena_chunks_count == 0);
+    return 0;
+}
@@ -0,0 +1,93 @@
+/*
+ * (C) Copyright 2005- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities granted to it by
+ * virtue of its status as an intergovernmental organisation nor does it submit to any jurisdiction.
+ */
+
+/*
+ * Time of creating and deleting the handle of each message of a file, the messages
+ * being in memory: mostly that of building and releasing the accessor trees
+ */
+
+#include "grib_api_internal.h"
+
+#if ECCODES_TIMER
+
+void usage(char* prog)
+{
+    printf("usage: %s file repetitions\n", prog);
+    exit(1);
+}
+
+int main(int argc, char* argv[])
+{
+    grib_context* c = grib_context_get_default();
+    grib_handle* h  = NULL;
+    FILE* fin       = NULL;
+    grib_timer* t   = NULL;
+    void** messages = NULL;
+    size_t* sizes   = NULL;
+    size_t count = 0, capacity = 0, i = 0;
+    int repeat = 0, r = 0, e = 0;
+
+    if (argc != 3)
+        usage(argv[0]);
+    fin = fopen(argv[1], "rb");
+    if (!fin) {
+        perror(argv[1]);
+        exit(1);
+    }
+    repeat = atoi(argv[2]);
+    if (repeat < 1)
+        usage(argv[0]);
+
+    while ((h = codes_handle_new_from_file(c, fin, PRODUCT_ANY, &e)) != NULL) {
+        const void* msg = NULL;
+        size_t size     = 0;
+        if (count == capacity) {
+            capacity = capacity ? 2 * capacity : 64;
+            messages = (void**)realloc(messages, capacity * sizeof(void*));
+            sizes    = (size_t*)realloc(sizes, capacity * sizeof(size_t));
+            Assert(messages && sizes);
+        }
+        GRIB_CHECK(grib_get_message(h, &msg, &size), 0);
+        messages[count] = malloc(size);
+        Assert(messages[count]);
+        memcpy(messages[count], msg, size);
+        sizes[count++] = size;
+        grib_handle_delete(h);
+    }
+    GRIB_CHECK(e, 0);
+    fclose(fin);
+
+    t = grib_get_timer(c, "handle create and delete", 0, 1);
+    t->timer_ = 0;
+    for (r = 0; r < repeat; r++) {
+        for (i = 0; i < count; i++) {
+            grib_timer_start(t);
+            h = grib_handle_new_from_message(c, messages[i], sizes[i]);
+            Assert(h);
+            grib_handle_delete(h);
+            grib_timer_stop(t, 0);
+        }
+    }
+    printf("%zu messages: %g s per handle created and deleted\n", count, t->timer_ / (repeat * count));
+
+    for (i = 0; i < count; i++)
+        free(messages[i]);
+    free(messages);
+    free(sizes);
+    return 0;
+}
+#else
+
+int main(int argc, char* argv[])
+{
+    return 0;
+}
+
+#endif
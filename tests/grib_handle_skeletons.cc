@@ -0,0 +1,193 @@
+/*
+ * (C) Copyright 2005- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities granted to it by
+ * virtue of its status as an intergovernmental organisation nor does it submit to any jurisdiction.
+ */
+
+/*
+ * The handles deleted unchanged are kept as skeletons for the next messages of the same layout:
+ * the keys of a message are the same, whether its handle is built or bound to a skeleton
+ */
+
+#include "grib_api_internal.h"
+
+#define MAX_MESSAGES 256
+
+typedef struct text
+{
+    char* s;
+    size_t len;
+    size_t capacity;
+} text;
+
+static void text_add(text* t, const char* s)
+{
+    size_t n = strlen(s);
+    if (t->len + n + 1 > t->capacity) {
+        t->capacity = 2 * (t->len + n + 1);
+        t->s        = (char*)realloc(t->s, t->capacity);
+        Assert(t->s);
+    }
+    memcpy(t->s + t->len, s, n + 1);
+    t->len += n;
+}
+
+/* The values of all the keys of the handle, the arrays summed up */
+static char* dump_keys(grib_handle* h)
+{
+    grib_keys_iterator* kiter = grib_keys_iterator_new(h, GRIB_KEYS_ITERATOR_ALL_KEYS, NULL);
+    text t                    = {0,};
+    char line[1100];
+    Assert(kiter);
+    text_add(&t, "");
+
+    while (grib_keys_iterator_next(kiter)) {
+        const char* name = grib_keys_iterator_get_name(kiter);
+        char value[1024] = {0,};
+        size_t len = sizeof(value), size = 0;
+        int type = 0, err = 0;
+
+        err = grib_get_size(h, name, &size);
+        if (!err)
+            err = grib_get_native_type(h, name, &type);
+        if (!err && size > 1 && (type == GRIB_TYPE_DOUBLE || type == GRIB_TYPE_LONG)) {
+            double* values = (double*)malloc(size * sizeof(double));
+            double sum     = 0;
+            size_t i       = 0;
+            Assert(values);
+            err = grib_get_double_array(h, name, values, &size);
+            for (i = 0; !err && i < size; i++)
+                sum += values[i];
+            snprintf(line, sizeof(line), "%s=[%zu %.17g %.17g %.17g] %d\n", name, size,
+                     err ? 0 : values[0], err ? 0 : values[size - 1], sum, err);
+            free(values);
+        }
+        else if (!err && size <= 1) {
+            err = grib_get_string(h, name, value, &len);
+            snprintf(line, sizeof(line), "%s=%s %d\n", name, err ? "" : value, err);
+        }
+        else {
+            snprintf(line, sizeof(line), "%s size=%zu %d\n", name, size, err);
+        }
+        text_add(&t, line);
+    }
+    grib_keys_iterator_delete(kiter);
+    return t.s;
+}
+
+static void check_same_keys(const char* expected, grib_handle* h, size_t i)
+{
+    char* keys = dump_keys(h);
+    if (strcmp(expected, keys) != 0) {
+        const char* e = expected;
+        const char* k = keys;
+        while (*e && *e == *k) {
+            e++;
+            k++;
+        }
+        while (e > expected && e[-1] != '\n') {
+            e--;
+            k--;
+        }
+        fprintf(stderr, "Message %zu: keys differ with a skeleton\n  expected: %.200s\n  got:      %.200s\n", i, e, k);
+        Assert(!"Keys differ");
+    }
+    free(keys);
+}
+
+int main(int argc, char** argv)
+{
+    grib_context* c = grib_context_get_default();
+    grib_handle* h  = NULL;
+    void* messages[MAX_MESSAGES];
+    size_t sizes[MAX_MESSAGES];
+    char* keys[MAX_MESSAGES];
+    size_t count = 0, i = 0, kept = 0, reused = 0, n = 0;
+    int a = 0, e = 0, max = 4;
+
+    /* The messages of the files, built without skeletons */
+    c->handle_skeletons_max = 0;
+    for (a = 1; a < argc; a++) {
+        FILE* f = fopen(argv[a], "rb");
+        if (!f) {
+            perror(argv[a]);
+            return 1;
+        }
+        while ((h = grib_handle_new_from_file(c, f, &e)) != NULL) {
+            const void* msg = NULL;
+            Assert(count < MAX_MESSAGES);
+            GRIB_CHECK(grib_get_message(h, &msg, &sizes[count]), 0);
+            messages[count] = malloc(sizes[count]);
+            Assert(messages[count]);
+            memcpy(messages[count], msg, sizes[count]);
+            grib_handle_delete(h);
+
+            h = grib_handle_new_from_message(c, messages[count], sizes[count]);
+            Assert(h && !h->layout);
+            keys[count++] = dump_keys(h);
+            grib_handle_delete(h);
+        }
+        GRIB_CHECK(e, 0);
+        fclose(f);
+    }
+    Assert(c->handle_skeletons == NULL);
+    c->handle_skeletons_max = max;
+
+    /* Each message bound to the skeleton of its own handle */
+    for (i = 0; i < count; i++) {
+        grib_handle* skeleton = grib_handle_new_from_message(c, messages[i], sizes[i]);
+        grib_handle_delete(skeleton);
+        if (c->handle_skeletons != skeleton)
+            continue;
+        kept++;
+        h = grib_handle_new_from_message(c, messages[i], sizes[i]);
+        Assert(h == skeleton);
+        check_same_keys(keys[i], h, i);
+        grib_handle_delete(h);
+    }
+    printf("%zu messages, %zu handles kept\n", count, kept);
+    Assert(kept > 0);
+
+    /* Each message bound to the skeleton of another one of the same length */
+    for (i = 0; i < count; i++) {
+        size_t before = c->handle_skeletons_count;
+        h             = grib_handle_new_from_message(c, messages[i], sizes[i]);
+        Assert(h);
+        if (c->handle_skeletons_count < before)
+            reused++;
+        check_same_keys(keys[i], h, i);
+        grib_handle_delete(h);
+        Assert(c->handle_skeletons_count <= (size_t)max);
+    }
+    printf("%zu messages bound to a skeleton\n", reused);
+    Assert(reused > 0);
+
+    /* A handle changed is not kept */
+    for (i = 0; i < count; i++) {
+        long edition = 0;
+        h            = grib_handle_new_from_message(c, messages[i], sizes[i]);
+        GRIB_CHECK(grib_get_long(h, "edition", &edition), 0);
+        if (edition != 2) {
+            grib_handle_delete(h);
+            continue;
+        }
+        GRIB_CHECK(grib_set_long(h, "scaledValueOfFirstFixedSurface", 1), 0);
+        n = c->handle_skeletons_count;
+        grib_handle_delete(h);
+        Assert(c->handle_skeletons_count == n);
+        break;
+    }
+
+    grib_handle_skeletons_delete(c);
+    Assert(c->handle_skeletons == NULL && c->handle_skeletons_count == 0);
+
+    for (i = 0; i < count; i++) {
+        free(messages[i]);
+        free(keys[i]);
+    }
+    return 0;
+}
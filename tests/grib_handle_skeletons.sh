@@ -0,0 +1,42 @@
+#!/bin/sh
+# (C) Copyright 2005- ECMWF.
+#
+# This software is licensed under the terms of the Apache Licence Version 2.0
+# which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+#
+# In applying this licence, ECMWF does not waive the privileges and immunities granted to it by
+# virtue of its status as an intergovernmental organisation nor does it submit to any jurisdiction.
+#
+
+. ./include.ctest.sh
+
+label="grib_handle_skeletons_test"
+tempGrib="temp.${label}.grib"
+tempSample="temp.${label}.sample.grib"
+
+# Messages of the same length with other values, some changing the layout
+rm -f $tempGrib
+for sample in GRIB1 GRIB2 reduced_gg_pl_32_grib2 regular_ll_pl_grib2; do
+    input=$ECCODES_SAMPLES_PATH/$sample.tmpl
+    cat $input >> $tempGrib
+    ${tools_dir}/grib_set -s paramId=130,level=500 $input $tempSample
+    cat $tempSample >> $tempGrib
+    ${tools_dir}/grib_set -s paramId=167,typeOfLevel=surface $input $tempSample
+    cat $tempSample >> $tempGrib
+    ${tools_dir}/grib_set -s dataDate=20240229,stepRange=12-24 $input $tempSample
+    cat $tempSample >> $tempGrib
+done
+${tools_dir}/grib_set -s productDefinitionTemplateNumber=1,number=3 $ECCODES_SAMPLES_PATH/GRIB2.tmpl $tempSample
+cat $tempSample >> $tempGrib
+
+# Some samples of other grids and packings, the spectral ones not being kept
+samples=""
+for sample in regular_ll_sfc_grib1 regular_ll_sfc_grib2 gg_sfc_grib1 gg_sfc_grib2 \
+              reduced_gg_pl_32_grib1 sh_sfc_grib1 sh_ml_grib2 polar_stereographic_pl_grib2; do
+    samples="$samples $ECCODES_SAMPLES_PATH/$sample.tmpl"
+done
+
+$EXEC ${test_dir}/grib_handle_skeletons $tempGrib $samples
+
+# Clean up
+rm -f $tempGrib $tempSample
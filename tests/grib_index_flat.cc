@@ -0,0 +1,192 @@
+/*
+ * (C) Copyright 2005- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities granted to it by
+ * virtue of its status as an intergovernmental organisation nor does it submit to any jurisdiction.
+ */
+
+/*
+ * Check an index written in the flat format (version 2) and read back selects the same
+ * fields as the index it was written from and as the same index in the old format.
+ */
+
+#include "eccodes.h"
+#include "grib_api_internal.h"
+
+#define MAX_KEYS   8
+#define MAX_VALUES 64
+#define MAX_FIELDS 1000
+
+typedef struct key_values
+{
+    const char* name;
+    char* values[MAX_VALUES];
+    size_t count;
+} key_values;
+
+static void check_identifier(const char* filename, const char* expected)
+{
+    char buf[8] = {0,};
+    FILE* f     = fopen(filename, "rb");
+    Assert(f);
+    Assert(fread(buf, 1, 8, f) == 8);
+    fclose(f);
+    if (memcmp(buf + 1, expected, 7) != 0) {
+        fprintf(stderr, "ERROR: %s: expected identifier %s\n", filename, expected);
+        exit(1);
+    }
+}
+
+static int same_files(const char* filename1, const char* filename2)
+{
+    FILE* f1 = fopen(filename1, "rb");
+    FILE* f2 = fopen(filename2, "rb");
+    int c1 = 0, c2 = 0;
+    Assert(f1 && f2);
+    do {
+        c1 = fgetc(f1);
+        c2 = fgetc(f2);
+    } while (c1 == c2 && c1 != EOF);
+    fclose(f1);
+    fclose(f2);
+    return c1 == c2;
+}
+
+/* Offsets of the fields selected by the current values of the keys */
+static size_t select_fields(codes_index* index, const key_values* keys, size_t nkeys, const size_t* which, long* offsets)
+{
+    size_t i = 0, n = 0;
+    int err = 0;
+    codes_handle* h = NULL;
+
+    for (i = 0; i < nkeys; i++)
+        CODES_CHECK(codes_index_select_string(index, keys[i].name, keys[i].values[which[i]]), 0);
+    while ((h = codes_handle_new_from_index(index, &err)) != NULL) {
+        Assert(n < MAX_FIELDS);
+        CODES_CHECK(codes_get_long(h, "offset", &offsets[n]), 0);
+        n++;
+        codes_handle_delete(h);
+    }
+    Assert(err == GRIB_END_OF_INDEX);
+    return n;
+}
+
+int main(int argc, char** argv)
+{
+    const char* infile  = NULL;
+    const char* keylist = NULL;
+    const char* outfile = NULL;
+    char filename[1024] = {0,};
+    char names[1024]    = {0,};
+    char* name          = NULL;
+    char* last          = NULL;
+    key_values keys[MAX_KEYS];
+    size_t which[MAX_KEYS] = {0,};
+    long offsets[3][MAX_FIELDS];
+    codes_index* indexes[3] = {0,}; /* in memory, old format, flat format */
+    size_t nkeys = 0, total = 0, i = 0, j = 0, n = 0;
+    int err = 0, done = 0;
+
+    if (argc != 4) {
+        fprintf(stderr, "usage: %s file keys index\n", argv[0]);
+        return 1;
+    }
+    infile  = argv[1];
+    keylist = argv[2];
+    outfile = argv[3];
+
+    indexes[0] = codes_index_new_from_file(NULL, infile, keylist, &err);
+    Assert(indexes[0] && !err);
+
+    /* Old format */
+    snprintf(filename, sizeof(filename), "%s.v1", outfile);
+    setenv("ECCODES_INDEX_FORMAT_VERSION", "1", 1);
+    CODES_CHECK(codes_index_write(indexes[0], filename), 0);
+    unsetenv("ECCODES_INDEX_FORMAT_VERSION");
+    check_identifier(filename, "GRBIDX1");
+    indexes[1] = codes_index_read(NULL, filename, &err);
+    Assert(indexes[1] && !err);
+    Assert(indexes[1]->flat == NULL);
+
+    /* Flat format is the default */
+    CODES_CHECK(codes_index_write(indexes[0], outfile), 0);
+    check_identifier(outfile, "GRBIDX2");
+    indexes[2] = codes_index_read(NULL, outfile, &err);
+    Assert(indexes[2] && !err);
+    Assert(indexes[2]->flat != NULL && indexes[2]->fields == NULL);
+    Assert(indexes[2]->count == indexes[0]->count);
+
+    /* Same keys and values */
+    snprintf(names, sizeof(names), "%s", keylist);
+    for (name = strtok_r(names, ",", &last); name; name = strtok_r(NULL, ",", &last)) {
+        char* colon = strchr(name, ':');
+        if (colon) *colon = 0;
+        Assert(nkeys < MAX_KEYS);
+        keys[nkeys].name  = name;
+        keys[nkeys].count = MAX_VALUES;
+        CODES_CHECK(codes_index_get_string(indexes[0], name, keys[nkeys].values, &keys[nkeys].count), 0);
+        for (i = 1; i < 3; i++) {
+            char* values[MAX_VALUES] = {0,};
+            size_t count = MAX_VALUES;
+            CODES_CHECK(codes_index_get_string(indexes[i], name, values, &count), 0);
+            Assert(count == keys[nkeys].count);
+            for (j = 0; j < count; j++) {
+                Assert(strcmp(values[j], keys[nkeys].values[j]) == 0);
+                free(values[j]);
+            }
+        }
+        nkeys++;
+    }
+
+    /* Every combination of values selects the same fields in the same order */
+    while (!done) {
+        size_t count[3] = {0,};
+        for (i = 0; i < 3; i++)
+            count[i] = select_fields(indexes[i], keys, nkeys, which, offsets[i]);
+        for (i = 1; i < 3; i++) {
+            Assert(count[i] == count[0]);
+            for (j = 0; j < count[0]; j++)
+                Assert(offsets[i][j] == offsets[0][j]);
+        }
+        total += count[0];
+
+        /* Next combination */
+        for (i = 0; i < nkeys; i++) {
+            if (++which[i] < keys[i].count)
+                break;
+            which[i] = 0;
+        }
+        done = (i == nkeys);
+    }
+    Assert(total == (size_t)indexes[0]->count);
+
+    /* Unknown value */
+    CODES_CHECK(codes_index_select_string(indexes[2], keys[0].name, "no such value"), 0);
+    Assert(codes_handle_new_from_index(indexes[2], &err) == NULL && err == GRIB_END_OF_INDEX);
+
+    /* Writing the flat index again gives the same file */
+    snprintf(filename, sizeof(filename), "%s.again", outfile);
+    CODES_CHECK(codes_index_write(indexes[2], filename), 0);
+    Assert(indexes[2]->flat == NULL);
+    Assert(same_files(outfile, filename));
+
+    /* Then it can be selected from as a tree */
+    for (i = 0; i < nkeys; i++)
+        which[i] = keys[i].count - 1;
+    n = select_fields(indexes[2], keys, nkeys, which, offsets[2]);
+    Assert(n == select_fields(indexes[0], keys, nkeys, which, offsets[0]));
+    for (j = 0; j < n; j++)
+        Assert(offsets[2][j] == offsets[0][j]);
+
+    printf("%s: %s: %zu fields, %zu keys OK\n", infile, keylist, total, nkeys);
+
+    for (i = 0; i < nkeys; i++)
+        for (j = 0; j < keys[i].count; j++)
+            free(keys[i].values[j]);
+    for (i = 0; i < 3; i++)
+        codes_index_delete(indexes[i]);
+    return 0;
+}
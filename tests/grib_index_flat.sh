@@ -0,0 +1,67 @@
+#!/bin/sh
+# (C) Copyright 2005- ECMWF.
+#
+# This software is licensed under the terms of the Apache Licence Version 2.0
+# which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+#
+# In applying this licence, ECMWF does not waive the privileges and immunities granted to it by
+# virtue of its status as an intergovernmental organisation nor does it submit to any jurisdiction.
+#
+
+. ./include.ctest.sh
+
+label="grib_index_flat_test"
+tempGrib=temp.$label.grib
+tempBufr=temp.$label.bufr
+tempIndex=temp.$label.idx
+tempIndex1=temp.$label.1.idx
+tempOut=temp.$label.out
+tempRef=temp.$label.ref
+
+rm -f $tempGrib
+for level in 1000 850 500; do
+    for step in 0 6 12; do
+        ${tools_dir}/grib_set -s typeOfLevel=isobaricInhPa,level=$level,step=$step \
+            $ECCODES_SAMPLES_PATH/GRIB2.tmpl $tempOut
+        cat $tempOut >> $tempGrib
+    done
+done
+# Several fields with the same keys
+cat $tempGrib $ECCODES_SAMPLES_PATH/GRIB1.tmpl $tempGrib $ECCODES_SAMPLES_PATH/reduced_gg_pl_32_grib2.tmpl > $tempOut
+mv $tempOut $tempGrib
+
+# Selections from the flat index, the old format and the index in memory
+$EXEC ${test_dir}/grib_index_flat $tempGrib "level,step,edition" $tempIndex
+$EXEC ${test_dir}/grib_index_flat $tempGrib "shortName,step:l,level:d" $tempIndex
+$EXEC ${test_dir}/grib_index_flat $tempGrib "edition" $tempIndex
+$EXEC ${test_dir}/grib_index_flat $tempGrib "mars.step,mars.levelist,mars.param" $tempIndex
+
+# The tools read both formats the same way
+${tools_dir}/grib_index_build -N -o $tempIndex $tempGrib > /dev/null
+ECCODES_INDEX_FORMAT_VERSION=1 ${tools_dir}/grib_index_build -N -o $tempIndex1 $tempGrib > /dev/null
+# Remove the first line with the name of the index file
+${tools_dir}/grib_dump $tempIndex | sed '1d' > $tempOut
+${tools_dir}/grib_dump $tempIndex1 | sed '1d' > $tempRef
+diff $tempRef $tempOut
+grep -q "Index count = 20" $tempOut
+${tools_dir}/grib_compare $tempIndex $tempIndex1
+
+# BUFR
+cat $ECCODES_SAMPLES_PATH/BUFR4.tmpl $ECCODES_SAMPLES_PATH/BUFR3_local.tmpl $ECCODES_SAMPLES_PATH/BUFR4.tmpl > $tempBufr
+${tools_dir}/bufr_index_build -N -o $tempIndex $tempBufr > /dev/null
+ECCODES_INDEX_FORMAT_VERSION=1 ${tools_dir}/bufr_index_build -N -o $tempIndex1 $tempBufr > /dev/null
+${tools_dir}/bufr_dump $tempIndex > $tempOut
+${tools_dir}/bufr_dump $tempIndex1 > $tempRef
+diff $tempRef $tempOut
+grep -q "BUFR File: $tempBufr" $tempOut
+
+# Corrupted index
+${tools_dir}/grib_index_build -N -o $tempIndex $tempGrib > /dev/null
+head -c 60 $tempIndex > $tempIndex1
+set +e
+${tools_dir}/grib_dump $tempIndex1 > $tempOut 2>&1
+status=$?
+set -e
+[ $status -ne 0 ]
+
+rm -f $tempGrib $tempBufr $tempIndex $tempIndex1 $tempIndex.v1 $tempIndex.again $tempOut $tempRef
@@ -0,0 +1,144 @@
+/*
+ * (C) Copyright 2005- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities granted to it by
+ * virtue of its status as an intergovernmental organisation nor does it submit to any jurisdiction.
+ */
+
+/*
+ * Check handles on the headers only agree with the fully decoded messages.
+ * If keys are given, also check the fields of an index and a fieldset on them.
+ */
+
+#include "eccodes.h"
+#include "grib_api_internal.h"
+
+#define MAX_MESSAGES 100
+#define MAX_KEYS 20
+
+static const char* keys[] = { "edition", "totalLength", "offset", "md5Headers", "shortName", "level", "step", "dataDate" };
+
+static off_t offsets[MAX_MESSAGES];
+static long lengths[MAX_MESSAGES];
+static int num_messages = 0;
+
+static void check_field(const grib_field* field)
+{
+    int i = 0;
+    for (i = 0; i < num_messages; i++) {
+        if (offsets[i] == field->offset) {
+            Assert(lengths[i] == field->length);
+            return;
+        }
+    }
+    Assert(!"Field at unknown offset");
+}
+
+static int check_field_tree(const grib_field_tree* tree)
+{
+    int n = 0;
+    for (; tree; tree = tree->next) {
+        const grib_field* field = tree->field;
+        for (; field; field = field->next) {
+            check_field(field);
+            n++;
+        }
+        n += check_field_tree(tree->next_level);
+    }
+    return n;
+}
+
+static void check_index(const char* filename, const char* index_keys)
+{
+    int err           = 0;
+    grib_index* index = grib_index_new_from_file(NULL, filename, index_keys, &err);
+    Assert(index && !err);
+    Assert(index->count == num_messages);
+    Assert(check_field_tree(index->fields) == num_messages);
+    grib_index_delete(index);
+}
+
+static void check_fieldset(const char* filename, const char* fieldset_keys)
+{
+    int err = 0, nkeys = 0, i = 0;
+    const char* names[MAX_KEYS] = {0,};
+    char* copy = strdup(fieldset_keys);
+    char* p    = NULL;
+    char* lasts = NULL;
+    grib_fieldset* set = NULL;
+
+    for (p = strtok_r(copy, ",", &lasts); p && nkeys < MAX_KEYS; p = strtok_r(NULL, ",", &lasts))
+        names[nkeys++] = p;
+
+    set = grib_fieldset_new_from_files(NULL, &filename, 1, names, nkeys, NULL, NULL, &err);
+    Assert(set && !err);
+    Assert(grib_fieldset_count(set) == num_messages);
+    for (i = 0; i < num_messages; i++) {
+        Assert(set->fields[i]->offset == offsets[i]);
+        Assert(set->fields[i]->length == lengths[i]);
+    }
+    grib_fieldset_delete(set);
+    free(copy);
+}
+
+int main(int argc, char** argv)
+{
+    int err = 0;
+    size_t i = 0;
+    FILE* in1 = NULL;
+    FILE* in2 = NULL;
+    grib_handle* h  = NULL;
+    grib_handle* hh = NULL;
+
+    Assert(argc == 2 || argc == 3);
+    in1 = fopen(argv[1], "rb");
+    in2 = fopen(argv[1], "rb");
+    Assert(in1 && in2);
+
+    while ((h = grib_new_from_file(NULL, in1, /*headers_only=*/0, &err)) != NULL) {
+        Assert(num_messages < MAX_MESSAGES);
+        hh = grib_new_from_file(NULL, in2, /*headers_only=*/1, &err);
+        Assert(hh && !err);
+        Assert(hh->partial);
+        /* Reading the headers skips the rest of the message */
+        Assert(ftello(in2) <= ftello(in1) && ftello(in1) <= ftello(in2) + 1);
+
+        for (i = 0; i < sizeof(keys) / sizeof(keys[0]); i++) {
+            char v1[1024] = {0,}, v2[1024] = {0,};
+            size_t len1 = sizeof(v1), len2 = sizeof(v2);
+            CODES_CHECK(codes_get_string(h, keys[i], v1, &len1), 0);
+            CODES_CHECK(codes_get_string(hh, keys[i], v2, &len2), 0);
+            if (strcmp(v1, v2) != 0) {
+                fprintf(stderr, "ERROR: message %d: %s is %s, headers only %s\n", num_messages + 1, keys[i], v1, v2);
+                return 1;
+            }
+        }
+
+        /* The data sections were not read */
+        Assert(hh->buffer->ulength < h->buffer->ulength);
+        Assert(!codes_is_defined(hh, "values"));
+
+        offsets[num_messages] = h->offset;
+        CODES_CHECK(codes_get_long(h, "totalLength", &lengths[num_messages]), 0);
+        num_messages++;
+
+        grib_handle_delete(h);
+        grib_handle_delete(hh);
+    }
+    Assert(!err);
+    hh = grib_new_from_file(NULL, in2, /*headers_only=*/1, &err);
+    Assert(!hh && !err);
+    fclose(in1);
+    fclose(in2);
+
+    if (argc == 3) {
+        check_index(argv[1], argv[2]);
+        check_fieldset(argv[1], argv[2]);
+    }
+
+    printf("%s: %d messages OK\n", argv[1], num_messages);
+    return 0;
+}
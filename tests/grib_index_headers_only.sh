@@ -0,0 +1,46 @@
+#!/bin/sh
+# (C) Copyright 2005- ECMWF.
+#
+# This software is licensed under the terms of the Apache Licence Version 2.0
+# which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+#
+# In applying this licence, ECMWF does not waive the privileges and immunities granted to it by
+# virtue of its status as an intergovernmental organisation nor does it submit to any jurisdiction.
+#
+
+. ./include.ctest.sh
+
+label="grib_index_headers_only_test"
+tempGrib=temp.$label.grib
+tempIndex=temp.$label.idx
+tempOut=temp.$label.out.grib
+tempText=temp.$label.txt
+
+# GRIB1 and GRIB2 with and without local section, bitmap and different levels
+rm -f $tempGrib
+for level in 1000 850 500 250; do
+    ${tools_dir}/grib_set -s level=$level $ECCODES_SAMPLES_PATH/GRIB2.tmpl $tempOut
+    cat $tempOut >> $tempGrib
+    ${tools_dir}/grib_set -s level=$level $ECCODES_SAMPLES_PATH/reduced_gg_pl_32_grib1.tmpl $tempOut
+    cat $tempOut >> $tempGrib
+    ${tools_dir}/grib_set -s level=$level,bitmapPresent=1 $ECCODES_SAMPLES_PATH/reduced_gg_pl_32_grib2.tmpl $tempOut
+    cat $tempOut >> $tempGrib
+done
+cat $ECCODES_SAMPLES_PATH/regular_ll_sfc_grib2.tmpl $ECCODES_SAMPLES_PATH/sh_ml_grib1.tmpl >> $tempGrib
+
+$EXEC ${test_dir}/grib_index_headers_only $tempGrib
+
+# Index and fieldset on keys in the headers and in the data sections
+$EXEC ${test_dir}/grib_index_headers_only $tempGrib "level,shortName,edition"
+$EXEC ${test_dir}/grib_index_headers_only $tempGrib "level,packingType"
+$EXEC ${test_dir}/grib_index_headers_only $tempGrib "mars.levtype,mars.levelist,mars.param"
+
+# Keys from the data sections must still be indexed
+${tools_dir}/grib_index_build -N -k level,packingType -o $tempIndex $tempGrib > $tempText
+grep -q "packingType = { grid_simple, spectral_complex }" $tempText
+
+# Fieldsets ordered on keys in the headers
+${tools_dir}/grib_copy -B "level:i asc,edition:i desc" $tempGrib $tempOut
+${tools_dir}/grib_compare -r $tempGrib $tempOut
+
+rm -f $tempGrib $tempIndex $tempOut $tempText
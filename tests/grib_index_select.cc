@@ -0,0 +1,158 @@
+/*
+ * (C) Copyright 2005- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities granted to it by
+ * virtue of its status as an intergovernmental organisation nor does it submit to any jurisdiction.
+ */
+
+/*
+ * Select every field of an index with many distinct values per key, with values
+ * given as long, double or string, in an index built, read back and added to.
+ */
+
+#include "eccodes.h"
+#include "grib_api_internal.h"
+
+#define NUM_STEPS 1500
+#define NUM_ADDED 10
+
+static const long levels[] = { 1000, 850, 500 };
+
+/* Write messages with steps from 0 and the given date, returning their offsets */
+static void write_messages(const char* filename, long date, int count, long* offsets)
+{
+    int i           = 0;
+    long offset     = 0;
+    const void* msg = NULL;
+    size_t msg_len  = 0;
+    FILE* out       = fopen(filename, "wb");
+    codes_handle* h = codes_grib_handle_new_from_samples(NULL, "GRIB2");
+    Assert(out && h);
+
+    CODES_CHECK(codes_set_string(h, "typeOfLevel", "isobaricInhPa", &msg_len), 0);
+    for (i = 0; i < count; i++) {
+        CODES_CHECK(codes_set_long(h, "dataDate", date + i % 2), 0);
+        CODES_CHECK(codes_set_long(h, "level", levels[i % 3]), 0);
+        CODES_CHECK(codes_set_long(h, "step", i), 0);
+        CODES_CHECK(codes_get_message(h, &msg, &msg_len), 0);
+        Assert(fwrite(msg, 1, msg_len, out) == msg_len);
+        offsets[i] = offset;
+        offset += msg_len;
+    }
+    codes_handle_delete(h);
+    fclose(out);
+}
+
+/* Number of fields selected and the offset of the last one */
+static int count_selected(codes_index* index, long* offset)
+{
+    int err = 0, n = 0;
+    codes_handle* h = NULL;
+    while ((h = codes_handle_new_from_index(index, &err)) != NULL) {
+        CODES_CHECK(codes_get_long(h, "offset", offset), 0);
+        codes_handle_delete(h);
+        n++;
+    }
+    Assert(err == GRIB_END_OF_INDEX);
+    return n;
+}
+
+static void check_field(codes_index* index, long date, int i, long expected_offset)
+{
+    long offset = -1;
+    CODES_CHECK(codes_index_select_long(index, "step", i), 0);
+    CODES_CHECK(codes_index_select_double(index, "level", (double)levels[i % 3]), 0);
+    CODES_CHECK(codes_index_select_long(index, "dataDate", date + i % 2), 0);
+    if (count_selected(index, &offset) != 1 || offset != expected_offset) {
+        fprintf(stderr, "ERROR: step %d date %ld: wrong selection\n", i, date);
+        exit(1);
+    }
+}
+
+/* Values given as another type than the key's select the same field */
+static void check_typed_values(codes_index* index, long date, long expected_offset)
+{
+    long offset = -1;
+    CODES_CHECK(codes_index_select_string(index, "step", "0007"), 0);
+    CODES_CHECK(codes_index_select_long(index, "level", 850), 0);
+    CODES_CHECK(codes_index_select_double(index, "dataDate", (double)(date + 1)), 0);
+    Assert(count_selected(index, &offset) == 1 && offset == expected_offset);
+
+    CODES_CHECK(codes_index_select_double(index, "step", 7.0), 0);
+    CODES_CHECK(codes_index_select_string(index, "level", "850.0"), 0);
+    CODES_CHECK(codes_index_select_string(index, "dataDate", "+20240102"), 0);
+    Assert(count_selected(index, &offset) == 1 && offset == expected_offset);
+
+    /* No such value */
+    CODES_CHECK(codes_index_select_string(index, "step", "7x"), 0);
+    Assert(count_selected(index, &offset) == 0);
+    CODES_CHECK(codes_index_select_long(index, "step", NUM_STEPS), 0);
+    Assert(count_selected(index, &offset) == 0);
+}
+
+int main(int argc, char** argv)
+{
+    char filename[1024] = {0,};
+    char added[1024]    = {0,};
+    char indexfile[1024] = {0,};
+    long offsets[NUM_STEPS];
+    long added_offsets[NUM_ADDED];
+    const long date    = 20240101;
+    const long date2   = 20240301;
+    codes_index* index = NULL;
+    size_t size        = 0;
+    int err = 0, i = 0;
+
+    Assert(argc == 2);
+    snprintf(filename, sizeof(filename), "%s.grib", argv[1]);
+    snprintf(added, sizeof(added), "%s.added.grib", argv[1]);
+    snprintf(indexfile, sizeof(indexfile), "%s.idx", argv[1]);
+    write_messages(filename, date, NUM_STEPS, offsets);
+    write_messages(added, date2, NUM_ADDED, added_offsets);
+
+    index = codes_index_new_from_file(NULL, filename, "step,level:d,dataDate", &err);
+    Assert(index && !err);
+    CODES_CHECK(codes_index_get_size(index, "step", &size), 0);
+    Assert(size == NUM_STEPS);
+    CODES_CHECK(codes_index_get_size(index, "level", &size), 0);
+    Assert(size == 3);
+    for (i = 0; i < NUM_STEPS; i++)
+        check_field(index, date, i, offsets[i]);
+    check_typed_values(index, date, offsets[7]);
+
+    /* Read back in the old format, then add a file to it */
+    setenv("ECCODES_INDEX_FORMAT_VERSION", "1", 1);
+    CODES_CHECK(codes_index_write(index, indexfile), 0);
+    unsetenv("ECCODES_INDEX_FORMAT_VERSION");
+    codes_index_delete(index);
+    index = codes_index_read(NULL, indexfile, &err);
+    Assert(index && !err);
+    check_typed_values(index, date, offsets[7]);
+    CODES_CHECK(codes_index_add_file(index, added), 0);
+    Assert(index->count == NUM_STEPS + NUM_ADDED);
+    CODES_CHECK(codes_index_get_size(index, "dataDate", &size), 0);
+    Assert(size == 4);
+    for (i = 0; i < NUM_STEPS; i++)
+        check_field(index, date, i, offsets[i]);
+    for (i = 0; i < NUM_ADDED; i++)
+        check_field(index, date2, i, added_offsets[i]);
+
+    /* The flat format */
+    CODES_CHECK(codes_index_write(index, indexfile), 0);
+    codes_index_delete(index);
+    index = codes_index_read(NULL, indexfile, &err);
+    Assert(index && !err && index->flat);
+    check_typed_values(index, date, offsets[7]);
+    for (i = 0; i < NUM_ADDED; i++)
+        check_field(index, date2, i, added_offsets[i]);
+    codes_index_delete(index);
+
+    printf("%d fields selected\n", NUM_STEPS + NUM_ADDED);
+    remove(filename);
+    remove(added);
+    remove(indexfile);
+    return 0;
+}
@@ -0,0 +1,72 @@
+#!/bin/sh
+# (C) Copyright 2005- ECMWF.
+#
+# This software is licensed under the terms of the Apache Licence Version 2.0
+# which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+#
+# In applying this licence, ECMWF does not waive the privileges and immunities granted to it by
+# virtue of its status as an intergovernmental organisation nor does it submit to any jurisdiction.
+#
+
+. ./include.ctest.sh
+
+label="grib_index_threads_test"
+tempGrib=temp.$label.grib
+tempBufr=temp.$label.bufr
+tempMsg=temp.$label.msg
+tempSerial=temp.$label.serial.idx
+tempThreads=temp.$label.threads.idx
+tempOut=temp.$label.out
+
+# Messages with several levels, steps and params, repeated in different orders
+# so the fields under a leaf of the index must keep the file order
+rm -f $tempGrib $tempMsg
+for level in 1000 850 500; do
+    for step in 0 6 12; do
+        ${tools_dir}/grib_set -s typeOfLevel=isobaricInhPa,level=$level,step=$step \
+            $ECCODES_SAMPLES_PATH/GRIB2.tmpl $tempOut
+        cat $tempOut >> $tempMsg
+    done
+done
+${tools_dir}/grib_set -s paramId=130 $tempMsg $tempOut
+for i in 1 2 3 4 5 6 7 8 9 10; do
+    cat $tempMsg $ECCODES_SAMPLES_PATH/GRIB1.tmpl $tempOut >> $tempGrib
+done
+${tools_dir}/grib_count $tempGrib
+
+# The index must be the same whatever the number of threads
+${tools_dir}/grib_index_build -N -o $tempSerial $tempGrib
+for nthreads in 1 2 3 8; do
+    ${tools_dir}/grib_index_build -N -j $nthreads -o $tempThreads $tempGrib
+    cmp $tempSerial $tempThreads
+done
+
+# Several files
+${tools_dir}/grib_index_build -o $tempSerial $tempGrib $tempMsg
+${tools_dir}/grib_index_build -j 4 -o $tempThreads $tempGrib $tempMsg
+cmp $tempSerial $tempThreads
+
+# Explicit key types
+keys="level:d,step:s,paramId:l,edition"
+${tools_dir}/grib_index_build -k $keys -o $tempSerial $tempGrib
+${tools_dir}/grib_index_build -k $keys -j 4 -o $tempThreads $tempGrib
+cmp $tempSerial $tempThreads
+
+# Bad number of threads
+set +e
+${tools_dir}/grib_index_build -j 0 -o $tempThreads $tempGrib > $tempOut 2>&1
+status=$?
+set -e
+[ $status -ne 0 ]
+grep -q "Invalid number of threads" $tempOut
+
+# BUFR
+rm -f $tempBufr
+for i in 1 2 3 4 5 6 7 8 9 10 11 12 13 14 15 16 17 18 19 20; do
+    cat $ECCODES_SAMPLES_PATH/BUFR4.tmpl $ECCODES_SAMPLES_PATH/BUFR3_local.tmpl >> $tempBufr
+done
+${tools_dir}/bufr_index_build -N -o $tempSerial $tempBufr
+${tools_dir}/bufr_index_build -N -j 3 -o $tempThreads $tempBufr
+cmp $tempSerial $tempThreads
+
+rm -f $tempGrib $tempBufr $tempMsg $tempSerial $tempThreads $tempOut
@@ -0,0 +1,135 @@
+/*
+ * (C) Copyright 2005- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities granted to it by
+ * virtue of its status as an intergovernmental organisation nor does it submit to any jurisdiction.
+ */
+
+/*
+ * Check the batched nearest search against the distances to every point of the grid,
+ * for each message of the input, and that messages on the same grid share the index.
+ */
+
+#include "eccodes.h"
+#include "grib_api_internal.h"
+
+#define NUM_POINTS 400
+
+/* Points spread over the sphere, with longitudes beyond [0,360), then the first points of the grid */
+static void make_points(const double* lats, const double* lons, size_t count, double* inlats, double* inlons)
+{
+    unsigned long seed = 12345;
+    size_t i           = 0;
+    for (i = 0; i < NUM_POINTS; i++) {
+        seed      = seed * 1103515245 + 12345;
+        inlats[i] = -90.0 + 180.0 * ((seed >> 8) % 100000) / 99999.0;
+        seed      = seed * 1103515245 + 12345;
+        inlons[i] = -180.0 + 720.0 * ((seed >> 8) % 100000) / 100000.0;
+        if (i < NUM_POINTS / 4 && i < count) {
+            inlats[i] = lats[i * (count / (NUM_POINTS / 4) + 1) % count];
+            inlons[i] = lons[i * (count / (NUM_POINTS / 4) + 1) % count];
+        }
+    }
+}
+
+static void check_message(codes_handle* h, int m)
+{
+    double inlats[NUM_POINTS], inlons[NUM_POINTS];
+    double outlats[NUM_POINTS], outlons[NUM_POINTS], values[NUM_POINTS], distances[NUM_POINTS];
+    int indexes[NUM_POINTS], indexes_no_values[NUM_POINTS];
+    double *lats = NULL, *lons = NULL, *all_values = NULL;
+    double radius = 0;
+    size_t count = 0, i = 0, j = 0, size = 0;
+    codes_iterator* iter = NULL;
+    int err = 0;
+
+    CODES_CHECK(codes_get_size(h, "values", &count), 0);
+    lats       = (double*)malloc(count * sizeof(double));
+    lons       = (double*)malloc(count * sizeof(double));
+    all_values = (double*)malloc(count * sizeof(double));
+    Assert(lats && lons && all_values);
+    size = count;
+    CODES_CHECK(codes_get_double_array(h, "values", all_values, &size), 0);
+    iter = codes_grib_iterator_new(h, 0, &err);
+    Assert(iter && !err);
+    for (i = 0; i < count; i++)
+        Assert(codes_grib_iterator_next(iter, &lats[i], &lons[i], NULL));
+    codes_grib_iterator_delete(iter);
+    CODES_CHECK(grib_nearest_get_radius(h, &radius), 0);
+
+    make_points(lats, lons, count, inlats, inlons);
+    CODES_CHECK(codes_grib_nearest_find_batch(h, inlats, inlons, NUM_POINTS, outlats, outlons, values, distances, indexes), 0);
+
+    for (i = 0; i < NUM_POINTS; i++) {
+        const double inlon = normalise_longitude_in_degrees(inlons[i]);
+        double min_dist    = 1e30;
+        size_t nearest     = 0;
+        for (j = 0; j < count; j++) {
+            const double d = geographic_distance_spherical(radius, inlon, inlats[i], normalise_longitude_in_degrees(lons[j]), lats[j]);
+            if (d < min_dist) {
+                min_dist = d;
+                nearest  = j;
+            }
+        }
+        Assert(indexes[i] >= 0 && (size_t)indexes[i] < count);
+        Assert(outlats[i] == lats[indexes[i]] && outlons[i] == lons[indexes[i]]);
+        Assert(values[i] == all_values[indexes[i]]);
+        /* Points at the same distance are equally good */
+        if (fabs(distances[i] - min_dist) > 1e-6 * (1 + min_dist)) {
+            fprintf(stderr, "ERROR: message %d: point %g %g: nearest %d at %.9g km instead of %zu at %.9g km\n",
+                    m, inlats[i], inlons[i], indexes[i], distances[i], nearest, min_dist);
+            exit(1);
+        }
+    }
+
+    /* Without the values */
+    CODES_CHECK(codes_grib_nearest_find_batch(h, inlats, inlons, NUM_POINTS, outlats, outlons, NULL, distances, indexes_no_values), 0);
+    for (i = 0; i < NUM_POINTS; i++)
+        Assert(indexes_no_values[i] == indexes[i]);
+
+    free(lats);
+    free(lons);
+    free(all_values);
+}
+
+int main(int argc, char** argv)
+{
+    grib_context* c     = grib_context_get_default();
+    codes_handle* h     = NULL;
+    codes_handle* clone = NULL;
+    FILE* in            = NULL;
+    int err = 0, m = 0;
+    grib_nearest_index* first = NULL;
+
+    Assert(argc == 2);
+    in = fopen(argv[1], "rb");
+    Assert(in);
+    while ((h = codes_handle_new_from_file(NULL, in, PRODUCT_GRIB, &err)) != NULL) {
+        char gridType[64] = {0,};
+        size_t len        = sizeof(gridType);
+        CODES_CHECK(codes_get_string(h, "gridType", gridType, &len), 0);
+        check_message(h, m);
+
+        /* Another field on the same grid uses the same index */
+        first = c->grid_geometries->nearest_index;
+        Assert(first);
+        clone = codes_handle_clone(h);
+        CODES_CHECK(codes_set_long(clone, "step", 12), 0);
+        check_message(clone, m);
+        Assert(c->grid_geometries->nearest_index == first);
+        codes_handle_delete(clone);
+
+        printf("%s: %d points OK\n", gridType, NUM_POINTS);
+        codes_handle_delete(h);
+        m++;
+    }
+    fclose(in);
+    Assert(m > 0);
+
+    grib_grid_geometry_cache_delete(c);
+    Assert(c->grid_geometries == NULL);
+    return 0;
+}
@@ -0,0 +1,99 @@
+#!/bin/sh
+# (C) Copyright 2005- ECMWF.
+#
+# This software is licensed under the terms of the Apache Licence Version 2.0
+# which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+#
+# In applying this licence, ECMWF does not waive the privileges and immunities granted to it by
+# virtue of its status as an intergovernmental organisation nor does it submit to any jurisdiction.
+#
+
+. ./include.ctest.sh
+
+label="grib_nearest_batch_test"
+tempFilter="temp.${label}.filt"
+tempGrib="temp.${label}.grib"
+tempGrid="temp.${label}.grid.grib"
+
+input=$ECCODES_SAMPLES_PATH/GRIB2.tmpl
+latest=`${tools_dir}/grib_get -p tablesVersionLatest $input`
+
+# Grids of the samples
+cat $ECCODES_SAMPLES_PATH/GRIB2.tmpl \
+    $ECCODES_SAMPLES_PATH/regular_ll_sfc_grib1.tmpl \
+    $ECCODES_SAMPLES_PATH/reduced_gg_pl_48_grib2.tmpl \
+    $ECCODES_SAMPLES_PATH/rotated_ll_sfc_grib2.tmpl \
+    $ECCODES_SAMPLES_PATH/polar_stereographic_sfc_grib2.tmpl > $tempGrib
+
+# Projections
+cat > $tempFilter <<EOF
+ set gridType="lambert";
+ set numberOfDataPoints=6000;
+ set shapeOfTheEarth=6;
+ set Nx=80;
+ set Ny=75;
+ set latitudeOfFirstGridPoint=40442000;
+ set longitudeOfFirstGridPoint=353559000;
+ set LaD=60000000;
+ set LoV=2200000;
+ set Dx=25000000;
+ set Dy=25000000;
+ set Latin1=46401000;
+ set Latin2=46401000;
+ set numberOfValues=6000;
+ write;
+EOF
+${tools_dir}/grib_filter -o $tempGrid $tempFilter $input
+cat $tempGrid >> $tempGrib
+
+cat > $tempFilter <<EOF
+ set gridType="mercator";
+ set Ni=60;
+ set Nj=50;
+ set numberOfDataPoints=3000;
+ set numberOfValues=3000;
+ set latitudeOfFirstGridPoint=-30000000;
+ set longitudeOfFirstGridPoint=100000000;
+ set LaD=20000000;
+ set latitudeOfLastGridPoint=40000000;
+ set longitudeOfLastGridPoint=200000000;
+ set orientationOfTheGrid=0;
+ set Di=150000000;
+ set Dj=150000000;
+ write;
+EOF
+${tools_dir}/grib_filter -o $tempGrid $tempFilter $input
+cat $tempGrid >> $tempGrib
+
+cat > $tempFilter <<EOF
+ set gridType="space_view";
+ set Nx=190;
+ set Ny=90;
+ set dx=362;
+ set dy=361;
+ set Xp=76400;
+ set Yp=177400;
+ set Nr=6610700;
+ set numberOfDataPoints=17100;
+ set numberOfValues=17100;
+ write;
+EOF
+${tools_dir}/grib_filter -o $tempGrid $tempFilter $input
+cat $tempGrid >> $tempGrib
+
+cat > $tempFilter <<EOF
+ set tablesVersion = $latest;
+ set gridType = "healpix";
+ set longitudeOfFirstGridPointInDegrees = 45;
+ set numberOfPointsAlongASide = 16;
+ set numberOfDataPoints = 3072; # 12 x 16 x 16
+ set numberOfValues = 3072;
+ write;
+EOF
+${tools_dir}/grib_filter -o $tempGrid $tempFilter $input
+cat $tempGrid >> $tempGrib
+
+$EXEC ${test_dir}/grib_nearest_batch $tempGrib
+
+# Clean up
+rm -f $tempFilter $tempGrib $tempGrid
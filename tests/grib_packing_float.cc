@@ -0,0 +1,120 @@
+/*
+ * (C) Copyright 2005- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities granted to it by
+ * virtue of its status as an intergovernmental organisation nor does it submit to any jurisdiction.
+ */
+
+/*
+ * Check the float decoding of the data values is the same as narrowing the doubles.
+ * If a packingType is given, the input is first repacked with a varying field.
+ */
+
+#include <math.h>
+#include "eccodes.h"
+#include "grib_api_internal.h"
+
+static codes_handle* repack(codes_handle* h, const char* packingType)
+{
+    size_t i = 0, values_len = 0, size = 0, len = 0;
+    double* values      = NULL;
+    const void* message = NULL;
+    codes_handle* h2    = NULL;
+    char gridType[64]   = {0,};
+    int with_bitmap     = 0;
+
+    CODES_CHECK(codes_get_size(h, "values", &values_len), 0);
+
+    len = sizeof(gridType);
+    CODES_CHECK(codes_get_string(h, "gridType", gridType, &len), 0);
+    /* Grid point fields also get some missing values */
+    with_bitmap = strcmp(gridType, "sh") != 0;
+    if (with_bitmap) {
+        CODES_CHECK(codes_set_long(h, "bitmapPresent", 1), 0);
+    }
+
+    values = (double*)malloc(values_len * sizeof(double));
+    Assert(values);
+    for (i = 0; i < values_len; i++) {
+        values[i] = 273.15 + 30 * sin(i * 0.01) + 0.001 * (i % 7);
+        if (with_bitmap && i % 11 == 5)
+            values[i] = 9999;
+    }
+    CODES_CHECK(codes_set_double_array(h, "values", values, values_len), 0);
+
+    len = strlen(packingType);
+    CODES_CHECK(codes_set_string(h, "packingType", packingType, &len), 0);
+
+    CODES_CHECK(codes_get_message(h, &message, &size), 0);
+    h2 = codes_handle_new_from_message_copy(0, message, size);
+    Assert(h2);
+
+    free(values);
+    return h2;
+}
+
+int main(int argc, char** argv)
+{
+    int err            = 0;
+    float* fvalues     = NULL;
+    double* dvalues    = NULL;
+    size_t values_len  = 0;
+    size_t i           = 0;
+    size_t len         = 0;
+    char packingType[64] = {0,};
+    FILE* in           = NULL;
+    codes_handle* h    = NULL;
+
+    if (argc != 2 && argc != 3) {
+        fprintf(stderr, "usage: %s file [packingType]\n", argv[0]);
+        return 1;
+    }
+
+    in = fopen(argv[1], "rb");
+    Assert(in);
+    h = codes_handle_new_from_file(0, in, PRODUCT_GRIB, &err);
+    Assert(h);
+    fclose(in);
+
+    if (argc == 3) {
+        codes_handle* h2 = repack(h, argv[2]);
+        codes_handle_delete(h);
+        h = h2;
+    }
+
+    len = sizeof(packingType);
+    CODES_CHECK(codes_get_string(h, "packingType", packingType, &len), 0);
+    if (argc == 3 && strcmp(packingType, argv[2]) != 0) {
+        fprintf(stderr, "ERROR: packingType is %s, expected %s\n", packingType, argv[2]);
+        return 1;
+    }
+
+    CODES_CHECK(codes_get_size(h, "values", &values_len), 0);
+    fvalues = (float*)malloc(values_len * sizeof(float));
+    dvalues = (double*)malloc(values_len * sizeof(double));
+    Assert(fvalues && dvalues);
+
+    len = values_len;
+    CODES_CHECK(codes_get_float_array(h, "values", fvalues, &len), 0);
+    Assert(len == values_len);
+    len = values_len;
+    CODES_CHECK(codes_get_double_array(h, "values", dvalues, &len), 0);
+    Assert(len == values_len);
+
+    for (i = 0; i < values_len; i++) {
+        if (fvalues[i] != (float)dvalues[i]) {
+            fprintf(stderr, "ERROR: %s: value %zu: float %.9g, double %.17g\n",
+                    packingType, i, fvalues[i], dvalues[i]);
+            return 1;
+        }
+    }
+    printf("%s: %zu values OK\n", packingType, values_len);
+
+    free(fvalues);
+    free(dvalues);
+    codes_handle_delete(h);
+    return 0;
+}
@@ -0,0 +1,51 @@
+#!/bin/sh
+# (C) Copyright 2005- ECMWF.
+#
+# This software is licensed under the terms of the Apache Licence Version 2.0
+# which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+#
+# In applying this licence, ECMWF does not waive the privileges and immunities granted to it by
+# virtue of its status as an intergovernmental organisation nor does it submit to any jurisdiction.
+#
+
+. ./include.ctest.sh
+
+label="grib_packing_float_test"
+tempGrib=temp.$label.grib
+
+# Decoding the values as float must give the same as narrowing the doubles
+# ------------------------------------------------------------------------
+packings="grid_simple grid_ieee grid_second_order grid_complex grid_complex_spatial_differencing grid_simple_log_preprocessing"
+if [ $HAVE_PNG -eq 1 ]; then
+    packings="$packings grid_png"
+fi
+if [ $HAVE_JPEG -eq 1 ]; then
+    packings="$packings grid_jpeg"
+fi
+if [ $HAVE_AEC -eq 1 ]; then
+    packings="$packings grid_ccsds"
+fi
+
+for packing in $packings; do
+    $EXEC ${test_dir}/grib_packing_float $ECCODES_SAMPLES_PATH/regular_ll_sfc_grib2.tmpl $packing
+    $EXEC ${test_dir}/grib_packing_float $ECCODES_SAMPLES_PATH/reduced_gg_pl_32_grib2.tmpl $packing
+done
+
+# GRIB1
+for packing in grid_simple grid_ieee grid_second_order grid_simple_matrix; do
+    $EXEC ${test_dir}/grib_packing_float $ECCODES_SAMPLES_PATH/regular_ll_sfc_grib1.tmpl $packing
+done
+$EXEC ${test_dir}/grib_packing_float $ECCODES_SAMPLES_PATH/reduced_gg_pl_32_grib1.tmpl grid_second_order
+
+# Spectral
+for packing in spectral_simple spectral_complex; do
+    $EXEC ${test_dir}/grib_packing_float $ECCODES_SAMPLES_PATH/sh_ml_grib1.tmpl $packing
+    $EXEC ${test_dir}/grib_packing_float $ECCODES_SAMPLES_PATH/sh_ml_grib2.tmpl $packing
+done
+$EXEC ${test_dir}/grib_packing_float $ECCODES_SAMPLES_PATH/lambert_bf_grib2.tmpl
+
+# Run length
+$EXEC ${test_dir}/grib_run_length_packing $tempGrib
+$EXEC ${test_dir}/grib_packing_float $tempGrib
+
+rm -f $tempGrib
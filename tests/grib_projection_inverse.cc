@@ -0,0 +1,143 @@
+/*
+ * (C) Copyright 2005- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities granted to it by
+ * virtue of its status as an intergovernmental organisation nor does it submit to any jurisdiction.
+ */
+
+/*
+ * Check the latitudes from the constant t of the conformal projections against the iteration
+ * of Snyder (7-9), then the points of the projected grids of the input
+ */
+
+#include "eccodes.h"
+#include "grib_api_internal.h"
+
+#define NUMBER_OF_T 2000
+
+/* The iteration the lambert conformal iterator used */
+static double phi_iterated(double eccent, double ts)
+{
+    double eccnth = 0.5 * eccent, phi = M_PI_2 - 2 * atan(ts), con, dphi;
+    int i;
+    for (i = 0; i <= 15; i++) {
+        con  = eccent * sin(phi);
+        dphi = M_PI_2 - 2 * atan(ts * (pow(((1.0 - con) / (1.0 + con)), eccnth))) - phi;
+        phi += dphi;
+        if (fabs(dphi) <= 0.0000000001)
+            return phi;
+    }
+    Assert(!"phi_iterated: no convergence");
+    return 0;
+}
+
+static void test_latitudes_from_conformal_t()
+{
+    const double eccentricities[] = { 0, 0.05, 0.0818191908426 /* WGS84 */, 0.09, 0.1, 0.15 };
+    double ts[NUMBER_OF_T], phi[NUMBER_OF_T], copy[NUMBER_OF_T];
+    size_t i = 0, k = 0;
+
+    /* From near the north pole to the south */
+    for (i = 0; i < NUMBER_OF_T; i++)
+        ts[i] = pow(10, -8 + 10.0 * i / (NUMBER_OF_T - 1));
+
+    for (k = 0; k < sizeof(eccentricities) / sizeof(eccentricities[0]); k++) {
+        const double e = eccentricities[k];
+        double maxdiff = 0;
+        GRIB_CHECK(grib_latitudes_from_conformal_t(e, ts, phi, NUMBER_OF_T), 0);
+        for (i = 0; i < NUMBER_OF_T; i++) {
+            const double diff = fabs(phi[i] - phi_iterated(e, ts[i]));
+            if (diff > maxdiff) maxdiff = diff;
+            Assert(phi[i] < M_PI_2 && phi[i] > -M_PI_2);
+            if (i) Assert(phi[i] < phi[i - 1]);
+        }
+        printf("e=%g: max difference %g radians\n", e, maxdiff);
+        Assert(maxdiff < 1e-10);
+
+        /* In place */
+        memcpy(copy, ts, sizeof(ts));
+        GRIB_CHECK(grib_latitudes_from_conformal_t(e, copy, copy, NUMBER_OF_T), 0);
+        Assert(memcmp(copy, phi, sizeof(phi)) == 0);
+    }
+
+    /* The equator and the south pole */
+    ts[0] = 1;
+    ts[1] = HUGE_VAL;
+    GRIB_CHECK(grib_latitudes_from_conformal_t(0.0818191908426, ts, phi, 2), 0);
+    Assert(fabs(phi[0]) < 1e-15);
+    Assert(fabs(phi[1] + M_PI_2) < 1e-12);
+    GRIB_CHECK(grib_latitudes_from_conformal_t(0.0818191908426, ts, phi, 0), 0);
+}
+
+static double normalise_longitude(double lon)
+{
+    while (lon < 0) lon += 360;
+    while (lon >= 360) lon -= 360;
+    return lon;
+}
+
+/* The first point is the one of the keys and the points are within the globe. A mercator
+ * grid has the same latitude along the rows and the same longitudes on every row
+ */
+static void test_grid(codes_handle* h)
+{
+    char gridType[64] = {0,};
+    size_t len = sizeof(gridType), count = 0, i = 0;
+    double *lats = NULL, *lons = NULL, *values = NULL;
+    double latFirst = 0, lonFirst = 0;
+    long Ni = 0;
+
+    CODES_CHECK(codes_get_string(h, "gridType", gridType, &len), 0);
+    CODES_CHECK(codes_get_size(h, "values", &count), 0);
+    CODES_CHECK(codes_get_double(h, "latitudeOfFirstGridPointInDegrees", &latFirst), 0);
+    CODES_CHECK(codes_get_double(h, "longitudeOfFirstGridPointInDegrees", &lonFirst), 0);
+    lats   = (double*)malloc(count * sizeof(double));
+    lons   = (double*)malloc(count * sizeof(double));
+    values = (double*)malloc(count * sizeof(double));
+    Assert(lats && lons && values);
+    CODES_CHECK(codes_grib_get_data(h, lats, lons, values), 0);
+
+    Assert(fabs(lats[0] - latFirst) < 1e-5);
+    Assert(fabs(normalise_longitude(lons[0]) - normalise_longitude(lonFirst)) < 1e-5);
+    for (i = 0; i < count; i++) {
+        Assert(lats[i] >= -90 && lats[i] <= 90);
+        Assert(lons[i] >= -360 && lons[i] <= 360);
+    }
+
+    if (strcmp(gridType, "mercator") == 0) {
+        CODES_CHECK(codes_get_long(h, "Ni", &Ni), 0);
+        for (i = 0; i < count; i++) {
+            Assert(lats[i] == lats[i - i % Ni]);
+            Assert(lons[i] == lons[i % Ni]);
+        }
+    }
+    printf("%s: %zu points OK\n", gridType, count);
+
+    free(lats);
+    free(lons);
+    free(values);
+}
+
+int main(int argc, char** argv)
+{
+    codes_handle* h = NULL;
+    FILE* in        = NULL;
+    int err = 0, m = 0;
+
+    Assert(argc == 2);
+    test_latitudes_from_conformal_t();
+
+    in = fopen(argv[1], "rb");
+    Assert(in);
+    while ((h = codes_handle_new_from_file(NULL, in, PRODUCT_GRIB, &err)) != NULL) {
+        test_grid(h);
+        codes_handle_delete(h);
+        m++;
+    }
+    fclose(in);
+    Assert(m > 0);
+    return 0;
+}
@@ -0,0 +1,97 @@
+#!/bin/sh
+# (C) Copyright 2005- ECMWF.
+#
+# This software is licensed under the terms of the Apache Licence Version 2.0
+# which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+#
+# In applying this licence, ECMWF does not waive the privileges and immunities granted to it by
+# virtue of its status as an intergovernmental organisation nor does it submit to any jurisdiction.
+#
+
+. ./include.ctest.sh
+
+label="grib_projection_inverse_test"
+tempFilter="temp.${label}.filt"
+tempGrib="temp.${label}.grib"
+tempGrid="temp.${label}.grid.grib"
+
+input=$ECCODES_SAMPLES_PATH/GRIB2.tmpl
+rm -f $tempGrib
+
+# Lambert conformal on a sphere and on the WGS84 ellipsoid
+for shape in 6 5; do
+  cat > $tempFilter <<EOF
+   set gridType="lambert";
+   set numberOfDataPoints=3000;
+   set shapeOfTheEarth=$shape;
+   set Nx=60;
+   set Ny=50;
+   set latitudeOfFirstGridPoint=30442000;
+   set longitudeOfFirstGridPoint=343559000;
+   set LaD=50000000;
+   set LoV=2200000;
+   set Dx=40000000;
+   set Dy=40000000;
+   set Latin1=46401000;
+   set Latin2=56401000;
+   set numberOfValues=3000;
+   write;
+EOF
+  ${tools_dir}/grib_filter -o $tempGrid $tempFilter $input
+  cat $tempGrid >> $tempGrib
+done
+
+# Mercator
+for shape in 0 5; do
+  cat > $tempFilter <<EOF
+   set gridType="mercator";
+   set shapeOfTheEarth=$shape;
+   set Ni=60;
+   set Nj=50;
+   set numberOfDataPoints=3000;
+   set numberOfValues=3000;
+   set latitudeOfFirstGridPoint=-30000000;
+   set longitudeOfFirstGridPoint=100000000;
+   set LaD=20000000;
+   set latitudeOfLastGridPoint=40000000;
+   set longitudeOfLastGridPoint=200000000;
+   set orientationOfTheGrid=0;
+   set Di=150000000;
+   set Dj=150000000;
+   write;
+EOF
+  ${tools_dir}/grib_filter -o $tempGrid $tempFilter $input
+  cat $tempGrid >> $tempGrib
+done
+
+# Polar stereographic
+cat $ECCODES_SAMPLES_PATH/polar_stereographic_sfc_grib2.tmpl >> $tempGrib
+
+# Lambert azimuthal equal area on a sphere and on an ellipsoid, in both orders of the points
+for shape in "1; set scaleFactorOfRadiusOfSphericalEarth=0; set scaledValueOfRadiusOfSphericalEarth=6378388" "4"; do
+  for consecutive in 0 1; do
+    cat > $tempFilter <<EOF
+     set gridType="lambert_azimuthal_equal_area";
+     set Nx=60;
+     set Ny=50;
+     set numberOfDataPoints=3000;
+     set shapeOfTheEarth=$shape;
+     set numberOfValues=3000;
+     set latitudeOfFirstGridPointInDegrees=67.575;
+     set longitudeOfFirstGridPointInDegrees=326.5056;
+     set Dx=80000000;
+     set Dy=80000000;
+     set standardParallel=48000000;
+     set centralLongitude=9000000;
+     set jPointsAreConsecutive=$consecutive;
+     write;
+EOF
+    ${tools_dir}/grib_filter -o $tempGrid $tempFilter $input
+    cat $tempGrid >> $tempGrib
+  done
+done
+
+$EXEC ${test_dir}/grib_projection_inverse $tempGrib
+
+# Clean up
+rm -f $tempFilter $tempGrib $tempGrid
@@ -0,0 +1,139 @@
+/*
+ * (C) Copyright 2005- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities granted to it by
+ * virtue of its status as an intergovernmental organisation nor does it submit to any jurisdiction.
+ */
+
+/*
+ * Scaling of decoding with the threads sharing the default context (see also ECC-604):
+ * each thread decodes all the messages of the input, held in memory, a number of times.
+ * The time is given for 1, 2, 4 .. up to the maximum number of threads
+ */
+
+#include "grib_api_internal.h"
+
+#if ECCODES_TIMER && GRIB_PTHREADS
+
+#define MAX_THREADS 256
+
+typedef struct message
+{
+    void* data;
+    size_t size;
+} message;
+
+static message* messages  = NULL;
+static size_t num_messages = 0;
+static int iterations      = 0;
+
+void usage(char* prog)
+{
+    printf("usage: %s grib_file max_threads iterations\n", prog);
+    exit(1);
+}
+
+static void decode(const message* m)
+{
+    grib_handle* h    = grib_handle_new_from_message(NULL, m->data, m->size);
+    char shortName[64] = {0,};
+    size_t len = sizeof(shortName), count = 0;
+    double* values = NULL;
+    long level = 0;
+
+    Assert(h);
+    GRIB_CHECK(grib_get_string(h, "shortName", shortName, &len), 0);
+    GRIB_CHECK(grib_get_long(h, "level", &level), 0);
+    GRIB_CHECK(grib_get_size(h, "values", &count), 0);
+    values = (double*)malloc(count * sizeof(double));
+    Assert(values);
+    GRIB_CHECK(grib_get_double_array(h, "values", values, &count), 0);
+    free(values);
+    grib_handle_delete(h);
+}
+
+static void* runner(void* arg)
+{
+    int i = 0;
+    size_t m = 0;
+    for (i = 0; i < iterations; i++)
+        for (m = 0; m < num_messages; m++)
+            decode(&messages[m]);
+    return NULL;
+}
+
+int main(int argc, char* argv[])
+{
+    grib_context* c = grib_context_get_default();
+    grib_handle* h  = NULL;
+    pthread_t threads[MAX_THREADS];
+    FILE* fin       = NULL;
+    grib_timer* t   = NULL;
+    double single = 0;
+    int max_threads = 0, n = 0, i = 0, e = 0;
+
+    if (argc != 4)
+        usage(argv[0]);
+    fin = fopen(argv[1], "rb");
+    if (!fin) {
+        perror(argv[1]);
+        exit(1);
+    }
+    max_threads = atoi(argv[2]);
+    iterations  = atoi(argv[3]);
+    if (max_threads < 1 || max_threads > MAX_THREADS || iterations < 1)
+        usage(argv[0]);
+
+    while ((h = grib_handle_new_from_file(c, fin, &e)) != NULL) {
+        const void* data = NULL;
+        size_t size      = 0;
+        messages = (message*)realloc(messages, (num_messages + 1) * sizeof(message));
+        Assert(messages);
+        GRIB_CHECK(grib_get_message(h, &data, &size), 0);
+        messages[num_messages].data = malloc(size);
+        Assert(messages[num_messages].data);
+        memcpy(messages[num_messages].data, data, size);
+        messages[num_messages].size = size;
+        num_messages++;
+        grib_handle_delete(h);
+    }
+    GRIB_CHECK(e, 0);
+    fclose(fin);
+    Assert(num_messages > 0);
+
+    /* Load the definitions and tables once, as a long running program would have */
+    for (i = 0; i < (int)num_messages; i++)
+        decode(&messages[i]);
+
+    t = grib_get_timer(c, "decoding", 0, 1);
+    for (n = 1; n <= max_threads; n = (n == max_threads || 2 * n <= max_threads) ? 2 * n : max_threads) {
+        t->timer_ = 0;
+        grib_timer_start(t);
+        for (i = 0; i < n; i++)
+            Assert(pthread_create(&threads[i], NULL, runner, NULL) == 0);
+        for (i = 0; i < n; i++)
+            pthread_join(threads[i], NULL);
+        grib_timer_stop(t, 0);
+        if (n == 1)
+            single = t->timer_;
+        printf("%3d threads: %zu messages in %g s, %g messages/s, speedup %.2f (efficiency %.0f%%)\n",
+               n, n * iterations * num_messages, t->timer_, n * iterations * num_messages / t->timer_,
+               n * single / t->timer_, 100 * single / t->timer_);
+    }
+
+    for (i = 0; i < (int)num_messages; i++)
+        free(messages[i].data);
+    free(messages);
+    return 0;
+}
+#else
+
+int main(int argc, char* argv[])
+{
+    return 0;
+}
+
+#endif
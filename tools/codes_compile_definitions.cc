@@ -0,0 +1,168 @@
+/*
+ * (C) Copyright 2005- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities granted to it by
+ * virtue of its status as an intergovernmental organisation nor does it submit to any jurisdiction.
+ */
+
+/*
+ * Write the definitions cache: the concept and hash array files of the definitions directories,
+ * already parsed. See grib_definitions_cache.cc
+ */
+
+#include "grib_api_internal.h"
+
+typedef struct file_list
+{
+    char** files;
+    size_t count, capacity;
+} file_list;
+
+static void usage(const char* prog)
+{
+    printf("Usage: %s [-o cache_file] [directory ...]\n", prog);
+    printf("       Compile the concept and hash array files of the directories, by default those\n");
+    printf("       of the definitions path, into the cache_file, by default $ECCODES_DEFINITION_CACHE\n");
+    printf("       or definitions.cache in the first directory of the definitions path\n");
+    exit(1);
+}
+
+static int is_def_file(const char* name)
+{
+    size_t len = strlen(name);
+    return len > 4 && strcmp(name + len - 4, ".def") == 0;
+}
+
+static void add_file(file_list* list, const char* path)
+{
+    if (list->count == list->capacity) {
+        list->capacity = list->capacity ? 2 * list->capacity : 1024;
+        list->files    = (char**)realloc(list->files, list->capacity * sizeof(char*));
+        if (!list->files) {
+            fprintf(stderr, "Out of memory\n");
+            exit(1);
+        }
+    }
+    list->files[list->count++] = strdup(path);
+}
+
+#ifndef ECCODES_ON_WINDOWS
+static int scan(grib_context* c, file_list* list, const char* dir)
+{
+    struct dirent* s;
+    DIR* d;
+    int err = 0;
+
+    d = opendir(dir);
+    if (!d) {
+        grib_context_log(c, (GRIB_LOG_ERROR) | (GRIB_LOG_PERROR), "opendir %s", dir);
+        return GRIB_IO_PROBLEM;
+    }
+
+    while ((s = readdir(d)) && (err == 0)) {
+        if (strcmp(s->d_name, ".") != 0 && strcmp(s->d_name, "..") != 0) {
+            char buf[1024];
+            struct stat st;
+            snprintf(buf, sizeof(buf), "%s/%s", dir, s->d_name);
+            if (stat(buf, &st) != 0)
+                continue;
+            if (S_ISDIR(st.st_mode))
+                err = scan(c, list, buf);
+            else if (S_ISREG(st.st_mode) && is_def_file(s->d_name))
+                add_file(list, buf);
+        }
+    }
+    closedir(d);
+    return err;
+}
+#else
+static int scan(grib_context* c, file_list* list, const char* dir)
+{
+    struct _finddata_t fileinfo;
+    intptr_t handle;
+    char buffer[1024];
+    int err = 0;
+    snprintf(buffer, sizeof(buffer), "%s/*", dir);
+    if ((handle = _findfirst(buffer, &fileinfo)) != -1) {
+        do {
+            if (strcmp(fileinfo.name, ".") != 0 && strcmp(fileinfo.name, "..") != 0) {
+                char buf[1024];
+                snprintf(buf, sizeof(buf), "%s/%s", dir, fileinfo.name);
+                if (fileinfo.attrib & _A_SUBDIR)
+                    err = scan(c, list, buf);
+                else if (is_def_file(fileinfo.name))
+                    add_file(list, buf);
+            }
+        } while (err == 0 && !_findnext(handle, &fileinfo));
+
+        _findclose(handle);
+    }
+    else {
+        grib_context_log(c, (GRIB_LOG_ERROR) | (GRIB_LOG_PERROR), "opendir %s", dir);
+        return GRIB_IO_PROBLEM;
+    }
+    return err;
+}
+#endif
+
+int main(int argc, char* argv[])
+{
+    grib_context* c  = grib_context_get_default();
+    char* cache_file = NULL;
+    file_list list   = {0,};
+    size_t num_compiled = 0, i = 0;
+    int err = 0, first_dir = 1;
+
+    if (argc > 1 && strcmp(argv[1], "-o") == 0) {
+        if (argc < 3)
+            usage(argv[0]);
+        cache_file = grib_context_strdup(c, argv[2]);
+        first_dir  = 3;
+    }
+    else if (argc > 1 && argv[1][0] == '-') {
+        usage(argv[0]);
+    }
+    if (!cache_file) {
+        const char* path = getenv("ECCODES_DEFINITION_CACHE");
+        cache_file       = path && *path ? grib_context_strdup(c, path) : grib_definitions_cache_default_path(c);
+        if (!cache_file) {
+            fprintf(stderr, "No definitions path: give the cache file with -o\n");
+            return 1;
+        }
+    }
+
+    if (first_dir < argc) {
+        /* The paths are looked up as the library builds them, from the resolved directories */
+        for (i = first_dir; i < (size_t)argc && err == 0; i++) {
+            char* dir = codes_resolve_path(c, argv[i]);
+            err       = scan(c, &list, dir);
+            grib_context_free(c, dir);
+        }
+    }
+    else {
+        const grib_string_list* dir = grib_context_get_definition_files_dirs(c);
+        if (!dir) {
+            fprintf(stderr, "Unable to find the definition files directories\n");
+            return 1;
+        }
+        for (; dir && err == 0; dir = dir->next)
+            err = scan(c, &list, dir->value);
+    }
+
+    if (err == 0)
+        err = grib_definitions_cache_write(c, cache_file, list.files, list.count, &num_compiled);
+    if (err) {
+        fprintf(stderr, "Failed to write the definitions cache %s: %s\n", cache_file, grib_get_error_message(err));
+        return 1;
+    }
+    printf("%zu of %zu definition files compiled into %s\n", num_compiled, list.count, cache_file);
+
+    for (i = 0; i < list.count; i++)
+        free(list.files[i]);
+    free(list.files);
+    grib_context_free(c, cache_file);
+    return 0;
+}
@@ -33,6 +33,10 @@ grib_option grib_options[] = {
     { "N", 0,
       "Do not compress index."
       "\n\t\tBy default the index is compressed to remove keys with only one value.\n",
+      0, 1, 0 },
+    { "j:", "threads",
+      "\n\t\tNumber of threads used to decode the messages and extract the keys."
+      "\n\t\tThe index is the same whatever the number of threads. Default is 1.\n",
       0, 1, 0 }
 };
 
@@ -73,6 +77,13 @@ int grib_tool_init(grib_runtime_options* options)
         grib_context_log(c, GRIB_LOG_FATAL,
                          "Unable to create index %s", grib_get_error_message(ret));
 
+    if (grib_options_on("j:")) {
+        const int num_threads = atoi(grib_options_get_option("j:"));
+        if (codes_index_set_num_threads(idx, num_threads) != GRIB_SUCCESS)
+            grib_context_log(c, GRIB_LOG_FATAL,
+                             "Invalid number of threads: %s", grib_options_get_option("j:"));
+    }
+
     return 0;
 }
 